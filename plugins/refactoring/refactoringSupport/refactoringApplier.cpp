@@ -141,7 +141,13 @@ QVariant RefactoringApplier::property(Id const &id, QString const &propertyName)
 void RefactoringApplier::applyRefactoringRule()
 {
 	loadRefactoringRule();
+
+	// The rule touches many elements, so views are updated once for each of them after it is applied.
+	mLogicalModelApi.beginTransaction();
+	mGraphicalModelApi.beginTransaction();
 	changeNamesRefactoring();
+	mLogicalModelApi.commitTransaction();
+	mGraphicalModelApi.commitTransaction();
 }
 
 IdList RefactoringApplier::applyElementsTo()
@@ -106,6 +106,10 @@ QList<qReal::ActionInfo> RefactoringPlugin::actions()
 	connect(mPlaceRLAction, SIGNAL(triggered()), this, SLOT(arrangeElementsRL()));
 	mPlaceMenu->addAction(mPlaceRLAction);
 
+	mPlaceByForcesAction = new QAction(tr("Force-directed"), NULL);
+	connect(mPlaceByForcesAction, SIGNAL(triggered()), this, SLOT(arrangeElementsByForces()));
+	mPlaceMenu->addAction(mPlaceByForcesAction);
+
 	mRefactoringMenu->addMenu(mPlaceMenu);
 
 	mActionInfos << refactoringMenuInfo;
@@ -333,17 +337,12 @@ void RefactoringPlugin::addPaletteGroup(QDomDocument metamodel
 
 void RefactoringPlugin::arrangeElements(const QString &algorithm)
 {
-	if (SettingsManager::value("pathToDot").toString().isEmpty()) {
-		mErrorReporter->addCritical(tr("Path to dot is not specified"));
-		return;
-	}
-
-	mMainWindowIFace->arrangeElementsByDotRunner(algorithm, mQRealSourceFilesPath + "/bin");
+	mMainWindowIFace->arrangeElements(algorithm);
 }
 
 void RefactoringPlugin::arrangeElementsBT()
 {
-	arrangeElements("TB"); // top-bottom
+	arrangeElements("BT");
 }
 
 void RefactoringPlugin::arrangeElementsLR()
@@ -352,7 +351,7 @@ void RefactoringPlugin::arrangeElementsLR()
 }
 void RefactoringPlugin::arrangeElementsTB()
 {
-	arrangeElements("BT"); // bottom-top
+	arrangeElements("TB");
 }
 
 void RefactoringPlugin::arrangeElementsRL()
@@ -360,6 +359,11 @@ void RefactoringPlugin::arrangeElementsRL()
 	arrangeElements("RL");
 }
 
+void RefactoringPlugin::arrangeElementsByForces()
+{
+	arrangeElements("force");
+}
+
 void RefactoringPlugin::findRefactoring(const QString &refactoringName)
 {
 	QString const refactoringPath = mPathToRefactoringExamples + refactoringName + ".qrs";
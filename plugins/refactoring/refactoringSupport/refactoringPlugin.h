@@ -49,18 +49,21 @@ private slots:
 	/// names of .qrs and .png are the same as name on the diagram
 	void saveRefactoring();
 
-	/// automatically arrange elements Bottom-Top by dotRunner
+	/// automatically arrange elements Bottom-Top in layers
 	void arrangeElementsBT();
 
-	/// automatically arrange elements Left-Right by dotRunner
+	/// automatically arrange elements Left-Right in layers
 	void arrangeElementsLR();
 
-	/// automatically arrange elements Top-Bottom by dotRunner
+	/// automatically arrange elements Top-Bottom in layers
 	void arrangeElementsTB();
 
-	/// automatically arrange elements Right-Left by dotRunner
+	/// automatically arrange elements Right-Left in layers
 	void arrangeElementsRL();
 
+	/// automatically arrange elements by simulation of forces pulling linked elements together
+	void arrangeElementsByForces();
+
 	/// find first place for applying refactoring on the active diagram
 	/// found place is highlighted
 	/// @param refactoringName name of .qrs with refactoring rule
@@ -129,6 +132,7 @@ private:
 	QAction *mPlaceTBAction;
 	QAction *mPlaceRLAction;
 	QAction *mPlaceBTAction;
+	QAction *mPlaceByForcesAction;
 
 	LogicalModelAssistInterface *mLogicalModelApi;
 	GraphicalModelAssistInterface *mGraphicalModelApi;
@@ -18,6 +18,9 @@ class AbstractTimer : public QObject
 public:
 	virtual void start(int ms) = 0;
 
+	/// Cancels the timeout of a started timer.
+	virtual void stop() = 0;
+
 signals:
 	void timeout();
 
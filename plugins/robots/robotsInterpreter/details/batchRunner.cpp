@@ -0,0 +1,479 @@
+#include "batchRunner.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMap>
+#include <QtCore/QProcess>
+#include <QtCore/QSet>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+
+#include <qrkernel/exception/exception.h>
+#include <qrkernel/settingsManager.h>
+#include <qrutils/xmlUtils.h>
+
+using namespace qReal;
+using namespace interpreters::robots::details;
+
+QString const batchOption = "--2d-batch";
+QString const outputOption = "--2d-batch-output";
+QString const jobsOption = "--2d-batch-jobs";
+QString const workerOption = "--2d-batch-worker";
+QString const timeoutOption = "--2d-batch-timeout";
+
+/// Option of QReal which keeps a session from writing anything shared: the project, its journal and autosaves,
+/// settings and the working directory.
+QString const readOnlyOption = "--read-only";
+
+quint64 const defaultTimeLimit = 60000;
+
+/// Time given to a worker to start and to open the project, or to close after the last experiment, in ms.
+qint64 const workerStartupTime = 60000;
+
+/// How many times longer than its time limit an experiment may take by the real clock. The clock of 2D model
+/// does not wait for real time, but nothing bounds how slow it is on a loaded machine, so the margin is wide.
+qint64 const timeLimitScale = 10;
+
+/// Interval between checks of workers' progress, in ms.
+int const workerPollInterval = 200;
+
+Id const robotDiagramType = Id("RobotsMetamodel", "RobotsDiagram", "RobotsDiagramNode");
+
+/// Settings changed by runs of a batch and restored after it.
+QStringList const batchSettings = QStringList() << "enableNoiseOfSensors" << "enableNoiseOfMotors"
+		<< "approximationLevel" << "port1SensorType" << "port2SensorType" << "port3SensorType" << "port4SensorType";
+
+namespace {
+
+struct NoiseSettings
+{
+	bool sensors;
+	bool motors;
+	int approximationLevel;
+};
+
+struct StartPose
+{
+	bool isSet;
+	QPointF position;
+	qreal direction;
+};
+
+/// Returns a value of given command line option, empty string if there is no such option.
+QString optionValue(QStringList const &arguments, QString const &option)
+{
+	int const index = arguments.indexOf(option);
+	return index == -1 ? QString() : arguments.value(index + 1);
+}
+
+/// Removes given option with its value from a command line.
+void removeOption(QStringList &arguments, QString const &option)
+{
+	int const index = arguments.indexOf(option);
+	if (index != -1) {
+		arguments.erase(arguments.begin() + index, arguments.begin() + qMin(index + 2, arguments.size()));
+	}
+}
+
+/// Makes a text fit into one cell of the table.
+QString cell(QString const &text)
+{
+	return QString(text).replace('\t', ' ').replace('\n', ' ');
+}
+
+/// Returns the count of lines in given file, 0 if it can not be read.
+int linesCount(QString const &fileName)
+{
+	QFile file(fileName);
+	return file.open(QIODevice::ReadOnly) ? file.readAll().count('\n') : 0;
+}
+
+}
+
+Experiment::Experiment()
+	: sensorNoise(false)
+	, motorNoise(false)
+	, approximationLevel(0)
+	, noiseSeed(1)
+	, hasStartPose(false)
+	, startDirection(0)
+	, timeLimit(defaultTimeLimit)
+{
+}
+
+BatchRunner::BatchRunner(GraphicalModelAssistInterface const &graphicalModelApi
+		, LogicalModelAssistInterface &logicalModelApi)
+	: mGraphicalModelApi(graphicalModelApi)
+	, mLogicalModelApi(logicalModelApi)
+{
+}
+
+bool BatchRunner::isRequested(QStringList const &arguments)
+{
+	return arguments.contains(batchOption);
+}
+
+int BatchRunner::runFromCommandLine(QStringList const &arguments)
+{
+	QTextStream errors(stderr);
+	QList<Experiment> experiments;
+	try {
+		experiments = readBatch(optionValue(arguments, batchOption));
+	} catch (Exception const &exception) {
+		errors << exception.message() << endl;
+		return 1;
+	}
+
+	int const jobs = arguments.contains(jobsOption)
+			? qMax(1, optionValue(arguments, jobsOption).toInt())
+			: QThread::idealThreadCount();
+
+	QString const outputFileName = optionValue(arguments, outputOption);
+	QFile output(outputFileName);
+	bool const isOpened = outputFileName.isEmpty()
+			? output.open(stdout, QIODevice::WriteOnly)
+			: output.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+	if (!isOpened) {
+		errors << QObject::tr("Can not write results to %1").arg(outputFileName) << endl;
+		return 1;
+	}
+
+	QTextStream out(&output);
+	if (arguments.contains(workerOption)) {
+		// A row is written as soon as its experiment finishes, so the batch sees that the worker makes progress.
+		foreach (int const i, workerShare(experiments.size(), jobs, optionValue(arguments, workerOption).toInt())) {
+			HeadlessRunResult const result = run(QList<Experiment>() << experiments[i]).first();
+			out << QString::number(i) << "\t" << tableRow(experiments[i], result) << "\n";
+			out.flush();
+		}
+	} else if (jobs > 1 && experiments.size() > 1) {
+		out << tableHeader() << "\n";
+		foreach (QString const &row, runInWorkers(arguments, experiments, qMin(jobs, experiments.size()))) {
+			out << row << "\n";
+		}
+	} else {
+		QList<HeadlessRunResult> const results = run(experiments);
+		out << tableHeader() << "\n";
+		for (int i = 0; i < experiments.size(); ++i) {
+			out << tableRow(experiments[i], results[i]) << "\n";
+		}
+	}
+
+	return 0;
+}
+
+QList<Experiment> BatchRunner::readBatch(QString const &fileName) const
+{
+	QDomDocument const batch = utils::xmlUtils::loadDocument(fileName);
+	QDomElement const root = batch.documentElement();
+	if (root.tagName() != "batch") {
+		throw Exception(QObject::tr("%1 is not a batch of 2D model runs").arg(fileName));
+	}
+
+	IdList const projectDiagrams = robotDiagrams();
+	IdList diagrams;
+	for (QDomElement diagram = root.firstChildElement("diagram"); !diagram.isNull()
+			; diagram = diagram.nextSiblingElement("diagram"))
+	{
+		QString const name = diagram.attribute("name");
+		Id found;
+		foreach (Id const &projectDiagram, projectDiagrams) {
+			if (mGraphicalModelApi.name(projectDiagram) == name) {
+				found = projectDiagram;
+				break;
+			}
+		}
+
+		if (found.isNull()) {
+			throw Exception(QObject::tr("There is no robot diagram \"%1\" in the project").arg(name));
+		}
+
+		diagrams << found;
+	}
+
+	if (diagrams.isEmpty()) {
+		diagrams = projectDiagrams;
+	}
+
+	QDir const batchDir = QFileInfo(fileName).absoluteDir();
+	QStringList worlds;
+	for (QDomElement world = root.firstChildElement("world"); !world.isNull()
+			; world = world.nextSiblingElement("world"))
+	{
+		QString const worldFile = batchDir.absoluteFilePath(world.attribute("file"));
+		if (!QFileInfo(worldFile).isFile()) {
+			throw Exception(QObject::tr("World %1 does not exist").arg(worldFile));
+		}
+
+		worlds << worldFile;
+	}
+
+	if (worlds.isEmpty()) {
+		worlds << QString();
+	}
+
+	QList<NoiseSettings> noises;
+	for (QDomElement noise = root.firstChildElement("noise"); !noise.isNull()
+			; noise = noise.nextSiblingElement("noise"))
+	{
+		NoiseSettings const settings = {
+			noise.attribute("sensors") == "true"
+			, noise.attribute("motors") == "true"
+			, noise.attribute("approximationLevel", "0").toInt()
+		};
+
+		noises << settings;
+	}
+
+	if (noises.isEmpty()) {
+		NoiseSettings const current = {
+			SettingsManager::value("enableNoiseOfSensors").toBool()
+			, SettingsManager::value("enableNoiseOfMotors").toBool()
+			, SettingsManager::value("approximationLevel").toInt()
+		};
+
+		noises << current;
+	}
+
+	QList<StartPose> poses;
+	for (QDomElement start = root.firstChildElement("start"); !start.isNull()
+			; start = start.nextSiblingElement("start"))
+	{
+		StartPose const pose = {
+			true
+			, QPointF(start.attribute("x").toDouble(), start.attribute("y").toDouble())
+			, start.attribute("direction").toDouble()
+		};
+
+		poses << pose;
+	}
+
+	if (poses.isEmpty()) {
+		StartPose const saved = { false, QPointF(), 0 };
+		poses << saved;
+	}
+
+	quint64 const timeLimit = root.attribute("timeLimit", QString::number(defaultTimeLimit)).toULongLong();
+	quint32 const seed = root.attribute("seed", "1").toUInt();
+	QList<Experiment> result;
+	foreach (Id const &diagram, diagrams) {
+		foreach (QString const &world, worlds) {
+			foreach (NoiseSettings const &noise, noises) {
+				foreach (StartPose const &pose, poses) {
+					Experiment experiment;
+					experiment.diagram = diagram;
+					experiment.worldFile = world;
+					experiment.sensorNoise = noise.sensors;
+					experiment.motorNoise = noise.motors;
+					experiment.approximationLevel = noise.approximationLevel;
+					experiment.noiseSeed = seed + result.size();
+					experiment.hasStartPose = pose.isSet;
+					experiment.startPosition = pose.position;
+					experiment.startDirection = pose.direction;
+					experiment.timeLimit = timeLimit;
+					result << experiment;
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+QList<HeadlessRunResult> BatchRunner::run(QList<Experiment> const &experiments)
+{
+	QMap<QString, QVariant> oldSettings;
+	foreach (QString const &setting, batchSettings) {
+		oldSettings[setting] = SettingsManager::value(setting);
+	}
+
+	HeadlessRunner runner(mGraphicalModelApi, mLogicalModelApi);
+	QList<HeadlessRunResult> results;
+	foreach (Experiment const &experiment, experiments) {
+		SettingsManager::setValue("enableNoiseOfSensors", experiment.sensorNoise);
+		SettingsManager::setValue("enableNoiseOfMotors", experiment.motorNoise);
+		SettingsManager::setValue("approximationLevel", experiment.approximationLevel);
+		runner.setNoiseSeed(experiment.noiseSeed);
+
+		if (experiment.hasStartPose) {
+			runner.setStartPose(experiment.startPosition, experiment.startDirection);
+		} else {
+			runner.resetStartPose();
+		}
+
+		QDomDocument const world = experiment.worldFile.isEmpty()
+				? QDomDocument()
+				: utils::xmlUtils::loadDocument(experiment.worldFile);
+		results << runner.run(experiment.diagram, world, experiment.timeLimit);
+	}
+
+	foreach (QString const &setting, batchSettings) {
+		SettingsManager::setValue(setting, oldSettings[setting]);
+	}
+
+	return results;
+}
+
+QString BatchRunner::tableHeader()
+{
+	return (QStringList() << "diagram" << "world" << "sensor noise" << "motor noise" << "approximation level"
+			<< "noise seed" << "start x" << "start y" << "start direction" << "finished" << "time" << "collisions"
+			<< "x" << "y" << "direction" << "errors").join("\t");
+}
+
+QString BatchRunner::tableRow(Experiment const &experiment, HeadlessRunResult const &result) const
+{
+	QStringList row;
+	row << cell(mGraphicalModelApi.name(experiment.diagram))
+			<< cell(experiment.worldFile.isEmpty() ? QObject::tr("saved") : experiment.worldFile)
+			<< QString::number(experiment.sensorNoise) << QString::number(experiment.motorNoise)
+			<< QString::number(experiment.approximationLevel) << QString::number(experiment.noiseSeed);
+
+	if (experiment.hasStartPose) {
+		row << QString::number(experiment.startPosition.x()) << QString::number(experiment.startPosition.y())
+				<< QString::number(experiment.startDirection);
+	} else {
+		row << "" << "" << "";
+	}
+
+	row << QString::number(result.finished) << QString::number(result.time)
+			<< QString::number(result.collisions)
+			<< QString::number(result.position.x()) << QString::number(result.position.y())
+			<< QString::number(result.direction) << cell(result.errors.join("; "));
+
+	return row.join("\t");
+}
+
+IdList BatchRunner::robotDiagrams() const
+{
+	IdList result;
+	foreach (Id const &diagram, mGraphicalModelApi.children(Id::rootId())) {
+		if (diagram.type() == robotDiagramType) {
+			result << diagram;
+		}
+	}
+
+	return result;
+}
+
+QStringList BatchRunner::runInWorkers(QStringList const &arguments, QList<Experiment> const &experiments, int jobs)
+{
+	QStringList workerArguments = arguments.mid(1);
+	removeOption(workerArguments, outputOption);
+	removeOption(workerArguments, jobsOption);
+	removeOption(workerArguments, timeoutOption);
+	workerArguments << jobsOption << QString::number(jobs) << "-platform" << "offscreen";
+	if (!workerArguments.contains(readOnlyOption)) {
+		// Workers open the project of this session, so they must not touch its journal and autosaves.
+		workerArguments << readOnlyOption;
+	}
+
+	// Workers write a row as soon as an experiment finishes. A worker which writes nothing for the timeout, by default
+	// for scaled time limit of its current experiment, is considered hung.
+	bool const hasTimeout = arguments.contains(timeoutOption);
+	qint64 const timeout = optionValue(arguments, timeoutOption).toLongLong() * 1000;
+
+	QElapsedTimer elapsed;
+	elapsed.start();
+
+	QList<QProcess *> workers;
+	QStringList outputs;
+	QList<int> finishedCounts;
+	QList<qint64> deadlines;
+	for (int worker = 0; worker < jobs; ++worker) {
+		outputs << QDir::temp().filePath(QString("qrealBatch_%1_%2.txt")
+				.arg(QCoreApplication::applicationPid()).arg(worker));
+
+		QProcess * const process = new QProcess();
+		process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+		process->start(QCoreApplication::applicationFilePath(), QStringList(workerArguments)
+				<< workerOption << QString::number(worker) << outputOption << outputs.last());
+		workers << process;
+		finishedCounts << 0;
+		deadlines << workerStartupTime + (hasTimeout ? timeout : timeLimitScale * experiments[worker].timeLimit);
+	}
+
+	QSet<int> hungWorkers;
+	int running = jobs;
+	while (running > 0) {
+		for (int worker = 0; worker < jobs; ++worker) {
+			if (!workers[worker]) {
+				continue;
+			}
+
+			bool const isFinished = workers[worker]->waitForFinished(qMax(1, workerPollInterval / running))
+					|| workers[worker]->state() == QProcess::NotRunning;
+			if (!isFinished) {
+				int const finishedCount = linesCount(outputs[worker]);
+				if (finishedCount > finishedCounts[worker]) {
+					finishedCounts[worker] = finishedCount;
+					int const current = worker + finishedCount * jobs;
+					deadlines[worker] = elapsed.elapsed() + (current >= experiments.size()
+							? workerStartupTime
+							: hasTimeout ? timeout : timeLimitScale * experiments[current].timeLimit);
+				}
+
+				if (elapsed.elapsed() < deadlines[worker]) {
+					continue;
+				}
+
+				workers[worker]->kill();
+				workers[worker]->waitForFinished();
+				hungWorkers << worker;
+			}
+
+			delete workers[worker];
+			workers[worker] = nullptr;
+			--running;
+		}
+	}
+
+	return mergeWorkerOutputs(experiments, outputs, hungWorkers);
+}
+
+QList<int> BatchRunner::workerShare(int experimentsCount, int jobs, int worker)
+{
+	QList<int> result;
+	for (int i = worker; i < experimentsCount; i += jobs) {
+		result << i;
+	}
+
+	return result;
+}
+
+QStringList BatchRunner::mergeWorkerOutputs(QList<Experiment> const &experiments, QStringList const &outputs
+		, QSet<int> const &hungWorkers) const
+{
+	QMap<int, QString> rows;
+	foreach (QString const &outputFileName, outputs) {
+		QFile output(outputFileName);
+		if (output.open(QIODevice::ReadOnly | QIODevice::Text)) {
+			QTextStream in(&output);
+			while (!in.atEnd()) {
+				QString const line = in.readLine();
+				int const separator = line.indexOf('\t');
+				rows[line.left(separator).toInt()] = line.mid(separator + 1);
+			}
+		}
+
+		output.remove();
+	}
+
+	QStringList result;
+	for (int i = 0; i < experiments.size(); ++i) {
+		if (rows.contains(i)) {
+			result << rows[i];
+		} else {
+			HeadlessRunResult failed;
+			failed.errors << (hungWorkers.contains(i % outputs.size())
+					? QObject::tr("Worker process did not finish in time and was killed")
+					: QObject::tr("Worker process failed"));
+			result << tableRow(experiments[i], failed);
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QPointF>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+
+#include <qrkernel/ids.h>
+#include <qrgui/toolPluginInterface/usedInterfaces/graphicalModelAssistInterface.h>
+#include <qrgui/toolPluginInterface/usedInterfaces/logicalModelAssistInterface.h>
+
+#include "headlessRunner.h"
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+
+/// One run of a batch: a program, a world and settings of 2D model to run it with.
+struct Experiment
+{
+	Experiment();
+
+	/// Graphical id of a diagram to interpret.
+	Id diagram;
+
+	/// File with 2D model world and robot, empty to use the world saved in the diagram.
+	QString worldFile;
+
+	bool sensorNoise;
+	bool motorNoise;
+	int approximationLevel;
+
+	/// Seed of the noise of sensors and motors, runs with the same seed give the same results.
+	quint32 noiseSeed;
+
+	/// If false, the robot starts from the pose saved in the world.
+	bool hasStartPose;
+	QPointF startPosition;
+	qreal startDirection;
+
+	/// Time in ms by the clock of 2D model after which the program is stopped.
+	quint64 timeLimit;
+};
+
+/// Runs series of robot programs on 2D model without windows and collects their results into a table.
+/// Runs are independent, so they are spread over worker processes, one per core by default. A worker is
+/// QReal itself started with the same project and a part of experiments to run:
+///
+///     qreal project.qrs --2d-batch batch.xml [--2d-batch-output results.txt] [--2d-batch-jobs 4]
+///             [--2d-batch-timeout 600]
+///
+/// Every worker runs experiments with numbers giving its number modulo the count of workers. Workers are
+/// started read-only, so they neither journal nor autosave the project and leave files of this session alone.
+/// A worker which finishes no experiment for the timeout, in seconds, is killed and its remaining experiments
+/// are reported as failed. By default it is given ten times the time limit of the current experiment, as the clock
+/// of 2D model has no fixed rate against the real one, and a minute to start. The table is tab-separated, one line
+/// per experiment in the order of the batch.
+class BatchRunner
+{
+public:
+	BatchRunner(GraphicalModelAssistInterface const &graphicalModelApi
+			, LogicalModelAssistInterface &logicalModelApi);
+
+	/// Returns true if QReal was started to run a batch.
+	static bool isRequested(QStringList const &arguments);
+
+	/// Runs a batch as requested by given command line of QReal, writing the table to the output file
+	/// or to standard output.
+	/// @returns exit code for the application.
+	int runFromCommandLine(QStringList const &arguments);
+
+	/// Reads a batch description, an XML file like
+	/// @code
+	/// <batch timeLimit="60000" seed="1">
+	///     <diagram name="Line follower"/>
+	///     <world file="maze.xml"/>
+	///     <noise sensors="true" motors="false" approximationLevel="1"/>
+	///     <start x="100" y="50" direction="90"/>
+	/// </batch>
+	/// @endcode
+	/// and returns an experiment for every combination of listed diagrams, worlds, noise settings
+	/// and start poses. Missing elements of a kind mean all robot diagrams of the project, worlds
+	/// saved in diagrams, current noise settings and saved poses respectively. Paths of worlds are
+	/// relative to the batch file. Noise of an experiment is seeded with the seed of the batch plus
+	/// the number of the experiment, so noisy runs differ from each other, but the batch repeats exactly.
+	/// @throws qReal::Exception if the file can not be read or refers to a missing diagram or world.
+	QList<Experiment> readBatch(QString const &fileName) const;
+
+	/// Runs given experiments one by one in this process. Settings of 2D model changed for runs
+	/// are restored afterwards.
+	QList<HeadlessRunResult> run(QList<Experiment> const &experiments);
+
+	/// Returns the header of the results table.
+	static QString tableHeader();
+
+	/// Returns a line of the results table for given experiment.
+	QString tableRow(Experiment const &experiment, HeadlessRunResult const &result) const;
+
+	/// Returns numbers of experiments run by given worker out of a given count of workers.
+	static QList<int> workerShare(int experimentsCount, int jobs, int worker);
+
+	/// Collects rows written by workers into given files, one file per worker and a line
+	/// "<number of experiment>\t<row>" per finished experiment, and removes the files.
+	/// @returns lines of the table in the order of experiments. Experiments without a row are reported
+	/// as failed, or as killed if their worker is listed as hung.
+	QStringList mergeWorkerOutputs(QList<Experiment> const &experiments, QStringList const &outputs
+			, QSet<int> const &hungWorkers) const;
+
+private:
+	/// Returns robot diagrams of the project.
+	IdList robotDiagrams() const;
+
+	/// Runs experiments in worker processes and returns lines of the table in the order of experiments.
+	QStringList runInWorkers(QStringList const &arguments, QList<Experiment> const &experiments, int jobs);
+
+	GraphicalModelAssistInterface const &mGraphicalModelApi;
+	LogicalModelAssistInterface &mLogicalModelApi;
+};
+
+}
+}
+}
+}
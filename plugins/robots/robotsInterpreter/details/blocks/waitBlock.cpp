@@ -1,12 +1,33 @@
 #include "waitBlock.h"
 
+#include "../robotParts/robotModel.h"
+
 using namespace qReal::interpreters::robots::details::blocks;
 
+int const activeWaitingInterval = 20;
+
 WaitBlock::WaitBlock(details::RobotModel * const robotModel)
 	: mRobotModel(robotModel)
+	, mActiveWaitingTimer(robotModel->timeline()->produceTimer())
+{
+	connect(mActiveWaitingTimer, SIGNAL(timeout()), this, SLOT(onActiveWaitingTimeout()));
+}
+
+WaitBlock::~WaitBlock()
+{
+	delete mActiveWaitingTimer;
+}
+
+void WaitBlock::startActiveWaiting()
+{
+	mActiveWaitingTimer->start(activeWaitingInterval);
+}
+
+void WaitBlock::onActiveWaitingTimeout()
 {
-	mActiveWaitingTimer.setInterval(20);
-	connect(&mActiveWaitingTimer, SIGNAL(timeout()), this, SLOT(timerTimeout()));
+	// The timer fires once, so it is restarted before polling which may stop the block.
+	startActiveWaiting();
+	timerTimeout();
 }
 
 void WaitBlock::setFailedStatus()
@@ -33,17 +54,17 @@ void WaitBlock::processResponce(int reading, int targetValue)
 
 void WaitBlock::stop()
 {
-	mActiveWaitingTimer.stop();
+	mActiveWaitingTimer->stop();
 	emit done(mNextBlock);
 }
 
 void WaitBlock::failureSlot()
 {
-	mActiveWaitingTimer.stop();
+	mActiveWaitingTimer->stop();
 	emit failure();
 }
 
 void WaitBlock::stopActiveTimerInBlock()
 {
-	mActiveWaitingTimer.stop();
+	mActiveWaitingTimer->stop();
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "block.h"
+#include "../abstractTimer.h"
 
 namespace qReal
 {
@@ -19,7 +20,7 @@ class WaitBlock : public Block
 
 public:
 	explicit WaitBlock(RobotModel * const robotModel);
-	virtual ~WaitBlock() {}
+	virtual ~WaitBlock();
 
 	virtual void setFailedStatus();
 	virtual void stopActiveTimerInBlock();
@@ -28,12 +29,20 @@ protected slots:
 	virtual void failureSlot();
 	virtual void timerTimeout() = 0;
 
+private slots:
+	void onActiveWaitingTimeout();
+
 protected:
 	void processResponce(int reading, int targetValue);
 	virtual void stop();
 
+	/// Starts polling, timerTimeout() is called periodically by the time of robot model until the block stops.
+	void startActiveWaiting();
+
 	RobotModel * const mRobotModel;
-	QTimer mActiveWaitingTimer;
+
+	/// Timer of robot model, so polling keeps up with the time of 2D model when it runs faster than real time.
+	AbstractTimer * const mActiveWaitingTimer;  // Has ownership
 };
 
 }
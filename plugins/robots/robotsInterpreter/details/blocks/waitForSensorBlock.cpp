@@ -17,7 +17,7 @@ void WaitForSensorBlock::run()
 	robotParts::Sensor * const sensorInstance = sensor();
 
 	if (!sensorInstance) {
-		mActiveWaitingTimer.stop();
+		mActiveWaitingTimer->stop();
 		error(tr("%1 is not configured on port %2").arg(name(), QString::number(static_cast<int>(mPort) + 1)));
 		return;
 	}
@@ -26,7 +26,7 @@ void WaitForSensorBlock::run()
 	connect(sensorInstance->sensorImpl(), SIGNAL(failure()), this, SLOT(failureSlot()), Qt::UniqueConnection);
 
 	sensorInstance->read();
-	mActiveWaitingTimer.start();
+	startActiveWaiting();
 }
 
 QList<Block::SensorPortPair> WaitForSensorBlock::usedSensors() const
@@ -16,6 +16,11 @@ void D2ModelTimer::start(int ms)
 	mListening = true;
 }
 
+void D2ModelTimer::stop()
+{
+	mListening = false;
+}
+
 void D2ModelTimer::onTick()
 {
 	if (!mListening) {
@@ -23,6 +23,7 @@ public:
 	D2ModelTimer(Timeline const *timeline /* Doesn`t take ownership */);
 
 	virtual void start(int ms);
+	virtual void stop();
 
 private slots:
 	void onTick();
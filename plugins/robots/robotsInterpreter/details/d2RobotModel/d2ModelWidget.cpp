@@ -711,24 +711,31 @@ void D2ModelWidget::mouseMoved(QGraphicsSceneMouseEvent *mouseEvent)
 	}
 
 	bool needUpdate = true;
+	// Mouse moves over the scene all the time, caches of the world are dropped only when it has changed.
+	bool worldChanged = false;
 	processDragMode();
 	switch (mDrawingAction){
 	case enums::drawingAction::wall:
 		reshapeWall(mouseEvent);
+		worldChanged = mCurrentWall != nullptr;
 		break;
 	case enums::drawingAction::line:
 		reshapeLine(mouseEvent);
+		worldChanged = mCurrentLine != nullptr;
 		break;
 	case enums::drawingAction::stylus:
 		reshapeStylus(mouseEvent);
+		worldChanged = mCurrentStylus != nullptr;
 		break;
 	case enums::drawingAction::ellipse:
 		reshapeEllipse(mouseEvent);
+		worldChanged = mCurrentEllipse != nullptr;
 		break;
 	default:
 		needUpdate = false;
 		if (mouseEvent->buttons() & Qt::LeftButton) {
 			mScene->forMoveResize(mouseEvent, mRobot->realBoundingRect());
+			worldChanged = isWorldItemSelected();
 		}
 		break;
 	}
@@ -736,6 +743,10 @@ void D2ModelWidget::mouseMoved(QGraphicsSceneMouseEvent *mouseEvent)
 	if (needUpdate) {
 		mScene->update();
 	}
+
+	if (worldChanged) {
+		mWorldModel->invalidateCaches();
+	}
 }
 
 void D2ModelWidget::mouseReleased(QGraphicsSceneMouseEvent *mouseEvent)
@@ -787,6 +798,7 @@ void D2ModelWidget::mouseReleased(QGraphicsSceneMouseEvent *mouseEvent)
 
 	mScene->setMoveFlag(mouseEvent);
 
+	mWorldModel->invalidateCaches();
 	mScene->update();
 	saveToRepo();
 }
@@ -978,6 +990,17 @@ QList<AbstractItem *> D2ModelWidget::selectedColorItems()
 	return resList;
 }
 
+bool D2ModelWidget::isWorldItemSelected() const
+{
+	foreach (QGraphicsItem * const item, mScene->selectedItems()) {
+		if (dynamic_cast<WallItem *>(item) || dynamic_cast<ColorFieldItem *>(item)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void D2ModelWidget::changePenWidth(int width)
 {
 	mScene->setPenWidthItems(width);
@@ -986,6 +1009,7 @@ void D2ModelWidget::changePenWidth(int width)
 		item->setPenWidth(width);
 	}
 
+	mWorldModel->invalidateCaches();
 	mScene->update();
 }
 
@@ -997,6 +1021,7 @@ void D2ModelWidget::changePenColor(int textIndex)
 		item->setPenColor(text);
 	}
 
+	mWorldModel->invalidateCaches();
 	mScene->update();
 }
 
@@ -1269,6 +1294,8 @@ void D2ModelWidget::alignWalls()
 			wall->setEndCoordinatesWithGrid(SettingsManager::value("2dGridCellSize").toInt());
 		}
 	}
+
+	mWorldModel->invalidateCaches();
 }
 
 void D2ModelWidget::onSensorConfigurationChanged(
@@ -245,6 +245,9 @@ private:
 	QList<graphicsUtils::AbstractItem *> selectedColorItems();
 	bool isColorItem(graphicsUtils::AbstractItem *item);
 
+	/// Returns true if a wall or a color field is selected, so dragging changes the world.
+	bool isWorldItemSelected() const;
+
 	int sensorTypeToComboBoxIndex(robots::enums::sensorType::SensorTypeEnum const type);
 
 	void centerOnRobot();
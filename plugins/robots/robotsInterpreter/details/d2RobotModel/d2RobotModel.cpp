@@ -11,6 +11,18 @@ using namespace qReal::interpreters::robots;
 using namespace details;
 using namespace d2Model;
 
+namespace {
+
+/// Returns transformation from robot coordinates to scene coordinates for the robot placed at given position
+/// and rotated around its centre as RobotItem is.
+QTransform robotTransform(QPointF const &position, qreal angle)
+{
+	return QTransform().translate(position.x() + rotatePoint.x(), position.y() + rotatePoint.y())
+			.rotate(angle).translate(-rotatePoint.x(), -rotatePoint.y());
+}
+
+}
+
 D2RobotModel::D2RobotModel(QObject *parent)
 	: QObject(parent)
 	, mD2ModelWidget(nullptr)
@@ -24,6 +36,8 @@ D2RobotModel::D2RobotModel(QObject *parent)
 	, mNeedSync(false)
 	, mPos(QPointF(0,0))
 	, mAngle(0)
+	, mCollisionsCount(0)
+	, mIsColliding(false)
 {
 	mNoiseGen.setApproximationLevel(SettingsManager::value("approximationLevel").toUInt());
 	connect(mTimeline, SIGNAL(tick()), this, SLOT(recalculateParams()), Qt::UniqueConnection);
@@ -34,6 +48,9 @@ D2RobotModel::D2RobotModel(QObject *parent)
 D2RobotModel::~D2RobotModel()
 {
 	delete mPhysicsEngine;
+	if (!mD2ModelWidget) {
+		deleteWorld();
+	}
 }
 
 void D2RobotModel::initPosition()
@@ -52,7 +69,9 @@ void D2RobotModel::initPosition()
 	mEngineB = initEngine(robotWheelDiameterInPx / 2, 0, 0, 1, false);
 	mEngineC = initEngine(robotWheelDiameterInPx / 2, 0, 0, 2, false);
 	setBeep(0, 0);
-	mPos = mD2ModelWidget ? mD2ModelWidget->robotPos() : QPointF(0, 0);
+	if (mD2ModelWidget) {
+		mPos = mD2ModelWidget->robotPos();
+	}
 }
 
 void D2RobotModel::clear()
@@ -143,6 +162,16 @@ D2ModelWidget *D2RobotModel::createModelWidget()
 
 QPair<QPointF, qreal> D2RobotModel::countPositionAndDirection(robots::enums::inputPort::InputPortEnum const port) const
 {
+	if (!mD2ModelWidget) {
+		if (mSensorsConfiguration.type(port) == robots::enums::sensorType::unused) {
+			return QPair<QPointF, qreal>(QPointF(), 0);
+		}
+
+		QPointF const onRobot = mConfigurationToRobot.map(mSensorsConfiguration.position(port));
+		return QPair<QPointF, qreal>(robotTransform(mPos, mAngle).map(onRobot)
+				, mSensorsConfiguration.direction(port) + mAngle);
+	}
+
 	QVector<SensorItem *> items = mD2ModelWidget->sensorItems();
 	SensorItem *sensor = items[port];
 	QPointF const position = sensor ? sensor->scenePos() : QPointF();
@@ -193,13 +222,12 @@ int D2RobotModel::spoilSonarReading(int const distance) const
 
 int D2RobotModel::readColorSensor(robots::enums::inputPort::InputPortEnum const port) const
 {
-	QImage const image = printColorSensor(port);
+	QVector<uint> const colors = sensorColors(port);
 	QHash<uint, int> countsColor;
 
-	uint const *data = reinterpret_cast<uint const *>(image.bits());
-	int const n = image.byteCount() / 4;
-	for (int i = 0; i < n; ++i) {
-		uint const color = mNeedSensorNoise ? spoilColor(data[i]) : data[i];
+	int const n = colors.size();
+	foreach (uint const pixel, colors) {
+		uint const color = mNeedSensorNoise ? spoilColor(pixel) : pixel;
 		++countsColor[color];
 	}
 
@@ -238,34 +266,17 @@ uint D2RobotModel::spoilColor(uint const color) const
 	return ((r & 0xFF) << 16) + ((g & 0xFF) << 8) + (b & 0xFF) + ((a & 0xFF) << 24);
 }
 
-QImage D2RobotModel::printColorSensor(robots::enums::inputPort::InputPortEnum const port) const
+QVector<uint> D2RobotModel::sensorColors(robots::enums::inputPort::InputPortEnum const port) const
 {
 	if (mSensorsConfiguration.type(port) == robots::enums::sensorType::unused) {
-		return QImage();
+		return QVector<uint>();
 	}
 
-	QPair<QPointF, qreal> const neededPosDir = countPositionAndDirection(port);
-	QPointF const position = neededPosDir.first;
+	// A pixel of the sensor sees the floor at its centre.
+	QPointF const position = countPositionAndDirection(port).first;
 	qreal const width = sensorWidth / 2.0;
-	QRectF const scanningRect = QRectF(position.x() - width, position.y() - width
-			, 2 * width, 2 * width);
-
-	QImage image(scanningRect.size().toSize(), QImage::Format_RGB32);
-	QPainter painter(&image);
-
-	QBrush brush(Qt::SolidPattern);
-	brush.setColor(Qt::white);
-	painter.setBrush(brush);
-	painter.setPen(QPen(Qt::white));
-	painter.drawRect(scanningRect.translated(-scanningRect.topLeft()));
-
-	bool const wasSelected = mD2ModelWidget->sensorItems()[port]->isSelected();
-	mD2ModelWidget->setSensorVisible(port, false);
-	mD2ModelWidget->scene()->render(&painter, QRectF(), scanningRect);
-	mD2ModelWidget->setSensorVisible(port, true);
-	mD2ModelWidget->sensorItems()[port]->setSelected(wasSelected);
-
-	return image;
+	QPoint const topLeft(qFloor(position.x() - width + 0.5), qFloor(position.y() - width + 0.5));
+	return mWorldModel.floorColors(QRect(topLeft, QSize(sensorWidth, sensorWidth)));
 }
 
 int D2RobotModel::readColorFullSensor(QHash<uint, int> const &countsColor) const
@@ -344,17 +355,16 @@ int D2RobotModel::readLightSensor(robots::enums::inputPort::InputPortEnum const
 	// Must return 1023 on white and 0 on black normalized to percents
 	// http://stackoverflow.com/questions/596216/formula-to-determine-brightness-of-rgb-color
 
-	QImage const image = printColorSensor(port);
-	if (image.isNull()) {
+	QVector<uint> const colors = sensorColors(port);
+	if (colors.isEmpty()) {
 		return 0;
 	}
 
 	uint sum = 0;
-	uint const *data = reinterpret_cast<uint const *>(image.bits());
-	int const n = image.byteCount() / 4;
+	int const n = colors.size();
 
-	for (int i = 0; i < n; ++i) {
-		int const color = mNeedSensorNoise ? spoilLight(data[i]) : data[i];
+	foreach (uint const pixel, colors) {
+		int const color = mNeedSensorNoise ? spoilLight(pixel) : pixel;
 		int const b = (color >> 0) & 0xFF;
 		int const g = (color >> 8) & 0xFF;
 		int const r = (color >> 16) & 0xFF;
@@ -386,13 +396,17 @@ uint D2RobotModel::spoilLight(uint const color) const
 void D2RobotModel::startInit()
 {
 	initPosition();
+	mCollisionsCount = 0;
+	mIsColliding = false;
 	mTimeline->start();
 }
 
 void D2RobotModel::startInterpretation()
 {
 	startInit();
-	mD2ModelWidget->startTimelineListening();
+	if (mD2ModelWidget) {
+		mD2ModelWidget->startTimelineListening();
+	}
 }
 
 void D2RobotModel::stopRobot()
@@ -403,17 +417,46 @@ void D2RobotModel::stopRobot()
 	mEngineB->breakMode = true;
 	mEngineC->speed = 0;
 	mEngineC->breakMode = true;
-	mD2ModelWidget->stopTimelineListening();
+	if (mD2ModelWidget) {
+		mD2ModelWidget->stopTimelineListening();
+	}
 }
 
 void D2RobotModel::countBeep()
 {
-	if (mBeep.time > 0) {
-		mD2ModelWidget->drawBeep(true);
+	bool const isNeededBeep = mBeep.time > 0;
+	if (isNeededBeep) {
 		mBeep.time -= Timeline::frameLength;
-	} else {
-		mD2ModelWidget->drawBeep(false);
 	}
+
+	if (mD2ModelWidget) {
+		mD2ModelWidget->drawBeep(isNeededBeep);
+	}
+}
+
+bool D2RobotModel::isRobotOnTheGround() const
+{
+	// Without the window nobody can pick the robot up.
+	return !mD2ModelWidget || mD2ModelWidget->isRobotOnTheGround();
+}
+
+QPainterPath D2RobotModel::robotBoundingPolygon() const
+{
+	if (mD2ModelWidget) {
+		return mD2ModelWidget->robotBoundingPolygon(mPos, mAngle);
+	}
+
+	QPainterPath path;
+	path.addRect(QRectF(0, 0, robotWidth, robotHeight));
+	for (int i = 0; i < 4; ++i) {
+		robots::enums::inputPort::InputPortEnum const port = static_cast<robots::enums::inputPort::InputPortEnum>(i);
+		if (mSensorsConfiguration.type(port) != robots::enums::sensorType::unused) {
+			QPointF const onRobot = mConfigurationToRobot.map(mSensorsConfiguration.position(port));
+			path.addRect(QRectF(onRobot - QPointF(sensorWidth / 2, sensorWidth / 2), QSizeF(sensorWidth, sensorWidth)));
+		}
+	}
+
+	return robotTransform(mPos, mAngle).map(path);
 }
 
 QPointF D2RobotModel::rotationCenter() const
@@ -430,13 +473,20 @@ void D2RobotModel::nextStep()
 void D2RobotModel::recalculateParams()
 {
 	// do nothing until robot gets back on the ground
-	if (!mD2ModelWidget->isRobotOnTheGround() || !mPhysicsEngine) {
+	if (!isRobotOnTheGround() || !mPhysicsEngine) {
 		mNeedSync = true;
 		return;
 	}
 
 	synchronizePositions();
 
+	bool const isColliding = mWorldModel.checkCollision(robotBoundingPolygon());
+	if (isColliding && !mIsColliding) {
+		++mCollisionsCount;
+	}
+
+	mIsColliding = isColliding;
+
 	Engine *engine1 = mEngineA;
 	Engine *engine2 = mEngineB;
 
@@ -457,26 +507,28 @@ void D2RobotModel::recalculateParams()
 	mPhysicsEngine->recalculateParams(Timeline::timeInterval, speed1, speed2
 			, engine1->breakMode, engine2->breakMode
 			, rotationCenter(), mAngle
-			, mD2ModelWidget->robotBoundingPolygon(mPos, mAngle));
+			, robotBoundingPolygon());
 	nextStep();
 	countMotorTurnover();
 }
 
 void D2RobotModel::nextFragment()
 {
-	if (!mD2ModelWidget->isRobotOnTheGround()) {
+	if (!isRobotOnTheGround()) {
 		return;
 	}
 
 	synchronizePositions();
 	countBeep();
-	mD2ModelWidget->draw(mPos, mAngle);
-	mNeedSync = true;
+	if (mD2ModelWidget) {
+		mD2ModelWidget->draw(mPos, mAngle);
+		mNeedSync = true;
+	}
 }
 
 void D2RobotModel::synchronizePositions()
 {
-	if (mNeedSync) {
+	if (mNeedSync && mD2ModelWidget) {
 		mPos = mD2ModelWidget->robotPos();
 		mNeedSync = false;
 	}
@@ -484,14 +536,18 @@ void D2RobotModel::synchronizePositions()
 
 void D2RobotModel::showModelWidget()
 {
-	mD2ModelWidget->init(true);
+	if (mD2ModelWidget) {
+		mD2ModelWidget->init(true);
+	}
 }
 
 void D2RobotModel::setRotation(qreal angle)
 {
-	mPos = mD2ModelWidget ? mD2ModelWidget->robotPos() : QPointF(0, 0);
 	mAngle = fmod(angle, 360);
-	mD2ModelWidget->draw(mPos, mAngle);
+	if (mD2ModelWidget) {
+		mPos = mD2ModelWidget->robotPos();
+		mD2ModelWidget->draw(mPos, mAngle);
+	}
 }
 
 qreal D2RobotModel::rotateAngle() const
@@ -508,7 +564,9 @@ void D2RobotModel::setSpeedFactor(qreal speedMul)
 void D2RobotModel::setRobotPos(QPointF const &newPos)
 {
 	mPos = newPos;
-	mD2ModelWidget->draw(mPos, mAngle);
+	if (mD2ModelWidget) {
+		mD2ModelWidget->draw(mPos, mAngle);
+	}
 }
 
 QPointF D2RobotModel::robotPos()
@@ -516,6 +574,16 @@ QPointF D2RobotModel::robotPos()
 	return mPos;
 }
 
+int D2RobotModel::collisionsCount() const
+{
+	return mCollisionsCount;
+}
+
+void D2RobotModel::setNoiseSeed(quint32 seed)
+{
+	mNoiseGen.setSeed(seed);
+}
+
 void D2RobotModel::serialize(QDomDocument &target)
 {
 	QDomElement robot = target.createElement("robot");
@@ -534,10 +602,37 @@ void D2RobotModel::deserialize(QDomElement const &robotElement)
 	mPos = QPointF(x, y);
 	mAngle = robotElement.attribute("direction", "0").toDouble();
 	configuration().deserialize(robotElement);
+	mConfigurationToRobot = robotTransform(mPos, mAngle).inverted();
 	mNeedSync = false;
 	nextFragment();
 }
 
+void D2RobotModel::loadWorld(QDomDocument const &worldModel)
+{
+	if (mD2ModelWidget) {
+		mD2ModelWidget->loadXml(worldModel);
+		return;
+	}
+
+	QDomNodeList const worldList = worldModel.elementsByTagName("world");
+	QDomNodeList const robotList = worldModel.elementsByTagName("robot");
+	if (worldList.count() != 1 || robotList.count() != 1) {
+		return;
+	}
+
+	deleteWorld();
+	mWorldModel.deserialize(worldList.at(0).toElement());
+	deserialize(robotList.at(0).toElement());
+}
+
+void D2RobotModel::deleteWorld()
+{
+	// Items of the world belong to the scene of 2D model window, without it they are deleted here.
+	qDeleteAll(mWorldModel.walls());
+	qDeleteAll(mWorldModel.colorFields());
+	mWorldModel.clearScene();
+}
+
 Timeline *D2RobotModel::timeline() const
 {
 	return mTimeline;
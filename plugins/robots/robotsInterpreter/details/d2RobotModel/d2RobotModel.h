@@ -3,6 +3,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 #include <QtCore/qmath.h>
+#include <QtGui/QTransform>
 
 #include <qrutils/mathUtils/gaussNoise.h>
 #include "d2ModelWidget.h"
@@ -21,6 +22,8 @@ namespace physics {
 class PhysicsEngineBase;
 }
 
+/// Simulated robot moving in 2D world. Can work without 2D model window, in which case sensors are read
+/// from the world model directly and the robot is not drawn, see HeadlessRunner.
 class D2RobotModel : public QObject, public RobotModelInterface
 {
 	Q_OBJECT
@@ -54,13 +57,22 @@ public:
 	void setRobotPos(QPointF const &newPos);
 	QPointF robotPos();
 
+	/// Returns how many times the robot has run into walls since the model was started.
+	int collisionsCount() const;
+
 	virtual void serialize(QDomDocument &target);
 	virtual void deserialize(const QDomElement &robotElement);
 
+	/// Loads world and robot from XML of 2D model, into 2D model window if there is one.
+	void loadWorld(QDomDocument const &worldModel);
+
 	Timeline *timeline() const;
 
 	void setNoiseSettings();
 
+	/// Makes noise of sensors and motors repeat from run to run when the model is driven the same way.
+	void setNoiseSeed(quint32 seed);
+
 	enum ATime {
 		DoInf,
 		DoByLimit,
@@ -101,13 +113,18 @@ private:
 	void countNewForces();
 	void countBeep();
 
+	bool isRobotOnTheGround() const;
+	QPainterPath robotBoundingPolygon() const;
+
 	QPair<QPointF, qreal> countPositionAndDirection(
 			robots::enums::inputPort::InputPortEnum const port
 			) const;
 
 	void countMotorTurnover();
 
-	QImage printColorSensor(robots::enums::inputPort::InputPortEnum const port) const;
+	/// Returns colors of the floor under color or light sensor on given port, empty if there is no sensor.
+	QVector<uint> sensorColors(robots::enums::inputPort::InputPortEnum const port) const;
+	void deleteWorld();
 	int readColorFullSensor(QHash<uint, int> const &countsColor) const;
 	int readColorNoneSensor(QHash<uint, int> const &countsColor, int n) const;
 	int readSingleColorSensor(uint color, QHash<uint, int> const &countsColor, int n) const;
@@ -143,6 +160,13 @@ private:
 
 	QPointF mPos;
 	qreal mAngle;
+
+	/// Maps positions of sensors in configuration to robot coordinates. Positions are stored in scene
+	/// coordinates of the robot as it was placed when they were saved.
+	QTransform mConfigurationToRobot;
+
+	int mCollisionsCount;
+	bool mIsColliding;
 };
 
 }
@@ -11,6 +11,8 @@ Timeline::Timeline(QObject *parent)
 	, mSpeedFactor(normalSpeedFactor)
 	, mCyclesCount(0)
 	, mIsStarted(false)
+	, mIsImmediate(false)
+	, mTimestamp(0)
 {
 	connect(&mTimer, SIGNAL(timeout()), this, SLOT(onTimer()));
 	mTimer.setInterval(realTimeInterval);
@@ -24,9 +26,21 @@ void Timeline::start()
 	}
 }
 
+void Timeline::stop()
+{
+	mIsStarted = false;
+	mTimer.stop();
+}
+
+void Timeline::setImmediateMode(bool immediate)
+{
+	mIsImmediate = immediate;
+	mTimer.setInterval(immediate ? 0 : realTimeInterval);
+}
+
 void Timeline::onTimer()
 {
-	for (int i = 0; i < ticksPerCycle; ++i) {
+	for (int i = 0; mIsStarted && i < ticksPerCycle; ++i) {
 		mTimestamp += timeInterval;
 		emit tick();
 		++mCyclesCount;
@@ -36,7 +50,7 @@ void Timeline::onTimer()
 			int const msFromFrameStart = static_cast<int>(QDateTime::currentMSecsSinceEpoch()
 					- mFrameStartTimestamp);
 			int const pauseBeforeFrameEnd = frameLength - msFromFrameStart;
-			if (pauseBeforeFrameEnd > 0) {
+			if (pauseBeforeFrameEnd > 0 && !mIsImmediate) {
 				QTimer::singleShot(pauseBeforeFrameEnd - 1, this, SLOT(gotoNextFrame()));
 			} else {
 				gotoNextFrame();
@@ -48,6 +62,10 @@ void Timeline::onTimer()
 
 void Timeline::gotoNextFrame()
 {
+	if (!mIsStarted) {
+		return;
+	}
+
 	emit nextFrame();
 	mFrameStartTimestamp = QDateTime::currentMSecsSinceEpoch();
 	if (!mTimer.isActive()) {
@@ -32,8 +32,16 @@ public:
 
 	AbstractTimer *produceTimer() override;
 
+	/// Makes the timeline run on a virtual clock, emitting ticks and frames as fast as possible without waiting
+	/// for real time to pass, or back on real time. Used to simulate the model without 2D model window.
+	void setImmediateMode(bool immediate);
+
 public slots:
 	void start();
+
+	/// Stops emitting ticks and frames until the timeline is started again.
+	void stop();
+
 	// Speed factor is also cycles per frame count
 	void setSpeedFactor(int factor);
 
@@ -54,6 +62,7 @@ private:
 	int mCyclesCount;
 	qint64 mFrameStartTimestamp;
 	bool mIsStarted;
+	bool mIsImmediate;
 	quint64 mTimestamp;
 };
 
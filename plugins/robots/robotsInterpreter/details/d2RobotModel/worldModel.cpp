@@ -1,5 +1,11 @@
 #include <QtGui/QTransform>
+#include <QtGui/QPainter>
 #include <QtCore/QStringList>
+#include <QtCore/qmath.h>
+#include <QtGui/QVector2D>
+
+#include <algorithm>
+#include <QtWidgets/QStyleOptionGraphicsItem>
 
 #include "worldModel.h"
 
@@ -9,58 +15,150 @@
 
 using namespace qReal::interpreters::robots::details::d2Model;
 
-WorldModel::WorldModel()
+/// Size of a side of a floor tile in scene pixels.
+int const floorTileSize = 256;
+
+/// Size of a side of a cell of the grid over walls in scene pixels.
+int const wallCellSize = 128;
+
+int const maxSonarRangeCms = 255;
+
+/// Half of the angle of the sonar sector in degrees.
+qreal const sonarRayWidthDegrees = 10.0;
+
+namespace {
+
+qreal crossProduct(QPointF const &a, QPointF const &b)
 {
+	return a.x() * b.y() - a.y() * b.x();
 }
 
-int WorldModel::sonarReading(QPointF const &position, qreal direction) const
+qreal dotProduct(QPointF const &a, QPointF const &b)
+{
+	return a.x() * b.x() + a.y() * b.y();
+}
+
+QPointF directionVector(qreal angleInDegrees)
+{
+	qreal const angle = qDegreesToRadians(angleInDegrees);
+	return QPointF(qCos(angle), qSin(angle));
+}
+
+/// Narrows parameters range [from, to] to the parameters t for which a + b * t >= 0.
+/// @returns false if nothing is left.
+bool clip(qreal a, qreal b, qreal &from, qreal &to)
+{
+	if (qFuzzyIsNull(b)) {
+		return a >= 0;
+	}
+
+	qreal const bound = -a / b;
+	if (b > 0) {
+		from = qMax(from, bound);
+	} else {
+		to = qMin(to, bound);
+	}
+
+	return from <= to;
+}
+
+qreal distance(QPointF const &point, QLineF const &segment)
+{
+	QPointF const vector = segment.p2() - segment.p1();
+	qreal const squaredLength = dotProduct(vector, vector);
+	qreal const t = qFuzzyIsNull(squaredLength)
+			? 0
+			: qBound(0.0, dotProduct(point - segment.p1(), vector) / squaredLength, 1.0);
+	return QLineF(point, segment.p1() + t * vector).length();
+}
+
+qreal distance(QLineF const &segment1, QLineF const &segment2)
 {
-	int maxSonarRangeCms = 255;
-	int minSonarRangeCms = 0;
-	int currentRangeInCm = (minSonarRangeCms + maxSonarRangeCms) / 2;
+	if (segment1.intersect(segment2, nullptr) == QLineF::BoundedIntersection) {
+		return 0;
+	}
+
+	return qMin(qMin(distance(segment1.p1(), segment2), distance(segment1.p2(), segment2))
+			, qMin(distance(segment2.p1(), segment1), distance(segment2.p2(), segment1)));
+}
 
-	QPainterPath const wallPath = buildWallPath();
-	if (!checkSonarDistance(maxSonarRangeCms, position, direction, wallPath)) {
-		Tracer::debug(tracer::enums::d2Model, "WorldModel::sonarReading", "Sonar sensor. Reading: max (" + QString(maxSonarRangeCms) + ")");
-		return maxSonarRangeCms;
+/// Returns true if given segment lies closer than given distance to given polygon or inside it.
+bool isNear(QLineF const &segment, QPolygonF const &polygon, qreal maxDistance)
+{
+	if (polygon.containsPoint(segment.p1(), Qt::OddEvenFill)) {
+		return true;
 	}
 
-	for ( ; minSonarRangeCms < maxSonarRangeCms;
-			currentRangeInCm = (minSonarRangeCms + maxSonarRangeCms) / 2)
-	{
-		if (checkSonarDistance(currentRangeInCm, position, direction, wallPath)) {
-			maxSonarRangeCms = currentRangeInCm;
-		} else {
-			minSonarRangeCms = currentRangeInCm + 1;
+	for (int i = 0; i + 1 < polygon.size(); ++i) {
+		if (distance(segment, QLineF(polygon[i], polygon[i + 1])) <= maxDistance) {
+			return true;
 		}
 	}
 
-	Tracer::debug(tracer::enums::d2Model, "WorldModel::sonarReading", "Sonar sensor. Reading: " + QString(currentRangeInCm));
-	return currentRangeInCm;
+	return false;
+}
+
 }
 
-bool WorldModel::checkSonarDistance(int const distance, QPointF const &position
-		, qreal const direction, QPainterPath const &wallPath) const
+WorldModel::WorldModel()
+	: mWallsIndexIsValid(false)
 {
-	QPainterPath const rayPath = sonarScanningRegion(position, direction, distance);
-	return rayPath.intersects(wallPath);
 }
 
-bool WorldModel::touchSensorReading(QPointF const &position, qreal direction, robots::enums::inputPort::InputPortEnum const port)
+int WorldModel::sonarReading(QPointF const &position, qreal direction) const
 {
-	Q_UNUSED(direction)
+	// The sector is the wedge between two rays cut by the range. Every wall is clipped by the wedge,
+	// and the distance to the closest remaining point is the reading.
+	QPointF const rightRay = directionVector(direction - sonarRayWidthDegrees);
+	QPointF const leftRay = directionVector(direction + sonarRayWidthDegrees);
+	qreal const range = maxSonarRangeCms * pixelsInCm;
+
+	// The arc of the sector lies inside the triangle with sides on rays and the tangent to the arc middle.
+	qreal const triangleSide = range / qCos(qDegreesToRadians(sonarRayWidthDegrees));
+	QPolygonF const triangle = QPolygonF() << position << position + triangleSide * rightRay
+			<< position + triangleSide * leftRay;
+
+	qreal closest = range;
+	bool found = false;
+	foreach (int const index, wallsIndicesNear(triangle.boundingRect())) {
+		QLineF const &wall = mWallSegments[index].line;
+		QPointF const begin = wall.p1() - position;
+		QPointF const vector = wall.p2() - wall.p1();
+		qreal from = 0;
+		qreal to = 1;
+		if (!clip(crossProduct(rightRay, begin), crossProduct(rightRay, vector), from, to)
+				|| !clip(crossProduct(begin, leftRay), crossProduct(vector, leftRay), from, to))
+		{
+			continue;
+		}
+
+		qreal const wallDistance = distance(position, QLineF(wall.pointAt(from), wall.pointAt(to)));
+		if (wallDistance <= closest) {
+			closest = wallDistance;
+			found = true;
+		}
+	}
 
-	QPainterPathStroker pathStroker;
-	pathStroker.setWidth(3);
-	QPainterPath robotPath;
+	int const reading = found ? qMin(maxSonarRangeCms, qCeil(closest / pixelsInCm)) : maxSonarRangeCms;
+	Tracer::debug(tracer::enums::d2Model, "WorldModel::sonarReading"
+			, "Sonar sensor. Reading: " + QString::number(reading));
+	return reading;
+}
 
-	robotPath.moveTo(mTouchSensorPositionOld[port]);
-	robotPath.lineTo(position);
+bool WorldModel::touchSensorReading(QPointF const &position, qreal direction, robots::enums::inputPort::InputPortEnum const port)
+{
+	Q_UNUSED(direction)
 
+	QLineF const sensorMove(mTouchSensorPositionOld[port], position);
 	mTouchSensorPositionOld[port] = position;
 
-	QPainterPath wallPath = buildWallPath();
-	return wallPath.intersects(robotPath);
+	foreach (int const index, wallsIndicesNear(QRectF(sensorMove.p1(), sensorMove.p2()).normalized())) {
+		if (mWallSegments[index].line.intersect(sensorMove, nullptr) == QLineF::BoundedIntersection) {
+			return true;
+		}
+	}
+
+	return false;
 }
 
 QPainterPath WorldModel::sonarScanningRegion(QPointF const &position, int range) const
@@ -84,14 +182,17 @@ QPainterPath WorldModel::sonarScanningRegion(QPointF const &position, qreal dire
 
 bool WorldModel::checkCollision(QPainterPath const &robotPath, int stroke) const
 {
-	QPainterPathStroker wallPathStroker;
-	wallPathStroker.setWidth(stroke);
-	QPainterPath const wallPath = buildWallPath();
-	QPainterPath const wallStrokedPath = stroke
-			? wallPathStroker.createStroke(wallPath)
-			: wallPath;
+	// Walls near the bounding rect of the robot are found by the grid, then checked exactly.
+	qreal const maxDistance = stroke / 2.0;
+	QPolygonF const polygon = robotPath.toFillPolygon();
+	QRectF const rect = polygon.boundingRect().adjusted(-maxDistance, -maxDistance, maxDistance, maxDistance);
+	foreach (int const index, wallsIndicesNear(rect)) {
+		if (isNear(mWallSegments[index].line, polygon, maxDistance)) {
+			return true;
+		}
+	}
 
-	return wallStrokedPath.intersects(robotPath);
+	return false;
 }
 
 QList<WallItem *> const &WorldModel::walls() const
@@ -102,11 +203,23 @@ QList<WallItem *> const &WorldModel::walls() const
 void WorldModel::addWall(WallItem* wall)
 {
 	mWalls.append(wall);
+	invalidateCaches();
 }
 
 void WorldModel::removeWall(WallItem* wall)
 {
 	mWalls.removeOne(wall);
+	invalidateCaches();
+}
+
+QList<WallItem *> WorldModel::wallsNear(QRectF const &rect) const
+{
+	QList<WallItem *> result;
+	foreach (int const index, wallsIndicesNear(rect)) {
+		result << mWallSegments[index].wall;
+	}
+
+	return result;
 }
 
 QList<ColorFieldItem *> const &WorldModel::colorFields() const
@@ -114,6 +227,112 @@ QList<ColorFieldItem *> const &WorldModel::colorFields() const
 	return mColorFields;
 }
 
+QVector<uint> WorldModel::floorColors(QRect const &rect) const
+{
+	QVector<uint> result;
+	result.reserve(rect.width() * rect.height());
+	for (int y = rect.top(); y <= rect.bottom(); ++y) {
+		int const tileY = qFloor(static_cast<qreal>(y) / floorTileSize);
+		int const row = y - tileY * floorTileSize;
+		for (int x = rect.left(); x <= rect.right(); ++x) {
+			int const tileX = qFloor(static_cast<qreal>(x) / floorTileSize);
+			QImage const &tile = floorTile(qMakePair(tileX, tileY));
+			result << reinterpret_cast<uint const *>(tile.constScanLine(row))[x - tileX * floorTileSize];
+		}
+	}
+
+	return result;
+}
+
+void WorldModel::invalidateCaches()
+{
+	mFloorTiles.clear();
+	mWallsIndexIsValid = false;
+}
+
+void WorldModel::updateWallsIndex() const
+{
+	if (mWallsIndexIsValid) {
+		return;
+	}
+
+	mWallSegments.clear();
+	mWallCells.clear();
+	foreach (WallItem * const wall, mWalls) {
+		qreal const halfWidth = wall->width() / 2.0;
+		WallSegment const segment = {
+			QLineF(wall->begin(), wall->end())
+			, QRectF(wall->begin(), wall->end()).normalized().adjusted(-halfWidth, -halfWidth, halfWidth, halfWidth)
+			, wall
+		};
+
+		int const index = mWallSegments.size();
+		mWallSegments << segment;
+		for (int x = qFloor(segment.bounds.left() / wallCellSize); x * wallCellSize <= segment.bounds.right(); ++x) {
+			for (int y = qFloor(segment.bounds.top() / wallCellSize); y * wallCellSize <= segment.bounds.bottom(); ++y) {
+				mWallCells[qMakePair(x, y)] << index;
+			}
+		}
+	}
+
+	mWallsIndexIsValid = true;
+}
+
+QVector<int> WorldModel::wallsIndicesNear(QRectF const &rect) const
+{
+	updateWallsIndex();
+
+	QVector<int> result;
+	for (int x = qFloor(rect.left() / wallCellSize); x * wallCellSize <= rect.right(); ++x) {
+		for (int y = qFloor(rect.top() / wallCellSize); y * wallCellSize <= rect.bottom(); ++y) {
+			foreach (int const index, mWallCells.value(qMakePair(x, y))) {
+				if (mWallSegments[index].bounds.intersects(rect)) {
+					result << index;
+				}
+			}
+		}
+	}
+
+	// A wall crossing several cells is met once in each of them.
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+QImage const &WorldModel::floorTile(QPair<int, int> const &tile) const
+{
+	auto const cached = mFloorTiles.constFind(tile);
+	if (cached != mFloorTiles.constEnd()) {
+		return cached.value();
+	}
+
+	QRectF const rect(tile.first * floorTileSize, tile.second * floorTileSize, floorTileSize, floorTileSize);
+	QImage image(floorTileSize, floorTileSize, QImage::Format_RGB32);
+	image.fill(Qt::white);
+
+	// Items are painted the way the scene renders them, color fields below walls.
+	QPainter painter(&image);
+	QTransform const toImage = QTransform::fromTranslate(-rect.left(), -rect.top());
+	QStyleOptionGraphicsItem const option;
+	auto print = [&](QGraphicsItem * const item) {
+		if (item->sceneBoundingRect().intersects(rect)) {
+			painter.setTransform(item->sceneTransform() * toImage);
+			item->paint(&painter, &option, nullptr);
+		}
+	};
+
+	foreach (ColorFieldItem * const colorField, mColorFields) {
+		print(colorField);
+	}
+
+	foreach (WallItem * const wall, mWalls) {
+		print(wall);
+	}
+
+	painter.end();
+	return mFloorTiles.insert(tile, image).value();
+}
+
 int WorldModel::wallsCount() const
 {
 	return mWalls.count();
@@ -127,30 +346,20 @@ WallItem *WorldModel::wallAt(int index) const
 void WorldModel::addColorField(ColorFieldItem *colorField)
 {
 	mColorFields.append(colorField);
+	invalidateCaches();
 }
 
 void WorldModel::removeColorField(ColorFieldItem *colorField)
 {
 	mColorFields.removeOne(colorField);
+	invalidateCaches();
 }
 
 void WorldModel::clearScene()
 {
 	mWalls.clear();
 	mColorFields.clear();
-}
-
-QPainterPath WorldModel::buildWallPath() const
-{
-	// TODO: Maintain a cache for this.
-	QPainterPath wallPath;
-
-	foreach (WallItem* wall, mWalls) {
-		wallPath.moveTo(wall->begin());
-		wallPath.lineTo(wall->end());
-	}
-
-	return wallPath;
+	invalidateCaches();
 }
 
 QDomElement WorldModel::serialize(QDomDocument &document, QPointF const &topLeftPicture) const
@@ -3,6 +3,10 @@
 #include <QtCore/QPoint>
 #include <QtCore/QList>
 #include <QtCore/QPair>
+#include <QtCore/QHash>
+#include <QtCore/QLineF>
+#include <QtCore/QVector>
+#include <QtGui/QImage>
 #include <QtGui/QPainterPath>
 #include <QtGui/QPolygon>
 #include <QtXml/QDomDocument>
@@ -25,14 +29,31 @@ class WorldModel
 {
 public:
 	WorldModel();
+
+	/// Returns the distance in cm to the closest wall in the sector of sonar, 255 if there are none.
 	int sonarReading(QPointF const &position, qreal direction) const;
 	bool touchSensorReading(QPointF const &position, qreal direction, robots::enums::inputPort::InputPortEnum const port);
 	QPainterPath sonarScanningRegion(QPointF const &position, qreal direction, int range = 255) const;
 	QPainterPath sonarScanningRegion(QPointF const &position, int range = 255) const;
+
+	/// Returns true if given polygon comes closer than stroke / 2 to some wall.
 	bool checkCollision(QPainterPath const &robotPath, int stroke = 3) const;
+
 	QList<WallItem *> const &walls() const;
+
+	/// Returns walls which may intersect given rect with their width taken into account.
+	QList<WallItem *> wallsNear(QRectF const &rect) const;
+
 	QList<ColorFieldItem *> const &colorFields() const;
 
+	/// Returns colors of the floor as seen from above in given rect of scene pixels, row by row.
+	/// The floor is rasterized once into tiles, so a read does not touch the scene.
+	QVector<uint> floorColors(QRect const &rect) const;
+
+	/// Drops rasterized floor and index of walls. Must be called when walls or color fields are moved
+	/// or changed in place, adding and removing them invalidates caches automatically.
+	void invalidateCaches();
+
 	int wallsCount() const;
 	WallItem *wallAt(int index) const;
 	void addWall(WallItem* wall);
@@ -47,15 +68,36 @@ public:
 	void deserialize(QDomElement const &element);
 
 private:
-	bool checkSonarDistance(int const distance, QPointF const &position
-			, qreal const direction, QPainterPath const &wallPath) const;
+	/// Center line of a wall cached in the index with a rect containing the whole wall.
+	struct WallSegment
+	{
+		QLineF line;
+		QRectF bounds;
+		WallItem *wall;
+	};
 
 	QList<WallItem *> mWalls;
 	QList<ColorFieldItem *> mColorFields;
 	QMap<robots::enums::inputPort::InputPortEnum, QPointF> mTouchSensorPositionOld;
 	QMap<robots::enums::inputPort::InputPortEnum, qreal> mTouchSensorDirectionOld;
 
-	QPainterPath buildWallPath() const;
+	/// Rebuilds segments of walls and the grid over them if walls have changed since the last query.
+	void updateWallsIndex() const;
+
+	/// Returns indices of wall segments whose bounds intersect given rect, each one once.
+	QVector<int> wallsIndicesNear(QRectF const &rect) const;
+
+	/// Returns the tile of the floor with given coordinates in tiles, rasterizing it if needed.
+	QImage const &floorTile(QPair<int, int> const &tile) const;
+
+	/// Floor tiles rasterized so far, by their coordinates in tiles.
+	mutable QHash<QPair<int, int>, QImage> mFloorTiles;
+
+	mutable bool mWallsIndexIsValid;
+	mutable QVector<WallSegment> mWallSegments;
+
+	/// Indices of wall segments whose bounds intersect a cell of the grid, by coordinates of the cell.
+	mutable QHash<QPair<int, int>, QVector<int> > mWallCells;
 };
 
 }
@@ -0,0 +1,174 @@
+#include "headlessInterpretersInterface.h"
+
+using namespace qReal;
+using namespace interpreters::robots::details;
+
+HeadlessInterpretersInterface::HeadlessInterpretersInterface(Id const &diagram, QStringList &errors)
+	: mDiagram(diagram)
+	, mErrors(errors)
+{
+}
+
+void HeadlessInterpretersInterface::selectItem(Id const &graphicalId)
+{
+	Q_UNUSED(graphicalId)
+}
+
+void HeadlessInterpretersInterface::selectItemOrDiagram(Id const &graphicalId)
+{
+	Q_UNUSED(graphicalId)
+}
+
+void HeadlessInterpretersInterface::highlight(Id const &graphicalId, bool exclusive, QColor const &color)
+{
+	Q_UNUSED(graphicalId)
+	Q_UNUSED(exclusive)
+	Q_UNUSED(color)
+}
+
+void HeadlessInterpretersInterface::dehighlight(Id const &graphicalId)
+{
+	Q_UNUSED(graphicalId)
+}
+
+void HeadlessInterpretersInterface::dehighlight()
+{
+}
+
+ErrorReporterInterface *HeadlessInterpretersInterface::errorReporter()
+{
+	return this;
+}
+
+Id HeadlessInterpretersInterface::activeDiagram()
+{
+	return mDiagram;
+}
+
+void HeadlessInterpretersInterface::openSettingsDialog(QString const &tab)
+{
+	Q_UNUSED(tab)
+}
+
+void HeadlessInterpretersInterface::reinitModels()
+{
+}
+
+QWidget *HeadlessInterpretersInterface::windowWidget()
+{
+	return nullptr;
+}
+
+bool HeadlessInterpretersInterface::unloadPlugin(QString const &pluginName)
+{
+	Q_UNUSED(pluginName)
+	return false;
+}
+
+bool HeadlessInterpretersInterface::loadPlugin(QString const &fileName, QString const &pluginName)
+{
+	Q_UNUSED(fileName)
+	Q_UNUSED(pluginName)
+	return false;
+}
+
+bool HeadlessInterpretersInterface::pluginLoaded(QString const &pluginName)
+{
+	Q_UNUSED(pluginName)
+	return false;
+}
+
+void HeadlessInterpretersInterface::saveDiagramAsAPictureToFile(QString const &fileName)
+{
+	Q_UNUSED(fileName)
+}
+
+void HeadlessInterpretersInterface::arrangeElementsByDotRunner(QString const &algorithm
+		, QString const &absolutePathToDotFiles)
+{
+	Q_UNUSED(algorithm)
+	Q_UNUSED(absolutePathToDotFiles)
+}
+
+void HeadlessInterpretersInterface::arrangeElements(QString const &algorithm)
+{
+	Q_UNUSED(algorithm)
+}
+
+IdList HeadlessInterpretersInterface::selectedElementsOnActiveDiagram()
+{
+	return IdList();
+}
+
+void HeadlessInterpretersInterface::activateItemOrDiagram(Id const &id, bool setSelected)
+{
+	Q_UNUSED(id)
+	Q_UNUSED(setSelected)
+}
+
+void HeadlessInterpretersInterface::updateActiveDiagram()
+{
+}
+
+void HeadlessInterpretersInterface::deleteElementFromDiagram(Id const &id)
+{
+	Q_UNUSED(id)
+}
+
+void HeadlessInterpretersInterface::reportOperation(invocation::LongOperation *operation)
+{
+	Q_UNUSED(operation)
+}
+
+QWidget *HeadlessInterpretersInterface::currentTab()
+{
+	return nullptr;
+}
+
+void HeadlessInterpretersInterface::openTab(QWidget *tab, QString const &title)
+{
+	Q_UNUSED(tab)
+	Q_UNUSED(title)
+}
+
+void HeadlessInterpretersInterface::closeTab(QWidget *tab)
+{
+	Q_UNUSED(tab)
+}
+
+void HeadlessInterpretersInterface::addInformation(QString const &message, Id const &position)
+{
+	Q_UNUSED(message)
+	Q_UNUSED(position)
+}
+
+void HeadlessInterpretersInterface::addWarning(QString const &message, Id const &position)
+{
+	Q_UNUSED(message)
+	Q_UNUSED(position)
+}
+
+void HeadlessInterpretersInterface::addError(QString const &message, Id const &position)
+{
+	Q_UNUSED(position)
+	mErrors << message;
+}
+
+void HeadlessInterpretersInterface::addCritical(QString const &message, Id const &position)
+{
+	Q_UNUSED(position)
+	mErrors << message;
+}
+
+void HeadlessInterpretersInterface::clear()
+{
+}
+
+void HeadlessInterpretersInterface::clearErrors()
+{
+}
+
+bool HeadlessInterpretersInterface::wereErrors()
+{
+	return !mErrors.isEmpty();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QtCore/QStringList>
+
+#include <qrgui/mainwindow/mainWindowInterpretersInterface.h>
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+
+/// Main window for threads of a run without windows: there is nothing to highlight, errors are collected.
+class HeadlessInterpretersInterface : public gui::MainWindowInterpretersInterface, public ErrorReporterInterface
+{
+public:
+	/// @param diagram - the diagram reported as active one.
+	/// @param errors - list errors and critical errors are appended to, not owned.
+	HeadlessInterpretersInterface(Id const &diagram, QStringList &errors);
+
+	void selectItem(Id const &graphicalId) override;
+	void selectItemOrDiagram(Id const &graphicalId) override;
+	void highlight(Id const &graphicalId, bool exclusive, QColor const &color) override;
+	void dehighlight(Id const &graphicalId) override;
+	void dehighlight() override;
+	ErrorReporterInterface *errorReporter() override;
+	Id activeDiagram() override;
+	void openSettingsDialog(QString const &tab) override;
+	void reinitModels() override;
+	QWidget *windowWidget() override;
+	bool unloadPlugin(QString const &pluginName) override;
+	bool loadPlugin(QString const &fileName, QString const &pluginName) override;
+	bool pluginLoaded(QString const &pluginName) override;
+	void saveDiagramAsAPictureToFile(QString const &fileName) override;
+	void arrangeElementsByDotRunner(QString const &algorithm, QString const &absolutePathToDotFiles) override;
+	void arrangeElements(QString const &algorithm) override;
+	IdList selectedElementsOnActiveDiagram() override;
+	void activateItemOrDiagram(Id const &id, bool setSelected) override;
+	void updateActiveDiagram() override;
+	void deleteElementFromDiagram(Id const &id) override;
+	void reportOperation(invocation::LongOperation *operation) override;
+	QWidget *currentTab() override;
+	void openTab(QWidget *tab, QString const &title) override;
+	void closeTab(QWidget *tab) override;
+	void addInformation(QString const &message, Id const &position) override;
+	void addWarning(QString const &message, Id const &position) override;
+	void addError(QString const &message, Id const &position) override;
+	void addCritical(QString const &message, Id const &position) override;
+	void clear() override;
+	void clearErrors() override;
+	bool wereErrors() override;
+
+private:
+	Id const mDiagram;
+	QStringList &mErrors;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,271 @@
+#include "headlessRunner.h"
+
+#include <QtCore/QEventLoop>
+
+#include <qrkernel/settingsManager.h>
+
+#include "details/autoconfigurer.h"
+#include "details/blocksTable.h"
+#include "details/headlessInterpretersInterface.h"
+#include "details/interpretationDriver.h"
+#include "details/robotsBlockParser.h"
+#include "details/traceRecorder.h"
+#include "details/robotParts/robotModel.h"
+#include "details/robotImplementations/unrealRobotModelImplementation.h"
+
+using namespace qReal;
+using namespace interpreters::robots;
+using namespace interpreters::robots::details;
+
+quint32 const defaultNoiseSeed = 1;
+
+HeadlessRunResult::HeadlessRunResult()
+	: finished(false)
+	, time(0)
+	, direction(0)
+	, collisions(0)
+{
+}
+
+HeadlessRunner::HeadlessRunner(GraphicalModelAssistInterface const &graphicalModelApi
+		, LogicalModelAssistInterface &logicalModelApi)
+	: mGraphicalModelApi(graphicalModelApi)
+	, mLogicalModelApi(logicalModelApi)
+	, mState(idle)
+	, mTimeLimit(0)
+	, mStartTimestamp(0)
+	, mHasStartPose(false)
+	, mStartDirection(0)
+	, mNoiseSeed(defaultNoiseSeed)
+	, mIsRecording(false)
+	, mInterpretersInterface(nullptr)
+	, mRobotModel(nullptr)
+	, mD2RobotModel(nullptr)
+	, mParser(nullptr)
+	, mBlocksTable(nullptr)
+	, mSensorsTimer(nullptr)
+	, mDriver(nullptr)
+	, mTraceRecorder(nullptr)
+{
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+}
+
+void HeadlessRunner::setStartPose(QPointF const &position, qreal direction)
+{
+	mHasStartPose = true;
+	mStartPosition = position;
+	mStartDirection = direction;
+}
+
+void HeadlessRunner::resetStartPose()
+{
+	mHasStartPose = false;
+}
+
+void HeadlessRunner::setNoiseSeed(quint32 seed)
+{
+	mNoiseSeed = seed;
+}
+
+void HeadlessRunner::setRecording(bool isRecording)
+{
+	mIsRecording = isRecording;
+}
+
+HeadlessRunResult HeadlessRunner::run(Id const &diagram, QDomDocument const &world, quint64 timeLimit)
+{
+	mDiagram = diagram;
+	mTimeLimit = timeLimit;
+	mStartTimestamp = 0;
+	mResult = HeadlessRunResult();
+
+	Id const logicalId = mGraphicalModelApi.logicalId(diagram);
+	QList<QVariant> const oldSensors = loadSensorConfiguration(logicalId);
+
+	mD2RobotModel = new d2Model::D2RobotModel();
+	mD2RobotModel->timeline()->setImmediateMode(true);
+	mD2RobotModel->setNoiseSettings();
+	mD2RobotModel->setNoiseSeed(mNoiseSeed);
+	if (world.isNull()) {
+		QDomDocument diagramWorld;
+		diagramWorld.setContent(mLogicalModelApi.propertyByRoleName(logicalId, "worldModel").toString());
+		mD2RobotModel->loadWorld(diagramWorld);
+	} else {
+		mD2RobotModel->loadWorld(world);
+	}
+
+	if (mHasStartPose) {
+		mD2RobotModel->setRobotPos(mStartPosition);
+		mD2RobotModel->setRotation(mStartDirection);
+	}
+
+	HeadlessInterpretersInterface interpretersInterface(diagram, mResult.errors);
+	mInterpretersInterface = &interpretersInterface;
+	mRobotModel = new RobotModel();
+	mRobotModel->setRobotImplementation(new robotImplementations::UnrealRobotModelImplementation(mD2RobotModel));
+	mParser = new RobotsBlockParser(&interpretersInterface, [this] () {
+		return mState == interpreting ? time() : 0;
+	});
+
+	// Readings are recorded, so polling of sensors is not, as with the polling timer of the interpreter.
+	mSensorsTimer = mRobotModel->timeline()->produceTimer();
+	if (mIsRecording) {
+		mTraceRecorder = new TraceRecorder();
+		mTraceRecorder->prepare(*mRobotModel);
+	}
+
+	mBlocksTable = new BlocksTable(mGraphicalModelApi, mLogicalModelApi, mRobotModel, &interpretersInterface, mParser);
+	mDriver = new InterpretationDriver(mGraphicalModelApi, interpretersInterface, *mRobotModel, *mBlocksTable, *mParser);
+	mDriver->setPollingTimer(mSensorsTimer);
+	if (mTraceRecorder) {
+		connect(mDriver, SIGNAL(blockStarted(Id const &)), mTraceRecorder, SLOT(blockStarted(Id const &)));
+	}
+
+	connect(mRobotModel, SIGNAL(sensorsConfigured()), this, SLOT(sensorsConfiguredSlot()));
+	connect(mDriver, SIGNAL(finished()), this, SLOT(onProgramFinished()));
+	connect(mDriver, SIGNAL(threadsLimitExceeded()), this, SLOT(onThreadsLimitExceeded()));
+	connect(mD2RobotModel->timeline(), SIGNAL(tick()), this, SLOT(onTick()));
+	connect(mD2RobotModel->timeline(), SIGNAL(nextFrame()), this, SLOT(onFrame()));
+
+	// The model connects after a delay by its own clock, so the loop is already running when it happens.
+	QEventLoop loop;
+	connect(this, SIGNAL(stopped()), &loop, SLOT(quit()));
+	mState = connecting;
+	mRobotModel->init();
+	loop.exec();
+
+	mResult.position = mD2RobotModel->robotPos();
+	mResult.direction = mD2RobotModel->rotateAngle();
+	mResult.collisions = mD2RobotModel->collisionsCount();
+
+	if (mTraceRecorder) {
+		mResult.interpreterTrace = mTraceRecorder->trace();
+	}
+
+	delete mDriver;
+	delete mSensorsTimer;
+	delete mBlocksTable;
+	delete mParser;
+	// Deletes the implementation and 2D model with it.
+	delete mRobotModel;
+	delete mTraceRecorder;
+	mDriver = nullptr;
+	mSensorsTimer = nullptr;
+	mBlocksTable = nullptr;
+	mParser = nullptr;
+	mRobotModel = nullptr;
+	mTraceRecorder = nullptr;
+	mD2RobotModel = nullptr;
+	mInterpretersInterface = nullptr;
+
+	restoreSensorConfiguration(oldSensors);
+	return mResult;
+}
+
+QList<QVariant> HeadlessRunner::loadSensorConfiguration(Id const &logicalId)
+{
+	// Autoconfigurer takes sensors from settings, the same as they are set for an opened diagram. Settings are
+	// shared with the rest of QReal, so they are changed for the time of the run only.
+	QList<QVariant> oldSensors;
+	for (int port = 1; port <= 4; ++port) {
+		QString const key = QString("port%1SensorType").arg(port);
+		oldSensors << SettingsManager::value(key);
+		int const sensor = mLogicalModelApi.propertyByRoleName(logicalId, QString("sensor%1Value").arg(port)).toInt();
+		SettingsManager::setValue(key, sensor);
+	}
+
+	return oldSensors;
+}
+
+void HeadlessRunner::restoreSensorConfiguration(QList<QVariant> const &sensors)
+{
+	for (int port = 1; port <= 4; ++port) {
+		SettingsManager::setValue(QString("port%1SensorType").arg(port), sensors[port - 1]);
+	}
+}
+
+void HeadlessRunner::sensorsConfiguredSlot()
+{
+	if (mState == connecting) {
+		// The model has connected, now sensors are configured for the program.
+		mState = waitingForSensorsConfiguredToLaunch;
+		mBlocksTable->setIdleForBlocks();
+		Autoconfigurer configurer(mGraphicalModelApi, mBlocksTable, mInterpretersInterface, mRobotModel);
+		if (!configurer.configure(mDiagram)) {
+			stop(false);
+		}
+	} else if (mState == waitingForSensorsConfiguredToLaunch) {
+		startInterpretation();
+	}
+}
+
+void HeadlessRunner::startInterpretation()
+{
+	mState = interpreting;
+	mStartTimestamp = mRobotModel->timeline()->timestamp();
+	if (mTraceRecorder) {
+		mTraceRecorder->start(mDiagram);
+	}
+
+	mDriver->resetSensorVariables();
+	mRobotModel->nextBlockAfterInitial(true);
+	mDriver->listenSensors();
+	mRobotModel->nullifySensors();
+	mRobotModel->startInterpretation();
+	mDriver->start(mDiagram);
+}
+
+void HeadlessRunner::onProgramFinished()
+{
+	if (mState == interpreting) {
+		stop(true);
+	}
+}
+
+void HeadlessRunner::onThreadsLimitExceeded()
+{
+	stop(false);
+}
+
+void HeadlessRunner::onTick()
+{
+	// Time is counted from the start of the model until the program starts, so connection can not hang.
+	if (mState != idle && time() >= mTimeLimit) {
+		stop(false);
+	}
+}
+
+void HeadlessRunner::onFrame()
+{
+	if (mState != interpreting) {
+		return;
+	}
+
+	TracePoint const point = { time(), mD2RobotModel->robotPos(), mD2RobotModel->rotateAngle() };
+	mResult.trace << point;
+}
+
+void HeadlessRunner::stop(bool finished)
+{
+	mResult.finished = finished;
+	mResult.time = mState == interpreting ? time() : 0;
+	mState = idle;
+
+	if (mTraceRecorder) {
+		mTraceRecorder->stop(finished);
+	}
+
+	mDriver->stop();
+	mRobotModel->stopRobot();
+	mBlocksTable->setFailure();
+	mD2RobotModel->timeline()->stop();
+	emit stopped();
+}
+
+quint64 HeadlessRunner::time() const
+{
+	return mRobotModel->timeline()->timestamp() - mStartTimestamp;
+}
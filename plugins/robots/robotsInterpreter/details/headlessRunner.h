@@ -0,0 +1,165 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QList>
+#include <QtCore/QPointF>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+#include <QtXml/QDomDocument>
+
+#include <qrkernel/ids.h>
+#include <qrgui/toolPluginInterface/usedInterfaces/graphicalModelAssistInterface.h>
+#include <qrgui/toolPluginInterface/usedInterfaces/logicalModelAssistInterface.h>
+
+#include "interpreterTrace.h"
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+
+class RobotModel;
+class BlocksTable;
+class RobotsBlockParser;
+class AbstractTimer;
+class HeadlessInterpretersInterface;
+class InterpretationDriver;
+class TraceRecorder;
+
+namespace d2Model {
+class D2RobotModel;
+}
+
+/// Position and direction of the robot at some moment of a run.
+struct TracePoint
+{
+	/// Time in ms passed since the start of the program by the clock of 2D model.
+	quint64 time;
+	QPointF position;
+	qreal direction;
+};
+
+/// Outcome of interpretation of a program on 2D model.
+struct HeadlessRunResult
+{
+	HeadlessRunResult();
+
+	/// True if the program stopped by itself before the time limit.
+	bool finished;
+
+	/// Time in ms the program was running by the clock of 2D model.
+	quint64 time;
+
+	/// Final position of the robot.
+	QPointF position;
+
+	/// Final direction of the robot.
+	qreal direction;
+
+	/// How many times the robot has run into walls.
+	int collisions;
+
+	/// Position and direction of the robot on every frame of 2D model.
+	QList<TracePoint> trace;
+
+	/// Readings, timeouts and passed blocks of the run for ReplayRunner, empty unless recording is on.
+	InterpreterTrace interpreterTrace;
+
+	/// Errors reported by the interpreter.
+	QStringList errors;
+};
+
+/// Interprets robot programs on 2D model without any windows. The clock of 2D model does not wait for real time,
+/// so a program runs as fast as the processor allows. Painting of color and light sensors needs QApplication,
+/// but nothing is shown, so on machines without display it may run with "-platform offscreen".
+class HeadlessRunner : public QObject
+{
+	Q_OBJECT
+
+public:
+	HeadlessRunner(GraphicalModelAssistInterface const &graphicalModelApi
+			, LogicalModelAssistInterface &logicalModelApi);
+
+	~HeadlessRunner();
+
+	/// Places the robot to given position and direction before following runs instead of the pose saved
+	/// in the world. Sensors keep their places on the robot.
+	void setStartPose(QPointF const &position, qreal direction);
+
+	/// Makes following runs start from the pose saved in the world.
+	void resetStartPose();
+
+	/// Seeds noise of sensors and motors before following runs, so a run with noise can be repeated exactly.
+	/// Runs are seeded with the same number by default.
+	void setNoiseSeed(quint32 seed);
+
+	/// Turns on or off recording of following runs into InterpreterTrace, as the interpreter does
+	/// with --record-trace. Runs are not recorded by default.
+	void setRecording(bool isRecording);
+
+	/// Interprets given diagram till it finishes or the time limit expires, running an event loop meanwhile.
+	/// Sensors are configured by properties of the diagram, as the interpreter does when its tab is opened.
+	/// @param diagram - graphical id of a diagram to interpret.
+	/// @param world - 2D model world and robot in the format of "worldModel" property of a diagram.
+	/// If it is empty, the world of the diagram is used.
+	/// @param timeLimit - time in ms by the clock of 2D model after which the program is stopped.
+	HeadlessRunResult run(Id const &diagram, QDomDocument const &world = QDomDocument(), quint64 timeLimit = 60000);
+
+signals:
+	/// Emitted when the run is over.
+	void stopped();
+
+private slots:
+	void sensorsConfiguredSlot();
+	void onProgramFinished();
+	void onThreadsLimitExceeded();
+	void onTick();
+	void onFrame();
+
+private:
+	enum State {
+		idle
+		, connecting
+		, waitingForSensorsConfiguredToLaunch
+		, interpreting
+	};
+
+	/// Sets sensors of given diagram to settings.
+	/// @returns previous values of the settings.
+	QList<QVariant> loadSensorConfiguration(Id const &logicalId);
+	void restoreSensorConfiguration(QList<QVariant> const &sensors);
+	void startInterpretation();
+	void stop(bool finished);
+	quint64 time() const;
+
+	GraphicalModelAssistInterface const &mGraphicalModelApi;
+	LogicalModelAssistInterface &mLogicalModelApi;
+
+	State mState;
+	Id mDiagram;
+	quint64 mTimeLimit;
+	quint64 mStartTimestamp;
+	HeadlessRunResult mResult;
+
+	bool mHasStartPose;
+	QPointF mStartPosition;
+	qreal mStartDirection;
+
+	quint32 mNoiseSeed;
+	bool mIsRecording;
+
+	/// Objects below live during a run only.
+	HeadlessInterpretersInterface *mInterpretersInterface;
+	RobotModel *mRobotModel;
+	d2Model::D2RobotModel *mD2RobotModel;  // Doesn't have ownership
+	RobotsBlockParser *mParser;
+	BlocksTable *mBlocksTable;
+	AbstractTimer *mSensorsTimer;
+	InterpretationDriver *mDriver;
+	TraceRecorder *mTraceRecorder;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,177 @@
+#include "interpretationDriver.h"
+
+#include "details/abstractTimer.h"
+#include "details/blocksTable.h"
+#include "details/robotsBlockParser.h"
+#include "details/thread.h"
+#include "details/tracer.h"
+#include "details/robotParts/robotModel.h"
+
+using namespace qReal;
+using namespace interpreters::robots;
+using namespace interpreters::robots::details;
+
+int const maxThreadsCount = 100;
+int const sensorsPollingInterval = 25;
+
+InterpretationDriver::InterpretationDriver(GraphicalModelAssistInterface const &graphicalModelApi
+		, gui::MainWindowInterpretersInterface &interpretersInterface
+		, RobotModel &robotModel
+		, BlocksTable &blocksTable
+		, RobotsBlockParser &parser)
+	: mGraphicalModelApi(graphicalModelApi)
+	, mInterpretersInterface(interpretersInterface)
+	, mRobotModel(robotModel)
+	, mBlocksTable(blocksTable)
+	, mParser(parser)
+	, mPollingTimer(nullptr)
+	, mRunning(false)
+{
+}
+
+InterpretationDriver::~InterpretationDriver()
+{
+	qDeleteAll(mThreads);
+}
+
+void InterpretationDriver::setPollingTimer(AbstractTimer *timer)
+{
+	if (mPollingTimer) {
+		disconnect(mPollingTimer, SIGNAL(timeout()), this, SLOT(readSensorValues()));
+	}
+
+	mPollingTimer = timer;
+	if (mPollingTimer) {
+		connect(mPollingTimer, SIGNAL(timeout()), this, SLOT(readSensorValues()));
+	}
+}
+
+bool InterpretationDriver::isRunning() const
+{
+	return mRunning;
+}
+
+void InterpretationDriver::listenSensors()
+{
+	mSensorVariables.clear();
+	for (int port = 0; port < 4; ++port) {
+		robotParts::Sensor * const sensor
+				= mRobotModel.sensor(static_cast<robots::enums::inputPort::InputPortEnum>(port));
+		if (sensor) {
+			mSensorVariables[sensor->sensorImpl()] = QString("Sensor%1").arg(port + 1);
+		}
+	}
+
+	mSensorVariables[mRobotModel.encoderA().encoderImpl()] = "EncoderA";
+	mSensorVariables[mRobotModel.encoderB().encoderImpl()] = "EncoderB";
+	mSensorVariables[mRobotModel.encoderC().encoderImpl()] = "EncoderC";
+	foreach (QObject * const sensorImpl, mSensorVariables.keys()) {
+		connect(sensorImpl, SIGNAL(response(int)), this, SLOT(sensorResponse(int)), Qt::UniqueConnection);
+		connect(sensorImpl, SIGNAL(failure()), this, SLOT(sensorFailure()), Qt::UniqueConnection);
+	}
+}
+
+void InterpretationDriver::resetSensorVariables()
+{
+	for (int port = 1; port <= 4; ++port) {
+		mParser.variables()[QString("Sensor%1").arg(port)]->setValue(0);
+	}
+}
+
+void InterpretationDriver::start(Id const &diagram)
+{
+	mRunning = true;
+	if (mPollingTimer) {
+		readSensorValues();
+	}
+
+	addThread(new Thread(&mGraphicalModelApi, mInterpretersInterface, diagram, mBlocksTable));
+}
+
+void InterpretationDriver::stop()
+{
+	mRunning = false;
+	if (mPollingTimer) {
+		mPollingTimer->stop();
+	}
+
+	qDeleteAll(mThreads);
+	mThreads.clear();
+}
+
+void InterpretationDriver::readSensorValues()
+{
+	if (!mRunning) {
+		return;
+	}
+
+	for (int port = 0; port < 4; ++port) {
+		robotParts::Sensor * const sensor
+				= mRobotModel.sensor(static_cast<robots::enums::inputPort::InputPortEnum>(port));
+		if (sensor) {
+			sensor->read();
+		}
+	}
+
+	mRobotModel.encoderA().read();
+	mRobotModel.encoderB().read();
+	mRobotModel.encoderC().read();
+	if (mPollingTimer) {
+		mPollingTimer->start(sensorsPollingInterval);
+	}
+}
+
+void InterpretationDriver::sensorResponse(int reading)
+{
+	QString const variable = mSensorVariables.value(sender());
+	if (variable.isEmpty()) {
+		return;
+	}
+
+	mParser.variables()[variable]->setValue(reading);
+	Tracer::debug(tracer::enums::autoupdatedSensorValues, "InterpretationDriver::sensorResponse"
+			, variable + QString::number(reading));
+}
+
+void InterpretationDriver::sensorFailure()
+{
+	Tracer::debug(tracer::enums::autoupdatedSensorValues, "InterpretationDriver::sensorFailure", "");
+}
+
+void InterpretationDriver::addThread(Thread * const thread)
+{
+	if (mThreads.count() >= maxThreadsCount) {
+		mInterpretersInterface.errorReporter()->addError(tr("Threads limit exceeded. Maximum threads count is %1")
+				.arg(maxThreadsCount));
+		delete thread;
+		emit threadsLimitExceeded();
+		return;
+	}
+
+	mThreads.append(thread);
+	connect(thread, SIGNAL(stopped()), this, SLOT(threadStopped()));
+	connect(thread, SIGNAL(newThread(details::blocks::Block*const)), this, SLOT(newThread(details::blocks::Block*const)));
+	connect(thread, SIGNAL(blockStarted(Id const &)), this, SIGNAL(blockStarted(Id const &)));
+	thread->interpret();
+}
+
+void InterpretationDriver::threadStopped()
+{
+	Thread * const thread = static_cast<Thread *>(sender());
+	mThreads.removeAll(thread);
+	delete thread;
+
+	if (mThreads.isEmpty() && mRunning) {
+		mRunning = false;
+		if (mPollingTimer) {
+			mPollingTimer->stop();
+		}
+
+		emit finished();
+	}
+}
+
+void InterpretationDriver::newThread(details::blocks::Block * const startBlock)
+{
+	addThread(new Thread(&mGraphicalModelApi, mInterpretersInterface, mBlocksTable, startBlock->id()));
+}
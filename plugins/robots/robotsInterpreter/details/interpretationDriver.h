@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+
+#include <qrkernel/ids.h>
+#include <qrgui/mainwindow/mainWindowInterpretersInterface.h>
+#include <qrgui/toolPluginInterface/usedInterfaces/graphicalModelAssistInterface.h>
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+
+class RobotModel;
+class BlocksTable;
+class RobotsBlockParser;
+class Thread;
+class AbstractTimer;
+
+namespace blocks {
+class Block;
+}
+
+/// Runs threads of a program and keeps variables of sensors up to date with readings of the robot model.
+/// This is the part of a run shared by the interpreter, HeadlessRunner and ReplayRunner: they connect the robot
+/// model, configure sensors and decide what to do when the program is over.
+class InterpretationDriver : public QObject
+{
+	Q_OBJECT
+
+public:
+	InterpretationDriver(GraphicalModelAssistInterface const &graphicalModelApi
+			, gui::MainWindowInterpretersInterface &interpretersInterface
+			, RobotModel &robotModel
+			, BlocksTable &blocksTable
+			, RobotsBlockParser &parser);
+
+	~InterpretationDriver();
+
+	/// Makes the driver poll sensors and encoders by given timer while a program runs. Without a timer readings
+	/// come only when the robot implementation sends them by itself. Doesn't take ownership.
+	void setPollingTimer(AbstractTimer *timer);
+
+	/// Returns true if threads of a program are running.
+	bool isRunning() const;
+
+	/// Connects readings of current sensors and encoders of the robot model to variables "Sensor1" - "Sensor4"
+	/// and "EncoderA" - "EncoderC". Configuration of sensors creates new ones, so it is called after it.
+	void listenSensors();
+
+	/// Sets variables of sensors to zero.
+	void resetSensorVariables();
+
+	/// Starts the initial thread of given diagram and polling of sensors.
+	void start(Id const &diagram);
+
+	/// Deletes all threads and stops polling. finished() is not emitted.
+	void stop();
+
+public slots:
+	/// Requests readings of all sensors and encoders, they come to variables with responses.
+	void readSensorValues();
+
+signals:
+	/// Emitted when the last thread of a program has stopped by itself.
+	void finished();
+
+	/// Emitted when a program tries to start more threads than allowed. The error is already reported,
+	/// the owner is expected to stop the run.
+	void threadsLimitExceeded();
+
+	/// Emitted when a thread passes control to a block, before the block is interpreted.
+	void blockStarted(Id const &block);
+
+private slots:
+	void threadStopped();
+	void newThread(details::blocks::Block * const startBlock);
+	void sensorResponse(int reading);
+	void sensorFailure();
+
+private:
+	void addThread(Thread * const thread);
+
+	GraphicalModelAssistInterface const &mGraphicalModelApi;
+	gui::MainWindowInterpretersInterface &mInterpretersInterface;
+	RobotModel &mRobotModel;
+	BlocksTable &mBlocksTable;
+	RobotsBlockParser &mParser;
+	AbstractTimer *mPollingTimer;  // Doesn't have ownership
+
+	bool mRunning;
+	QList<Thread *> mThreads;  // Has ownership
+
+	/// Names of variables updated by responses of sensor and encoder implementations.
+	QHash<QObject *, QString> mSensorVariables;
+};
+
+}
+}
+}
+}
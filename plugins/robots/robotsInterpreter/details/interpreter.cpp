@@ -1,7 +1,8 @@
-#include <QtCore/QCoreApplication>
 #include <QtCore/QDateTime>
 #include <QtWidgets/QAction>
 
+#include <qrkernel/exception/exception.h>
+
 #include "interpreter.h"
 
 #include "details/autoconfigurer.h"
@@ -18,8 +19,6 @@ using namespace qReal;
 using namespace interpreters::robots;
 using namespace interpreters::robots::details;
 
-int const maxThreadsCount = 100;
-
 Interpreter::Interpreter()
 	: SensorsConfigurationProvider("Interpreter")
 	, mGraphicalModelApi(nullptr)
@@ -29,6 +28,7 @@ Interpreter::Interpreter()
 	, mRobotModel(new RobotModel())
 	, mBlocksTable(nullptr)
 	, mParser(nullptr)
+	, mDriver(nullptr)
 	, mRobotCommunication(new RobotCommunicator())
 	, mImplementationType(robots::enums::robotModelType::null)
 	, mWatchListWindow(nullptr)
@@ -61,6 +61,12 @@ void Interpreter::init(GraphicalModelAssistInterface const &graphicalModelApi
 	mBlocksTable = new BlocksTable(graphicalModelApi, logicalModelApi, mRobotModel
 			, mInterpretersInterface->errorReporter(), mParser);
 
+	mDriver = new InterpretationDriver(graphicalModelApi, interpretersInterface, *mRobotModel, *mBlocksTable, *mParser);
+	mDriver->setPollingTimer(&mSensorsPollingTimer);
+	connect(mDriver, SIGNAL(finished()), this, SLOT(programFinished()));
+	connect(mDriver, SIGNAL(threadsLimitExceeded()), this, SLOT(stopRobot()));
+	connect(mDriver, SIGNAL(blockStarted(Id const &)), &mTraceRecorder, SLOT(blockStarted(Id const &)));
+
 	connect(&projectManager, SIGNAL(beforeOpen(QString)), this, SLOT(stopRobot()));
 
 	robots::enums::robotModelType::robotModelTypeEnum const modelType
@@ -81,9 +87,7 @@ void Interpreter::init(GraphicalModelAssistInterface const &graphicalModelApi
 
 Interpreter::~Interpreter()
 {
-	foreach (Thread * const thread, mThreads) {
-		delete thread;
-	}
+	delete mDriver;
 	delete mBlocksTable;
 }
 
@@ -105,11 +109,17 @@ void Interpreter::interpret()
 	}
 
 	mBlocksTable->clear();
+	if (!mTraceFile.isEmpty()) {
+		// Blocks are created from now on, so timers they take from the robot model are recorded.
+		mTraceRecorder.prepare(*mRobotModel);
+	}
+
 	mState = waitingForSensorsConfiguredToLaunch;
 	mBlocksTable->setIdleForBlocks();
 
 	Autoconfigurer configurer(*mGraphicalModelApi, mBlocksTable, mInterpretersInterface->errorReporter(), mRobotModel);
 	if (!configurer.configure(currentDiagramId)) {
+		mTraceRecorder.stop(false);
 		return;
 	}
 
@@ -118,13 +128,10 @@ void Interpreter::interpret()
 
 void Interpreter::stopRobot()
 {
-	mTimer.stop();
+	saveTrace(false);
+	mDriver->stop();
 	mRobotModel->stopRobot();
 	mState = idle;
-	foreach (Thread * const thread, mThreads) {
-		delete thread;
-		mThreads.removeAll(thread);
-	}
 	mBlocksTable->setFailure();
 
 	mGraphicsWatch->stopJob();
@@ -229,43 +236,29 @@ void Interpreter::sensorsConfiguredSlot()
 	mConnected = true;
 	mActionConnectToRobot->setChecked(mConnected);
 
-	resetVariables();
+	mDriver->resetSensorVariables();
 
 	mRobotModel->nextBlockAfterInitial(mConnected);
 
 	if (mState == waitingForSensorsConfiguredToLaunch) {
 		mState = interpreting;
 		mInterpretationStartedTimestamp = mRobotModel->timeline()->timestamp();
+		if (!mTraceFile.isEmpty()) {
+			mTraceRecorder.start(mInterpretersInterface->activeDiagram());
+		}
 
-		runTimer();
+		listenSensors();
 
 		Tracer::debug(tracer::enums::initialization, "Interpreter::sensorsConfiguredSlot", "Starting interpretation");
 		mRobotModel->startInterpretation();
-
-		Id const &currentDiagramId = mInterpretersInterface->activeDiagram();
-		Thread * const initialThread = new Thread(mGraphicalModelApi
-				, *mInterpretersInterface, currentDiagramId, *mBlocksTable);
-		addThread(initialThread);
+		mDriver->start(mInterpretersInterface->activeDiagram());
 	}
 }
 
-void Interpreter::threadStopped()
+void Interpreter::programFinished()
 {
-	Thread *thread = static_cast<Thread *>(sender());
-
-	mThreads.removeAll(thread);
-	delete thread;
-
-	if (mThreads.isEmpty()) {
-		stopRobot();
-	}
-}
-
-void Interpreter::newThread(details::blocks::Block * const startBlock)
-{
-	Thread * const thread = new Thread(mGraphicalModelApi
-			, *mInterpretersInterface, *mBlocksTable, startBlock->id());
-	addThread(thread);
+	saveTrace(true);
+	stopRobot();
 }
 
 void Interpreter::configureSensors(
@@ -281,23 +274,6 @@ void Interpreter::configureSensors(
 	updateGraphicWatchSensorsList();
 }
 
-void Interpreter::addThread(details::Thread * const thread)
-{
-	if (mThreads.count() >= maxThreadsCount) {
-		reportError(tr("Threads limit exceeded. Maximum threads count is %1").arg(maxThreadsCount));
-		stopRobot();
-	}
-
-	mThreads.append(thread);
-	connect(thread, SIGNAL(stopped()), this, SLOT(threadStopped()));
-	connect(thread, SIGNAL(newThread(details::blocks::Block*const)), this, SLOT(newThread(details::blocks::Block*const)));
-
-	QCoreApplication::processEvents();
-	if (mState != idle) {
-		thread->interpret();
-	}
-}
-
 interpreters::robots::details::RobotModel *Interpreter::robotModel()
 {
 	return mRobotModel;
@@ -312,183 +288,34 @@ void Interpreter::setRobotImplementation(details::robotImplementations::Abstract
 {
 	mRobotModel->setRobotImplementation(robotImpl);
 	if (robotImpl) {
-		connect(mRobotModel, SIGNAL(connected(bool)), this, SLOT(runTimer()));
-	}
-}
-
-void Interpreter::runTimer()
-{
-	if (mRobotModel->sensor(robots::enums::inputPort::port1)) {
-		connect(
-				mRobotModel->sensor(robots::enums::inputPort::port1)->sensorImpl()
-				, SIGNAL(response(int))
-				, this
-				, SLOT(responseSlot1(int))
-				, Qt::UniqueConnection
-				);
-
-		connect(
-				mRobotModel->sensor(robots::enums::inputPort::port1)->sensorImpl()
-				, SIGNAL(failure())
-				, this
-				, SLOT(slotFailure())
-				, Qt::UniqueConnection
-				);
-	}
-	if (mRobotModel->sensor(robots::enums::inputPort::port2)) {
-		connect(
-				mRobotModel->sensor(robots::enums::inputPort::port2)->sensorImpl()
-				, SIGNAL(response(int))
-				, this
-				, SLOT(responseSlot2(int))
-				, Qt::UniqueConnection
-				);
-
-		connect(
-				mRobotModel->sensor(robots::enums::inputPort::port2)->sensorImpl()
-				, SIGNAL(failure())
-				, this
-				, SLOT(slotFailure())
-				, Qt::UniqueConnection
-				);
-	}
-	if (mRobotModel->sensor(robots::enums::inputPort::port3)) {
-		connect(
-				mRobotModel->sensor(robots::enums::inputPort::port3)->sensorImpl()
-				, SIGNAL(response(int))
-				, this
-				, SLOT(responseSlot3(int))
-				, Qt::UniqueConnection
-				);
-
-		connect(
-				mRobotModel->sensor(robots::enums::inputPort::port3)->sensorImpl()
-				, SIGNAL(failure())
-				, this
-				, SLOT(slotFailure())
-				, Qt::UniqueConnection
-				);
-	}
-	if (mRobotModel->sensor(robots::enums::inputPort::port4)) {
-		connect(
-				mRobotModel->sensor(robots::enums::inputPort::port4)->sensorImpl()
-				, SIGNAL(response(int))
-				, this
-				, SLOT(responseSlot4(int))
-				, Qt::UniqueConnection
-				);
-
-		connect(
-				mRobotModel->sensor(robots::enums::inputPort::port4)->sensorImpl()
-				, SIGNAL(failure())
-				, this
-				, SLOT(slotFailure())
-				, Qt::UniqueConnection
-				);
-	}
-
-	connect(mRobotModel->encoderA().encoderImpl(), SIGNAL(response(int))
-			, this, SLOT(responseSlotA(int)), Qt::UniqueConnection);
-	connect(mRobotModel->encoderA().encoderImpl(), SIGNAL(failure())
-			, this, SLOT(slotFailure()), Qt::UniqueConnection);
-	connect(mRobotModel->encoderB().encoderImpl(), SIGNAL(response(int))
-			, this, SLOT(responseSlotB(int)), Qt::UniqueConnection);
-	connect(mRobotModel->encoderB().encoderImpl(), SIGNAL(failure())
-			, this, SLOT(slotFailure()), Qt::UniqueConnection);
-	connect(mRobotModel->encoderC().encoderImpl(), SIGNAL(response(int))
-			, this, SLOT(responseSlotC(int)), Qt::UniqueConnection);
-	connect(mRobotModel->encoderC().encoderImpl(), SIGNAL(failure())
-			, this, SLOT(slotFailure()), Qt::UniqueConnection);
-
-	mRobotModel->nullifySensors();
-	if (!mTimer.isActive()) {
-		readSensorValues();
-		mTimer.start(25);
-		connect(&mTimer, SIGNAL(timeout()), this, SLOT(readSensorValues()), Qt::UniqueConnection);
-	}
-}
-
-void Interpreter::readSensorValues()
-{
-	if (mState == idle) {
-		return;
-	}
-
-	if (mRobotModel->sensor(robots::enums::inputPort::port1)) {
-		mRobotModel->sensor(robots::enums::inputPort::port1)->read();
+		connect(mRobotModel, SIGNAL(connected(bool)), this, SLOT(listenSensors()));
 	}
-	if (mRobotModel->sensor(robots::enums::inputPort::port2)) {
-		mRobotModel->sensor(robots::enums::inputPort::port2)->read();
-	}
-	if (mRobotModel->sensor(robots::enums::inputPort::port3)) {
-		mRobotModel->sensor(robots::enums::inputPort::port3)->read();
-	}
-	if (mRobotModel->sensor(robots::enums::inputPort::port4)) {
-		mRobotModel->sensor(robots::enums::inputPort::port4)->read();
-	}
-
-	mRobotModel->encoderA().read();
-	mRobotModel->encoderB().read();
-	mRobotModel->encoderC().read();
-}
-
-void Interpreter::slotFailure()
-{
-	Tracer::debug(tracer::enums::autoupdatedSensorValues, "Interpreter::slotFailure", "");
-}
-
-void Interpreter::responseSlot1(int sensorValue)
-{
-	updateSensorValues("Sensor1", sensorValue);
-}
-
-void Interpreter::responseSlot2(int sensorValue)
-{
-	updateSensorValues("Sensor2", sensorValue);
 }
 
-void Interpreter::responseSlot3(int sensorValue)
+void Interpreter::listenSensors()
 {
-	updateSensorValues("Sensor3", sensorValue);
-}
-
-void Interpreter::responseSlot4(int sensorValue)
-{
-	updateSensorValues("Sensor4", sensorValue);
-}
-
-void Interpreter::responseSlotA(int encoderValue)
-{
-	updateSensorValues("EncoderA", encoderValue);
-}
-
-void Interpreter::responseSlotB(int encoderValue)
-{
-	updateSensorValues("EncoderB", encoderValue);
+	mDriver->listenSensors();
+	mRobotModel->nullifySensors();
 }
 
-void Interpreter::responseSlotC(int encoderValue)
+void Interpreter::setTraceFile(QString const &fileName)
 {
-	updateSensorValues("EncoderC", encoderValue);
+	mTraceFile = fileName;
 }
 
-void Interpreter::updateSensorValues(QString const &sensorVariableName, int sensorValue)
+void Interpreter::saveTrace(bool finished)
 {
-	mParser->variables()[sensorVariableName]->setValue(sensorValue);
-	Tracer::debug(
-			tracer::enums::autoupdatedSensorValues
-			, "Interpreter::updateSensorValues"
-			, sensorVariableName + QString::number(sensorValue)
-			);
-}
+	bool const wasRecording = mTraceRecorder.isRecording();
+	mTraceRecorder.stop(finished);
+	if (!wasRecording) {
+		return;
+	}
 
-void Interpreter::resetVariables()
-{
-	int const resetValue = 0;
-	responseSlot1(resetValue);
-	responseSlot2(resetValue);
-	responseSlot3(resetValue);
-	responseSlot4(resetValue);
+	try {
+		mTraceRecorder.trace().save(mTraceFile);
+	} catch (Exception const &exception) {
+		reportError(exception.message());
+	}
 }
 
 void Interpreter::connectToRobot()
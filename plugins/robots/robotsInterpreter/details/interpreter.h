@@ -17,6 +17,9 @@
 #include "details/robotCommunication/bluetoothRobotCommunicationThread.h"
 #include "details/sensorsConfigurationProvider.h"
 #include "details/nxtDisplay.h"
+#include "details/traceRecorder.h"
+#include "details/interpretationDriver.h"
+#include "details/realTimer.h"
 
 namespace qReal {
 namespace interpreters {
@@ -64,6 +67,10 @@ public:
 	/// Disable Run and Stop buttons on 2d model widget, when running current diagram is impossible
 	void disableD2ModelWidgetRunStopButtons();
 
+	/// Records following runs of programs to given file, so they can be replayed by ReplayRunner. The file is
+	/// overwritten by every run. Empty name stops recording.
+	void setTraceFile(QString const &fileName);
+
 	utils::WatchListWindow *watchWindow() const;
 	utils::sensorsGraph::SensorsGraph *graphicsWatchWindow() const;
 
@@ -76,19 +83,8 @@ public slots:
 	void onTabChanged(Id const &diagramId, bool enabled);
 
 private slots:
-	void threadStopped();
-	void newThread(details::blocks::Block * const startBlock);
-	void runTimer();
-	void readSensorValues();
-	void slotFailure();
-
-	void responseSlot1(int sensorValue);
-	void responseSlot2(int sensorValue);
-	void responseSlot3(int sensorValue);
-	void responseSlot4(int sensorValue);
-	void responseSlotA(int encoderValue);
-	void responseSlotB(int encoderValue);
-	void responseSlotC(int encoderValue);
+	void programFinished();
+	void listenSensors();
 
 	void connectedSlot(bool success);
 	void sensorsConfiguredSlot();
@@ -109,12 +105,12 @@ private:
 	};
 
 	void setRobotImplementation(details::robotImplementations::AbstractRobotModelImplementation *robotImpl);
-	void addThread(details::Thread * const thread);
-	void updateSensorValues(QString const &sensorVariableName, int sensorValue);
-	void resetVariables();
 	void saveSensorConfiguration();
 	void updateGraphicWatchSensorsList();
 
+	/// Finishes recording of a run and saves the trace if the run is recorded.
+	void saveTrace(bool finished);
+
 	void onSensorConfigurationChanged(
 			qReal::interpreters::robots::enums::inputPort::InputPortEnum port
 			, qReal::interpreters::robots::enums::sensorType::SensorTypeEnum type
@@ -126,11 +122,11 @@ private:
 
 	InterpreterState mState;
 	quint64 mInterpretationStartedTimestamp;
-	QList<details::Thread *> mThreads;  // Has ownership
 	details::RobotModel *mRobotModel;
 	details::BlocksTable *mBlocksTable;  // Has ownership
 	details::RobotsBlockParser *mParser;
-	QTimer mTimer;
+	details::InterpretationDriver *mDriver;  // Has ownership
+	details::RealTimer mSensorsPollingTimer;
 	details::d2Model::D2ModelWidget *mD2ModelWidget;
 	details::d2Model::D2RobotModel *mD2RobotModel;
 	details::RobotCommunicator* const mRobotCommunication;
@@ -147,6 +143,10 @@ private:
 	QAction *mActionConnectToRobot;
 
 	QString mLastCommunicationValue;
+
+	/// File to record runs to, empty if runs are not recorded.
+	QString mTraceFile;
+	details::TraceRecorder mTraceRecorder;
 };
 
 }
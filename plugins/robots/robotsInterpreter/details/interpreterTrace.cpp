@@ -0,0 +1,251 @@
+#include "interpreterTrace.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+
+#include <qrkernel/exception/exception.h>
+
+using namespace qReal;
+using namespace interpreters::robots;
+using namespace interpreters::robots::details;
+
+quint32 const signature = 0x51525452;  // "QRTR"
+quint32 const formatVersion = 1;
+
+namespace {
+
+/// Appends a number using as many bytes as it needs: seven bits per byte, the highest bit tells that
+/// more bytes follow. Time from the previous event and indices usually take one byte.
+void writeNumber(QByteArray &target, quint64 value)
+{
+	while (value >= 0x80) {
+		target.append(static_cast<char>((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+
+	target.append(static_cast<char>(value));
+}
+
+quint64 readNumber(QByteArray const &source, int &position)
+{
+	quint64 result = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (position >= source.size()) {
+			throw Exception(QObject::tr("Trace is truncated"));
+		}
+
+		quint8 const byte = static_cast<quint8>(source[position++]);
+		result |= static_cast<quint64>(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return result;
+		}
+	}
+
+	throw Exception(QObject::tr("Trace is corrupted"));
+}
+
+/// Sensor readings may be negative, so the sign is moved to the lowest bit to keep small values short.
+quint32 zigzag(int value)
+{
+	return (static_cast<quint32>(value) << 1) ^ (value < 0 ? 0xffffffffu : 0);
+}
+
+int unzigzag(quint64 value)
+{
+	quint32 const bits = static_cast<quint32>(value);
+	return static_cast<int>((bits >> 1) ^ (bits & 1 ? 0xffffffffu : 0));
+}
+
+}
+
+InterpreterTrace::InterpreterTrace()
+	: mSensorTypes(4, robots::enums::sensorType::unused)
+	, mFinished(false)
+{
+}
+
+void InterpreterTrace::clear()
+{
+	mDiagram = Id();
+	mSensorTypes.fill(robots::enums::sensorType::unused);
+	mFinished = false;
+	mEvents.clear();
+	mBlocks.clear();
+	mBlockIndices.clear();
+}
+
+Id InterpreterTrace::diagram() const
+{
+	return mDiagram;
+}
+
+void InterpreterTrace::setDiagram(Id const &diagram)
+{
+	mDiagram = diagram;
+}
+
+robots::enums::sensorType::SensorTypeEnum InterpreterTrace::sensorType(
+		robots::enums::inputPort::InputPortEnum port) const
+{
+	return mSensorTypes[port];
+}
+
+void InterpreterTrace::setSensorType(robots::enums::inputPort::InputPortEnum port
+		, robots::enums::sensorType::SensorTypeEnum type)
+{
+	mSensorTypes[port] = type;
+}
+
+bool InterpreterTrace::finished() const
+{
+	return mFinished;
+}
+
+void InterpreterTrace::setFinished(bool finished)
+{
+	mFinished = finished;
+}
+
+void InterpreterTrace::addSensorResponse(quint64 time, int source, int reading)
+{
+	TraceEvent const event = { TraceEvent::sensorResponse, time, source, reading };
+	mEvents << event;
+}
+
+void InterpreterTrace::addTimerTimeout(quint64 time, int timer)
+{
+	TraceEvent const event = { TraceEvent::timerTimeout, time, timer, 0 };
+	mEvents << event;
+}
+
+void InterpreterTrace::addBlockStarted(quint64 time, Id const &block)
+{
+	if (!mBlockIndices.contains(block)) {
+		mBlockIndices[block] = mBlocks.size();
+		mBlocks << block;
+	}
+
+	TraceEvent const event = { TraceEvent::blockStarted, time, mBlockIndices[block], 0 };
+	mEvents << event;
+}
+
+QList<TraceEvent> const &InterpreterTrace::events() const
+{
+	return mEvents;
+}
+
+Id InterpreterTrace::block(int index) const
+{
+	return mBlocks.value(index);
+}
+
+void InterpreterTrace::save(QString const &fileName) const
+{
+	QByteArray events;
+	quint64 previousTime = 0;
+	foreach (TraceEvent const &event, mEvents) {
+		events.append(static_cast<char>(event.type));
+		writeNumber(events, event.time - previousTime);
+		writeNumber(events, event.source);
+		if (event.type == TraceEvent::sensorResponse) {
+			writeNumber(events, zigzag(event.value));
+		}
+
+		previousTime = event.time;
+	}
+
+	QStringList blocks;
+	foreach (Id const &block, mBlocks) {
+		blocks << block.toString();
+	}
+
+	QList<int> sensorTypes;
+	foreach (robots::enums::sensorType::SensorTypeEnum const type, mSensorTypes) {
+		sensorTypes << type;
+	}
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		throw Exception(QObject::tr("Can not write trace to %1").arg(fileName));
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	stream << signature << formatVersion << mDiagram.toString() << sensorTypes << mFinished << blocks
+			<< static_cast<quint32>(mEvents.size()) << events;
+
+	if (stream.status() != QDataStream::Ok) {
+		throw Exception(QObject::tr("Can not write trace to %1").arg(fileName));
+	}
+}
+
+void InterpreterTrace::load(QString const &fileName)
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly)) {
+		throw Exception(QObject::tr("Can not read trace from %1").arg(fileName));
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_0);
+	quint32 fileSignature = 0;
+	quint32 version = 0;
+	stream >> fileSignature >> version;
+	if (fileSignature != signature || version != formatVersion) {
+		throw Exception(QObject::tr("%1 is not a trace of robot program").arg(fileName));
+	}
+
+	QString diagram;
+	QList<int> sensorTypes;
+	bool finished = false;
+	QStringList blocks;
+	quint32 eventsCount = 0;
+	QByteArray events;
+	stream >> diagram >> sensorTypes >> finished >> blocks >> eventsCount >> events;
+	if (stream.status() != QDataStream::Ok || sensorTypes.size() != mSensorTypes.size()) {
+		throw Exception(QObject::tr("Trace %1 is corrupted").arg(fileName));
+	}
+
+	// The trace is changed only when the whole file is read, so a failed load leaves it as it was.
+	QList<TraceEvent> loadedEvents;
+	int position = 0;
+	quint64 time = 0;
+	for (quint32 i = 0; i < eventsCount; ++i) {
+		if (position >= events.size()) {
+			throw Exception(QObject::tr("Trace is truncated"));
+		}
+
+		quint8 const type = static_cast<quint8>(events[position++]);
+		if (type > TraceEvent::blockStarted) {
+			throw Exception(QObject::tr("Trace is corrupted"));
+		}
+
+		TraceEvent event;
+		event.type = static_cast<TraceEvent::Type>(type);
+		time += readNumber(events, position);
+		event.time = time;
+		event.source = static_cast<int>(readNumber(events, position));
+		event.value = event.type == TraceEvent::sensorResponse ? unzigzag(readNumber(events, position)) : 0;
+		if (event.type == TraceEvent::blockStarted && event.source >= blocks.size()) {
+			throw Exception(QObject::tr("Trace is corrupted"));
+		}
+
+		loadedEvents << event;
+	}
+
+	clear();
+	mDiagram = Id::loadFromString(diagram);
+	for (int port = 0; port < sensorTypes.size(); ++port) {
+		mSensorTypes[port] = static_cast<robots::enums::sensorType::SensorTypeEnum>(sensorTypes[port]);
+	}
+
+	mFinished = finished;
+	foreach (QString const &block, blocks) {
+		mBlockIndices[Id::loadFromString(block)] = mBlocks.size();
+		mBlocks << Id::loadFromString(block);
+	}
+
+	mEvents = loadedEvents;
+}
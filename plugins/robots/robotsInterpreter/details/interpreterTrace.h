@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <qrkernel/ids.h>
+
+#include "sensorConstants.h"
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+
+/// Something that happened during interpretation of a program: a reading came from a sensor, a timer of robot
+/// model fired or a thread passed control to a block.
+struct TraceEvent
+{
+	enum Type {
+		sensorResponse
+		, timerTimeout
+		, blockStarted
+	};
+
+	/// Sources of sensor responses after sensors on ports 1-4, which are numbered from 0.
+	enum Encoder {
+		encoderA = 4
+		, encoderB
+		, encoderC
+	};
+
+	Type type;
+
+	/// Time in ms passed since the start of interpretation by the clock of robot model.
+	quint64 time;
+
+	/// Port of a sensor or an encoder, index of a timer in order of creation or index of a block
+	/// in InterpreterTrace::block().
+	int source;
+
+	/// Reading of a sensor, unused for other events.
+	int value;
+};
+
+/// Log of a run of the interpreter: everything that comes from outside into a program, so the run can be repeated
+/// without a robot, and blocks the program passed, to check that it was repeated. Saved to a file in compact
+/// binary form, a few bytes per event.
+class InterpreterTrace
+{
+public:
+	InterpreterTrace();
+
+	/// Removes all events and resets the description of the run.
+	void clear();
+
+	/// Graphical id of the interpreted diagram.
+	Id diagram() const;
+	void setDiagram(Id const &diagram);
+
+	/// Types of sensors the program was run with.
+	robots::enums::sensorType::SensorTypeEnum sensorType(robots::enums::inputPort::InputPortEnum port) const;
+	void setSensorType(robots::enums::inputPort::InputPortEnum port
+			, robots::enums::sensorType::SensorTypeEnum type);
+
+	/// True if the program stopped by itself, false if it was stopped by a user.
+	bool finished() const;
+	void setFinished(bool finished);
+
+	void addSensorResponse(quint64 time, int source, int reading);
+	void addTimerTimeout(quint64 time, int timer);
+	void addBlockStarted(quint64 time, Id const &block);
+
+	QList<TraceEvent> const &events() const;
+
+	/// Returns the block given index of block in an event refers to.
+	Id block(int index) const;
+
+	/// Writes the trace to a file.
+	/// @throws qReal::Exception if the file can not be written.
+	void save(QString const &fileName) const;
+
+	/// Reads a trace written by save().
+	/// @throws qReal::Exception if the file can not be read or is not a trace, the trace is left unchanged then.
+	void load(QString const &fileName);
+
+private:
+	Id mDiagram;
+	QVector<robots::enums::sensorType::SensorTypeEnum> mSensorTypes;
+	bool mFinished;
+	QList<TraceEvent> mEvents;
+
+	/// Blocks are stored once, events refer to them by index.
+	IdList mBlocks;
+	QHash<Id, int> mBlockIndices;
+};
+
+}
+}
+}
+}
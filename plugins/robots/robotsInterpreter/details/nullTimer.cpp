@@ -6,3 +6,7 @@ void NullTimer::start(int ms)
 {
 	Q_UNUSED(ms)
 }
+
+void NullTimer::stop()
+{
+}
@@ -17,6 +17,7 @@ class NullTimer : public AbstractTimer
 {
 public:
 	virtual void start(int ms);
+	virtual void stop();
 };
 
 }
@@ -16,6 +16,7 @@ public:
 	RealTimer();
 
 	virtual void start(int ms);
+	virtual void stop();
 
 private:
 	QTimer mTimer;
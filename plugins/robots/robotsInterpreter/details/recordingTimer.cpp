@@ -0,0 +1,34 @@
+#include "recordingTimer.h"
+
+#include "traceRecorder.h"
+
+using namespace qReal::interpreters::robots::details;
+
+RecordingTimer::RecordingTimer(AbstractTimer * const timer, TraceRecorder &recorder, int index)
+	: mTimer(timer)
+	, mRecorder(recorder)
+	, mIndex(index)
+{
+	connect(mTimer, SIGNAL(timeout()), this, SLOT(onTimerTimeout()));
+}
+
+RecordingTimer::~RecordingTimer()
+{
+	delete mTimer;
+}
+
+void RecordingTimer::start(int ms)
+{
+	mTimer->start(ms);
+}
+
+void RecordingTimer::stop()
+{
+	mTimer->stop();
+}
+
+void RecordingTimer::onTimerTimeout()
+{
+	mRecorder.timerTimeout(mIndex);
+	onTimeout();
+}
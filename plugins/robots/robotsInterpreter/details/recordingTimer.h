@@ -0,0 +1,38 @@
+#pragma once
+
+#include "abstractTimer.h"
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+
+class TraceRecorder;
+
+/// Timer of robot model that tells a recorder when it fires, produced by TraceRecorder.
+class RecordingTimer : public AbstractTimer
+{
+	Q_OBJECT
+
+public:
+	/// @param timer - timer of robot model to watch, takes ownership.
+	/// @param index - number of the timer among timers produced by the recorder.
+	RecordingTimer(AbstractTimer * const timer, TraceRecorder &recorder, int index);
+	~RecordingTimer();
+
+	virtual void start(int ms);
+	virtual void stop();
+
+private slots:
+	void onTimerTimeout();
+
+private:
+	AbstractTimer * const mTimer;  // Has ownership
+	TraceRecorder &mRecorder;
+	int const mIndex;
+};
+
+}
+}
+}
+}
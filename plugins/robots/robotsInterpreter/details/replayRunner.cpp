@@ -0,0 +1,357 @@
+#include "replayRunner.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QTextStream>
+
+#include <qrkernel/exception/exception.h>
+#include <qrkernel/settingsManager.h>
+
+#include "details/autoconfigurer.h"
+#include "details/blocksTable.h"
+#include "details/headlessInterpretersInterface.h"
+#include "details/interpretationDriver.h"
+#include "details/robotsBlockParser.h"
+#include "details/robotParts/robotModel.h"
+#include "details/robotImplementations/replayRobotModelImplementation.h"
+
+using namespace qReal;
+using namespace interpreters::robots;
+using namespace interpreters::robots::details;
+
+QString const replayOption = "--replay-trace";
+QString const recordOption = "--record-trace";
+
+/// Real time in ms the program is given to pass an expected block or to stop. A program waits only for events
+/// which are replayed, so when it is silent that long, it is not going to pass the block at all.
+int const stallTimeout = 3000;
+
+ReplayResult::ReplayResult()
+	: reproduced(false)
+	, eventsReplayed(0)
+	, time(0)
+{
+}
+
+ReplayRunner::ReplayRunner(GraphicalModelAssistInterface const &graphicalModelApi
+		, LogicalModelAssistInterface &logicalModelApi)
+	: mGraphicalModelApi(graphicalModelApi)
+	, mLogicalModelApi(logicalModelApi)
+	, mState(idle)
+	, mTrace(nullptr)
+	, mCursor(0)
+	, mInterpretersInterface(nullptr)
+	, mRobotModel(nullptr)
+	, mRobotImpl(nullptr)
+	, mParser(nullptr)
+	, mBlocksTable(nullptr)
+	, mDriver(nullptr)
+{
+	mStallTimer.setSingleShot(true);
+	mStallTimer.setInterval(stallTimeout);
+	connect(&mStallTimer, SIGNAL(timeout()), this, SLOT(stalled()));
+}
+
+ReplayRunner::~ReplayRunner()
+{
+}
+
+bool ReplayRunner::isRequested(QStringList const &arguments)
+{
+	return arguments.contains(replayOption);
+}
+
+QString ReplayRunner::recordedTraceFile(QStringList const &arguments)
+{
+	int const index = arguments.indexOf(recordOption);
+	return index == -1 ? QString() : arguments.value(index + 1);
+}
+
+int ReplayRunner::runFromCommandLine(QStringList const &arguments)
+{
+	QTextStream output(stdout);
+	QTextStream errors(stderr);
+	InterpreterTrace trace;
+	try {
+		trace.load(arguments.value(arguments.indexOf(replayOption) + 1));
+	} catch (Exception const &exception) {
+		errors << exception.message() << endl;
+		return 1;
+	}
+
+	if (!mGraphicalModelApi.graphicalRepoApi().exist(trace.diagram())) {
+		errors << tr("The recorded diagram is not in the project") << endl;
+		return 1;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	ReplayResult const result = run(trace);
+	qint64 const elapsed = timer.elapsed();
+
+	foreach (QString const &error, result.errors) {
+		errors << error << endl;
+	}
+
+	if (!result.reproduced) {
+		errors << tr("Diverged after %1 of %2 events at %3 ms: %4").arg(result.eventsReplayed)
+				.arg(trace.events().size()).arg(result.time).arg(result.divergence) << endl;
+		return 1;
+	}
+
+	output << tr("Reproduced %1 events, %2 ms of robot time in %3 ms").arg(result.eventsReplayed)
+			.arg(result.time).arg(elapsed) << endl;
+	return 0;
+}
+
+ReplayResult ReplayRunner::run(InterpreterTrace const &trace)
+{
+	mTrace = &trace;
+	mCursor = 0;
+	mResult = ReplayResult();
+
+	// Autoconfigurer takes sensors from settings, so they are set as in the recorded run for a while.
+	QList<QVariant> oldSensors;
+	for (int port = 0; port < 4; ++port) {
+		QString const key = QString("port%1SensorType").arg(port + 1);
+		oldSensors << SettingsManager::value(key);
+		SettingsManager::setValue(key, trace.sensorType(static_cast<robots::enums::inputPort::InputPortEnum>(port)));
+	}
+
+	HeadlessInterpretersInterface interpretersInterface(trace.diagram(), mResult.errors);
+	mInterpretersInterface = &interpretersInterface;
+	mRobotImpl = new robotImplementations::ReplayRobotModelImplementation();
+	mRobotModel = new RobotModel();
+	mRobotModel->setRobotImplementation(mRobotImpl);
+	mParser = new RobotsBlockParser(&interpretersInterface, [this] () {
+		return mState == interpreting ? mRobotImpl->timeline()->timestamp() : 0;
+	});
+
+	mBlocksTable = new BlocksTable(mGraphicalModelApi, mLogicalModelApi, mRobotModel, &interpretersInterface, mParser);
+	mDriver = new InterpretationDriver(mGraphicalModelApi, interpretersInterface, *mRobotModel, *mBlocksTable, *mParser);
+
+	// Readings are fed from the trace, so sensors are not polled.
+	connect(mRobotModel, SIGNAL(sensorsConfigured()), this, SLOT(sensorsConfiguredSlot()));
+	connect(mDriver, SIGNAL(finished()), this, SLOT(onProgramFinished()));
+	connect(mDriver, SIGNAL(threadsLimitExceeded()), this, SLOT(onThreadsLimitExceeded()));
+	connect(mDriver, SIGNAL(blockStarted(Id const &)), this, SLOT(blockStarted(Id const &)));
+
+	QEventLoop loop;
+	connect(this, SIGNAL(stopped()), &loop, SLOT(quit()));
+	mState = connecting;
+	mRobotModel->init();
+	loop.exec();
+
+	delete mDriver;
+	delete mBlocksTable;
+	delete mParser;
+	// Deletes the implementation with it.
+	delete mRobotModel;
+	mDriver = nullptr;
+	mBlocksTable = nullptr;
+	mParser = nullptr;
+	mRobotModel = nullptr;
+	mRobotImpl = nullptr;
+	mInterpretersInterface = nullptr;
+	mTrace = nullptr;
+
+	for (int port = 0; port < 4; ++port) {
+		SettingsManager::setValue(QString("port%1SensorType").arg(port + 1), oldSensors[port]);
+	}
+
+	return mResult;
+}
+
+void ReplayRunner::sensorsConfiguredSlot()
+{
+	if (mState == connecting) {
+		mState = waitingForSensorsConfiguredToLaunch;
+		mBlocksTable->setIdleForBlocks();
+		Autoconfigurer configurer(mGraphicalModelApi, mBlocksTable, mInterpretersInterface, mRobotModel);
+		if (!configurer.configure(mTrace->diagram())) {
+			diverge(tr("The program can not be started with sensors of the recorded run"));
+		}
+	} else if (mState == waitingForSensorsConfiguredToLaunch) {
+		startInterpretation();
+	}
+}
+
+void ReplayRunner::startInterpretation()
+{
+	mState = interpreting;
+	mDriver->resetSensorVariables();
+	mRobotModel->nextBlockAfterInitial(true);
+	mDriver->listenSensors();
+	mRobotModel->startInterpretation();
+
+	// Readings recorded before the first block came before the program started.
+	replayInputs();
+	if (mState == interpreting) {
+		mDriver->start(mTrace->diagram());
+	}
+}
+
+void ReplayRunner::replayInputs()
+{
+	if (mState != interpreting) {
+		return;
+	}
+
+	QList<TraceEvent> const &events = mTrace->events();
+	while (mState == interpreting && mCursor < events.size() && events[mCursor].type != TraceEvent::blockStarted) {
+		TraceEvent const event = events[mCursor];
+		++mCursor;
+		mRobotImpl->timeline()->setTimestamp(event.time);
+		replayInput(event);
+	}
+
+	if (mState != interpreting) {
+		return;
+	}
+
+	if (mCursor == events.size() && !mTrace->finished()) {
+		// The recorded run was stopped by a user here.
+		mResult.reproduced = true;
+		stop();
+	} else {
+		// Waiting for the program to pass the next recorded block or to stop by itself.
+		mStallTimer.start();
+	}
+}
+
+void ReplayRunner::replayInput(TraceEvent const &event)
+{
+	if (event.type == TraceEvent::timerTimeout) {
+		ReplayTimer * const timer = mRobotImpl->timeline()->timer(event.source);
+		if (!timer || !timer->isActive()) {
+			diverge(tr("Timer %1 fired in the recorded run, but it is not started").arg(event.source));
+			return;
+		}
+
+		timer->fire();
+		return;
+	}
+
+	switch (event.source) {
+	case TraceEvent::encoderA:
+		mRobotImpl->encoderA().replay(event.value);
+		break;
+	case TraceEvent::encoderB:
+		mRobotImpl->encoderB().replay(event.value);
+		break;
+	case TraceEvent::encoderC:
+		mRobotImpl->encoderC().replay(event.value);
+		break;
+	default:
+		sensorImplementations::ReplaySensorImplementation * const sensor = mRobotImpl->replaySensor(
+				static_cast<robots::enums::inputPort::InputPortEnum>(event.source));
+		if (!sensor) {
+			diverge(tr("A reading came from port %1 in the recorded run, but there is no sensor")
+					.arg(event.source + 1));
+			return;
+		}
+
+		sensor->replay(event.value);
+	}
+}
+
+void ReplayRunner::blockStarted(Id const &block)
+{
+	if (mState != interpreting) {
+		return;
+	}
+
+	QList<TraceEvent> const &events = mTrace->events();
+	if (mCursor == events.size() && !mTrace->finished()) {
+		// The program goes on after the moment the recorded run was stopped.
+		return;
+	}
+
+	if (mCursor == events.size() || events[mCursor].type != TraceEvent::blockStarted) {
+		diverge(tr("Block %1 started, but the recorded program was waiting").arg(blockName(block)));
+		return;
+	}
+
+	Id const expected = mTrace->block(events[mCursor].source);
+	if (block != expected) {
+		diverge(tr("Block %1 started instead of %2").arg(blockName(block), blockName(expected)));
+		return;
+	}
+
+	mRobotImpl->timeline()->setTimestamp(events[mCursor].time);
+	++mCursor;
+	mStallTimer.stop();
+
+	// Readings which follow are given when the block has done what it does right away, as a robot
+	// answers requests of blocks.
+	QMetaObject::invokeMethod(this, "replayInputs", Qt::QueuedConnection);
+}
+
+void ReplayRunner::onProgramFinished()
+{
+	if (mState != interpreting) {
+		return;
+	}
+
+	if (mCursor == mTrace->events().size() && mTrace->finished()) {
+		mResult.reproduced = true;
+		stop();
+	} else {
+		diverge(tr("The program stopped, but the recorded one went on"));
+	}
+}
+
+void ReplayRunner::onThreadsLimitExceeded()
+{
+	diverge(tr("Threads limit exceeded"));
+}
+
+void ReplayRunner::stalled()
+{
+	if (mState != interpreting) {
+		return;
+	}
+
+	QList<TraceEvent> const &events = mTrace->events();
+	if (mCursor < events.size()) {
+		diverge(tr("The program waits, but the recorded one passed block %1")
+				.arg(blockName(mTrace->block(events[mCursor].source))));
+	} else {
+		diverge(tr("The program goes on, but the recorded one stopped"));
+	}
+}
+
+void ReplayRunner::diverge(QString const &message)
+{
+	mResult.reproduced = false;
+	if (mResult.divergence.isEmpty()) {
+		mResult.divergence = message;
+	}
+
+	// A signal of a thread may be being processed, so threads are deleted later.
+	mState = idle;
+	QMetaObject::invokeMethod(this, "stop", Qt::QueuedConnection);
+}
+
+void ReplayRunner::stop()
+{
+	if (!mRobotModel) {
+		return;
+	}
+
+	mState = idle;
+	mStallTimer.stop();
+	mResult.eventsReplayed = mCursor;
+	mResult.time = mRobotImpl->timeline()->timestamp();
+
+	mDriver->stop();
+	mRobotModel->stopRobot();
+	mBlocksTable->setFailure();
+	emit stopped();
+}
+
+QString ReplayRunner::blockName(Id const &block) const
+{
+	QString const name = mGraphicalModelApi.graphicalRepoApi().name(block);
+	return QString("\"%1\" (%2)").arg(name.isEmpty() ? block.element() : name, block.id());
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QTimer>
+
+#include <qrkernel/ids.h>
+#include <qrgui/toolPluginInterface/usedInterfaces/graphicalModelAssistInterface.h>
+#include <qrgui/toolPluginInterface/usedInterfaces/logicalModelAssistInterface.h>
+
+#include "interpreterTrace.h"
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+
+class RobotModel;
+class BlocksTable;
+class RobotsBlockParser;
+class HeadlessInterpretersInterface;
+class InterpretationDriver;
+
+namespace robotImplementations {
+class ReplayRobotModelImplementation;
+}
+
+/// Outcome of a replay of a recorded run.
+struct ReplayResult
+{
+	ReplayResult();
+
+	/// True if the program passed the same blocks in the same order and at the same time as in the recorded run
+	/// and stopped the same way.
+	bool reproduced;
+
+	/// How many events of the trace were replayed or checked.
+	int eventsReplayed;
+
+	/// Time in ms by the clock of the trace when the replay was over.
+	quint64 time;
+
+	/// The first difference from the recorded run, empty if the run was reproduced.
+	QString divergence;
+
+	/// Errors reported by the interpreter.
+	QStringList errors;
+};
+
+/// Repeats a run recorded by the interpreter into InterpreterTrace without a robot or 2D model. The program gets
+/// readings of sensors and timeouts of timers in the recorded order, time jumps from one recorded event to another,
+/// so a replay takes as long as the program needs to process the events. Blocks passed by threads are compared
+/// with the recorded ones up to the first difference. Runs are recorded and replayed from the command line:
+///
+///     qreal project.qrs --record-trace run.trace
+///     qreal project.qrs --replay-trace run.trace -platform offscreen
+///
+/// The replay exits with code 0 if the run is reproduced, so it may be a regression test for a program.
+class ReplayRunner : public QObject
+{
+	Q_OBJECT
+
+public:
+	ReplayRunner(GraphicalModelAssistInterface const &graphicalModelApi
+			, LogicalModelAssistInterface &logicalModelApi);
+
+	~ReplayRunner();
+
+	/// Returns true if QReal was started to replay a trace.
+	static bool isRequested(QStringList const &arguments);
+
+	/// Returns the file QReal was started to record runs of the interpreter to, empty if runs are not recorded.
+	static QString recordedTraceFile(QStringList const &arguments);
+
+	/// Replays a trace given by command line of QReal, printing the outcome.
+	/// @returns exit code for the application.
+	int runFromCommandLine(QStringList const &arguments);
+
+	/// Replays given trace, running an event loop meanwhile. Sensors are configured as in the recorded run.
+	ReplayResult run(InterpreterTrace const &trace);
+
+signals:
+	/// Emitted when the replay is over.
+	void stopped();
+
+private slots:
+	void sensorsConfiguredSlot();
+	void onProgramFinished();
+	void onThreadsLimitExceeded();
+	void blockStarted(Id const &block);
+
+	/// Gives recorded readings and timeouts to the program until a block is expected to start.
+	void replayInputs();
+
+	void stalled();
+	void stop();
+
+private:
+	enum State {
+		idle
+		, connecting
+		, waitingForSensorsConfiguredToLaunch
+		, interpreting
+	};
+
+	void startInterpretation();
+	void replayInput(TraceEvent const &event);
+
+	/// Remembers the first difference from the recorded run and stops the replay when control returns
+	/// to the event loop.
+	void diverge(QString const &message);
+
+	QString blockName(Id const &block) const;
+
+	GraphicalModelAssistInterface const &mGraphicalModelApi;
+	LogicalModelAssistInterface &mLogicalModelApi;
+
+	State mState;
+	InterpreterTrace const *mTrace;  // Doesn't have ownership
+	int mCursor;
+	ReplayResult mResult;
+
+	/// Fires if the program does not pass an expected block for a long time by real clock.
+	QTimer mStallTimer;
+
+	/// Objects below live during a replay only.
+	HeadlessInterpretersInterface *mInterpretersInterface;
+	RobotModel *mRobotModel;
+	robotImplementations::ReplayRobotModelImplementation *mRobotImpl;  // Doesn't have ownership
+	RobotsBlockParser *mParser;
+	BlocksTable *mBlocksTable;
+	InterpretationDriver *mDriver;
+};
+
+}
+}
+}
+}
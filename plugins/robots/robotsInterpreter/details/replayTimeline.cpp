@@ -0,0 +1,30 @@
+#include "replayTimeline.h"
+
+using namespace qReal::interpreters::robots::details;
+
+ReplayTimeline::ReplayTimeline()
+	: mTimestamp(0)
+{
+}
+
+quint64 ReplayTimeline::timestamp() const
+{
+	return mTimestamp;
+}
+
+AbstractTimer *ReplayTimeline::produceTimer()
+{
+	ReplayTimer * const timer = new ReplayTimer;
+	mTimers << timer;
+	return timer;
+}
+
+void ReplayTimeline::setTimestamp(quint64 timestamp)
+{
+	mTimestamp = qMax(mTimestamp, timestamp);
+}
+
+ReplayTimer *ReplayTimeline::timer(int index) const
+{
+	return index >= 0 && index < mTimers.size() ? mTimers[index].data() : nullptr;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QPointer>
+
+#include "timelineInterface.h"
+#include "replayTimer.h"
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+
+/// A timeline of a replayed run. Time does not flow by itself, it jumps to moments of recorded events,
+/// so a replay takes no more time than the program needs to process the events.
+class ReplayTimeline : public TimelineInterface
+{
+public:
+	ReplayTimeline();
+
+	quint64 timestamp() const override;
+
+	AbstractTimer *produceTimer() override;
+
+	/// Moves the clock to given time, it never goes back.
+	void setTimestamp(quint64 timestamp);
+
+	/// Returns a timer by number in order of production, nullptr if it does not exist or is already deleted.
+	ReplayTimer *timer(int index) const;
+
+private:
+	quint64 mTimestamp;
+	QList<QPointer<ReplayTimer> > mTimers;
+};
+
+}
+}
+}
+}
@@ -0,0 +1,30 @@
+#include "replayTimer.h"
+
+using namespace qReal::interpreters::robots::details;
+
+ReplayTimer::ReplayTimer()
+	: mIsActive(false)
+{
+}
+
+void ReplayTimer::start(int ms)
+{
+	Q_UNUSED(ms)
+	mIsActive = true;
+}
+
+void ReplayTimer::stop()
+{
+	mIsActive = false;
+}
+
+bool ReplayTimer::isActive() const
+{
+	return mIsActive;
+}
+
+void ReplayTimer::fire()
+{
+	mIsActive = false;
+	onTimeout();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "abstractTimer.h"
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+
+/// Timer of a replayed run, it fires when ReplayRunner tells it to, when the recorded timer fired.
+class ReplayTimer : public AbstractTimer
+{
+	Q_OBJECT
+
+public:
+	ReplayTimer();
+
+	virtual void start(int ms);
+	virtual void stop();
+
+	/// Returns true if the timer is started and has not fired yet.
+	bool isActive() const;
+
+	/// Fires the timer.
+	void fire();
+
+private:
+	bool mIsActive;
+};
+
+}
+}
+}
+}
@@ -1,45 +1,45 @@
 HEADERS += \
-	details/robotCommunication/robotCommunicator.h \
-	details/robotCommunication/robotCommunicationThreadInterface.h \
-	details/robotCommunication/bluetoothRobotCommunicationThread.h \
-	details/robotCommunication/usbRobotCommunicationThread.h \
-	details/robotCommunication/fantom.h \
-	details/robotCommunication/fantomMethods.h \
-	details/robotCommunication/robotCommunicationException.h \
-	details/robotCommunication/robotCommunicationThreadBase.h \
-	details/robotCommunication/tcpRobotCommunicationThread.h \
+	$$PWD/robotCommunicator.h \
+	$$PWD/robotCommunicationThreadInterface.h \
+	$$PWD/bluetoothRobotCommunicationThread.h \
+	$$PWD/usbRobotCommunicationThread.h \
+	$$PWD/fantom.h \
+	$$PWD/fantomMethods.h \
+	$$PWD/robotCommunicationException.h \
+	$$PWD/robotCommunicationThreadBase.h \
+	$$PWD/tcpRobotCommunicationThread.h \
 
 SOURCES += \
-	details/robotCommunication/bluetoothRobotCommunicationThread.cpp \
-	details/robotCommunication/usbRobotCommunicationThread.cpp \
-	details/robotCommunication/robotCommunicator.cpp \
-	details/robotCommunication/robotCommunicationException.cpp \
-	details/robotCommunication/robotCommunicationThreadBase.cpp \
-	details/robotCommunication/tcpRobotCommunicationThread.cpp \
+	$$PWD/bluetoothRobotCommunicationThread.cpp \
+	$$PWD/usbRobotCommunicationThread.cpp \
+	$$PWD/robotCommunicator.cpp \
+	$$PWD/robotCommunicationException.cpp \
+	$$PWD/robotCommunicationThreadBase.cpp \
+	$$PWD/tcpRobotCommunicationThread.cpp \
 
 win32 {
 	HEADERS += \
-		details/robotCommunication/windowsFantom.h \
+		$$PWD/windowsFantom.h \
 
 	SOURCES += \
-		details/robotCommunication/windowsFantom.cpp \
+		$$PWD/windowsFantom.cpp \
 
 }
 
 unix {
 	HEADERS += \
-		details/robotCommunication/linuxFantom.h \
+		$$PWD/linuxFantom.h \
 
 	SOURCES += \
-		details/robotCommunication/linuxFantom.cpp \
+		$$PWD/linuxFantom.cpp \
 
 }
 
 macx {
 	HEADERS += \
-		details/robotCommunication/macFantom.h \
+		$$PWD/macFantom.h \
 
 	SOURCES += \
-		details/robotCommunication/macFantom.cpp \
+		$$PWD/macFantom.cpp \
 
 }
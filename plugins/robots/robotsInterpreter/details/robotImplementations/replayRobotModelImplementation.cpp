@@ -0,0 +1,188 @@
+#include "replayRobotModelImplementation.h"
+
+#include <QtCore/QTimer>
+
+using namespace qReal::interpreters::robots;
+using namespace details::robotImplementations;
+
+ReplayRobotModelImplementation::ReplayRobotModelImplementation()
+	: AbstractRobotModelImplementation()
+	, mMotorA(0)
+	, mMotorB(1)
+	, mMotorC(2)
+	, mEncoderA(enums::outputPort::port1)
+	, mEncoderB(enums::outputPort::port2)
+	, mEncoderC(enums::outputPort::port3)
+{
+	connect(&mSensorsConfigurer, SIGNAL(allSensorsConfigured()), this, SLOT(sensorConfigurationDoneSlot()));
+}
+
+void ReplayRobotModelImplementation::init()
+{
+	AbstractRobotModelImplementation::init();
+	// Connection is reported from the event loop, as a robot does it, and without a delay.
+	QTimer::singleShot(0, this, SLOT(connectSlot()));
+}
+
+void ReplayRobotModelImplementation::connectSlot()
+{
+	mSensorsConfigurer.unlockConfiguring();
+}
+
+void ReplayRobotModelImplementation::sensorConfigurationDoneSlot()
+{
+	connectRobot();
+}
+
+void ReplayRobotModelImplementation::stopRobot()
+{
+	mMotorA.off();
+	mMotorB.off();
+	mMotorC.off();
+}
+
+brickImplementations::NullBrickImplementation &ReplayRobotModelImplementation::brick()
+{
+	return mBrick;
+}
+
+displayImplementations::NullDisplayImplementation &ReplayRobotModelImplementation::display()
+{
+	return mDisplay;
+}
+
+sensorImplementations::ReplaySensorImplementation *ReplayRobotModelImplementation::touchSensor(
+		robots::enums::inputPort::InputPortEnum const port
+		) const
+{
+	return replaySensor(port);
+}
+
+sensorImplementations::ReplaySensorImplementation *ReplayRobotModelImplementation::sonarSensor(
+		robots::enums::inputPort::InputPortEnum const port
+		) const
+{
+	return replaySensor(port);
+}
+
+sensorImplementations::ReplaySensorImplementation *ReplayRobotModelImplementation::colorSensor(
+		robots::enums::inputPort::InputPortEnum const port
+		) const
+{
+	return replaySensor(port);
+}
+
+sensorImplementations::ReplaySensorImplementation *ReplayRobotModelImplementation::lightSensor(
+		robots::enums::inputPort::InputPortEnum const port
+		) const
+{
+	return replaySensor(port);
+}
+
+sensorImplementations::ReplaySensorImplementation *ReplayRobotModelImplementation::soundSensor(
+		robots::enums::inputPort::InputPortEnum const port
+		) const
+{
+	return replaySensor(port);
+}
+
+sensorImplementations::ReplaySensorImplementation *ReplayRobotModelImplementation::accelerometerSensor(
+		robots::enums::inputPort::InputPortEnum const port
+		) const
+{
+	return replaySensor(port);
+}
+
+sensorImplementations::ReplaySensorImplementation *ReplayRobotModelImplementation::gyroscopeSensor(
+		robots::enums::inputPort::InputPortEnum const port
+		) const
+{
+	return replaySensor(port);
+}
+
+sensorImplementations::ReplaySensorImplementation *ReplayRobotModelImplementation::replaySensor(
+		robots::enums::inputPort::InputPortEnum const port
+		) const
+{
+	return dynamic_cast<sensorImplementations::ReplaySensorImplementation *>(mSensorsConfigurer.sensor(port));
+}
+
+void ReplayRobotModelImplementation::addTouchSensor(robots::enums::inputPort::InputPortEnum const port)
+{
+	addSensor(port, robots::enums::sensorType::touchBoolean);
+}
+
+void ReplayRobotModelImplementation::addSonarSensor(robots::enums::inputPort::InputPortEnum const port)
+{
+	addSensor(port, robots::enums::sensorType::sonar);
+}
+
+void ReplayRobotModelImplementation::addLightSensor(robots::enums::inputPort::InputPortEnum const port)
+{
+	addSensor(port, robots::enums::sensorType::light);
+}
+
+void ReplayRobotModelImplementation::addColorSensor(
+		robots::enums::inputPort::InputPortEnum const port
+		, enums::lowLevelSensorType::SensorTypeEnum mode
+		, robots::enums::sensorType::SensorTypeEnum const &sensorType)
+{
+	Q_UNUSED(mode);
+	addSensor(port, sensorType);
+}
+
+void ReplayRobotModelImplementation::addSoundSensor(robots::enums::inputPort::InputPortEnum const port)
+{
+	addSensor(port, robots::enums::sensorType::sound);
+}
+
+void ReplayRobotModelImplementation::addGyroscopeSensor(robots::enums::inputPort::InputPortEnum const port)
+{
+	addSensor(port, robots::enums::sensorType::gyroscope);
+}
+
+void ReplayRobotModelImplementation::addAccelerometerSensor(robots::enums::inputPort::InputPortEnum const port)
+{
+	addSensor(port, robots::enums::sensorType::accelerometer);
+}
+
+void ReplayRobotModelImplementation::addSensor(robots::enums::inputPort::InputPortEnum const port
+		, robots::enums::sensorType::SensorTypeEnum const &sensorType)
+{
+	mSensorsConfigurer.configureSensor(new sensorImplementations::ReplaySensorImplementation(port, sensorType), port);
+}
+
+motorImplementations::NullMotorImplementation &ReplayRobotModelImplementation::motorA()
+{
+	return mMotorA;
+}
+
+motorImplementations::NullMotorImplementation &ReplayRobotModelImplementation::motorB()
+{
+	return mMotorB;
+}
+
+motorImplementations::NullMotorImplementation &ReplayRobotModelImplementation::motorC()
+{
+	return mMotorC;
+}
+
+sensorImplementations::ReplayEncoderImplementation &ReplayRobotModelImplementation::encoderA()
+{
+	return mEncoderA;
+}
+
+sensorImplementations::ReplayEncoderImplementation &ReplayRobotModelImplementation::encoderB()
+{
+	return mEncoderB;
+}
+
+sensorImplementations::ReplayEncoderImplementation &ReplayRobotModelImplementation::encoderC()
+{
+	return mEncoderC;
+}
+
+details::ReplayTimeline *ReplayRobotModelImplementation::timeline()
+{
+	return &mTimeline;
+}
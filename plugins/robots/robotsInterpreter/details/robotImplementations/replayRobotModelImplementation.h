@@ -0,0 +1,114 @@
+#pragma once
+
+#include "abstractRobotModelImplementation.h"
+#include "brickImplementations/nullBrickImplementation.h"
+#include "displayImplementations/nullDisplayImplementation.h"
+#include "motorImplementations/nullMotorImplementation.h"
+#include "sensorImplementations/replaySensorImplementation.h"
+#include "sensorImplementations/replayEncoderImplementation.h"
+#include "details/replayTimeline.h"
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+namespace robotImplementations {
+
+/// Robot for replaying a recorded run: sensors and encoders give readings from a trace, commands to motors,
+/// brick and display go nowhere and time is the clock of the trace. Driven by ReplayRunner.
+class ReplayRobotModelImplementation : public AbstractRobotModelImplementation
+{
+	Q_OBJECT
+
+public:
+	ReplayRobotModelImplementation();
+
+	virtual void init();
+	virtual void stopRobot();
+
+	virtual brickImplementations::NullBrickImplementation &brick();
+	virtual displayImplementations::NullDisplayImplementation &display();
+
+	virtual sensorImplementations::ReplaySensorImplementation *touchSensor(
+			robots::enums::inputPort::InputPortEnum const port
+			) const;
+
+	virtual sensorImplementations::ReplaySensorImplementation *sonarSensor(
+			robots::enums::inputPort::InputPortEnum const port
+			) const;
+
+	virtual sensorImplementations::ReplaySensorImplementation *colorSensor(
+			robots::enums::inputPort::InputPortEnum const port
+			) const;
+
+	virtual sensorImplementations::ReplaySensorImplementation *lightSensor(
+			robots::enums::inputPort::InputPortEnum const port
+			) const;
+
+	virtual sensorImplementations::ReplaySensorImplementation *soundSensor(
+			robots::enums::inputPort::InputPortEnum const port
+			) const;
+
+	virtual sensorImplementations::ReplaySensorImplementation *accelerometerSensor(
+			robots::enums::inputPort::InputPortEnum const port
+			) const;
+
+	virtual sensorImplementations::ReplaySensorImplementation *gyroscopeSensor(
+			robots::enums::inputPort::InputPortEnum const port
+			) const;
+
+	/// Returns a sensor configured on given port, whatever its type is, or nullptr.
+	sensorImplementations::ReplaySensorImplementation *replaySensor(
+			robots::enums::inputPort::InputPortEnum const port
+			) const;
+
+	virtual motorImplementations::NullMotorImplementation &motorA();
+	virtual motorImplementations::NullMotorImplementation &motorB();
+	virtual motorImplementations::NullMotorImplementation &motorC();
+
+	virtual sensorImplementations::ReplayEncoderImplementation &encoderA();
+	virtual sensorImplementations::ReplayEncoderImplementation &encoderB();
+	virtual sensorImplementations::ReplayEncoderImplementation &encoderC();
+
+	ReplayTimeline *timeline() override;
+
+private slots:
+	void connectSlot();
+	void sensorConfigurationDoneSlot();
+
+private:
+	virtual void addTouchSensor(robots::enums::inputPort::InputPortEnum const port);
+	virtual void addSonarSensor(robots::enums::inputPort::InputPortEnum const port);
+	virtual void addLightSensor(robots::enums::inputPort::InputPortEnum const port);
+
+	virtual void addColorSensor(
+			robots::enums::inputPort::InputPortEnum const port
+			, enums::lowLevelSensorType::SensorTypeEnum mode
+			, robots::enums::sensorType::SensorTypeEnum const &sensorType
+			);
+
+	virtual void addSoundSensor(robots::enums::inputPort::InputPortEnum const port);
+	virtual void addGyroscopeSensor(robots::enums::inputPort::InputPortEnum const port);
+	virtual void addAccelerometerSensor(robots::enums::inputPort::InputPortEnum const port);
+
+	void addSensor(robots::enums::inputPort::InputPortEnum const port
+			, robots::enums::sensorType::SensorTypeEnum const &sensorType);
+
+	brickImplementations::NullBrickImplementation mBrick;
+	displayImplementations::NullDisplayImplementation mDisplay;
+	motorImplementations::NullMotorImplementation mMotorA;
+	motorImplementations::NullMotorImplementation mMotorB;
+	motorImplementations::NullMotorImplementation mMotorC;
+
+	sensorImplementations::ReplayEncoderImplementation mEncoderA;
+	sensorImplementations::ReplayEncoderImplementation mEncoderB;
+	sensorImplementations::ReplayEncoderImplementation mEncoderC;
+
+	ReplayTimeline mTimeline;
+};
+
+}
+}
+}
+}
+}
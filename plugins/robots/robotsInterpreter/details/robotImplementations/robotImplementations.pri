@@ -1,95 +1,101 @@
 HEADERS += \
-	details/robotImplementations/sensorImplementations/abstractSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/abstractEncoderImplementation.h \
-	details/robotImplementations/sensorImplementations/bluetoothTouchSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/bluetoothSonarSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/bluetoothColorSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/bluetoothEncoderImplementation.h \
-	details/robotImplementations/sensorImplementations/nullSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/nullTouchSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/nullSonarSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/nullColorSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/nullEncoderImplementation.h \
-	details/robotImplementations/sensorImplementations/unrealSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/unrealTouchSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/unrealSonarSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/unrealColorSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/unrealEncoderImplementation.h \
-	details/robotImplementations/motorImplementations/abstractMotorImplementation.h \
-	details/robotImplementations/motorImplementations/realMotorImplementation.h \
-	details/robotImplementations/motorImplementations/nullMotorImplementation.h \
-	details/robotImplementations/motorImplementations/unrealMotorImplementation.h \
-	details/robotImplementations/brickImplementations/abstractBrickImplementation.h \
-	details/robotImplementations/brickImplementations/realBrickImplementation.h \
-	details/robotImplementations/brickImplementations/nullBrickImplementation.h \
-	details/robotImplementations/brickImplementations/unrealBrickImplementation.h \
-	details/robotImplementations/abstractRobotModelImplementation.h \
-	details/robotImplementations/realRobotModelImplementation.h \
-	details/robotImplementations/nullRobotModelImplementation.h \
-	details/robotImplementations/unrealRobotModelImplementation.h \
-	details/robotImplementations/sensorsConfigurer.h \
-	details/robotImplementations/sensorImplementations/bluetoothLightSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/nullLightSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/unrealLightSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/bluetoothSoundSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/bluetoothSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/bluetoothAccelerometerSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/bluetoothGyroscopeSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/nullSoundSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/unrealSoundSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/unrealGyroscopeSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/nullAccelerometerSensorImplementation.h \
-	details/robotImplementations/sensorImplementations/unrealAccelerometerSensorImplementation.h \
-	details/robotImplementations/displayImplementations/abstractDisplayImplementation.h \
-	details/robotImplementations/displayImplementations/realDisplayImplementation.h \
-	details/robotImplementations/displayImplementations/unrealDisplayImplementation.h \
-	details/robotImplementations/displayImplementations/nullDisplayImplementation.h \
-	details/robotImplementations/sensorImplementations/nullGyroscopeSensorImplementation.h \
+	$$PWD/sensorImplementations/abstractSensorImplementation.h \
+	$$PWD/sensorImplementations/abstractEncoderImplementation.h \
+	$$PWD/sensorImplementations/bluetoothTouchSensorImplementation.h \
+	$$PWD/sensorImplementations/bluetoothSonarSensorImplementation.h \
+	$$PWD/sensorImplementations/bluetoothColorSensorImplementation.h \
+	$$PWD/sensorImplementations/bluetoothEncoderImplementation.h \
+	$$PWD/sensorImplementations/nullSensorImplementation.h \
+	$$PWD/sensorImplementations/nullTouchSensorImplementation.h \
+	$$PWD/sensorImplementations/nullSonarSensorImplementation.h \
+	$$PWD/sensorImplementations/nullColorSensorImplementation.h \
+	$$PWD/sensorImplementations/nullEncoderImplementation.h \
+	$$PWD/sensorImplementations/unrealSensorImplementation.h \
+	$$PWD/sensorImplementations/unrealTouchSensorImplementation.h \
+	$$PWD/sensorImplementations/unrealSonarSensorImplementation.h \
+	$$PWD/sensorImplementations/unrealColorSensorImplementation.h \
+	$$PWD/sensorImplementations/unrealEncoderImplementation.h \
+	$$PWD/motorImplementations/abstractMotorImplementation.h \
+	$$PWD/motorImplementations/realMotorImplementation.h \
+	$$PWD/motorImplementations/nullMotorImplementation.h \
+	$$PWD/motorImplementations/unrealMotorImplementation.h \
+	$$PWD/brickImplementations/abstractBrickImplementation.h \
+	$$PWD/brickImplementations/realBrickImplementation.h \
+	$$PWD/brickImplementations/nullBrickImplementation.h \
+	$$PWD/brickImplementations/unrealBrickImplementation.h \
+	$$PWD/abstractRobotModelImplementation.h \
+	$$PWD/realRobotModelImplementation.h \
+	$$PWD/nullRobotModelImplementation.h \
+	$$PWD/unrealRobotModelImplementation.h \
+	$$PWD/replayRobotModelImplementation.h \
+	$$PWD/sensorImplementations/replaySensorImplementation.h \
+	$$PWD/sensorImplementations/replayEncoderImplementation.h \
+	$$PWD/sensorsConfigurer.h \
+	$$PWD/sensorImplementations/bluetoothLightSensorImplementation.h \
+	$$PWD/sensorImplementations/nullLightSensorImplementation.h \
+	$$PWD/sensorImplementations/unrealLightSensorImplementation.h \
+	$$PWD/sensorImplementations/bluetoothSoundSensorImplementation.h \
+	$$PWD/sensorImplementations/bluetoothSensorImplementation.h \
+	$$PWD/sensorImplementations/bluetoothAccelerometerSensorImplementation.h \
+	$$PWD/sensorImplementations/bluetoothGyroscopeSensorImplementation.h \
+	$$PWD/sensorImplementations/nullSoundSensorImplementation.h \
+	$$PWD/sensorImplementations/unrealSoundSensorImplementation.h \
+	$$PWD/sensorImplementations/unrealGyroscopeSensorImplementation.h \
+	$$PWD/sensorImplementations/nullAccelerometerSensorImplementation.h \
+	$$PWD/sensorImplementations/unrealAccelerometerSensorImplementation.h \
+	$$PWD/displayImplementations/abstractDisplayImplementation.h \
+	$$PWD/displayImplementations/realDisplayImplementation.h \
+	$$PWD/displayImplementations/unrealDisplayImplementation.h \
+	$$PWD/displayImplementations/nullDisplayImplementation.h \
+	$$PWD/sensorImplementations/nullGyroscopeSensorImplementation.h \
 
 SOURCES += \
-	details/robotImplementations/sensorImplementations/abstractSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/abstractEncoderImplementation.cpp \
-	details/robotImplementations/sensorImplementations/bluetoothSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/bluetoothTouchSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/bluetoothSonarSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/bluetoothColorSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/bluetoothEncoderImplementation.cpp \
-	details/robotImplementations/sensorImplementations/nullSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/nullTouchSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/nullSonarSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/nullColorSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/nullEncoderImplementation.cpp \
-	details/robotImplementations/sensorImplementations/unrealSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/unrealTouchSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/unrealSonarSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/unrealColorSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/unrealEncoderImplementation.cpp \
-	details/robotImplementations/motorImplementations/abstractMotorImplementation.cpp \
-	details/robotImplementations/motorImplementations/realMotorImplementation.cpp \
-	details/robotImplementations/motorImplementations/nullMotorImplementation.cpp \
-	details/robotImplementations/motorImplementations/unrealMotorImplementation.cpp \
-	details/robotImplementations/brickImplementations/abstractBrickImplementation.cpp \
-	details/robotImplementations/brickImplementations/realBrickImplementation.cpp \
-	details/robotImplementations/brickImplementations/nullBrickImplementation.cpp \
-	details/robotImplementations/brickImplementations/unrealBrickImplementation.cpp \
-	details/robotImplementations/abstractRobotModelImplementation.cpp \
-	details/robotImplementations/realRobotModelImplementation.cpp \
-	details/robotImplementations/nullRobotModelImplementation.cpp \
-	details/robotImplementations/unrealRobotModelImplementation.cpp \
-	details/robotImplementations/sensorsConfigurer.cpp \
-	details/robotImplementations/sensorImplementations/bluetoothLightSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/nullLightSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/unrealLightSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/bluetoothSoundSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/bluetoothAccelerometerSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/bluetoothGyroscopeSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/nullSoundSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/unrealSoundSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/unrealGyroscopeSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/nullAccelerometerSensorImplementation.cpp \
-	details/robotImplementations/sensorImplementations/unrealAccelerometerSensorImplementation.cpp \
-	details/robotImplementations/displayImplementations/abstractDisplayImplementation.cpp \
-	details/robotImplementations/displayImplementations/realDisplayImplementation.cpp \
-	details/robotImplementations/displayImplementations/unrealDisplayImplementation.cpp \
-	details/robotImplementations/displayImplementations/nullDisplayImplementation.cpp \
-	details/robotImplementations/sensorImplementations/nullGyroscopeSensorImplementation.cpp \
+	$$PWD/sensorImplementations/abstractSensorImplementation.cpp \
+	$$PWD/sensorImplementations/abstractEncoderImplementation.cpp \
+	$$PWD/sensorImplementations/bluetoothSensorImplementation.cpp \
+	$$PWD/sensorImplementations/bluetoothTouchSensorImplementation.cpp \
+	$$PWD/sensorImplementations/bluetoothSonarSensorImplementation.cpp \
+	$$PWD/sensorImplementations/bluetoothColorSensorImplementation.cpp \
+	$$PWD/sensorImplementations/bluetoothEncoderImplementation.cpp \
+	$$PWD/sensorImplementations/nullSensorImplementation.cpp \
+	$$PWD/sensorImplementations/nullTouchSensorImplementation.cpp \
+	$$PWD/sensorImplementations/nullSonarSensorImplementation.cpp \
+	$$PWD/sensorImplementations/nullColorSensorImplementation.cpp \
+	$$PWD/sensorImplementations/nullEncoderImplementation.cpp \
+	$$PWD/sensorImplementations/unrealSensorImplementation.cpp \
+	$$PWD/sensorImplementations/unrealTouchSensorImplementation.cpp \
+	$$PWD/sensorImplementations/unrealSonarSensorImplementation.cpp \
+	$$PWD/sensorImplementations/unrealColorSensorImplementation.cpp \
+	$$PWD/sensorImplementations/unrealEncoderImplementation.cpp \
+	$$PWD/motorImplementations/abstractMotorImplementation.cpp \
+	$$PWD/motorImplementations/realMotorImplementation.cpp \
+	$$PWD/motorImplementations/nullMotorImplementation.cpp \
+	$$PWD/motorImplementations/unrealMotorImplementation.cpp \
+	$$PWD/brickImplementations/abstractBrickImplementation.cpp \
+	$$PWD/brickImplementations/realBrickImplementation.cpp \
+	$$PWD/brickImplementations/nullBrickImplementation.cpp \
+	$$PWD/brickImplementations/unrealBrickImplementation.cpp \
+	$$PWD/abstractRobotModelImplementation.cpp \
+	$$PWD/realRobotModelImplementation.cpp \
+	$$PWD/nullRobotModelImplementation.cpp \
+	$$PWD/unrealRobotModelImplementation.cpp \
+	$$PWD/replayRobotModelImplementation.cpp \
+	$$PWD/sensorImplementations/replaySensorImplementation.cpp \
+	$$PWD/sensorImplementations/replayEncoderImplementation.cpp \
+	$$PWD/sensorsConfigurer.cpp \
+	$$PWD/sensorImplementations/bluetoothLightSensorImplementation.cpp \
+	$$PWD/sensorImplementations/nullLightSensorImplementation.cpp \
+	$$PWD/sensorImplementations/unrealLightSensorImplementation.cpp \
+	$$PWD/sensorImplementations/bluetoothSoundSensorImplementation.cpp \
+	$$PWD/sensorImplementations/bluetoothAccelerometerSensorImplementation.cpp \
+	$$PWD/sensorImplementations/bluetoothGyroscopeSensorImplementation.cpp \
+	$$PWD/sensorImplementations/nullSoundSensorImplementation.cpp \
+	$$PWD/sensorImplementations/unrealSoundSensorImplementation.cpp \
+	$$PWD/sensorImplementations/unrealGyroscopeSensorImplementation.cpp \
+	$$PWD/sensorImplementations/nullAccelerometerSensorImplementation.cpp \
+	$$PWD/sensorImplementations/unrealAccelerometerSensorImplementation.cpp \
+	$$PWD/displayImplementations/abstractDisplayImplementation.cpp \
+	$$PWD/displayImplementations/realDisplayImplementation.cpp \
+	$$PWD/displayImplementations/unrealDisplayImplementation.cpp \
+	$$PWD/displayImplementations/nullDisplayImplementation.cpp \
+	$$PWD/sensorImplementations/nullGyroscopeSensorImplementation.cpp \
@@ -0,0 +1,22 @@
+#include "replayEncoderImplementation.h"
+
+using namespace qReal::interpreters::robots;
+using namespace details::robotImplementations::sensorImplementations;
+
+ReplayEncoderImplementation::ReplayEncoderImplementation(enums::outputPort::OutputPortEnum const &port)
+	: AbstractEncoderImplementation(port)
+{
+}
+
+void ReplayEncoderImplementation::read()
+{
+}
+
+void ReplayEncoderImplementation::nullificate()
+{
+}
+
+void ReplayEncoderImplementation::replay(int reading)
+{
+	emit response(reading);
+}
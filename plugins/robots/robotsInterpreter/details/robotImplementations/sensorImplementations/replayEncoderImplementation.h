@@ -0,0 +1,32 @@
+#pragma once
+
+#include "abstractEncoderImplementation.h"
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+namespace robotImplementations {
+namespace sensorImplementations {
+
+/// Encoder which gives readings taken from a trace of a recorded run, see ReplayRunner.
+class ReplayEncoderImplementation : public AbstractEncoderImplementation
+{
+	Q_OBJECT
+
+public:
+	ReplayEncoderImplementation(enums::outputPort::OutputPortEnum const &port);
+
+	virtual void read();
+	virtual void nullificate();
+
+	/// Gives a recorded reading to those who listen to the encoder.
+	void replay(int reading);
+};
+
+}
+}
+}
+}
+}
+}
@@ -0,0 +1,28 @@
+#include "replaySensorImplementation.h"
+
+using namespace qReal::interpreters::robots;
+using namespace details::robotImplementations::sensorImplementations;
+
+ReplaySensorImplementation::ReplaySensorImplementation(robots::enums::inputPort::InputPortEnum const port
+		, robots::enums::sensorType::SensorTypeEnum const &sensorType)
+	: AbstractSensorImplementation(port, sensorType)
+{
+}
+
+void ReplaySensorImplementation::read()
+{
+}
+
+void ReplaySensorImplementation::configure()
+{
+	emit configured();
+}
+
+void ReplaySensorImplementation::nullify()
+{
+}
+
+void ReplaySensorImplementation::replay(int reading)
+{
+	emit response(reading);
+}
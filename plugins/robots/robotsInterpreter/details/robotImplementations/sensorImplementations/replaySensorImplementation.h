@@ -0,0 +1,37 @@
+#pragma once
+
+#include "abstractSensorImplementation.h"
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+namespace robotImplementations {
+namespace sensorImplementations {
+
+/// Sensor of any type which gives readings taken from a trace of a recorded run, see ReplayRunner.
+/// Reading requests are ignored: readings come when the recorded ones came.
+class ReplaySensorImplementation : public AbstractSensorImplementation
+{
+	Q_OBJECT
+
+public:
+	ReplaySensorImplementation(robots::enums::inputPort::InputPortEnum const port
+			, robots::enums::sensorType::SensorTypeEnum const &sensorType);
+
+	virtual void read();
+	virtual void configure();
+
+	/// Does nothing, a nullified reading is recorded in a trace as any other.
+	virtual void nullify();
+
+	/// Gives a recorded reading to those who listen to the sensor.
+	void replay(int reading);
+};
+
+}
+}
+}
+}
+}
+}
@@ -7,8 +7,11 @@ using namespace details;
 using namespace details::robotImplementations;
 using namespace details::d2Model;
 
+int const connectionDelay = 500;
+
 UnrealRobotModelImplementation::UnrealRobotModelImplementation(D2RobotModel *d2RobotModel)
 	: AbstractRobotModelImplementation()
+	, mActiveWaitingTimer(d2RobotModel->timeline()->produceTimer())
 	, mD2Model(d2RobotModel)
 	, mBrick(d2RobotModel)
 	, mMotorA(0, d2RobotModel)
@@ -19,15 +22,14 @@ UnrealRobotModelImplementation::UnrealRobotModelImplementation(D2RobotModel *d2R
 	, mEncoderB(enums::outputPort::port2, d2RobotModel)
 	, mEncoderC(enums::outputPort::port3, d2RobotModel)
 {
-	mActiveWaitingTimer.setInterval(500);
-	mActiveWaitingTimer.setSingleShot(true);
-	connect(&mActiveWaitingTimer, SIGNAL(timeout()), this, SLOT(timerTimeout()));
+	connect(mActiveWaitingTimer, SIGNAL(timeout()), this, SLOT(timerTimeout()));
 	connect(&mSensorsConfigurer, SIGNAL(allSensorsConfigured()), this, SLOT(sensorConfigurationDoneSlot()));
 	mDisplay.attachToPaintWidget();
 }
 
  UnrealRobotModelImplementation::~UnrealRobotModelImplementation()
 {
+	delete mActiveWaitingTimer;
 	delete mD2Model;
 }
 
@@ -133,7 +135,7 @@ void UnrealRobotModelImplementation::addAccelerometerSensor(robots::enums::input
 void UnrealRobotModelImplementation::init()
 {
 	AbstractRobotModelImplementation::init();
-	mActiveWaitingTimer.start();
+	mActiveWaitingTimer->start(connectionDelay);
 	mD2Model->startInit();
 }
 
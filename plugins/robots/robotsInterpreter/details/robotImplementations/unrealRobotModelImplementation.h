@@ -1,5 +1,4 @@
 #pragma once
-#include <QtCore/QTimer>
 #include "abstractRobotModelImplementation.h"
 #include "brickImplementations/unrealBrickImplementation.h"
 #include "motorImplementations/unrealMotorImplementation.h"
@@ -78,7 +77,8 @@ private slots:
 	void sensorConfigurationDoneSlot();
 
 private:
-	QTimer mActiveWaitingTimer;
+	/// Imitates connection delay by the time of 2D model.
+	AbstractTimer * const mActiveWaitingTimer;  // Has ownership
 	d2Model::D2RobotModel *mD2Model;
 	brickImplementations::UnrealBrickImplementation mBrick;
 	motorImplementations::UnrealMotorImplementation mMotorA;
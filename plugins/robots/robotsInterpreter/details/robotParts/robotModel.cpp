@@ -8,6 +8,7 @@ using namespace robotImplementations;
 
 RobotModel::RobotModel()
 	: mRobotImpl(new NullRobotModelImplementation)
+	, mTimeline(nullptr)
 	, mBrick(&mRobotImpl->brick())
 	, mDisplay(&mRobotImpl->display())
 	, mMotorA(0, &mRobotImpl->motorA())
@@ -286,5 +287,10 @@ void RobotModel::nextBlockAfterInitial(bool success)
 
 TimelineInterface *RobotModel::timeline()
 {
-	return mRobotImpl->timeline();
+	return mTimeline ? mTimeline : mRobotImpl->timeline();
+}
+
+void RobotModel::setTimeline(TimelineInterface *timeline)
+{
+	mTimeline = timeline;
 }
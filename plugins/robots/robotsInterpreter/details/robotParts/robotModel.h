@@ -85,6 +85,10 @@ public:
 
 	TimelineInterface *timeline();
 
+	/// Makes timeline() return given timeline instead of the timeline of robot implementation, so timers of blocks
+	/// created meanwhile may be watched. Null restores the timeline of robot implementation.
+	void setTimeline(TimelineInterface *timeline);
+
 signals:
 	void sensorsConfigured();
 	void connected(bool success);
@@ -100,6 +104,7 @@ private slots:
 
 private:
 	robotImplementations::AbstractRobotModelImplementation *mRobotImpl;  // Has ownership.
+	TimelineInterface *mTimeline;  // Doesn't have ownership.
 	robotParts::Brick mBrick;
 	robotParts::Display mDisplay;
 	robotParts::Motor mMotorA;
@@ -1,29 +1,29 @@
 HEADERS += \
-	details/robotParts/robotModel.h \
-	details/robotParts/brick.h \
-	details/robotParts/motor.h \
-	details/robotParts/sensor.h \
-	details/robotParts/touchSensor.h \
-	details/robotParts/sonarSensor.h \
-	details/robotParts/colorSensor.h \
-	details/robotParts/encoderSensor.h \
-	details/robotParts/lightSensor.h \
-	details/robotParts/soundSensor.h \
-	details/robotParts/gyroscopeSensor.h \
-	details/robotParts/accelerometerSensor.h \
-	details/robotParts/display.h \
+	$$PWD/robotModel.h \
+	$$PWD/brick.h \
+	$$PWD/motor.h \
+	$$PWD/sensor.h \
+	$$PWD/touchSensor.h \
+	$$PWD/sonarSensor.h \
+	$$PWD/colorSensor.h \
+	$$PWD/encoderSensor.h \
+	$$PWD/lightSensor.h \
+	$$PWD/soundSensor.h \
+	$$PWD/gyroscopeSensor.h \
+	$$PWD/accelerometerSensor.h \
+	$$PWD/display.h \
 
 SOURCES += \
-	details/robotParts/robotModel.cpp \
-	details/robotParts/touchSensor.cpp \
-	details/robotParts/sonarSensor.cpp \
-	details/robotParts/colorSensor.cpp \
-	details/robotParts/encoderSensor.cpp \
-	details/robotParts/sensor.cpp \
-	details/robotParts/motor.cpp \
-	details/robotParts/brick.cpp \
-	details/robotParts/lightSensor.cpp \
-	details/robotParts/soundSensor.cpp \
-	details/robotParts/gyroscopeSensor.cpp \
-	details/robotParts/accelerometerSensor.cpp \
-	details/robotParts/display.cpp \
+	$$PWD/robotModel.cpp \
+	$$PWD/touchSensor.cpp \
+	$$PWD/sonarSensor.cpp \
+	$$PWD/colorSensor.cpp \
+	$$PWD/encoderSensor.cpp \
+	$$PWD/sensor.cpp \
+	$$PWD/motor.cpp \
+	$$PWD/brick.cpp \
+	$$PWD/lightSensor.cpp \
+	$$PWD/soundSensor.cpp \
+	$$PWD/gyroscopeSensor.cpp \
+	$$PWD/accelerometerSensor.cpp \
+	$$PWD/display.cpp \
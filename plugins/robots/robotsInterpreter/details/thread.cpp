@@ -141,6 +141,7 @@ void Thread::turnOn(blocks::Block * const block)
 	connect(mCurrentBlock, SIGNAL(stepInto(Id const &)), this, SLOT(stepInto(Id const &)));
 
 	mStack.push(mCurrentBlock);
+	emit blockStarted(mCurrentBlock->id());
 
 	++mBlocksSincePreviousEventsProcessing;
 	if (mBlocksSincePreviousEventsProcessing > blocksCountTillProcessingEvents) {
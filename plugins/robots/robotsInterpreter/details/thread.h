@@ -40,6 +40,9 @@ signals:
 	void stopped();
 	void newThread(details::blocks::Block * const startBlock);
 
+	/// Emitted when the thread passes control to a block, before the block is interpreted.
+	void blockStarted(Id const &block);
+
 private slots:
 	void nextBlock(blocks::Block * const block);
 
@@ -0,0 +1,111 @@
+#include "traceRecorder.h"
+
+#include "details/recordingTimer.h"
+#include "details/robotParts/robotModel.h"
+
+using namespace qReal;
+using namespace interpreters::robots;
+using namespace interpreters::robots::details;
+
+TraceRecorder::TraceRecorder()
+	: mRobotModel(nullptr)
+	, mTimeline(nullptr)
+	, mIsRecording(false)
+	, mStartTimestamp(0)
+	, mTimersCount(0)
+{
+}
+
+void TraceRecorder::prepare(RobotModel &robotModel)
+{
+	stop(false);
+	mRobotModel = &robotModel;
+	mTimeline = robotModel.timeline();
+	mTimersCount = 0;
+	robotModel.setTimeline(this);
+}
+
+void TraceRecorder::start(Id const &diagram)
+{
+	mTrace.clear();
+	mTrace.setDiagram(diagram);
+	mSources.clear();
+	for (int port = 0; port < 4; ++port) {
+		robots::enums::inputPort::InputPortEnum const inputPort
+				= static_cast<robots::enums::inputPort::InputPortEnum>(port);
+		robotParts::Sensor * const sensor = mRobotModel->sensor(inputPort);
+		if (sensor) {
+			mTrace.setSensorType(inputPort, sensor->sensorImpl()->type());
+			mSources[sensor->sensorImpl()] = port;
+		}
+	}
+
+	mSources[mRobotModel->encoderA().encoderImpl()] = TraceEvent::encoderA;
+	mSources[mRobotModel->encoderB().encoderImpl()] = TraceEvent::encoderB;
+	mSources[mRobotModel->encoderC().encoderImpl()] = TraceEvent::encoderC;
+	foreach (QObject * const source, mSources.keys()) {
+		connect(source, SIGNAL(response(int)), this, SLOT(sensorResponse(int)), Qt::UniqueConnection);
+	}
+
+	mStartTimestamp = mTimeline->timestamp();
+	mIsRecording = true;
+}
+
+void TraceRecorder::stop(bool finished)
+{
+	if (mIsRecording) {
+		mIsRecording = false;
+		mTrace.setFinished(finished);
+	}
+
+	if (mRobotModel) {
+		mRobotModel->setTimeline(nullptr);
+	}
+}
+
+bool TraceRecorder::isRecording() const
+{
+	return mIsRecording;
+}
+
+InterpreterTrace const &TraceRecorder::trace() const
+{
+	return mTrace;
+}
+
+quint64 TraceRecorder::timestamp() const
+{
+	return mTimeline->timestamp();
+}
+
+AbstractTimer *TraceRecorder::produceTimer()
+{
+	return new RecordingTimer(mTimeline->produceTimer(), *this, mTimersCount++);
+}
+
+void TraceRecorder::timerTimeout(int timer)
+{
+	if (mIsRecording) {
+		mTrace.addTimerTimeout(time(), timer);
+	}
+}
+
+void TraceRecorder::blockStarted(Id const &block)
+{
+	if (mIsRecording) {
+		mTrace.addBlockStarted(time(), block);
+	}
+}
+
+void TraceRecorder::sensorResponse(int reading)
+{
+	// Sources of previous runs stay connected, but they are not in the table anymore.
+	if (mIsRecording && mSources.contains(sender())) {
+		mTrace.addSensorResponse(time(), mSources[sender()], reading);
+	}
+}
+
+quint64 TraceRecorder::time() const
+{
+	return mTimeline->timestamp() - mStartTimestamp;
+}
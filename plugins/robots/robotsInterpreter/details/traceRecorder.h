@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QHash>
+
+#include <qrkernel/ids.h>
+
+#include "details/timelineInterface.h"
+#include "details/interpreterTrace.h"
+
+namespace qReal {
+namespace interpreters {
+namespace robots {
+namespace details {
+
+class RobotModel;
+
+/// Records a run of a program into InterpreterTrace: readings of sensors and encoders, timeouts of timers of
+/// robot model and blocks passed by threads. The recorder stands between the robot model and its timeline,
+/// so timers of blocks are produced by it.
+class TraceRecorder : public QObject, public TimelineInterface
+{
+	Q_OBJECT
+
+public:
+	TraceRecorder();
+
+	/// Puts the recorder between given robot model and its timeline. Must be called before blocks
+	/// of a program are created.
+	void prepare(RobotModel &robotModel);
+
+	/// Starts a trace of a program that starts now. Sensors of the model must be configured.
+	void start(Id const &diagram);
+
+	/// Stops recording if it was started and gives the robot model its timeline back.
+	/// @param finished - true if the program stopped by itself.
+	void stop(bool finished);
+
+	bool isRecording() const;
+
+	/// The last recorded trace.
+	InterpreterTrace const &trace() const;
+
+	/// Returns time of the timeline of robot model.
+	quint64 timestamp() const override;
+
+	/// Produces a timer of robot model, timeouts of which are recorded.
+	AbstractTimer *produceTimer() override;
+
+	/// Records timeout of a timer produced by the recorder.
+	void timerTimeout(int timer);
+
+public slots:
+	/// Records that a thread has passed control to a block.
+	void blockStarted(Id const &block);
+
+private slots:
+	void sensorResponse(int reading);
+
+private:
+	quint64 time() const;
+
+	RobotModel *mRobotModel;  // Doesn't have ownership
+	TimelineInterface *mTimeline;  // Doesn't have ownership
+	bool mIsRecording;
+	quint64 mStartTimestamp;
+	int mTimersCount;
+	InterpreterTrace mTrace;
+
+	/// Sensor and encoder implementations listened by the recorder with their numbers in the trace.
+	QHash<QObject *, int> mSources;
+};
+
+}
+}
+}
+}
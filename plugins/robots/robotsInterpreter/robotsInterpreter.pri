@@ -0,0 +1,90 @@
+QT += xml widgets network
+
+CONFIG += c++11
+
+INCLUDEPATH += \
+	$$PWD \
+	$$PWD/../../.. \
+	$$PWD/../../../qrgui \
+
+LIBS += -L$$PWD/../../../bin -lqrkernel -lqrutils -lqextserialport
+
+HEADERS += \
+	$$PWD/sensorConstants.h \
+	$$PWD/details/interpreter.h \
+	$$PWD/details/thread.h \
+	$$PWD/details/blocksFactory.h \
+	$$PWD/details/blocksTable.h \
+	$$PWD/details/robotCommandConstants.h \
+	$$PWD/details/robotsBlockParser.h \
+	$$PWD/details/autoconfigurer.h \
+	$$PWD/details/tracer.h \
+	$$PWD/details/debugHelper.h \
+	$$PWD/details/timelineInterface.h \
+	$$PWD/details/realTimeline.h \
+	$$PWD/details/abstractTimer.h \
+	$$PWD/details/realTimer.h \
+	$$PWD/details/sensorsConfigurationManager.h \
+	$$PWD/details/sensorsConfigurationProvider.h \
+	$$PWD/details/sensorsConfigurationWidget.h \
+	$$PWD/details/nullTimer.h \
+	$$PWD/details/nxtDisplay.h \
+	$$PWD/details/textExpressionProcessor.h \
+	$$PWD/details/headlessRunner.h \
+	$$PWD/details/batchRunner.h \
+	$$PWD/details/headlessInterpretersInterface.h \
+	$$PWD/details/interpreterTrace.h \
+	$$PWD/details/traceRecorder.h \
+	$$PWD/details/recordingTimer.h \
+	$$PWD/details/replayTimer.h \
+	$$PWD/details/replayTimeline.h \
+	$$PWD/details/replayRunner.h \
+	$$PWD/details/interpretationDriver.h \
+
+SOURCES += \
+	$$PWD/sensorConstants.cpp \
+	$$PWD/details/abstractTimer.cpp \
+	$$PWD/details/autoconfigurer.cpp \
+	$$PWD/details/blocksTable.cpp \
+	$$PWD/details/blocksFactory.cpp \
+	$$PWD/details/debugHelper.cpp \
+	$$PWD/details/interpreter.cpp \
+	$$PWD/details/nullTimer.cpp \
+	$$PWD/details/nxtDisplay.cpp \
+	$$PWD/details/realTimeline.cpp \
+	$$PWD/details/realTimer.cpp \
+	$$PWD/details/robotsBlockParser.cpp \
+	$$PWD/details/sensorsConfigurationManager.cpp \
+	$$PWD/details/sensorsConfigurationProvider.cpp \
+	$$PWD/details/sensorsConfigurationWidget.cpp \
+	$$PWD/details/thread.cpp \
+	$$PWD/details/tracer.cpp \
+	$$PWD/details/textExpressionProcessor.cpp \
+	$$PWD/details/headlessRunner.cpp \
+	$$PWD/details/headlessInterpretersInterface.cpp \
+	$$PWD/details/batchRunner.cpp \
+	$$PWD/details/interpreterTrace.cpp \
+	$$PWD/details/traceRecorder.cpp \
+	$$PWD/details/recordingTimer.cpp \
+	$$PWD/details/replayTimer.cpp \
+	$$PWD/details/replayTimeline.cpp \
+	$$PWD/details/replayRunner.cpp \
+	$$PWD/details/interpretationDriver.cpp \
+
+FORMS += \
+	$$PWD/details/d2RobotModel/d2Form.ui \
+	$$PWD/details/sensorsConfigurationWidget.ui \
+	$$PWD/details/nxtDisplay.ui \
+
+RESOURCES += \
+	$$PWD/robotsInterpreter.qrc \
+
+include($$PWD/details/robotCommunication/robotCommunication.pri)
+
+include($$PWD/details/d2RobotModel/d2RobotModel.pri)
+
+include($$PWD/details/blocks/blocks.pri)
+
+include($$PWD/details/robotImplementations/robotImplementations.pri)
+
+include($$PWD/details/robotParts/robotParts.pri)
@@ -21,6 +21,8 @@ RobotsPlugin::RobotsPlugin()
 		, mRobotSettingsAction(nullptr)
 		, mTitlesAction(nullptr)
 		, mAppTranslator(new QTranslator())
+		, mGraphicalModelApi(nullptr)
+		, mLogicalModelApi(nullptr)
 {
 	details::Tracer::debug(details::tracer::enums::initialization, "RobotsPlugin::RobotsPlugin", "Plugin constructor");
 	mAppTranslator->load(":/robotsInterpreter_" + QLocale::system().name());
@@ -142,6 +144,8 @@ void RobotsPlugin::init(PluginConfigurator const &configurator)
 			, configurator.projectManager());
 	mMainWindowInterpretersInterface = &configurator.mainWindowInterpretersInterface();
 	mSceneCustomizer = &configurator.sceneCustomizer();
+	mGraphicalModelApi = &configurator.graphicalModelApi();
+	mLogicalModelApi = &configurator.logicalModelApi();
 	SettingsManager::setValue("IndexGrid", gridWidth);
 	mCustomizer.placeSensorsConfig(produceSensorsConfigurer());
 	mCustomizer.placeWatchPlugins(mInterpreter->watchWindow(), mInterpreter->graphicsWatchWindow());
@@ -155,6 +159,17 @@ void RobotsPlugin::init(PluginConfigurator const &configurator)
 	connect(systemEvents, SIGNAL(activeTabChanged(Id)), this, SLOT(activeTabChanged(Id)));
 	connect(systemEvents, SIGNAL(closedMainWindow()), this, SLOT(closeNeededWidget()));
 
+	if (details::BatchRunner::isRequested(QApplication::arguments())) {
+		// Queued, so the batch is run when the main window is ready and the event loop is running.
+		connect(&configurator.projectManager(), SIGNAL(afterOpen(QString)), this, SLOT(runBatch())
+				, Qt::QueuedConnection);
+	} else if (details::ReplayRunner::isRequested(QApplication::arguments())) {
+		connect(&configurator.projectManager(), SIGNAL(afterOpen(QString)), this, SLOT(runReplay())
+				, Qt::QueuedConnection);
+	}
+
+	mInterpreter->setTraceFile(details::ReplayRunner::recordedTraceFile(QApplication::arguments()));
+
 	updateEnabledActions();
 	details::Tracer::debug(details::tracer::enums::initialization, "RobotsPlugin::init", "Initializing done");
 }
@@ -238,6 +253,18 @@ void RobotsPlugin::activeTabChanged(Id const &rootElementId)
 	mInterpreter->onTabChanged(rootElementId, enabled);
 }
 
+void RobotsPlugin::runBatch()
+{
+	details::BatchRunner runner(*mGraphicalModelApi, *mLogicalModelApi);
+	QApplication::exit(runner.runFromCommandLine(QApplication::arguments()));
+}
+
+void RobotsPlugin::runReplay()
+{
+	details::ReplayRunner runner(*mGraphicalModelApi, *mLogicalModelApi);
+	QApplication::exit(runner.runFromCommandLine(QApplication::arguments()));
+}
+
 interpreters::robots::details::SensorsConfigurationWidget *RobotsPlugin::produceSensorsConfigurer()
 {
 	interpreters::robots::details::SensorsConfigurationWidget *result =
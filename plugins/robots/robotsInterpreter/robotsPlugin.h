@@ -12,6 +12,8 @@
 #include "details/sensorsConfigurationWidget.h"
 #include "details/sensorsConfigurationManager.h"
 #include "details/nxtDisplay.h"
+#include "details/batchRunner.h"
+#include "details/replayRunner.h"
 
 namespace qReal {
 namespace interpreters {
@@ -48,6 +50,12 @@ private slots:
 	/// a diagram which is not related to a plugin.
 	void activeTabChanged(Id const &rootElementId);
 
+	/// Runs a batch of 2D model experiments requested in the command line and quits.
+	void runBatch();
+
+	/// Replays a recorded run of a program requested in the command line and quits.
+	void runReplay();
+
 private:
 	/// Initializes and connects actions, fills action info list
 	void initActions();
@@ -116,6 +124,9 @@ private:
 
 	SceneCustomizationInterface *mSceneCustomizer;  // Does not have ownership
 
+	GraphicalModelAssistInterface *mGraphicalModelApi;  // Does not have ownership
+	LogicalModelAssistInterface *mLogicalModelApi;  // Does not have ownership
+
 	details::SensorsConfigurationManager mSensorsConfigurationManager;
 };
 
@@ -0,0 +1,33 @@
+#include "changePositionsCommand.h"
+
+using namespace qReal::commands;
+
+ChangePositionsCommand::ChangePositionsCommand(LogicalModelAssistInterface &logicalModel
+		, GraphicalModelAssistInterface &graphicalModel, QHash<Id, QPointF> const &positions)
+	: TransactionCommand(logicalModel, graphicalModel)
+	, mGraphicalModel(graphicalModel)
+	, mNewPositions(positions)
+{
+	foreach (Id const &id, positions.keys()) {
+		mOldPositions[id] = mGraphicalModel.position(id);
+	}
+}
+
+bool ChangePositionsCommand::execute()
+{
+	setPositions(mNewPositions);
+	return true;
+}
+
+bool ChangePositionsCommand::restoreState()
+{
+	setPositions(mOldPositions);
+	return true;
+}
+
+void ChangePositionsCommand::setPositions(QHash<Id, QPointF> const &positions)
+{
+	for (QHash<Id, QPointF>::const_iterator it = positions.constBegin(); it != positions.constEnd(); ++it) {
+		mGraphicalModel.setPosition(it.key(), it.value());
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QPointF>
+
+#include "controller/commands/transactionCommand.h"
+
+namespace qReal {
+namespace commands {
+
+/// Moves a number of elements in graphical model at once, for example, after automatic arrangement of
+/// a diagram. Views are notified about all moves together and undoing returns elements to their old places.
+class ChangePositionsCommand : public TransactionCommand
+{
+public:
+	/// @param positions - new positions of elements by their graphical ids.
+	ChangePositionsCommand(LogicalModelAssistInterface &logicalModel, GraphicalModelAssistInterface &graphicalModel
+			, QHash<Id, QPointF> const &positions);
+
+protected:
+	virtual bool execute();
+	virtual bool restoreState();
+
+private:
+	void setPositions(QHash<Id, QPointF> const &positions);
+
+	GraphicalModelAssistInterface &mGraphicalModel;
+	QHash<Id, QPointF> mOldPositions;
+	QHash<Id, QPointF> const mNewPositions;
+};
+
+}
+}
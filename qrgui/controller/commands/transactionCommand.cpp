@@ -0,0 +1,50 @@
+#include "transactionCommand.h"
+
+using namespace qReal::commands;
+
+TransactionCommand::TransactionCommand(LogicalModelAssistInterface &logicalModel
+		, GraphicalModelAssistInterface &graphicalModel)
+	: mLogicalModel(logicalModel)
+	, mGraphicalModel(graphicalModel)
+{
+}
+
+void TransactionCommand::redo()
+{
+	beginTransaction();
+	AbstractCommand::redo();
+	commitTransaction();
+}
+
+void TransactionCommand::undo()
+{
+	beginTransaction();
+	AbstractCommand::undo();
+	commitTransaction();
+}
+
+bool TransactionCommand::execute()
+{
+	// Execution happens in child commands
+	return true;
+}
+
+bool TransactionCommand::restoreState()
+{
+	// Restoration happens in child commands
+	return true;
+}
+
+void TransactionCommand::beginTransaction()
+{
+	mLogicalModel.beginTransaction();
+	mGraphicalModel.beginTransaction();
+}
+
+void TransactionCommand::commitTransaction()
+{
+	// Logical model goes first: views of the graphical model are notified about names of logical elements
+	// through it, so these notifications are coalesced too.
+	mLogicalModel.commitTransaction();
+	mGraphicalModel.commitTransaction();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "controller/commands/abstractCommand.h"
+#include "toolPluginInterface/usedInterfaces/logicalModelAssistInterface.h"
+#include "toolPluginInterface/usedInterfaces/graphicalModelAssistInterface.h"
+
+namespace qReal {
+namespace commands {
+
+/// A "container" command which executes and undoes its pre- and post-actions within one transaction
+/// of logical and graphical models. Views are notified about every changed element once, after all
+/// actions are done, and the whole group is a single step on an undo stack.
+class TransactionCommand : public AbstractCommand
+{
+public:
+	TransactionCommand(LogicalModelAssistInterface &logicalModel, GraphicalModelAssistInterface &graphicalModel);
+
+	virtual void redo();
+	virtual void undo();
+
+protected:
+	virtual bool execute();
+	virtual bool restoreState();
+
+private:
+	void beginTransaction();
+	void commitTransaction();
+
+	LogicalModelAssistInterface &mLogicalModel;
+	GraphicalModelAssistInterface &mGraphicalModel;
+};
+
+}
+}
@@ -20,6 +20,8 @@ HEADERS += \
 	$$PWD/commands/renameCommand.h \
 	$$PWD/commands/explosionCommand.h \
 	$$PWD/commands/renameExplosionCommand.h \
+	$$PWD/commands/transactionCommand.h \
+	$$PWD/commands/changePositionsCommand.h \
 
 SOURCES += \
 	$$PWD/controller.cpp \
@@ -43,3 +45,5 @@ SOURCES += \
 	$$PWD/commands/renameCommand.cpp \
 	$$PWD/commands/explosionCommand.cpp \
 	$$PWD/commands/renameExplosionCommand.cpp \
+	$$PWD/commands/transactionCommand.cpp \
+	$$PWD/commands/changePositionsCommand.cpp \
@@ -117,6 +117,8 @@ void PreferencesEditorPage::save()
 	SettingsManager::setValue("LineType", mUi->lineMode->currentIndex() - 1);
 	SettingsManager::setValue("LoopEdgeBoundsIndent", mUi->loopEdgeBoundsIndent->value());
 	SettingsManager::setValue("zoomFactor", mUi->zoomFactorSlider->value());
+	SettingsManager::setValue("SimplifiedDrawingZoom", mUi->simplifiedDrawingZoomSpinBox->value());
+	SettingsManager::setValue("MinimalDetailSize", mUi->minimalDetailSizeSpinBox->value());
 	SettingsManager::setValue("ShowGrid", mUi->showGridCheckBox->isChecked());
 	SettingsManager::setValue("ShowAlignment", mUi->showAlignmentCheckBox->isChecked());
 	SettingsManager::setValue("ActivateGrid", mUi->activateGridCheckBox->isChecked());
@@ -161,6 +163,8 @@ void PreferencesEditorPage::restoreSettings()
 	mUi->embeddedLinkerIndentSlider->setValue(SettingsManager::value("EmbeddedLinkerIndent").toInt());
 	mUi->embeddedLinkerSizeSlider->setValue(SettingsManager::value("EmbeddedLinkerSize").toInt());
 	mUi->zoomFactorSlider->setValue(SettingsManager::value("zoomFactor").toInt());
+	mUi->simplifiedDrawingZoomSpinBox->setValue(SettingsManager::value("SimplifiedDrawingZoom").toInt());
+	mUi->minimalDetailSizeSpinBox->setValue(SettingsManager::value("MinimalDetailSize").toInt());
 	mUi->loopEdgeBoundsIndent->setValue(SettingsManager::value("LoopEdgeBoundsIndent").toInt());
 
 	mUi->enableMoveLabelsCheckBox->setChecked(SettingsManager::value("MoveLabels").toBool());
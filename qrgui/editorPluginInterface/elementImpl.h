@@ -22,6 +22,7 @@ enum LinkShape
 	, broken
 	, square
 	, curve
+	, routed
 };
 }
 }
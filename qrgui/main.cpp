@@ -33,6 +33,12 @@ int main(int argc, char *argv[])
 	}
 
 	QString fileToOpen;
+	bool const readOnly = app.arguments().contains("--read-only");
+	if (readOnly) {
+		// Settings changed by the session, imported ones included, are not stored.
+		SettingsManager::instance()->setReadOnly(true);
+	}
+
 	if (app.arguments().count() > 1) {
 		if (app.arguments().contains("--clear-conf")) {
 			clearConfig();
@@ -56,7 +62,7 @@ int main(int argc, char *argv[])
 	app.setStyle(new WindowsModernStyle());
 #endif
 
-	MainWindow window(fileToOpen);
+	MainWindow window(fileToOpen, readOnly);
 	int exitCode = 0; // The window decided to not show itself, exiting now.
 
 	if (window.isVisible()) {
@@ -1,13 +1,23 @@
 #include "findManager.h"
 
+#include "controller/commands/transactionCommand.h"
+#include "controller/commands/renameCommand.h"
+#include "controller/commands/changePropertyCommand.h"
+
 FindManager::FindManager(qrRepo::RepoControlInterface &controlApi
 		, qrRepo::LogicalRepoApi &logicalApi
+		, qReal::models::LogicalModelAssistApi &logicalModelApi
+		, qReal::models::GraphicalModelAssistApi &graphicalModelApi
+		, qReal::Controller &controller
 		, qReal::gui::MainWindowInterpretersInterface *mainWindow
 		, FindReplaceDialog *findReplaceDialog
 		, QObject *parent)
 	: QObject(parent)
 	, mControlApi(controlApi)
 	, mLogicalApi(logicalApi)
+	, mLogicalModelApi(logicalModelApi)
+	, mGraphicalModelApi(graphicalModelApi)
+	, mController(controller)
 	, mFindReplaceDialog(findReplaceDialog)
 	, mMainWindow(mainWindow)
 {
@@ -62,21 +72,64 @@ void FindManager::handleFindDialog(QStringList const &searchData)
 	mFindReplaceDialog->initIds(findItems(searchData));
 }
 
+qReal::IdList FindManager::logicalIds(qReal::IdList const &found) const
+{
+	qReal::IdList result;
+	foreach (qReal::Id const &id, found) {
+		qReal::Id const logicalId = mLogicalModelApi.isLogicalId(id) ? id : mGraphicalModelApi.logicalId(id);
+		if (!logicalId.isNull() && !result.contains(logicalId)) {
+			result << logicalId;
+		}
+	}
+
+	return result;
+}
+
 void FindManager::handleReplaceDialog(QStringList &searchData)
 {
+	qReal::commands::TransactionCommand * const replaceCommand
+			= new qReal::commands::TransactionCommand(mLogicalModelApi, mGraphicalModelApi);
+	bool replaced = false;
+
 	if (searchData.contains(tr("by name"))) {
-		qReal::IdList toRename = foundByMode(searchData.first(), tr("by name")
+		qReal::IdList toRename = logicalIds(foundByMode(searchData.first(), tr("by name")
 				, searchData.contains(tr("case sensitivity"))
-				, searchData.contains(tr("by regular expression")));
+				, searchData.contains(tr("by regular expression"))));
 		foreach (qReal::Id currentId, toRename) {
-			mLogicalApi.setName(currentId, searchData[1]);
+			replaceCommand->addPostAction(new qReal::commands::RenameCommand(mLogicalModelApi
+					, currentId, searchData[1]));
+			replaced = true;
 		}
 	}
 
 	if (searchData.contains(tr("by property content"))) {
-		qReal::IdList toRename = foundByMode(searchData.first(), tr("by property content")
+		qReal::IdList toRename = logicalIds(foundByMode(searchData.first(), tr("by property content")
 				, searchData.contains(tr("case sensitivity"))
-				, searchData.contains(tr("by regular expression")));
-		mLogicalApi.replaceProperties(toRename, searchData[0], searchData[1]);
+				, searchData.contains(tr("by regular expression"))));
+		foreach (qReal::Id currentId, toRename) {
+			QMapIterator<QString, QVariant> properties = mLogicalApi.propertiesIterator(currentId);
+			while (properties.hasNext()) {
+				properties.next();
+				if (!properties.value().toString().contains(searchData[0])) {
+					continue;
+				}
+
+				if (properties.key() == "name") {
+					replaceCommand->addPostAction(new qReal::commands::RenameCommand(mLogicalModelApi
+							, currentId, searchData[1]));
+				} else {
+					replaceCommand->addPostAction(new qReal::commands::ChangePropertyCommand(&mLogicalModelApi
+							, properties.key(), currentId, searchData[1]));
+				}
+
+				replaced = true;
+			}
+		}
+	}
+
+	if (replaced) {
+		mController.executeGlobal(replaceCommand);
+	} else {
+		delete replaceCommand;
 	}
 }
@@ -4,6 +4,8 @@
 
 #include "mainwindow/mainWindowInterpretersInterface.h"
 #include "models/logicalModelAssistApi.h"
+#include "models/graphicalModelAssistApi.h"
+#include "controller/controller.h"
 #include "dialogs/findReplaceDialog.h"
 
 class MainWindowInterpretersInterface;
@@ -15,6 +17,9 @@ class FindManager : public QObject
 public:
 	explicit FindManager(qrRepo::RepoControlInterface &controlApi
 			, qrRepo::LogicalRepoApi &logicalApi
+			, qReal::models::LogicalModelAssistApi &logicalModelApi
+			, qReal::models::GraphicalModelAssistApi &graphicalModelApi
+			, qReal::Controller &controller
 			, qReal::gui::MainWindowInterpretersInterface *mainWindow
 			, FindReplaceDialog *findReplaceDialog
 			, QObject *paresnt = 0);
@@ -28,7 +33,8 @@ public slots:
 	/// @param id - id of element that was chosen to show and highlight
 	void handleRefsDialog(qReal::Id const &id);
 
-	/// handler for find & replace dialog 'button replace' pressed
+	/// handler for find & replace dialog 'button replace' pressed, all replacements are done
+	/// as one command, so elements are redrawn once and the replace is undone in one step
 	/// @param searchData - data was input to find & replace
 	void handleReplaceDialog(QStringList &searchData);
 
@@ -42,10 +48,17 @@ private:
 	/// @param searchData - name and search modes
 	QMap<QString, QString> findItems(QStringList const &searchData);
 
+	/// Returns logical ids of found elements, graphical elements are replaced with their logical ones
+	qReal::IdList logicalIds(qReal::IdList const &found) const;
+
 	qrRepo::RepoControlInterface &mControlApi;
 
 	qrRepo::LogicalRepoApi &mLogicalApi;
 
+	qReal::models::LogicalModelAssistApi &mLogicalModelApi;
+	qReal::models::GraphicalModelAssistApi &mGraphicalModelApi;
+	qReal::Controller &mController;
+
 	/// mFindDialog - Dialog for searching elements.
 	FindReplaceDialog *mFindReplaceDialog;
 
@@ -0,0 +1,133 @@
+#include "forceDirectedLayout.h"
+
+#include <cmath>
+
+#include <QtCore/QHash>
+
+using namespace qReal::layout;
+
+namespace {
+
+/// Distance below which nodes are considered coinciding.
+qreal const minimalDistance = 0.01;
+
+/// Share of the size of the initial layout a node may move by in the first iteration.
+qreal const initialTemperatureShare = 0.1;
+
+qreal length(QPointF const &vector)
+{
+	return std::sqrt(vector.x() * vector.x() + vector.y() * vector.y());
+}
+
+}
+
+ForceDirectedLayout::ForceDirectedLayout(int iterations, qreal nodeSpacing)
+	: mIterations(iterations)
+	, mNodeSpacing(nodeSpacing)
+{
+}
+
+QVector<QPointF> ForceDirectedLayout::arrange(LayoutGraph const &graph) const
+{
+	int const nodesCount = graph.sizes.size();
+	if (nodesCount == 0) {
+		return QVector<QPointF>();
+	}
+
+	QVector<QPointF> centres;
+	qreal averageSize = 0;
+	QPointF topLeft = graph.positions.value(0);
+	QPointF bottomRight = topLeft;
+	for (int node = 0; node < nodesCount; ++node) {
+		QSizeF const &size = graph.sizes[node];
+		centres << graph.positions.value(node) + QPointF(size.width() / 2, size.height() / 2);
+		averageSize += qMax(size.width(), size.height());
+		topLeft = QPointF(qMin(topLeft.x(), centres.last().x()), qMin(topLeft.y(), centres.last().y()));
+		bottomRight = QPointF(qMax(bottomRight.x(), centres.last().x()), qMax(bottomRight.y(), centres.last().y()));
+	}
+
+	qreal const idealDistance = averageSize / nodesCount + mNodeSpacing;
+	QPointF const extent = bottomRight - topLeft;
+	qreal const initialTemperature = qMax(idealDistance, initialTemperatureShare * qMax(extent.x(), extent.y()));
+
+	for (int iteration = 0; iteration < mIterations; ++iteration) {
+		QVector<QPointF> displacements(nodesCount);
+		addRepulsion(centres, idealDistance, displacements);
+
+		foreach (Edge const &edge, graph.edges) {
+			if (edge.first == edge.second) {
+				continue;
+			}
+
+			QPointF const delta = centres[edge.second] - centres[edge.first];
+			qreal const distance = qMax(length(delta), minimalDistance);
+			QPointF const attraction = delta * (distance / idealDistance);
+			displacements[edge.first] += attraction;
+			displacements[edge.second] -= attraction;
+		}
+
+		qreal const temperature = initialTemperature * (mIterations - iteration) / mIterations;
+		for (int node = 0; node < nodesCount; ++node) {
+			qreal const displacement = length(displacements[node]);
+			if (displacement > 0) {
+				centres[node] += displacements[node] * (qMin(displacement, temperature) / displacement);
+			}
+		}
+	}
+
+	QVector<QPointF> result;
+	for (int node = 0; node < nodesCount; ++node) {
+		result << centres[node] - QPointF(graph.sizes[node].width() / 2, graph.sizes[node].height() / 2);
+	}
+
+	return result;
+}
+
+void ForceDirectedLayout::addRepulsion(QVector<QPointF> const &centres, qreal idealDistance
+		, QVector<QPointF> &displacements)
+{
+	// Pushing is ignored beyond two ideal distances, so only nodes of neighbouring cells push each other.
+	qreal const cellSize = 2 * idealDistance;
+	QHash<QPair<int, int>, QVector<int> > cells;
+	QVector<QPair<int, int> > cellOf;
+	for (int node = 0; node < centres.size(); ++node) {
+		cellOf << qMakePair(static_cast<int>(std::floor(centres[node].x() / cellSize))
+				, static_cast<int>(std::floor(centres[node].y() / cellSize)));
+		cells[cellOf.last()] << node;
+	}
+
+	for (int node = 0; node < centres.size(); ++node) {
+		for (int dx = -1; dx <= 1; ++dx) {
+			for (int dy = -1; dy <= 1; ++dy) {
+				auto const cell = cells.constFind(qMakePair(cellOf[node].first + dx, cellOf[node].second + dy));
+				if (cell == cells.constEnd()) {
+					continue;
+				}
+
+				foreach (int const other, cell.value()) {
+					// Every pair is processed once, by its node with the smaller number.
+					if (other <= node) {
+						continue;
+					}
+
+					QPointF delta = centres[node] - centres[other];
+					qreal distance = length(delta);
+					if (distance >= cellSize) {
+						continue;
+					}
+
+					if (distance < minimalDistance) {
+						// Coinciding nodes are pushed apart in a direction depending on their numbers.
+						delta = QPointF(std::cos(static_cast<qreal>(other)), std::sin(static_cast<qreal>(other)))
+								* minimalDistance;
+						distance = minimalDistance;
+					}
+
+					QPointF const repulsion = delta * (idealDistance * idealDistance / (distance * distance));
+					displacements[node] += repulsion;
+					displacements[other] -= repulsion;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "mainwindow/layout/graphLayout.h"
+
+namespace qReal {
+namespace layout {
+
+/// Fruchterman-Reingold layout: edges pull nodes together, all nodes push each other apart, and moves
+/// are limited by a temperature falling with each iteration. Nodes push only ones in neighbouring cells
+/// of a grid, so an iteration takes linear time. Starts from current positions of nodes, so it may be used
+/// to tidy up an existing diagram.
+class ForceDirectedLayout : public GraphLayout
+{
+public:
+	/// @param iterations - the number of moves of all nodes.
+	/// @param nodeSpacing - desired gap between connected nodes.
+	explicit ForceDirectedLayout(int iterations = 100, qreal nodeSpacing = 40);
+
+	// Override.
+	virtual QVector<QPointF> arrange(LayoutGraph const &graph) const;
+
+private:
+	/// Adds forces pushing close nodes apart to given displacements.
+	/// @param idealDistance - distance at which pushing and pulling of connected nodes are equal.
+	static void addRepulsion(QVector<QPointF> const &centres, qreal idealDistance
+			, QVector<QPointF> &displacements);
+
+	int const mIterations;
+	qreal const mNodeSpacing;
+};
+
+}
+}
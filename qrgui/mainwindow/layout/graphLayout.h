@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QtCore/QPair>
+#include <QtCore/QPointF>
+#include <QtCore/QSizeF>
+#include <QtCore/QVector>
+
+namespace qReal {
+namespace layout {
+
+/// An edge of a graph to be laid out, numbers of its source and destination nodes.
+typedef QPair<int, int> Edge;
+
+/// A graph to be laid out, nodes are numbered from 0.
+struct LayoutGraph
+{
+	/// Sizes of nodes.
+	QVector<QSizeF> sizes;
+
+	/// Current positions of top left corners of nodes.
+	QVector<QPointF> positions;
+
+	QVector<Edge> edges;
+};
+
+/// Algorithm of automatic arrangement of nodes of a graph.
+class GraphLayout
+{
+public:
+	virtual ~GraphLayout() {}
+
+	/// Returns new positions of top left corners of nodes of given graph, in the order of nodes.
+	/// Only relative placement of nodes is meaningful, the result may be translated as a whole.
+	virtual QVector<QPointF> arrange(LayoutGraph const &graph) const = 0;
+};
+
+}
+}
@@ -0,0 +1,332 @@
+#include "layeredLayout.h"
+
+#include <algorithm>
+
+using namespace qReal::layout;
+
+namespace {
+
+/// The number of pairs of down and up sweeps reordering layers.
+int const crossingReductionSweeps = 4;
+
+/// The number of pairs of down and up passes pulling nodes towards their neighbours.
+int const placementPasses = 4;
+
+/// States of nodes during depth-first search.
+enum VisitState
+{
+	unvisited = 0
+	, onStack
+	, finished
+};
+
+/// Returns the mean of coordinates of given neighbours, defaultValue if there are none.
+qreal barycenter(QVector<int> const &neighbours, QVector<qreal> const &coordinates, qreal defaultValue)
+{
+	if (neighbours.isEmpty()) {
+		return defaultValue;
+	}
+
+	qreal sum = 0;
+	foreach (int const neighbour, neighbours) {
+		sum += coordinates[neighbour];
+	}
+
+	return sum / neighbours.size();
+}
+
+/// Sorts nodes of a layer by barycenters of their neighbours and renumbers them.
+/// @param indices - indices of nodes in their layers, updated for the sorted layer.
+void sortByBarycenters(QVector<int> &layer, QVector<QVector<int> > const &neighbours, QVector<qreal> &indices)
+{
+	QVector<QPair<qreal, int> > keys;
+	foreach (int const node, layer) {
+		keys << qMakePair(barycenter(neighbours[node], indices, indices[node]), node);
+	}
+
+	std::stable_sort(keys.begin(), keys.end(), [](QPair<qreal, int> const &a, QPair<qreal, int> const &b) {
+		return a.first < b.first;
+	});
+
+	for (int i = 0; i < keys.size(); ++i) {
+		layer[i] = keys[i].second;
+		indices[layer[i]] = i;
+	}
+}
+
+/// Returns coordinates closest to desired ones in the least squares sense, such that every next coordinate
+/// is at least a gap greater than the previous one. It is the isotonic regression of desired coordinates
+/// shifted by accumulated gaps, solved by pooling adjacent violators.
+/// @param gaps - minimal distances from each coordinate to the next one.
+QVector<qreal> closestSeparated(QVector<qreal> const &desired, QVector<qreal> const &gaps)
+{
+	int const count = desired.size();
+	QVector<qreal> offsets(count, 0);
+	for (int i = 1; i < count; ++i) {
+		offsets[i] = offsets[i - 1] + gaps[i - 1];
+	}
+
+	// Blocks of neighbouring coordinates moved together: means of their shifted coordinates and sizes.
+	QVector<qreal> means;
+	QVector<int> sizes;
+	for (int i = 0; i < count; ++i) {
+		means << desired[i] - offsets[i];
+		sizes << 1;
+		while (means.size() > 1 && means[means.size() - 2] > means.last()) {
+			int const last = means.size() - 1;
+			means[last - 1] = (means[last - 1] * sizes[last - 1] + means[last] * sizes[last])
+					/ (sizes[last - 1] + sizes[last]);
+			sizes[last - 1] += sizes[last];
+			means.removeLast();
+			sizes.removeLast();
+		}
+	}
+
+	QVector<qreal> result;
+	for (int block = 0; block < means.size(); ++block) {
+		for (int i = 0; i < sizes[block]; ++i) {
+			result << means[block] + offsets[result.size()];
+		}
+	}
+
+	return result;
+}
+
+}
+
+LayeredLayout::LayeredLayout(Direction direction, qreal nodeSpacing, qreal layerSpacing)
+	: mDirection(direction)
+	, mNodeSpacing(nodeSpacing)
+	, mLayerSpacing(layerSpacing)
+{
+}
+
+QVector<QPointF> LayeredLayout::arrange(LayoutGraph const &graph) const
+{
+	int const nodesCount = graph.sizes.size();
+	bool const isVertical = mDirection == topToBottom || mDirection == bottomToTop;
+
+	QVector<Edge> edges;
+	foreach (Edge const &edge, graph.edges) {
+		if (edge.first != edge.second) {
+			edges << edge;
+		}
+	}
+
+	QVector<int> layerOf = layers(nodesCount, edges);
+
+	// Sizes of nodes along layers and across them.
+	QVector<qreal> extents;
+	QVector<qreal> depths;
+	foreach (QSizeF const &size, graph.sizes) {
+		extents << (isVertical ? size.width() : size.height());
+		depths << (isVertical ? size.height() : size.width());
+	}
+
+	// Neighbours of nodes in previous and next layers. Edges going through several layers are split
+	// by dummy nodes of zero size, one per layer, so every edge connects neighbouring layers.
+	QVector<QVector<int> > upper(nodesCount);
+	QVector<QVector<int> > lower(nodesCount);
+	int layersCount = 0;
+	foreach (Edge const &edge, edges) {
+		int previous = edge.first;
+		for (int layer = layerOf[edge.first] + 1; layer < layerOf[edge.second]; ++layer) {
+			int const dummy = layerOf.size();
+			layerOf << layer;
+			extents << 0;
+			depths << 0;
+			upper << (QVector<int>() << previous);
+			lower << QVector<int>();
+			lower[previous] << dummy;
+			previous = dummy;
+		}
+
+		lower[previous] << edge.second;
+		upper[edge.second] << previous;
+	}
+
+	foreach (int const layer, layerOf) {
+		layersCount = qMax(layersCount, layer + 1);
+	}
+
+	QVector<QVector<int> > ordered(layersCount);
+	for (int node = 0; node < layerOf.size(); ++node) {
+		ordered[layerOf[node]] << node;
+	}
+
+	reduceCrossings(ordered, upper, lower);
+	QVector<qreal> const alongLayers = placeInLayers(ordered, upper, lower, extents);
+
+	QVector<qreal> layerStarts(layersCount, 0);
+	QVector<qreal> layerDepths(layersCount, 0);
+	for (int node = 0; node < layerOf.size(); ++node) {
+		layerDepths[layerOf[node]] = qMax(layerDepths[layerOf[node]], depths[node]);
+	}
+
+	for (int layer = 1; layer < layersCount; ++layer) {
+		layerStarts[layer] = layerStarts[layer - 1] + layerDepths[layer - 1] + mLayerSpacing;
+	}
+
+	bool const isReversed = mDirection == bottomToTop || mDirection == rightToLeft;
+	QVector<QPointF> result;
+	for (int node = 0; node < nodesCount; ++node) {
+		qreal const layerCentre = layerStarts[layerOf[node]] + layerDepths[layerOf[node]] / 2;
+		qreal const across = isReversed ? -layerCentre : layerCentre;
+		QPointF const centre = isVertical ? QPointF(alongLayers[node], across) : QPointF(across, alongLayers[node]);
+		result << centre - QPointF(graph.sizes[node].width() / 2, graph.sizes[node].height() / 2);
+	}
+
+	return result;
+}
+
+QVector<int> LayeredLayout::layers(int nodesCount, QVector<Edge> &edges)
+{
+	QVector<QVector<int> > outgoing(nodesCount);
+	QVector<int> inDegrees(nodesCount, 0);
+	for (int i = 0; i < edges.size(); ++i) {
+		outgoing[edges[i].first] << i;
+		++inDegrees[edges[i].second];
+	}
+
+	// Depth-first search starts from sources, so edges keep their direction where possible. Edges leading
+	// to nodes on the stack close cycles and are reversed.
+	QVector<int> roots;
+	for (int node = 0; node < nodesCount; ++node) {
+		if (inDegrees[node] == 0) {
+			roots << node;
+		}
+	}
+
+	for (int node = 0; node < nodesCount; ++node) {
+		roots << node;
+	}
+
+	QVector<char> states(nodesCount, unvisited);
+	QVector<bool> reversed(edges.size(), false);
+	QVector<QPair<int, int> > stack;
+	foreach (int const root, roots) {
+		if (states[root] != unvisited) {
+			continue;
+		}
+
+		states[root] = onStack;
+		stack << qMakePair(root, 0);
+		while (!stack.isEmpty()) {
+			int const node = stack.last().first;
+			int const next = stack.last().second;
+			if (next == outgoing[node].size()) {
+				states[node] = finished;
+				stack.removeLast();
+				continue;
+			}
+
+			++stack.last().second;
+			int const edge = outgoing[node][next];
+			int const target = edges[edge].second;
+			if (states[target] == onStack) {
+				reversed[edge] = true;
+			} else if (states[target] == unvisited) {
+				states[target] = onStack;
+				stack << qMakePair(target, 0);
+			}
+		}
+	}
+
+	for (int node = 0; node < nodesCount; ++node) {
+		outgoing[node].clear();
+		inDegrees[node] = 0;
+	}
+
+	for (int i = 0; i < edges.size(); ++i) {
+		if (reversed[i]) {
+			std::swap(edges[i].first, edges[i].second);
+		}
+
+		outgoing[edges[i].first] << i;
+		++inDegrees[edges[i].second];
+	}
+
+	// Longest path layering in topological order.
+	QVector<int> result(nodesCount, 0);
+	QVector<int> queue;
+	for (int node = 0; node < nodesCount; ++node) {
+		if (inDegrees[node] == 0) {
+			queue << node;
+		}
+	}
+
+	for (int i = 0; i < queue.size(); ++i) {
+		int const node = queue[i];
+		foreach (int const edge, outgoing[node]) {
+			int const target = edges[edge].second;
+			result[target] = qMax(result[target], result[node] + 1);
+			if (--inDegrees[target] == 0) {
+				queue << target;
+			}
+		}
+	}
+
+	return result;
+}
+
+void LayeredLayout::reduceCrossings(QVector<QVector<int> > &ordered, QVector<QVector<int> > const &upper
+		, QVector<QVector<int> > const &lower)
+{
+	QVector<qreal> indices(upper.size(), 0);
+	foreach (QVector<int> const &layer, ordered) {
+		for (int i = 0; i < layer.size(); ++i) {
+			indices[layer[i]] = i;
+		}
+	}
+
+	for (int sweep = 0; sweep < crossingReductionSweeps; ++sweep) {
+		for (int layer = 1; layer < ordered.size(); ++layer) {
+			sortByBarycenters(ordered[layer], upper, indices);
+		}
+
+		for (int layer = ordered.size() - 2; layer >= 0; --layer) {
+			sortByBarycenters(ordered[layer], lower, indices);
+		}
+	}
+}
+
+QVector<qreal> LayeredLayout::placeInLayers(QVector<QVector<int> > const &ordered
+		, QVector<QVector<int> > const &upper, QVector<QVector<int> > const &lower
+		, QVector<qreal> const &extents) const
+{
+	QVector<qreal> result(extents.size(), 0);
+	QVector<QVector<qreal> > gaps;
+	foreach (QVector<int> const &layer, ordered) {
+		QVector<qreal> layerGaps;
+		for (int i = 1; i < layer.size(); ++i) {
+			layerGaps << (extents[layer[i - 1]] + extents[layer[i]]) / 2 + mNodeSpacing;
+			result[layer[i]] = result[layer[i - 1]] + layerGaps.last();
+		}
+
+		gaps << layerGaps;
+	}
+
+	auto align = [&](int layer, QVector<QVector<int> > const &neighbours) {
+		QVector<qreal> desired;
+		foreach (int const node, ordered[layer]) {
+			desired << barycenter(neighbours[node], result, result[node]);
+		}
+
+		QVector<qreal> const aligned = closestSeparated(desired, gaps[layer]);
+		for (int i = 0; i < aligned.size(); ++i) {
+			result[ordered[layer][i]] = aligned[i];
+		}
+	};
+
+	for (int pass = 0; pass < placementPasses; ++pass) {
+		for (int layer = 1; layer < ordered.size(); ++layer) {
+			align(layer, upper);
+		}
+
+		for (int layer = ordered.size() - 2; layer >= 0; --layer) {
+			align(layer, lower);
+		}
+	}
+
+	return result;
+}
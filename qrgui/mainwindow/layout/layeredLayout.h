@@ -0,0 +1,52 @@
+#pragma once
+
+#include "mainwindow/layout/graphLayout.h"
+
+namespace qReal {
+namespace layout {
+
+/// Sugiyama-style layout placing nodes in layers so that edges go in one direction. Cycles are broken
+/// by reversing edges found by depth-first search, nodes are assigned to layers by the longest path
+/// from sources, long edges are split by dummy nodes, crossings are reduced by barycenter sweeps and
+/// nodes are pulled towards their neighbours within the order of a layer.
+class LayeredLayout : public GraphLayout
+{
+public:
+	/// Direction edges go in.
+	enum Direction
+	{
+		topToBottom = 0
+		, bottomToTop
+		, leftToRight
+		, rightToLeft
+	};
+
+	/// @param nodeSpacing - minimal gap between neighbouring nodes of a layer.
+	/// @param layerSpacing - gap between layers.
+	explicit LayeredLayout(Direction direction = topToBottom, qreal nodeSpacing = 40, qreal layerSpacing = 80);
+
+	// Override.
+	virtual QVector<QPointF> arrange(LayoutGraph const &graph) const;
+
+private:
+	/// Returns numbers of layers of nodes, so every edge goes from a lower layer to a higher one after
+	/// edges closing cycles are reversed.
+	/// @param edges - edges without loops, reversed ones are turned in place.
+	static QVector<int> layers(int nodesCount, QVector<Edge> &edges);
+
+	/// Orders nodes of every layer so neighbours of a node are placed close to it.
+	/// @param ordered - nodes of every layer, reordered in place.
+	static void reduceCrossings(QVector<QVector<int> > &ordered, QVector<QVector<int> > const &upper
+			, QVector<QVector<int> > const &lower);
+
+	/// Assigns coordinates of centres of nodes along layers, keeping their order and gaps between them.
+	QVector<qreal> placeInLayers(QVector<QVector<int> > const &ordered, QVector<QVector<int> > const &upper
+			, QVector<QVector<int> > const &lower, QVector<qreal> const &extents) const;
+
+	Direction const mDirection;
+	qreal const mNodeSpacing;
+	qreal const mLayerSpacing;
+};
+
+}
+}
@@ -0,0 +1,126 @@
+#include "layoutEngine.h"
+
+#include "mainwindow/layout/layeredLayout.h"
+#include "mainwindow/layout/forceDirectedLayout.h"
+#include "controller/commands/changePositionsCommand.h"
+#include "pluginManager/editorManagerInterface.h"
+
+using namespace qReal;
+using namespace qReal::layout;
+
+namespace {
+
+/// Size of nodes without stored configuration.
+QSizeF const defaultNodeSize(50, 50);
+
+}
+
+LayoutEngine::LayoutEngine(models::LogicalModelAssistApi &logicalModel
+		, models::GraphicalModelAssistApi &graphicalModel)
+	: mLogicalModel(logicalModel)
+	, mGraphicalModel(graphicalModel)
+{
+}
+
+GraphLayout *LayoutEngine::layout(QString const &name)
+{
+	if (name == "TB") {
+		return new LayeredLayout(LayeredLayout::topToBottom);
+	} else if (name == "BT") {
+		return new LayeredLayout(LayeredLayout::bottomToTop);
+	} else if (name == "LR") {
+		return new LayeredLayout(LayeredLayout::leftToRight);
+	} else if (name == "RL") {
+		return new LayeredLayout(LayeredLayout::rightToLeft);
+	} else if (name == "force") {
+		return new ForceDirectedLayout();
+	}
+
+	return nullptr;
+}
+
+LayoutGraph LayoutEngine::graph(Id const &diagram, IdList &nodes) const
+{
+	LayoutGraph result;
+	QHash<Id, int> outermost;
+	nodes.clear();
+	foreach (Id const &child, mGraphicalModel.children(diagram)) {
+		if (!isNode(child)) {
+			continue;
+		}
+
+		QRect const configuration = mGraphicalModel.configuration(child).boundingRect();
+		result.sizes << (configuration.isEmpty() ? defaultNodeSize : QSizeF(configuration.size()));
+		result.positions << mGraphicalModel.position(child);
+		mapDescendants(child, nodes.size(), outermost);
+		nodes << child;
+	}
+
+	IdList links;
+	collectLinks(diagram, links);
+	foreach (Id const &link, links) {
+		int const from = outermost.value(mGraphicalModel.from(link), -1);
+		int const to = outermost.value(mGraphicalModel.to(link), -1);
+		if (from != -1 && to != -1) {
+			result.edges << qMakePair(from, to);
+		}
+	}
+
+	return result;
+}
+
+commands::AbstractCommand *LayoutEngine::arrange(Id const &diagram, GraphLayout const &layout) const
+{
+	IdList nodes;
+	LayoutGraph const layoutGraph = graph(diagram, nodes);
+	if (nodes.isEmpty()) {
+		return nullptr;
+	}
+
+	QVector<QPointF> const arranged = layout.arrange(layoutGraph);
+	QPointF oldTopLeft = layoutGraph.positions.first();
+	QPointF newTopLeft = arranged.first();
+	for (int i = 1; i < nodes.size(); ++i) {
+		oldTopLeft = QPointF(qMin(oldTopLeft.x(), layoutGraph.positions[i].x())
+				, qMin(oldTopLeft.y(), layoutGraph.positions[i].y()));
+		newTopLeft = QPointF(qMin(newTopLeft.x(), arranged[i].x()), qMin(newTopLeft.y(), arranged[i].y()));
+	}
+
+	QHash<Id, QPointF> positions;
+	for (int i = 0; i < nodes.size(); ++i) {
+		QPointF const position = arranged[i] - newTopLeft + oldTopLeft;
+		if (position != layoutGraph.positions[i]) {
+			positions[nodes[i]] = position;
+		}
+	}
+
+	if (positions.isEmpty()) {
+		return nullptr;
+	}
+
+	return new commands::ChangePositionsCommand(mLogicalModel, mGraphicalModel, positions);
+}
+
+void LayoutEngine::mapDescendants(Id const &element, int node, QHash<Id, int> &outermost) const
+{
+	outermost[element] = node;
+	foreach (Id const &child, mGraphicalModel.children(element)) {
+		mapDescendants(child, node, outermost);
+	}
+}
+
+void LayoutEngine::collectLinks(Id const &element, IdList &links) const
+{
+	foreach (Id const &child, mGraphicalModel.children(element)) {
+		if (isNode(child)) {
+			collectLinks(child, links);
+		} else {
+			links << child;
+		}
+	}
+}
+
+bool LayoutEngine::isNode(Id const &element) const
+{
+	return mGraphicalModel.editorManagerInterface().isGraphicalElementNode(element);
+}
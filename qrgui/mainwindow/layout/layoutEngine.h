@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QtCore/QString>
+
+#include <qrkernel/ids.h>
+
+#include "mainwindow/layout/graphLayout.h"
+#include "models/graphicalModelAssistApi.h"
+#include "models/logicalModelAssistApi.h"
+#include "controller/commands/abstractCommand.h"
+
+namespace qReal {
+namespace layout {
+
+/// Arranges elements of diagrams in graphical model with in-process layout algorithms. Only nodes lying
+/// directly on a diagram are placed, nested nodes move with their containers, and links of nested nodes
+/// are considered links of their outermost containers.
+class LayoutEngine
+{
+public:
+	LayoutEngine(models::LogicalModelAssistApi &logicalModel, models::GraphicalModelAssistApi &graphicalModel);
+
+	/// Returns a layout by its name: "TB", "BT", "LR" or "RL" for layered layouts with edges going
+	/// top-bottom, bottom-top, left-right or right-left, "force" for force-directed one.
+	/// @returns nullptr for unknown names, the caller takes ownership otherwise.
+	static GraphLayout *layout(QString const &name);
+
+	/// Returns the graph of nodes lying on given diagram and links between them.
+	/// @param nodes - graphical ids of nodes of the graph in the order of their numbers.
+	LayoutGraph graph(Id const &diagram, IdList &nodes) const;
+
+	/// Returns a command moving nodes of given diagram to places found by given layout, as one undoable step.
+	/// The arranged diagram keeps its top left corner.
+	/// @returns nullptr if nothing is to be moved, the caller takes ownership otherwise.
+	commands::AbstractCommand *arrange(Id const &diagram, GraphLayout const &layout) const;
+
+private:
+	/// Maps given element and all elements nested into it to given number of an outermost node.
+	void mapDescendants(Id const &element, int node, QHash<Id, int> &outermost) const;
+
+	/// Collects links from given element and elements nested into it.
+	void collectLinks(Id const &element, IdList &links) const;
+
+	bool isNode(Id const &element) const;
+
+	models::LogicalModelAssistApi &mLogicalModel;
+	models::GraphicalModelAssistApi &mGraphicalModel;
+};
+
+}
+}
@@ -13,6 +13,7 @@
 #include <QtWidgets/QListWidgetItem>
 #include <QtCore/QPluginLoader>
 #include <QtCore/QMetaType>
+#include <QtCore/QScopedPointer>
 #include <QtSvg/QSvgGenerator>
 #include <QtWidgets/QAbstractButton>
 #include <QtWidgets/QAction>
@@ -29,6 +30,7 @@
 #include "view/editorView.h"
 #include "hotKeyManager/hotKeyManager.h"
 #include "umllib/element.h"
+#include "umllib/private/levelOfDetail.h"
 #include "pluginManager/listenerManager.h"
 #include "view/sceneCustomizer.h"
 #include "brandManager/brandManager.h"
@@ -41,6 +43,7 @@
 #include "mainwindow/referenceList.h"
 #include "mainwindow/splashScreen.h"
 #include "mainwindow/dotRunner.h"
+#include "mainwindow/layout/layoutEngine.h"
 #include "mainwindow/qscintillaTextEdit.h"
 
 #include "controller/commands/removeElementCommand.h"
@@ -59,7 +62,7 @@ using namespace gui;
 
 QString const unsavedDir = "unsaved";
 
-MainWindow::MainWindow(QString const &fileToOpen)
+MainWindow::MainWindow(QString const &fileToOpen, bool readOnly)
 		: mUi(new Ui::MainWindowUi)
 		, mCodeTabManager(new QMap<EditorView*, QScintillaTextEdit*>())
 		, mModels(nullptr)
@@ -73,7 +76,9 @@ MainWindow::MainWindow(QString const &fileToOpen)
 		, mRootIndex(QModelIndex())
 		, mErrorReporter(nullptr)
 		, mIsFullscreen(false)
-		, mTempDir(qApp->applicationDirPath() + "/" + unsavedDir)
+		, mTempDir(readOnly
+				? QDir::temp().filePath(QString("qreal_%1_%2").arg(unsavedDir).arg(QCoreApplication::applicationPid()))
+				: qApp->applicationDirPath() + "/" + unsavedDir)
 		, mPreferencesDialog(this)
 		, mRecentProjectsLimit(SettingsManager::value("recentProjectsLimit").toInt())
 		, mRecentProjectsMapper(new QSignalMapper())
@@ -81,11 +86,20 @@ MainWindow::MainWindow(QString const &fileToOpen)
 		, mStartWidget(nullptr)
 		, mSceneCustomizer(new SceneCustomizer(this))
 		, mInitialFileToOpen(fileToOpen)
+		, mReadOnly(readOnly)
 {
 	mUi->setupUi(this);
 	mUi->paletteTree->initMainWindow(this);
 	setWindowTitle("QReal");
 	initSettingsManager();
+	if (mReadOnly) {
+		// Settings are not stored in this mode, so these changes last for the session only.
+		SettingsManager::instance()->setReadOnly(true);
+		SettingsManager::setValue("ProjectJournal", false);
+		SettingsManager::setValue("Autosave", false);
+		mProjectManager->setReadOnly(true);
+	}
+
 	registerMetaTypes();
 	SplashScreen splashScreen(SettingsManager::value("Splashscreen").toBool());
 	splashScreen.setVisible(false);
@@ -137,7 +151,9 @@ MainWindow::MainWindow(QString const &fileToOpen)
 	splashScreen.close();
 
 	mFindReplaceDialog = new FindReplaceDialog(mModels->logicalRepoApi(), this);
-	mFindHelper = new FindManager(mModels->repoControlApi(), mModels->mutableLogicalRepoApi(), this, mFindReplaceDialog);
+	mFindHelper = new FindManager(mModels->repoControlApi(), mModels->mutableLogicalRepoApi()
+			, mModels->logicalModelAssistApi(), mModels->graphicalModelAssistApi(), *mController
+			, this, mFindReplaceDialog);
 	mFilterObject = new FilterObject();
 	connectActionsForUXInfo();
 	connectActions();
@@ -293,6 +309,11 @@ MainWindow::~MainWindow()
 	delete mRecentProjectsMenu;
 	delete mRecentProjectsMapper;
 	delete mModels;
+	if (mReadOnly) {
+		// Working directory of the session is emptied by the repository and is not needed by anyone else.
+		QDir().rmdir(mTempDir);
+	}
+
 	delete mController;
 	delete mCodeTabManager;
 	delete mFindReplaceDialog;
@@ -1022,6 +1043,7 @@ void MainWindow::showPreferencesDialog()
 	}
 	connect(&mPreferencesDialog, SIGNAL(usabilityTestingModeChanged(bool)), this, SLOT(setUsabilityMode(bool)));
 	mPreferencesDialog.exec();
+	LevelOfDetail::reloadSettings();
 	mToolManager.updateSettings();
 	mProjectManager->reinitAutosaver();
 }
@@ -1834,6 +1856,7 @@ void MainWindow::finishUsabilityTest()
 
 void MainWindow::applySettings()
 {
+	LevelOfDetail::reloadSettings();
 	for (int i = 0; i < mUi->tabs->count(); i++) {
 		EditorView * const tab = static_cast<EditorView *>(mUi->tabs->widget(i));
 		EditorViewScene *scene = dynamic_cast <EditorViewScene *> (tab->scene());
@@ -2158,6 +2181,21 @@ void MainWindow::arrangeElementsByDotRunner(QString const &algorithm, QString co
 	}
 }
 
+void MainWindow::arrangeElements(QString const &algorithm)
+{
+	Id const diagramId = activeDiagram();
+	QScopedPointer<qReal::layout::GraphLayout> const graphLayout(qReal::layout::LayoutEngine::layout(algorithm));
+	if (diagramId.isNull() || !graphLayout) {
+		return;
+	}
+
+	qReal::layout::LayoutEngine const engine(mModels->logicalModelAssistApi(), mModels->graphicalModelAssistApi());
+	commands::AbstractCommand * const command = engine.arrange(diagramId, *graphLayout);
+	if (command) {
+		mController->execute(command, diagramId);
+	}
+}
+
 IdList MainWindow::selectedElementsOnActiveDiagram()
 {
 	if (!getCurrentTab()) {
@@ -71,7 +71,10 @@ class MainWindow : public QMainWindow
 	Q_OBJECT
 
 public:
-	MainWindow(QString const &fileToOpen = QString());
+	/// @param readOnly - if true, the session writes nothing shared with other sessions: the project is not saved,
+	/// journaled or autosaved, settings are not stored and the model is unpacked into a directory of its own.
+	/// Used by processes started to work with a project opened elsewhere, like workers of batch runs.
+	MainWindow(QString const &fileToOpen = QString(), bool readOnly = false);
 	~MainWindow();
 
 	EditorManagerInterface &editorManager();
@@ -130,6 +133,7 @@ public:
 
 	virtual void saveDiagramAsAPictureToFile(QString const &fileName);
 	virtual void arrangeElementsByDotRunner(QString const &algorithm, QString const &absolutePathToDotFiles);
+	virtual void arrangeElements(QString const &algorithm);
 	virtual IdList selectedElementsOnActiveDiagram();
 	virtual void updateActiveDiagram();
 	virtual void deleteElementFromDiagram(Id const &id);
@@ -421,6 +425,8 @@ private:
 	/// A field for storing file name passed as console argument
 	QString mInitialFileToOpen;
 
+	bool mReadOnly;
+
 	QToolBar *mUsabilityTestingToolbar; // Has ownership
 	QAction *mStartTest; // Has ownership
 	QAction *mFinishTest; // Has ownership
@@ -63,6 +63,11 @@ public:
 	/// @param absolutePathToDotFiles Path to directory DotFiles
 	virtual void arrangeElementsByDotRunner(QString const &algorithm, QString const &absolutePathToDotFiles) = 0;
 
+	/// Automatically arranges elements on active diagram without external tools, as one undoable action.
+	/// @param algorithm "TB", "BT", "LR" or "RL" for layered arrangement with links going top-bottom, bottom-top,
+	/// left-right or right-left, "force" for force-directed arrangement.
+	virtual void arrangeElements(QString const &algorithm) = 0;
+
 	/// returns selected elements on current tab
 	virtual IdList selectedElementsOnActiveDiagram() = 0;
 
@@ -9,6 +9,10 @@ HEADERS += \
 	$$PWD/mainWindowInterpretersInterface.h \
 	$$PWD/findManager.h \
 	$$PWD/dotRunner.h \
+	$$PWD/layout/graphLayout.h \
+	$$PWD/layout/layeredLayout.h \
+	$$PWD/layout/forceDirectedLayout.h \
+	$$PWD/layout/layoutEngine.h \
 	$$PWD/splashScreen.h \
 	$$PWD/tabWidget.h \
 	$$PWD/modelExplorer.h \
@@ -49,6 +53,9 @@ SOURCES += \
 	$$PWD/errorListWidget.cpp \
 	$$PWD/findManager.cpp \
 	$$PWD/dotRunner.cpp \
+	$$PWD/layout/layeredLayout.cpp \
+	$$PWD/layout/forceDirectedLayout.cpp \
+	$$PWD/layout/layoutEngine.cpp \
 	$$PWD/splashScreen.cpp \
 	$$PWD/tabWidget.cpp \
 	$$PWD/miniMap.cpp \
@@ -1,21 +1,55 @@
 #include <QtCore/QFileInfo>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QMessageBox>
 
 #include <qrkernel/settingsManager.h>
+#include <qrkernel/exception/exception.h>
+#include <qrrepo/private/repositorySnapshot.h>
 
 #include "mainwindow/projectManager/projectManager.h"
 #include "mainwindow/projectManager/autosaver.h"
 
 using namespace qReal;
 
+namespace {
+
+/// Writes a snapshot to a file, runs in a worker thread. Returns the duration of the save or -1 on failure.
+qint64 saveSnapshot(QSharedPointer<qrRepo::details::RepositorySnapshot> const &snapshot, QString const &fileName)
+{
+	QElapsedTimer timer;
+	timer.start();
+	try {
+		snapshot->saveTo(fileName);
+	} catch (Exception const &) {
+		return -1;
+	}
+
+	return timer.elapsed();
+}
+
+}
+
 Autosaver::Autosaver(ProjectManager *projectManager)
 	: QObject(projectManager)
 	, mProjectManager(projectManager)
 	, mTimer(new QTimer(this))
+	, mSavingFileDiscarded(false)
+	, mHasUnsavedChanges(true)
+	, mStartGuiStall(0)
+	, mLastSaveDuration(0)
+	, mLastGuiStall(0)
 {
 	connect(mTimer, SIGNAL(timeout()), this, SLOT(saveAutoSave()));
+	connect(&mSaveWatcher, SIGNAL(finished()), this, SLOT(onBackgroundSaveFinished()));
+}
+
+Autosaver::~Autosaver()
+{
+	mSaveWatcher.waitForFinished();
+	finishBackgroundSave();
 }
 
 void Autosaver::reinit()
@@ -115,7 +149,11 @@ bool Autosaver::openAutosave(QString const &fileName)
 
 void Autosaver::saveTemp()
 {
-	mProjectManager->saveTo(tempFilePath());
+	QElapsedTimer stallTimer;
+	stallTimer.start();
+	if (mHasUnsavedChanges) {
+		saveInBackground(tempFilePath(), stallTimer);
+	}
 }
 
 bool Autosaver::checkAutoSavedVersion(QString const &originalProjectPath)
@@ -157,13 +195,105 @@ QString Autosaver::openTempFilePrompt() const
 			"unusial way. Do you wish to recover unsaved project?");
 }
 
+void Autosaver::setUnsavedChanges(bool hasUnsavedChanges)
+{
+	mHasUnsavedChanges = hasUnsavedChanges;
+}
+
+void Autosaver::projectSaved()
+{
+	mHasUnsavedChanges = false;
+	mPendingFile.clear();
+	if (!mSavingFile.isEmpty()) {
+		mSavingFileDiscarded = true;
+	}
+
+	if (mTimer->isActive()) {
+		mTimer->start();
+	}
+}
+
 void Autosaver::saveAutoSave()
 {
-	mProjectManager->saveTo(autosaveFilePath());
+	QElapsedTimer stallTimer;
+	stallTimer.start();
+	if (mHasUnsavedChanges) {
+		saveInBackground(autosaveFilePath(), stallTimer);
+	}
+}
+
+void Autosaver::saveInBackground(QString const &fileName, QElapsedTimer const &stallTimer)
+{
+	if (!mSavingFile.isEmpty()) {
+		// Model state will be captured when the current save finishes, so the latest state is written only once.
+		mPendingFile = fileName;
+		return;
+	}
+
+	QSharedPointer<qrRepo::details::RepositorySnapshot> const snapshot = mProjectManager->snapshot();
+	mSavingFile = fileName;
+	mSavingFileDiscarded = false;
+	mSaveWatcher.setFuture(QtConcurrent::run(saveSnapshot, snapshot, fileName));
+
+	mStartGuiStall = stallTimer.nsecsElapsed() / 1000;
+}
+
+void Autosaver::onBackgroundSaveFinished()
+{
+	finishBackgroundSave();
+
+	if (!mPendingFile.isEmpty()) {
+		QElapsedTimer stallTimer;
+		stallTimer.start();
+		QString const pendingFile = mPendingFile;
+		mPendingFile.clear();
+		saveInBackground(pendingFile, stallTimer);
+	}
+}
+
+void Autosaver::finishBackgroundSave()
+{
+	if (mSavingFile.isEmpty()) {
+		return;
+	}
+
+	QElapsedTimer stallTimer;
+	stallTimer.start();
+
+	QString const savedFile = mSavingFile;
+	mSavingFile.clear();
+	mLastSaveDuration = mSaveWatcher.result();
+
+	if (mSavingFileDiscarded) {
+		QFile::remove(savedFile);
+		mLastSaveDuration = -1;
+	}
+
+	mLastGuiStall = mStartGuiStall + stallTimer.nsecsElapsed() / 1000;
+
+	emit saved(savedFile, mLastSaveDuration, mLastGuiStall);
+}
+
+qint64 Autosaver::lastSaveDuration() const
+{
+	return mLastSaveDuration;
+}
+
+qint64 Autosaver::lastGuiStall() const
+{
+	return mLastGuiStall;
 }
 
 bool Autosaver::removeFile(QString const &fileName)
 {
+	if (mPendingFile == fileName) {
+		mPendingFile.clear();
+	}
+
+	if (mSavingFile == fileName) {
+		mSavingFileDiscarded = true;
+	}
+
 	return QFile::remove(fileName);
 }
 
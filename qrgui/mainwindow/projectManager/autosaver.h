@@ -2,6 +2,8 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFutureWatcher>
 
 namespace qReal {
 
@@ -9,7 +11,12 @@ class ProjectManager;
 
 /// @brief class provides automatic saving of the project at equal time intervals.
 /// All options for working are retrieved from the settings manager.
-/// Autosaver provides an interface that allows you to make it reload parameters
+/// Autosaver provides an interface that allows you to make it reload parameters.
+/// Saving is performed in background: GUI thread only captures a snapshot of the model, serialization and
+/// compression are done in a worker thread. Only one save runs at a time, requests that come while it runs are
+/// merged into one that is started after it. Removing an autosave file (for example, after the project is saved by
+/// user) cancels a pending request and discards a result of the running one. Autosaves are skipped while the project
+/// has no unsaved changes, and a save by user starts the autosave interval anew.
 class Autosaver : public QObject
 {
 	Q_OBJECT
@@ -26,6 +33,10 @@ public:
 	};
 
 	explicit Autosaver(ProjectManager *projectManager);
+
+	/// Waits for a background save in progress, so autosave files do not appear after the project is closed.
+	~Autosaver();
+
 	void reinit();
 
 	QString tempFilePath() const;
@@ -50,11 +61,43 @@ public:
 	/// Similar to @see checkAutoSavedVersion, but searches for temp save
 	bool checkTempFile();
 
+	/// Tells if the project has changes that are not saved by user. Autosave is not needed when there are none.
+	void setUnsavedChanges(bool hasUnsavedChanges);
+
+	/// Called when user saved the project: autosaves made or requested before are outdated, the next one is made
+	/// a whole interval later.
+	void projectSaved();
+
+	/// Returns how long the last background save took in the worker thread, in milliseconds, or -1 if it failed.
+	qint64 lastSaveDuration() const;
+
+	/// Returns for how long the last autosave blocked GUI thread in total, in microseconds: from the start of
+	/// the request to the start of the worker thread, plus the handling of its result.
+	qint64 lastGuiStall() const;
+
+signals:
+	/// Emitted when background save is finished.
+	/// @param fileName - the file that was written.
+	/// @param duration - time spent in the worker thread in milliseconds, -1 if the file was not written.
+	/// @param guiStall - time spent in GUI thread in microseconds.
+	void saved(QString const &fileName, qint64 duration, qint64 guiStall);
+
 private slots:
 	void saveAutoSave();
 	void saveTemp();
 
+	/// Handles the end of background save and starts a pending one, if any.
+	void onBackgroundSaveFinished();
+
 private:
+	/// Captures model contents and starts writing them to given file in a worker thread, or postpones the request
+	/// if another save is in progress.
+	/// @param stallTimer - timer started when GUI thread began to handle the request.
+	void saveInBackground(QString const &fileName, QElapsedTimer const &stallTimer);
+
+	/// Collects results of finished background save, removes written file if it was discarded.
+	void finishBackgroundSave();
+
 	QString autosaveFilePath() const;
 	QString autosaveFilePath(QString const &currentFilePath) const;
 	void resume();
@@ -70,6 +113,27 @@ private:
 
 	ProjectManager *mProjectManager;
 	QTimer *mTimer;
+
+	/// Watches background save, its result is the duration of the save.
+	QFutureWatcher<qint64> mSaveWatcher;
+
+	/// File being written by background save, empty if there is no save in progress.
+	QString mSavingFile;
+
+	/// True if the file being written shall be removed when the save finishes.
+	bool mSavingFileDiscarded;
+
+	/// File requested to be saved while another save was in progress, empty if there is no such request.
+	QString mPendingFile;
+
+	/// False if the project was not modified since it was saved by user.
+	bool mHasUnsavedChanges;
+
+	/// Time spent in GUI thread to start the running save, in microseconds.
+	qint64 mStartGuiStall;
+
+	qint64 mLastSaveDuration;
+	qint64 mLastGuiStall;
 };
 
 }
@@ -22,6 +22,7 @@ ProjectManager::ProjectManager(MainWindow *mainWindow, TextManagerInterface *tex
 	, mAutosaver(new Autosaver(this))
 	, mUnsavedIndicator(false)
 	, mSomeProjectOpened(false)
+	, mReadOnly(false)
 {
 	setSaveFilePath();
 }
@@ -65,7 +66,7 @@ bool ProjectManager::suggestToOpenExisting()
 
 bool ProjectManager::suggestToSaveChangesOrCancel()
 {
-	if (!mUnsavedIndicator) {
+	if (!mUnsavedIndicator || mReadOnly) {
 		return true;
 	}
 	switch (suggestToSaveOrCancelMessage()) {
@@ -109,7 +110,7 @@ bool ProjectManager::open(QString const &fileName)
 	if (mSomeProjectOpened) {
 		close();
 	}
-	if (mAutosaver->checkAutoSavedVersion(fileName)) {
+	if (!mReadOnly && mAutosaver->checkAutoSavedVersion(fileName)) {
 		setUnsavedIndicator(true);
 		mSomeProjectOpened = true;
 		return true;
@@ -197,6 +198,7 @@ void ProjectManager::refreshApplicationStateAfterSave()
 	if (!mAutosaver->isAutosave(mSaveFilePath)) {
 		refreshApplicationStateAfterOpen();
 		mMainWindow->controller()->projectSaved();
+		mAutosaver->projectSaved();
 		setUnsavedIndicator(false);
 	}
 	mAutosaver->removeTemp();
@@ -269,8 +271,11 @@ void ProjectManager::close()
 	mMainWindow->closeAllTabs();
 	mMainWindow->setWindowTitle(mMainWindow->toolManager().customizer()->windowTitle());
 
-	mAutosaver->removeAutoSave();
-	mAutosaver->removeTemp();
+	if (!mReadOnly) {
+		mAutosaver->removeAutoSave();
+		mAutosaver->removeTemp();
+	}
+
 	mSomeProjectOpened = false;
 
 	emit closed();
@@ -281,8 +286,17 @@ void ProjectManager::saveTo(QString const &fileName)
 	mMainWindow->models()->repoControlApi().saveTo(fileName);
 }
 
+QSharedPointer<qrRepo::details::RepositorySnapshot> ProjectManager::snapshot() const
+{
+	return mMainWindow->models()->repoControlApi().snapshot();
+}
+
 void ProjectManager::save()
 {
+	if (mReadOnly) {
+		return;
+	}
+
 	// Do not change the method to saveAll - in the current implementation, an empty project in the repository is
 	// created to initialize the file name with an empty string, which allows the internal state of the file
 	// name = "" Attempt to save the project in this case result in
@@ -294,7 +308,7 @@ void ProjectManager::save()
 
 bool ProjectManager::restoreIncorrectlyTerminated()
 {
-	return mAutosaver->checkTempFile();
+	return !mReadOnly && mAutosaver->checkTempFile();
 }
 
 bool ProjectManager::saveOrSuggestToSaveAs()
@@ -330,7 +344,7 @@ bool ProjectManager::suggestToSaveAs()
 bool ProjectManager::saveAs(QString const &fileName)
 {
 	QString const workingFileName = fileName;
-	if (workingFileName.isEmpty()) {
+	if (workingFileName.isEmpty() || mReadOnly) {
 		return false;
 	}
 	mAutosaver->removeAutoSave();
@@ -367,9 +381,15 @@ QString ProjectManager::getSaveFileName(QString const &dialogWindowTitle)
 	return fileName;
 }
 
+void ProjectManager::setReadOnly(bool readOnly)
+{
+	mReadOnly = readOnly;
+}
+
 void ProjectManager::setUnsavedIndicator(bool isUnsaved)
 {
 	mUnsavedIndicator = isUnsaved;
+	mAutosaver->setUnsavedChanges(isUnsaved);
 	refreshWindowTitleAccordingToSaveFile();
 }
 
@@ -1,10 +1,17 @@
 #pragma once
 
 #include <QtCore/QFileInfo>
+#include <QtCore/QSharedPointer>
 
 #include "mainwindow/projectManager/projectManagementInterface.h"
 #include "textEditor/textManagerInterface.h"
 
+namespace qrRepo {
+namespace details {
+class RepositorySnapshot;
+}
+}
+
 namespace qReal {
 
 class MainWindow;
@@ -49,6 +56,14 @@ public:
 	/// and returns yes if he agrees. Otherwise returns false
 	bool restoreIncorrectlyTerminated();
 
+	/// Captures current project contents in constant time, so they can be saved in background
+	virtual QSharedPointer<qrRepo::details::RepositorySnapshot> snapshot() const;
+
+	/// In read-only mode the project is never written: saves do nothing, unsaved changes are discarded silently,
+	/// autosaved and temporary versions are neither offered nor removed. So the project may be opened by
+	/// several sessions at once.
+	void setReadOnly(bool readOnly);
+
 private:
 	bool import(QString const &fileName);
 	bool saveFileExists(QString const &fileName);
@@ -73,6 +88,7 @@ private:
 	bool mUnsavedIndicator;
 	QString mSaveFilePath;
 	bool mSomeProjectOpened;
+	bool mReadOnly;
 };
 
 }
@@ -36,12 +36,10 @@ void GraphicalModel::init()
 {
 	mModelItems.insert(Id::rootId(), mRootItem);
 	mApi.setName(Id::rootId(), Id::rootId().toString());
-	// Turn off view notification while loading. Model can be inconsistent during a process,
+	// Views are not notified while loading. Model can be inconsistent during a process,
 	// so views shall not update themselves before time. It is important for
-	// scene, where adding edge before adding nodes may lead to disconnected edge.	blockSignals(true);
-	blockSignals(true);
+	// scene, where adding edge before adding nodes may lead to disconnected edge.
 	loadSubtreeFromClient(static_cast<GraphicalModelItem *>(mRootItem));
-	blockSignals(false);
 }
 
 void GraphicalModel::loadSubtreeFromClient(GraphicalModelItem * const parent)
@@ -56,15 +54,10 @@ void GraphicalModel::loadSubtreeFromClient(GraphicalModelItem * const parent)
 
 GraphicalModelItem *GraphicalModel::loadElement(GraphicalModelItem *parentItem, Id const &id)
 {
-	int newRow = parentItem->children().size();
-
-	beginInsertRows(index(parentItem), newRow, newRow);
 	Id const logicalId = mApi.logicalId(id);
 	GraphicalModelItem *item = new GraphicalModelItem(id, logicalId, parentItem);
 	parentItem->addChild(item);
 	mModelItems.insert(id, item);
-	endInsertRows();
-
 	return item;
 }
 
@@ -83,9 +76,9 @@ void GraphicalModel::updateElements(Id const &logicalId, QString const &name)
 {
 	foreach (AbstractModelItem *item,  mModelItems.values()) {
 		GraphicalModelItem *graphicalItem = static_cast<GraphicalModelItem *>(item);
-		if (graphicalItem->logicalId() == logicalId) {
+		if (graphicalItem->logicalId() == logicalId && mApi.name(graphicalItem->id()) != name) {
 			setNewName(graphicalItem->id(), name);
-			emit dataChanged(index(graphicalItem), index(graphicalItem));
+			notifyDataChanged(index(graphicalItem));
 		}
 	}
 }
@@ -205,7 +198,7 @@ bool GraphicalModel::setData(const QModelIndex &index, const QVariant &value, in
 			Q_ASSERT(role < Qt::UserRole);
 			return false;
 		}
-		emit dataChanged(index, index);
+		notifyDataChanged(index);
 		return true;
 	}
 	return false;
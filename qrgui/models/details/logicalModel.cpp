@@ -27,10 +27,7 @@ void LogicalModel::init()
 {
 	mModelItems.insert(Id::rootId(), mRootItem);
 	mApi.setName(Id::rootId(), Id::rootId().toString());
-	// Turn off view notification while loading.
-	blockSignals(true);
 	loadSubtreeFromClient(static_cast<LogicalModelItem *>(mRootItem));
-	blockSignals(false);
 }
 
 void LogicalModel::loadSubtreeFromClient(LogicalModelItem * const parent)
@@ -45,15 +42,11 @@ void LogicalModel::loadSubtreeFromClient(LogicalModelItem * const parent)
 
 LogicalModelItem *LogicalModel::loadElement(LogicalModelItem *parentItem, Id const &id)
 {
-	int const newRow = parentItem->children().size();
-
-	beginInsertRows(index(parentItem), newRow, newRow);
+	// Rows are not announced one by one, the model is loaded as a whole (see init()).
 	LogicalModelItem *item = new LogicalModelItem(id, parentItem);
 	addInsufficientProperties(id);
 	parentItem->addChild(item);
 	mModelItems.insert(id, item);
-	endInsertRows();
-
 	return item;
 }
 
@@ -102,7 +95,7 @@ void LogicalModel::updateElements(Id const &logicalId, QString const &name)
 		return;
 	}
 	mApi.setName(logicalId, name);
-	emit dataChanged(indexById(logicalId), indexById(logicalId));
+	notifyDataChanged(indexById(logicalId));
 }
 
 QMimeData* LogicalModel::mimeData(QModelIndexList const &indexes) const
@@ -239,7 +232,7 @@ bool LogicalModel::setData(const QModelIndex &index, const QVariant &value, int
 			Q_ASSERT(role < Qt::UserRole);
 			return false;
 		}
-		emit dataChanged(index, index);
+		notifyDataChanged(index);
 		return true;
 	}
 	return false;
@@ -47,6 +47,16 @@ QVariant ModelsAssistApi::property(Id const &elem, int const role) const
 	return mModel.data(indexById(elem), role);
 }
 
+void ModelsAssistApi::beginTransaction()
+{
+	mModel.beginTransaction();
+}
+
+void ModelsAssistApi::commitTransaction()
+{
+	mModel.commitTransaction();
+}
+
 int ModelsAssistApi::roleIndexByName(Id const &elem, QString const &roleName) const
 {
 	QStringList const properties = editorManagerInterface().propertyNames(elem.type());
@@ -53,6 +53,9 @@ public:
 	QVariant property(Id const &elem, int const role) const;
 	int roleIndexByName(Id const &elem, QString const &roleName) const;
 
+	void beginTransaction();
+	void commitTransaction();
+
 private:
 
 	ModelsAssistApi(ModelsAssistApi const &);
@@ -8,6 +8,7 @@ using namespace models::details::modelsImplementation;
 
 AbstractModel::AbstractModel(const EditorManagerInterface &editorManagerInterface)
 		: mEditorManagerInterface(editorManagerInterface)
+		, mTransactionDepth(0)
 {
 }
 
@@ -83,21 +84,13 @@ QModelIndex AbstractModel::parent(const QModelIndex &index) const
 
 QModelIndex AbstractModel::index(AbstractModelItem const * const item) const
 {
-	QList<int> rowCoords;
-
-	for (AbstractModelItem const *curItem = item;
-		curItem != mRootItem; curItem = curItem->parent())
-	{
-		rowCoords.append(const_cast<AbstractModelItem *>(curItem)->row());
-	}
-
-	QModelIndex result;
-
-	for (int i = rowCoords.size() - 1; i >= 0; --i) {
-		result = index(rowCoords[i], 0, result);
+	if (item == mRootItem) {
+		return QModelIndex();
 	}
 
-	return result;
+	// Items know their rows, so there is no need to walk the path from the root.
+	AbstractModelItem * const mutableItem = const_cast<AbstractModelItem *>(item);
+	return createIndex(mutableItem->row(), 0, mutableItem);
 }
 
 QString AbstractModel::findPropertyName(Id const &id, int const role) const
@@ -129,17 +122,14 @@ EditorManagerInterface const &AbstractModel::editorManagerInterface() const
 
 QModelIndex AbstractModel::indexById(Id const &id) const
 {
-	if (mModelItems.keys().contains(id)) {
-		return index(mModelItems.find(id).value());
-	}
-
-	return QModelIndex();
+	AbstractModelItem const * const item = mModelItems.value(id);
+	return item ? index(item) : QModelIndex();
 }
 
 Id AbstractModel::idByIndex(QModelIndex const &index) const
 {
 	AbstractModelItem *item = static_cast<AbstractModelItem*>(index.internalPointer());
-	return mModelItems.key(item);
+	return item ? item->id() : Id();
 }
 
 Id AbstractModel::rootId() const
@@ -187,13 +177,14 @@ bool AbstractModel::dropMimeData(QMimeData const *data, Qt::DropAction action, i
 
 void AbstractModel::reinit()
 {
+	// The whole tree is loaded between these calls, so views get a single reset instead of a signal per element.
+	beginResetModel();
 	cleanupTree(mRootItem);
 	mModelItems.clear();
 	delete mRootItem;
 	mRootItem = createModelItem(Id::rootId(), NULL);
-	beginResetModel();
-	endResetModel();
 	init();
+	endResetModel();
 }
 
 void AbstractModel::cleanupTree(modelsImplementation::AbstractModelItem * item)
@@ -218,3 +209,49 @@ void AbstractModel::removeModelItems(details::modelsImplementation::AbstractMode
 		endRemoveRows();
 	}
 }
+
+void AbstractModel::beginTransaction()
+{
+	++mTransactionDepth;
+}
+
+void AbstractModel::commitTransaction()
+{
+	Q_ASSERT(mTransactionDepth > 0);
+	if (--mTransactionDepth > 0) {
+		return;
+	}
+
+	IdList const changed = mChangedInTransaction;
+	mChangedInTransaction.clear();
+	mChangedInTransactionSet.clear();
+
+	foreach (Id const &id, changed) {
+		// Elements removed during the transaction have no index anymore and need no notification.
+		QModelIndex const changedIndex = indexById(id);
+		if (changedIndex.isValid()) {
+			emit dataChanged(changedIndex, changedIndex);
+		}
+	}
+}
+
+bool AbstractModel::isInTransaction() const
+{
+	return mTransactionDepth > 0;
+}
+
+void AbstractModel::notifyDataChanged(QModelIndex const &index)
+{
+	if (mTransactionDepth == 0) {
+		emit dataChanged(index, index);
+		return;
+	}
+
+	Id const id = idByIndex(index);
+	if (!mChangedInTransactionSet.contains(id)) {
+		mChangedInTransactionSet.insert(id);
+		mChangedInTransaction.append(id);
+	}
+
+	emit dataChangedInTransaction(index);
+}
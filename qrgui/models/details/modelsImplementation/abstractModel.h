@@ -3,6 +3,7 @@
 #include <QtCore/QAbstractItemModel>
 #include <QtCore/QMimeData>
 #include <QtCore/QModelIndexList>
+#include <QtCore/QSet>
 
 #include <qrrepo/repoApi.h>
 
@@ -42,12 +43,28 @@ public:
 	/// Stacks item element before sibling (they should have the same parent)
 	virtual void stackBefore(QModelIndex const &element, QModelIndex const &sibling) = 0;
 
+	/// Returns index of an element with given id, invalid index if there is no such element or it is the root.
 	QModelIndex indexById(Id const &id) const;
 	Id idByIndex(QModelIndex const &index) const;
 	Id rootId() const;
 
 	void reinit();
 
+	/// Starts a transaction: notifications about changed data of elements are deferred until the outermost
+	/// transaction is committed, then views get one dataChanged() per changed element. Transactions may be nested.
+	void beginTransaction();
+
+	/// Finishes a transaction started by beginTransaction().
+	void commitTransaction();
+
+	/// Returns true if there is an uncommitted transaction.
+	bool isInTransaction() const;
+
+signals:
+	/// Emitted on a change of element data within a transaction, when dataChanged() is deferred.
+	/// Logical and graphical models watch each other through it to stay in sync before the commit.
+	void dataChangedInTransaction(QModelIndex const &index);
+
 protected:
 	EditorManagerInterface const &mEditorManagerInterface;
 	QHash<Id, AbstractModelItem *> mModelItems;
@@ -61,11 +78,24 @@ protected:
 	AbstractModelItem * parentAbstractItem(QModelIndex const &parent) const;
 	void removeModelItems(details::modelsImplementation::AbstractModelItem *const root);
 
+	/// Notifies views that data of given element changed, or remembers the element if a transaction is in progress.
+	void notifyDataChanged(QModelIndex const &index);
+
 private:
 	virtual AbstractModelItem *createModelItem(Id const &id, AbstractModelItem *parentItem) const = 0;
+
+	/// Loads all elements from the repository into the item tree without notifying views, shall be called
+	/// either when there are no views or between beginResetModel() and endResetModel().
 	virtual void init() = 0;
 	virtual void removeModelItemFromApi(details::modelsImplementation::AbstractModelItem *const root
 			, details::modelsImplementation::AbstractModelItem *child) = 0;
+
+	/// Nesting level of transactions, 0 when there is no transaction.
+	int mTransactionDepth;
+
+	/// Elements changed during current transaction, in order of their first change.
+	IdList mChangedInTransaction;
+	QSet<Id> mChangedInTransactionSet;
 };
 
 }
@@ -6,7 +6,7 @@ using namespace qReal;
 using namespace models::details::modelsImplementation;
 
 AbstractModelItem::AbstractModelItem(Id const &id, AbstractModelItem *parent)
-		: mParent(parent), mId(id)
+		: mParent(parent), mId(id), mRow(-1)
 {
 }
 
@@ -32,17 +32,20 @@ AbstractModelItem::PointerList AbstractModelItem::children() const
 
 void AbstractModelItem::addChild(AbstractModelItem *child)
 {
-	if (mChildren.contains(child)) {
+	if (hasChild(child)) {
 		throw Exception("Model: Adding already existing child " + child->id().toString() + "  to object " + mId.toString());
 	}
 
+	child->mRow = mChildren.size();
 	mChildren.append(child);
 }
 
 void AbstractModelItem::removeChild(AbstractModelItem *child)
 {
-	if (mChildren.contains(child)) {
-		mChildren.removeAll(child);
+	if (hasChild(child)) {
+		mChildren.removeAt(child->mRow);
+		updateRows(child->mRow);
+		child->mRow = -1;
 	} else {
 		throw Exception("Model: Removing nonexistent child " + child->id().toString() + "  from object " + mId.toString());
 	}
@@ -54,24 +57,43 @@ void AbstractModelItem::stackBefore(AbstractModelItem *element, AbstractModelIte
 		return;
 	}
 
-	if (!mChildren.contains(element)) {
+	if (!hasChild(element)) {
 		throw Exception("Model: Trying to move nonexistent child " + element->id().toString());
 	}
 
-	if (!mChildren.contains(sibling)) {
+	if (!hasChild(sibling)) {
 		throw Exception("Model: Trying to stack element before nonexistent child " + sibling->id().toString());
 	}
 
-	mChildren.removeOne(element);
-	mChildren.insert(mChildren.indexOf(sibling), element);
+	int const oldRow = element->mRow;
+	mChildren.removeAt(oldRow);
+	int const newRow = oldRow < sibling->mRow ? sibling->mRow - 1 : sibling->mRow;
+	mChildren.insert(newRow, element);
+	updateRows(qMin(oldRow, newRow));
 }
 
 int AbstractModelItem::row()
 {
-	return mParent->children().indexOf(this);
+	return mRow;
 }
 
 void AbstractModelItem::clearChildren()
 {
+	foreach (AbstractModelItem * const child, mChildren) {
+		child->mRow = -1;
+	}
+
 	mChildren.clear();
 }
+
+bool AbstractModelItem::hasChild(AbstractModelItem const *child) const
+{
+	return child->mRow >= 0 && child->mRow < mChildren.size() && mChildren.at(child->mRow) == child;
+}
+
+void AbstractModelItem::updateRows(int from)
+{
+	for (int i = from; i < mChildren.size(); ++i) {
+		mChildren.at(i)->mRow = i;
+	}
+}
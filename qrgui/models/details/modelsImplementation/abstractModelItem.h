@@ -17,6 +17,7 @@ public:
 	AbstractModelItem *parent() const;
 	PointerList children() const;
 
+	/// Returns the position of the item among children of its parent, cached so it is not searched for.
 	int row();
 	void addChild(AbstractModelItem *child);
 	void removeChild(AbstractModelItem *child);
@@ -28,9 +29,18 @@ public:
 	void stackBefore(AbstractModelItem *element, AbstractModelItem *sibling);
 
 private:
+	/// Returns true if given item is a child of this one, uses cached row of the child.
+	bool hasChild(AbstractModelItem const *child) const;
+
+	/// Updates cached rows of children starting from given position.
+	void updateRows(int from);
+
 	AbstractModelItem *mParent;
 	const Id mId;
 	PointerList mChildren;
+
+	/// Position of the item among children of its parent, -1 if it is not added to a parent yet.
+	int mRow;
 };
 
 }
@@ -16,6 +16,13 @@ AbstractView::~AbstractView()
 {
 }
 
+void AbstractView::setModel(QAbstractItemModel *model)
+{
+	QAbstractItemView::setModel(model);
+	// Models shall be in sync within a transaction too, so changes are handled without waiting for a commit.
+	connect(model, SIGNAL(dataChangedInTransaction(QModelIndex)), this, SLOT(dataChangedInTransaction(QModelIndex)));
+}
+
 void AbstractView::rowsAboutToBeMoved(QModelIndex const &sourceParent
 		, int sourceStart, int sourceEnd, QModelIndex const &destinationParent, int destinationRow)
 {
@@ -44,6 +51,11 @@ void AbstractView::dataChanged(QModelIndex const &topLeft, QModelIndex const &bo
 	Q_UNUSED(roles)
 }
 
+void AbstractView::dataChangedInTransaction(QModelIndex const &index)
+{
+	dataChanged(index, index);
+}
+
 void AbstractView::rowsAboutToBeRemoved(QModelIndex const &parent, int start, int end)
 {
 	Q_UNUSED(parent)
@@ -17,6 +17,8 @@ public:
 	explicit AbstractView(AbstractModel * const model);
 	virtual ~AbstractView();
 
+	virtual void setModel(QAbstractItemModel *model);
+
 public slots:
 	void rowsAboutToBeMoved(QModelIndex const &sourceParent, int sourceStart, int sourceEnd
 			, QModelIndex const &destinationParent, int destinationRow);
@@ -29,6 +31,9 @@ protected slots:
 	virtual void rowsAboutToBeRemoved(QModelIndex const &parent, int start, int end);
 	virtual void rowsInserted(QModelIndex const &parent, int start, int end);
 
+private slots:
+	void dataChangedInTransaction(QModelIndex const &index);
+
 protected:
 	AbstractModel * const mModel;
 
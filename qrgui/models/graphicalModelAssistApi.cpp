@@ -252,6 +252,16 @@ void GraphicalModelAssistApi::removeElement(Id const &graphicalId)
 	}
 }
 
+void GraphicalModelAssistApi::beginTransaction()
+{
+	mModelsAssistApi.beginTransaction();
+}
+
+void GraphicalModelAssistApi::commitTransaction()
+{
+	mModelsAssistApi.commitTransaction();
+}
+
 bool GraphicalModelAssistApi::hasLabel(Id const &graphicalId, int index)
 {
 	return mGraphicalPartModel.findIndex(graphicalId, index).isValid();
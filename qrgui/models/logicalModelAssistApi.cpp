@@ -215,3 +215,13 @@ void LogicalModelAssistApi::removeElement(Id const &logicalId)
 		mLogicalModel.removeRow(index.row(), index.parent());
 	}
 }
+
+void LogicalModelAssistApi::beginTransaction()
+{
+	mModelsAssistApi.beginTransaction();
+}
+
+void LogicalModelAssistApi::commitTransaction()
+{
+	mModelsAssistApi.commitTransaction();
+}
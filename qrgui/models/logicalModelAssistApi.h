@@ -68,6 +68,9 @@ public:
 
 	virtual void removeElement(Id const &logicalId);
 
+	virtual void beginTransaction();
+	virtual void commitTransaction();
+
 private:
 	LogicalModelAssistApi(LogicalModelAssistApi const &);  // Copying is forbidden
 	LogicalModelAssistApi& operator =(LogicalModelAssistApi const &); // Assignment is forbidden also
@@ -1,11 +1,14 @@
 #include "models.h"
 
+#include <qrkernel/settingsManager.h>
+
 using namespace qReal;
 using namespace models;
 
 Models::Models(QString const &workingCopy, EditorManagerInterface &editorManager)
 {
 	qrRepo::RepoApi *repoApi = new qrRepo::RepoApi(workingCopy);
+	repoApi->setJournalEnabled(SettingsManager::value("ProjectJournal").toBool());
 	mGraphicalModel = new models::details::GraphicalModel(repoApi, editorManager);
 	mGraphicalPartModel = new models::details::GraphicalPartModel(*repoApi, *mGraphicalModel);
 
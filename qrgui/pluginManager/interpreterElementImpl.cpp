@@ -490,6 +490,8 @@ enums::linkShape::LinkShape InterpreterElementImpl::shapeTypeByString(QString co
 		return enums::linkShape::broken;
 	} else if (type == "curve") {
 		return enums::linkShape::curve;
+	} else if (type == "routed") {
+		return enums::linkShape::routed;
 	} else {
 		return enums::linkShape::square;
 	}
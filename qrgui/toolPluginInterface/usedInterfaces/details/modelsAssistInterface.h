@@ -39,6 +39,14 @@ public:
 	virtual int childrenOfDiagram(const Id &parent) const = 0;
 
 	virtual void removeElement(Id const &id) = 0;
+
+	/// Starts a group of changes: views are notified about every element changed within the group once,
+	/// when the outermost group is committed, instead of once per changed property.
+	/// Groups may be nested, each beginTransaction() shall be matched by commitTransaction().
+	virtual void beginTransaction() = 0;
+
+	/// Finishes a group of changes started by beginTransaction().
+	virtual void commitTransaction() = 0;
 };
 
 }
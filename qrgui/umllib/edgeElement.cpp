@@ -15,6 +15,7 @@
 
 #include "umllib/private/lineFactory.h"
 #include "umllib/private/lineHandler.h"
+#include "umllib/private/levelOfDetail.h"
 
 using namespace qReal;
 using namespace enums;
@@ -149,6 +150,7 @@ void EdgeElement::setLine(QPolygonF const &line)
 {
 	prepareGeometryChange();
 	mLine = line;
+	notifyGeometryChanged();
 	saveConfiguration();
 	update();
 	updateLongestPart();
@@ -180,6 +182,11 @@ void EdgeElement::setToPort(qreal const toPort)
 
 void EdgeElement::paint(QPainter *painter, QStyleOptionGraphicsItem const *option, QWidget*)
 {
+	if (LevelOfDetail::isSimplified(painter)) {
+		paintSimplified(painter, option);
+		return;
+	}
+
 	if (SettingsManager::value("PaintOldEdgeMode").toBool() && mHandler->isReshapeStarted()) {
 		paintEdge(painter, option, true);
 	}
@@ -210,6 +217,16 @@ void EdgeElement::paintEdge(QPainter *painter, QStyleOptionGraphicsItem const *o
 	painter->restore();
 }
 
+void EdgeElement::paintSimplified(QPainter *painter, QStyleOptionGraphicsItem const *option) const
+{
+	painter->save();
+	QPen pen(option->state & QStyle::State_Selected ? QColor(Qt::blue) : mColor);
+	pen.setCosmetic(true);
+	painter->setPen(pen);
+	painter->drawPolyline(mLine);
+	painter->restore();
+}
+
 void EdgeElement::drawArrows(QPainter *painter, bool savedLine) const
 {
 	Qt::PenStyle style(QPen(painter->pen()).style());
@@ -368,6 +385,20 @@ void EdgeElement::layOut()
 	saveConfiguration();
 }
 
+void EdgeElement::layOutAround(QRectF const &oldSceneRect, QRectF const &newSceneRect)
+{
+	if (!mHandler->isObstructedBy(newSceneRect)
+			&& (oldSceneRect.isNull() || !mHandler->isRoutedAround(oldSceneRect)))
+	{
+		return;
+	}
+
+	mHandler->layOut(false);
+
+	setGraphicApiPos();
+	saveConfiguration();
+}
+
 void EdgeElement::connectLoopEdge(NodeElement *newMaster)
 {
 	mPortFrom = newMaster ? newMaster->portId(mapToItem(newMaster, mLine.first()), fromPortTypes()) : -1.0;
@@ -622,22 +653,22 @@ NodeElement *EdgeElement::getNodeAt(QPointF const &position, bool isStart)
 	QPainterPath circlePath;
 	int const searchAreaRadius = SettingsManager::value("IndexGrid", 25).toInt() / 2;
 	circlePath.addEllipse(mapToScene(position), searchAreaRadius, searchAreaRadius);
-	QList<QGraphicsItem*> const items = scene()->items(circlePath);
+	EditorViewScene * const editorViewScene = dynamic_cast<EditorViewScene *>(scene());
+	if (!editorViewScene) {
+		return nullptr;
+	}
 
 	qreal minimalDistance = 10e10;  // Very large number
 	NodeElement *closestNode = nullptr;
 
 	// Searching for the node with closest port to our point
-	for (QGraphicsItem * const item : items) {
-		NodeElement * const currentNode = dynamic_cast<NodeElement *>(item);
-		if (currentNode) {
-			QPointF const positionInSceneCoordinates = mapToScene(position);
-			qreal const currentDistance = currentNode->shortestDistanceToPort(positionInSceneCoordinates
-					, isStart ? fromPortTypes() : toPortTypes());
-			if (currentDistance < minimalDistance) {
-				minimalDistance = currentDistance;
-				closestNode = currentNode;
-			}
+	for (NodeElement * const currentNode : editorViewScene->nodesIn(circlePath)) {
+		QPointF const positionInSceneCoordinates = mapToScene(position);
+		qreal const currentDistance = currentNode->shortestDistanceToPort(positionInSceneCoordinates
+				, isStart ? fromPortTypes() : toPortTypes());
+		if (currentDistance < minimalDistance) {
+			minimalDistance = currentDistance;
+			closestNode = currentNode;
 		}
 	}
 
@@ -739,6 +770,10 @@ void EdgeElement::reversingReconnectToPorts(NodeElement *newSrc, NodeElement *ne
 
 void EdgeElement::setGraphicApiPos()
 {
+	if (isModelUpdateDeferred()) {
+		return;
+	}
+
 	mMoving = true;
 	mGraphicalAssistApi.setPosition(id(), this->pos());
 	mMoving = false;
@@ -746,10 +781,20 @@ void EdgeElement::setGraphicApiPos()
 
 void EdgeElement::saveConfiguration()
 {
+	if (isModelUpdateDeferred()) {
+		return;
+	}
+
 	mModelUpdateIsCalled = true;
 	mGraphicalAssistApi.setConfiguration(id(), mLine.toPolygon());
 }
 
+bool EdgeElement::isModelUpdateDeferred()
+{
+	EditorViewScene * const editorViewScene = dynamic_cast<EditorViewScene *>(scene());
+	return editorViewScene && editorViewScene->deferModelUpdate(this);
+}
+
 bool EdgeElement::isBreakPointPressed()
 {
 	return mBreakPointPressed;
@@ -812,6 +857,16 @@ void EdgeElement::adjustLink()
 	mHandler->adjust();
 }
 
+bool EdgeElement::endsMoved() const
+{
+	if (mLine.isEmpty()) {
+		return false;
+	}
+
+	return (mSrc && mapFromItem(mSrc, mSrc->portPos(mPortFrom)) != mLine.first())
+			|| (mDst && mapFromItem(mDst, mDst->portPos(mPortTo)) != mLine.last());
+}
+
 NodeElement *EdgeElement::src() const
 {
 	return mSrc;
@@ -888,6 +943,7 @@ void EdgeElement::updateData()
 
 	if (!newLine.isEmpty()) {
 		mLine = newLine;
+		notifyGeometryChanged();
 	}
 
 	qReal::Id idFrom = mGraphicalAssistApi.from(id());
@@ -948,12 +1004,14 @@ QStringList EdgeElement::toPortTypes() const
 void EdgeElement::placeStartTo(QPointF const &place)
 {
 	mLine[0] = place;
+	notifyGeometryChanged();
 }
 
 void EdgeElement::placeEndTo(QPointF const &place)
 {
 	prepareGeometryChange();
 	mLine[mLine.size() - 1] = place;
+	notifyGeometryChanged();
 
 	mHandler->adjust();
 
@@ -1029,6 +1087,7 @@ QVariant EdgeElement::itemChange(GraphicsItemChange change, QVariant const &valu
 {
 	switch (change) {
 	case ItemPositionHasChanged:
+		notifyGeometryChanged();
 		if (mIsLoop) {
 			return value;
 		}
@@ -1046,7 +1105,7 @@ QVariant EdgeElement::itemChange(GraphicsItemChange change, QVariant const &valu
 		updateLongestPart();
 		return value;
 	default:
-		return QGraphicsItem::itemChange(change, value);
+		return Element::itemChange(change, value);
 	}
 }
 
@@ -1097,6 +1156,7 @@ void EdgeElement::alignToGrid()
 {
 	prepareGeometryChange();
 	mHandler->alignToGrid();
+	notifyGeometryChanged();
 	updateLongestPart();
 }
 
@@ -59,9 +59,17 @@ public:
 	/// Adjust link to make its' ends be placed exactly on corresponding ports
 	void adjustLink();
 
+	/// Returns true if ports of adjacent nodes are not where the ends of the link are.
+	bool endsMoved() const;
+
 	/// Reconnect, arrange links on linear ports and lay out the link depending on its' type
 	void layOut();
 
+	/// Lay out the link again without reconnecting if its' type avoids nodes and a node moved from the old
+	/// rectangle to the new one in scene coordinates obstructs it now or was avoided by it before
+	/// @param oldSceneRect - null rectangle if the node was not on the scene before
+	void layOutAround(QRectF const &oldSceneRect, QRectF const &newSceneRect);
+
 	/// Reconnect link to exclude intersections with adjacent nodes
 	void reconnectToNearestPorts(bool reconnectSrc = true, bool reconnectDst = true);
 
@@ -120,10 +128,10 @@ public:
 	/// Change link type and redraw it
 	void changeShapeType(enums::linkShape::LinkShape const shapeType);
 
-	/// Save link position to the repo
+	/// Save link position to the repo, postponed until the end of dragging if the user drags elements
 	void setGraphicApiPos();
 
-	/// Save link configuration to the repo
+	/// Save link configuration to the repo, postponed until the end of dragging if the user drags elements
 	void saveConfiguration();
 
 	bool isLoop();
@@ -183,7 +191,15 @@ private:
 	/// Returns the next clockwise side.
 	NodeSide rotateRight(NodeSide side) const;
 
+	/// Returns true if writing to the repo shall wait for the end of dragging, the scene writes the link then.
+	bool isModelUpdateDeferred();
+
 	void paintEdge(QPainter *painter, QStyleOptionGraphicsItem const *option, bool drawSavedLine) const;
+
+	/// Paints the edge as a plain polyline without arrows and ports, used when the diagram is zoomed out
+	/// too far to see them.
+	void paintSimplified(QPainter *painter, QStyleOptionGraphicsItem const *option) const;
+
 	void drawArrows(QPainter *painter, bool savedLine) const;
 	QPen edgePen(QPainter *painter, QColor color, Qt::PenStyle style, int width) const;
 	void setEdgePainter(QPainter *painter, QPen pen, qreal opacity) const;
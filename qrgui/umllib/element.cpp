@@ -1,6 +1,7 @@
 #include "element.h"
 
 #include "controller/commands/changePropertyCommand.h"
+#include "view/editorViewScene.h"
 
 using namespace qReal;
 
@@ -23,6 +24,44 @@ Element::Element(ElementImpl *elementImpl
 	setCursor(Qt::PointingHandCursor);
 }
 
+Element::~Element()
+{
+	// Deleted items are removed from the scene without itemChange() notification.
+	EditorViewScene * const editorViewScene = dynamic_cast<EditorViewScene *>(scene());
+	if (editorViewScene) {
+		editorViewScene->unregisterElement(this);
+	}
+}
+
+QVariant Element::itemChange(GraphicsItemChange change, QVariant const &value)
+{
+	if (change == ItemSceneChange) {
+		EditorViewScene * const oldScene = dynamic_cast<EditorViewScene *>(scene());
+		if (oldScene) {
+			oldScene->unregisterElement(this);
+		}
+	} else if (change == ItemSceneHasChanged) {
+		EditorViewScene * const newScene = dynamic_cast<EditorViewScene *>(value.value<QGraphicsScene *>());
+		if (newScene) {
+			newScene->registerElement(this);
+		}
+	} else if (change == ItemPositionHasChanged || change == ItemParentHasChanged
+			|| change == ItemTransformHasChanged)
+	{
+		notifyGeometryChanged();
+	}
+
+	return QGraphicsItem::itemChange(change, value);
+}
+
+void Element::notifyGeometryChanged()
+{
+	EditorViewScene * const editorViewScene = dynamic_cast<EditorViewScene *>(scene());
+	if (editorViewScene) {
+		editorViewScene->elementGeometryChanged(this);
+	}
+}
+
 Id Element::id() const
 {
 	return mId;
@@ -37,7 +37,8 @@ public:
 			, models::LogicalModelAssistApi &logicalAssistApi
 			);
 
-	virtual ~Element() {}
+	/// Unregisters the element from the scene's id registry.
+	virtual ~Element();
 
 	void initEmbeddedControls();
 
@@ -77,6 +78,14 @@ signals:
 	void switchFolding(bool);
 
 protected:
+	/// Keeps the element registered in EditorViewScene it belongs to, so the scene can find it by id
+	/// and by geometry.
+	virtual QVariant itemChange(GraphicsItemChange change, QVariant const &value);
+
+	/// Tells the scene that the element was moved or resized. Shall be called after changes of geometry
+	/// not reported to itemChange() of this class.
+	void notifyGeometryChanged();
+
 	void initTitlesBy(QRectF const& contents);
 	/// Sets titles visibility without state registering
 	void setTitlesVisiblePrivate(bool visible);
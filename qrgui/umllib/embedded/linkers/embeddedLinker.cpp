@@ -11,6 +11,7 @@
 #include "view/editorViewScene.h"
 #include "mainwindow/mainWindow.h"
 #include "umllib/private/reshapeEdgeCommand.h"
+#include "umllib/private/levelOfDetail.h"
 
 using namespace qReal;
 
@@ -61,6 +62,10 @@ void EmbeddedLinker::generateColor()
 void EmbeddedLinker::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget*)
 {
 	Q_UNUSED(option);
+	if (LevelOfDetail::isTooSmall(painter, mSize * 2)) {
+		return;
+	}
+
 	painter->save();
 
 	QBrush brush;
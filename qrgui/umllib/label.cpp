@@ -1,9 +1,11 @@
 #include "label.h"
 
 #include <QtGui/QTextCursor>
+#include <QtGui/QFontMetricsF>
 
 #include "umllib/nodeElement.h"
 #include "umllib/edgeElement.h"
+#include "umllib/private/levelOfDetail.h"
 #include "brandManager/brandManager.h"
 
 using namespace qReal;
@@ -326,6 +328,10 @@ void Label::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWi
 		return;
 	}
 
+	if (LevelOfDetail::isTooSmall(painter, QFontMetricsF(font()).height())) {
+		return;
+	}
+
 	painter->save();
 	painter->setBrush(QBrush(mBackground));
 
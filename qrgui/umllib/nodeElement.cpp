@@ -21,6 +21,7 @@
 #include "umllib/private/copyHandler.h"
 #include "umllib/private/resizeCommand.h"
 #include "umllib/private/foldCommand.h"
+#include "umllib/private/levelOfDetail.h"
 
 #include "controller/commands/changeParentCommand.h"
 #include "controller/commands/renameCommand.h"
@@ -164,6 +165,7 @@ void NodeElement::setGeometry(QRectF const &geom)
 	}
 	mTransform.reset();
 	mTransform.scale(mContents.width(), mContents.height());
+	notifyGeometryChanged();
 	adjustLinks();
 }
 
@@ -180,6 +182,11 @@ void NodeElement::setPos(qreal x, qreal y)
 
 void NodeElement::adjustLinks()
 {
+	EditorViewScene * const evScene = dynamic_cast<EditorViewScene *>(scene());
+	if (evScene && evScene->deferLinksAdjustment(this)) {
+		return;
+	}
+
 	foreach (EdgeElement *edge, mEdgeList) {
 		edge->adjustLink();
 	}
@@ -503,6 +510,13 @@ void NodeElement::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 	}
 	delUnusedLines();
 
+	// Contents of the node before dragging in scene coordinates, taken before the node changes its parent.
+	QRectF oldSceneRect;
+	if (mResizeCommand) {
+		QRectF const geometry = mResizeCommand->geometryBeforeDrag();
+		oldSceneRect = parentItem() ? parentItem()->mapRectToScene(geometry) : geometry;
+	}
+
 	storeGeometry();
 
 	if (scene() && (scene()->selectedItems().size() == 1) && isSelected()) {
@@ -547,6 +561,7 @@ void NodeElement::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 
 			while (newParent) {
 				newParent->mContents = newParent->mContents.normalized();
+				newParent->notifyGeometryChanged();
 				newParent->storeGeometry();
 				newParent = dynamic_cast<NodeElement*>(newParent->parentItem());
 			}
@@ -566,6 +581,11 @@ void NodeElement::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 		}
 	}
 
+	if (evScene) {
+		evScene->layOutLinksAround(this, oldSceneRect
+				, shouldProcessResize ? static_cast<AbstractCommand *>(mResizeCommand) : nullptr);
+	}
+
 	if (shouldProcessResize && mResizeCommand) {
 		mResizeCommand->addPostAction(insertCommand);
 		endResize();
@@ -716,6 +736,7 @@ QVariant NodeElement::itemChange(GraphicsItemChange change, QVariant const &valu
 	NodeElement *item = dynamic_cast<NodeElement*>(value.value<QGraphicsItem*>());
 	switch (change) {
 	case ItemPositionHasChanged:
+		notifyGeometryChanged();
 		if (mDragState == None) {
 			alignToGrid();
 		}
@@ -730,11 +751,12 @@ QVariant NodeElement::itemChange(GraphicsItemChange change, QVariant const &valu
 		return value;
 
 	case ItemParentHasChanged:
+		notifyGeometryChanged();
 		updateByNewParent();
 		return value;
 
 	default:
-		return QGraphicsItem::itemChange(change, value);
+		return Element::itemChange(change, value);
 	}
 }
 
@@ -823,6 +845,11 @@ void NodeElement::setPortsVisible(QStringList const &types)
 
 void NodeElement::paint(QPainter *painter, QStyleOptionGraphicsItem const *style, QWidget *)
 {
+	if (LevelOfDetail::isSimplified(painter)) {
+		paintSimplified(painter, style);
+		return;
+	}
+
 	mElementImpl->paint(painter, mContents);
 	paint(painter, style);
 
@@ -883,8 +910,25 @@ void NodeElement::paint(QPainter *painter, QStyleOptionGraphicsItem const *optio
 	}
 }
 
+void NodeElement::paintSimplified(QPainter *painter, QStyleOptionGraphicsItem const *option) const
+{
+	painter->save();
+	QPen pen(option->state & QStyle::State_Selected ? Qt::blue : Qt::black);
+	pen.setCosmetic(true);
+	painter->setPen(pen);
+	painter->setBrush(QColor(Qt::lightGray));
+	painter->drawRect(mContents);
+	painter->restore();
+}
+
 void NodeElement::drawPorts(QPainter *painter, bool mouseOver)
 {
+	// Width of the narrowest port mark, see StatLine::paint().
+	qreal const portWidth = 7;
+	if (LevelOfDetail::isTooSmall(painter, portWidth)) {
+		return;
+	}
+
 	painter->save();
 	painter->setOpacity(0.7);
 
@@ -236,6 +236,10 @@ private:
 	virtual void hoverLeaveEvent(QGraphicsSceneHoverEvent *event);
 
 	void paint(QPainter *p, QStyleOptionGraphicsItem const *opt);
+
+	/// Paints the node as a plain rectangle, used when the diagram is zoomed out too far to see its shape.
+	void paintSimplified(QPainter *painter, QStyleOptionGraphicsItem const *option) const;
+
 	void drawPorts(QPainter *painter, bool mouseOver);
 
 	/**
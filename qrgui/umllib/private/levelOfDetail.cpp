@@ -0,0 +1,42 @@
+#include "levelOfDetail.h"
+
+#include <QtWidgets/QStyleOptionGraphicsItem>
+
+#include <qrkernel/settingsManager.h>
+
+using namespace qReal;
+
+bool LevelOfDetail::mSettingsLoaded = false;
+qreal LevelOfDetail::mSimplifiedDrawingZoom = 0;
+qreal LevelOfDetail::mMinimalDetailSize = 0;
+
+qreal LevelOfDetail::scale(QPainter const *painter)
+{
+	return QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+}
+
+bool LevelOfDetail::isSimplified(QPainter const *painter)
+{
+	ensureSettingsLoaded();
+	return scale(painter) * 100 < mSimplifiedDrawingZoom;
+}
+
+bool LevelOfDetail::isTooSmall(QPainter const *painter, qreal size)
+{
+	ensureSettingsLoaded();
+	return size * scale(painter) < mMinimalDetailSize;
+}
+
+void LevelOfDetail::reloadSettings()
+{
+	mSimplifiedDrawingZoom = SettingsManager::value("SimplifiedDrawingZoom").toReal();
+	mMinimalDetailSize = SettingsManager::value("MinimalDetailSize").toReal();
+	mSettingsLoaded = true;
+}
+
+void LevelOfDetail::ensureSettingsLoaded()
+{
+	if (!mSettingsLoaded) {
+		reloadSettings();
+	}
+}
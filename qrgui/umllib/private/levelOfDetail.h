@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QtGui/QPainter>
+
+namespace qReal {
+
+/// Decides how detailed diagram elements are painted at the current zoom. Thresholds are set in preferences:
+/// "SimplifiedDrawingZoom" is the zoom in percents below which nodes are painted as plain rectangles and edges
+/// as plain polylines, "MinimalDetailSize" is the size in pixels below which labels, ports and embedded linkers
+/// are not painted at all.
+class LevelOfDetail
+{
+public:
+	/// Returns the scale of items painted with given painter.
+	static qreal scale(QPainter const *painter);
+
+	/// Returns true if elements shall be painted simplified with given painter.
+	static bool isSimplified(QPainter const *painter);
+
+	/// Returns true if a detail of given size in item coordinates is too small on screen to be painted.
+	static bool isTooSmall(QPainter const *painter, qreal size);
+
+	/// Rereads thresholds from settings. They are read once and cached, since they are needed by every paint of
+	/// every element, so this shall be called when the settings are changed.
+	static void reloadSettings();
+
+private:
+	static void ensureSettingsLoaded();
+
+	static bool mSettingsLoaded;
+	static qreal mSimplifiedDrawingZoom;
+	static qreal mMinimalDetailSize;
+};
+
+}
@@ -3,6 +3,7 @@
 #include "umllib/private/brokenLine.h"
 #include "umllib/private/squareLine.h"
 #include "umllib/private/curveLine.h"
+#include "umllib/private/routedLine.h"
 
 using namespace qReal;
 
@@ -18,6 +19,8 @@ LineHandler * LineFactory::createHandler(linkShape::LinkShape const type) const
 		return new BrokenLine(mEdge);
 	case linkShape::curve:
 		return new CurveLine(mEdge);
+	case linkShape::routed:
+		return new RoutedLine(mEdge);
 	default:
 		return new SquareLine(mEdge);
 	}
@@ -36,6 +39,9 @@ QMenu * LineFactory::shapeTypeMenu() const
 	QAction * const curveLine = menu->addAction(tr("Curve"));
 	connect(curveLine, SIGNAL(triggered()), this, SLOT(setCurveLine()));
 
+	QAction * const routedLine = menu->addAction(tr("Routed around nodes"));
+	connect(routedLine, SIGNAL(triggered()), this, SLOT(setRoutedLine()));
+
 	return menu;
 }
 
@@ -46,6 +52,8 @@ QString LineFactory::shapeToString(linkShape::LinkShape const shapeType)
 		return "broken";
 	case linkShape::curve:
 		return "curve";
+	case linkShape::routed:
+		return "routed";
 	default:
 		return "square";
 	}
@@ -59,6 +67,8 @@ linkShape::LinkShape LineFactory::stringToShape(QString const &string)
 		return linkShape::square;
 	} else if (string == "curve") {
 		return linkShape::curve;
+	} else if (string == "routed") {
+		return linkShape::routed;
 	} else {
 		return linkShape::unset;
 	}
@@ -78,3 +88,8 @@ void LineFactory::setCurveLine() const
 {
 	mEdge->changeShapeType(linkShape::curve);
 }
+
+void LineFactory::setRoutedLine() const
+{
+	mEdge->changeShapeType(linkShape::routed);
+}
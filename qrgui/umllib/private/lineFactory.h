@@ -30,6 +30,7 @@ private slots:
 	void setSquareLine() const;
 	void setBrokenLine() const;
 	void setCurveLine() const;
+	void setRoutedLine() const;
 
 private:
 	EdgeElement *mEdge; // Doesn't take ownership
@@ -252,6 +252,18 @@ void LineHandler::improveAppearance()
 {
 }
 
+bool LineHandler::isObstructedBy(QRectF const &sceneRect) const
+{
+	Q_UNUSED(sceneRect)
+	return false;
+}
+
+bool LineHandler::isRoutedAround(QRectF const &sceneRect) const
+{
+	Q_UNUSED(sceneRect)
+	return false;
+}
+
 void LineHandler::deleteLoops()
 {
 	if (mEdge->isLoop()) {
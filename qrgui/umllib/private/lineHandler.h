@@ -55,6 +55,14 @@ public:
 	/// @return link shape (depending on a link type, default implementation returns link's line() polygon)
 	virtual QPainterPath shape() const;
 
+	/// @return true if the link shall be laid out again when a node is placed to given rectangle in scene
+	/// coordinates. Default implementation returns false, links avoid only adjacent nodes.
+	virtual bool isObstructedBy(QRectF const &sceneRect) const;
+
+	/// @return true if the link was laid out to avoid a node placed to given rectangle in scene coordinates,
+	/// so it shall be laid out again when the node moves away. Default implementation returns false.
+	virtual bool isRoutedAround(QRectF const &sceneRect) const;
+
 	/// @return configuration that link had before reshaping
 	QPolygonF savedLine() const;
 
@@ -0,0 +1,367 @@
+#include "orthogonalRouter.h"
+
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+#include <QtCore/QBitArray>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QVector>
+
+using namespace qReal;
+
+namespace {
+
+/// Directions of moves over the routing grid, in the same order as sides of a node in EdgeElement::NodeSide,
+/// so the side of a node is also the direction of leaving it.
+enum Direction
+{
+	leftward = 0
+	, upward
+	, rightward
+	, downward
+};
+
+int const directionsCount = 4;
+int const anyDirection = -1;
+
+int const stepX[] = {-1, 0, 1, 0};
+int const stepY[] = {0, -1, 0, 1};
+
+/// Indent of the area searched for a route from the ends of the route, it grows twice with each expansion.
+qreal const initialAreaIndent = 100;
+
+/// The number of times the searched area grows before the route is considered impossible.
+int const maxAreaExpansions = 4;
+
+/// The number of routes remembered by a router.
+int const routeCacheSize = 256;
+
+/// The number of points of the routing grid a route is searched on at most. Grids of crowded areas are larger, the
+/// route is considered impossible there instead of spending memory and time on it.
+int const maxGridPoints = 1 << 20;
+
+/// Sides of a rectangle inflated by a margin. Stored as numbers rather than QRectF, so the sides are exactly
+/// the same as coordinates of outgoing points computed from the same rectangle.
+struct Bounds
+{
+	Bounds(QRectF const &rect, qreal margin)
+		: left(rect.left() - margin)
+		, top(rect.top() - margin)
+		, right(rect.right() + margin)
+		, bottom(rect.bottom() + margin)
+	{
+	}
+
+	qreal left;
+	qreal top;
+	qreal right;
+	qreal bottom;
+};
+
+/// Returns sorted coordinates of grid lines without duplicates, only ones within [min, max] are kept.
+QVector<qreal> gridLines(QVector<qreal> const &coordinates, qreal min, qreal max)
+{
+	QVector<qreal> result;
+	foreach (qreal const coordinate, coordinates) {
+		if (coordinate >= min && coordinate <= max) {
+			result << coordinate;
+		}
+	}
+
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+/// Returns index of the first grid line not less than given coordinate.
+int firstNotLess(QVector<qreal> const &lines, qreal coordinate)
+{
+	return std::lower_bound(lines.constBegin(), lines.constEnd(), coordinate) - lines.constBegin();
+}
+
+/// Returns index of the first grid line greater than given coordinate.
+int firstGreater(QVector<qreal> const &lines, qreal coordinate)
+{
+	return std::upper_bound(lines.constBegin(), lines.constEnd(), coordinate) - lines.constBegin();
+}
+
+}
+
+bool OrthogonalRouter::RouteKey::operator ==(RouteKey const &other) const
+{
+	return start == other.start && startNode == other.startNode && end == other.end && endNode == other.endNode;
+}
+
+OrthogonalRouter::OrthogonalRouter(ObstaclesProvider const &obstacles, qreal margin, qreal bendPenalty)
+	: mObstacles(obstacles)
+	, mMargin(margin)
+	, mBendPenalty(bendPenalty)
+	, mCache(routeCacheSize)
+{
+}
+
+QPolygonF OrthogonalRouter::route(QPointF const &start, QRectF const &startNode
+		, QPointF const &end, QRectF const &endNode)
+{
+	RouteKey const key = {start, startNode, end, endNode};
+	CachedRoute const * const cached = mCache.object(key);
+	if (cached && mObstacles(cached->area) == cached->obstacles) {
+		return cached->route;
+	}
+
+	int const startDirection = startNode.isNull() ? anyDirection : exitDirection(start, startNode);
+	int const endSide = endNode.isNull() ? anyDirection : exitDirection(end, endNode);
+	// The route comes into the end node moving in the direction opposite to leaving it.
+	int const endDirection = endNode.isNull() ? anyDirection : (endSide + 2) % directionsCount;
+	QPointF const routeStart = startNode.isNull() ? start : outgoingPoint(start, startNode, startDirection);
+	QPointF const routeEnd = endNode.isNull() ? end : outgoingPoint(end, endNode, endSide);
+
+	QRectF ends = QRectF(routeStart, routeEnd).normalized();
+	if (!startNode.isNull()) {
+		ends |= startNode;
+	}
+
+	if (!endNode.isNull()) {
+		ends |= endNode;
+	}
+
+	CachedRoute * const result = new CachedRoute();
+	qreal indent = initialAreaIndent + mMargin;
+	for (int i = 0; i <= maxAreaExpansions && result->route.isEmpty(); ++i, indent *= 2) {
+		result->area = ends.adjusted(-indent, -indent, indent, indent);
+		result->obstacles = mObstacles(result->area);
+		QPolygonF const path = search(routeStart, startDirection, routeEnd, endDirection, result->area
+				, relevantObstacles(result->obstacles, start, startNode, end, endNode));
+
+		if (!path.isEmpty()) {
+			QPolygonF route;
+			route << start << path << end;
+			result->route = simplified(route);
+		}
+	}
+
+	QPolygonF const route = result->route;
+	mCache.insert(key, result);
+	return route;
+}
+
+void OrthogonalRouter::clearCache()
+{
+	mCache.clear();
+}
+
+QPolygonF OrthogonalRouter::search(QPointF const &start, int startDirection, QPointF const &end, int endDirection
+		, QRectF const &area, QList<QRectF> const &obstacles) const
+{
+	QList<Bounds> inflated;
+	QVector<qreal> xs;
+	QVector<qreal> ys;
+	xs << area.left() << area.right() << start.x() << end.x();
+	ys << area.top() << area.bottom() << start.y() << end.y();
+	foreach (QRectF const &obstacle, obstacles) {
+		Bounds const bounds(obstacle, mMargin);
+		inflated << bounds;
+		xs << bounds.left << bounds.right;
+		ys << bounds.top << bounds.bottom;
+	}
+
+	xs = gridLines(xs, area.left(), area.right());
+	ys = gridLines(ys, area.top(), area.bottom());
+	int const width = xs.size();
+	int const height = ys.size();
+	if (static_cast<qint64>(width) * height > maxGridPoints) {
+		return QPolygonF();
+	}
+
+	// Grid points strictly inside obstacles and grid segments going through their insides.
+	// A horizontal segment of a point goes to the right of it, a vertical one goes down.
+	QBitArray blockedPoints(width * height);
+	QBitArray blockedHorizontal(width * height);
+	QBitArray blockedVertical(width * height);
+	foreach (Bounds const &bounds, inflated) {
+		int const firstX = firstNotLess(xs, bounds.left);
+		int const lastX = firstGreater(xs, bounds.right) - 1;
+		int const firstY = firstNotLess(ys, bounds.top);
+		int const lastY = firstGreater(ys, bounds.bottom) - 1;
+		int const firstInnerX = firstGreater(xs, bounds.left);
+		int const lastInnerX = firstNotLess(xs, bounds.right) - 1;
+		int const firstInnerY = firstGreater(ys, bounds.top);
+		int const lastInnerY = firstNotLess(ys, bounds.bottom) - 1;
+
+		for (int y = firstInnerY; y <= lastInnerY; ++y) {
+			for (int x = firstX; x < lastX; ++x) {
+				blockedHorizontal.setBit(y * width + x);
+			}
+
+			for (int x = firstInnerX; x <= lastInnerX; ++x) {
+				blockedPoints.setBit(y * width + x);
+			}
+		}
+
+		for (int x = firstInnerX; x <= lastInnerX; ++x) {
+			for (int y = firstY; y < lastY; ++y) {
+				blockedVertical.setBit(y * width + x);
+			}
+		}
+	}
+
+	int const goalX = firstNotLess(xs, end.x());
+	int const goalY = firstNotLess(ys, end.y());
+	int const goal = goalY * width + goalX;
+	int const origin = firstNotLess(ys, start.y()) * width + firstNotLess(xs, start.x());
+
+	// A* over states "grid point and direction the route came into it", so bends can be penalized. Only states
+	// reached by the search are stored, usually a small part of the grid.
+	QHash<int, qreal> costs;
+	QHash<int, int> previous;
+
+	typedef QPair<qreal, int> QueueItem;
+	std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > queue;
+
+	auto heuristic = [&](int point) {
+		return qAbs(xs[point % width] - xs[goalX]) + qAbs(ys[point / width] - ys[goalY]);
+	};
+
+	for (int direction = 0; direction < directionsCount; ++direction) {
+		if (startDirection == anyDirection || direction == startDirection) {
+			int const state = origin * directionsCount + direction;
+			costs[state] = 0;
+			queue.push(qMakePair(heuristic(origin), state));
+		}
+	}
+
+	while (!queue.empty()) {
+		QueueItem const item = queue.top();
+		queue.pop();
+
+		int const state = item.second;
+		int const point = state / directionsCount;
+		int const direction = state % directionsCount;
+		qreal const stateCost = costs.value(state);
+		if (item.first > stateCost + heuristic(point)) {
+			// The state has been reached cheaper since this item was queued.
+			continue;
+		}
+
+		if (point == goal) {
+			QPolygonF result;
+			for (int current = state; current != -1; current = previous.value(current, -1)) {
+				int const currentPoint = current / directionsCount;
+				result.prepend(QPointF(xs[currentPoint % width], ys[currentPoint / width]));
+			}
+
+			return result;
+		}
+
+		int const x = point % width;
+		int const y = point / width;
+		for (int next = 0; next < directionsCount; ++next) {
+			int const nextX = x + stepX[next];
+			int const nextY = y + stepY[next];
+			if (nextX < 0 || nextX >= width || nextY < 0 || nextY >= height) {
+				continue;
+			}
+
+			int const nextPoint = nextY * width + nextX;
+			bool const isSegmentBlocked = stepX[next] != 0
+					? blockedHorizontal.testBit(y * width + qMin(x, nextX))
+					: blockedVertical.testBit(qMin(y, nextY) * width + x);
+			if (isSegmentBlocked || blockedPoints.testBit(nextPoint)) {
+				continue;
+			}
+
+			qreal cost = stateCost + qAbs(xs[nextX] - xs[x]) + qAbs(ys[nextY] - ys[y]);
+			if (next != direction) {
+				// Turning back is two bends.
+				cost += (next == (direction + 2) % directionsCount) ? 2 * mBendPenalty : mBendPenalty;
+			}
+
+			if (nextPoint == goal && endDirection != anyDirection && next != endDirection) {
+				cost += mBendPenalty;
+			}
+
+			int const nextState = nextPoint * directionsCount + next;
+			QHash<int, qreal>::const_iterator const known = costs.constFind(nextState);
+			if (known == costs.constEnd() || cost < known.value()) {
+				costs[nextState] = cost;
+				previous[nextState] = state;
+				queue.push(qMakePair(cost + heuristic(nextPoint), nextState));
+			}
+		}
+	}
+
+	return QPolygonF();
+}
+
+int OrthogonalRouter::exitDirection(QPointF const &point, QRectF const &rect)
+{
+	qreal const distances[directionsCount] = {
+		qAbs(point.x() - rect.left())
+		, qAbs(point.y() - rect.top())
+		, qAbs(rect.right() - point.x())
+		, qAbs(rect.bottom() - point.y())
+	};
+
+	return std::min_element(distances, distances + directionsCount) - distances;
+}
+
+QPointF OrthogonalRouter::outgoingPoint(QPointF const &point, QRectF const &rect, int direction) const
+{
+	Bounds const bounds(rect, mMargin);
+	switch (direction) {
+	case leftward:
+		return QPointF(bounds.left, point.y());
+	case upward:
+		return QPointF(point.x(), bounds.top);
+	case rightward:
+		return QPointF(bounds.right, point.y());
+	default:
+		return QPointF(point.x(), bounds.bottom);
+	}
+}
+
+QList<QRectF> OrthogonalRouter::relevantObstacles(QList<QRectF> const &obstacles, QPointF const &start
+		, QRectF const &startNode, QPointF const &end, QRectF const &endNode)
+{
+	QList<QRectF> result;
+	foreach (QRectF const &obstacle, obstacles) {
+		bool const containsStart = startNode.isNull()
+				? obstacle.contains(start)
+				: obstacle != startNode && obstacle.contains(startNode);
+		bool const containsEnd = endNode.isNull()
+				? obstacle.contains(end)
+				: obstacle != endNode && obstacle.contains(endNode);
+		if (!containsStart && !containsEnd) {
+			result << obstacle;
+		}
+	}
+
+	return result;
+}
+
+QPolygonF OrthogonalRouter::simplified(QPolygonF const &route)
+{
+	QPolygonF result;
+	foreach (QPointF const &point, route) {
+		if (!result.isEmpty() && result.last() == point) {
+			continue;
+		}
+
+		if (result.size() >= 2) {
+			QPointF const &beforeLast = result[result.size() - 2];
+			QPointF const &last = result.last();
+			if ((beforeLast.x() == last.x() && last.x() == point.x())
+					|| (beforeLast.y() == last.y() && last.y() == point.y()))
+			{
+				result.last() = point;
+				continue;
+			}
+		}
+
+		result << point;
+	}
+
+	return result;
+}
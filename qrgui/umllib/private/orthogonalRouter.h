@@ -0,0 +1,94 @@
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QCache>
+#include <QtCore/QList>
+#include <QtCore/QRectF>
+#include <QtGui/QPolygonF>
+
+namespace qReal {
+
+/// Finds orthogonal routes of links avoiding rectangular obstacles. A route goes along a sparse visibility graph
+/// made of lines through sides of obstacles inflated by a margin and through ends of the link, A* search over
+/// that graph prefers short routes with few bends. Obstacles are requested from a provider only around the ends
+/// of the link, so routing stays local when the provider is backed by a spatial index. Found routes are reused
+/// while obstacles around them stay the same.
+class OrthogonalRouter
+{
+public:
+	/// Returns obstacles intersecting given rectangle.
+	typedef std::function<QList<QRectF>(QRectF const &area)> ObstaclesProvider;
+
+	/// @param obstacles - provider of obstacles to be avoided.
+	/// @param margin - minimal distance between a route and obstacles.
+	/// @param bendPenalty - length a route may be made longer by to avoid one bend.
+	explicit OrthogonalRouter(ObstaclesProvider const &obstacles, qreal margin = 20, qreal bendPenalty = 40);
+
+	/// Returns a route from start to end consisting of horizontal and vertical segments, an empty polygon if
+	/// there is no such route.
+	/// @param start - start of the route, usually a port on a side of startNode.
+	/// @param startNode - rectangle of a node the route starts from, it is left perpendicularly to the side closest
+	///        to start. Null rectangle if the start is not attached.
+	/// @param end - end of the route.
+	/// @param endNode - rectangle of a node the route ends at, null if the end is not attached.
+	QPolygonF route(QPointF const &start, QRectF const &startNode, QPointF const &end, QRectF const &endNode);
+
+	/// Forgets all found routes.
+	void clearCache();
+
+private:
+	/// Link ends a route is requested for.
+	struct RouteKey
+	{
+		QPointF start;
+		QRectF startNode;
+		QPointF end;
+		QRectF endNode;
+
+		bool operator ==(RouteKey const &other) const;
+	};
+
+	/// A found route with the area it was searched in and obstacles in that area.
+	struct CachedRoute
+	{
+		QRectF area;
+		QList<QRectF> obstacles;
+		QPolygonF route;
+	};
+
+	friend uint qHash(RouteKey const &key)
+	{
+		return ::qHash(key.start.x()) ^ ::qHash(key.start.y()) * 7
+				^ ::qHash(key.end.x()) * 31 ^ ::qHash(key.end.y()) * 127;
+	}
+
+	/// Searches for a route among given obstacles inside given area.
+	/// @param startDirection - direction the route shall leave the start point in, -1 for any.
+	/// @param endDirection - direction the route shall enter the end point in, -1 for any.
+	QPolygonF search(QPointF const &start, int startDirection, QPointF const &end, int endDirection
+			, QRectF const &area, QList<QRectF> const &obstacles) const;
+
+	/// Returns the side of a rectangle closest to given point, as the direction going out of the rectangle.
+	static int exitDirection(QPointF const &point, QRectF const &rect);
+
+	/// Returns a point on the line through given point perpendicular to the side of given rectangle,
+	/// margin away from the side.
+	QPointF outgoingPoint(QPointF const &point, QRectF const &rect, int direction) const;
+
+	/// Returns obstacles to be avoided by a route between given ends, that is all except containers of the ends.
+	static QList<QRectF> relevantObstacles(QList<QRectF> const &obstacles, QPointF const &start
+			, QRectF const &startNode, QPointF const &end, QRectF const &endNode);
+
+	/// Removes repeated points and intermediate points of straight parts.
+	static QPolygonF simplified(QPolygonF const &route);
+
+	ObstaclesProvider mObstacles;
+	qreal const mMargin;
+	qreal const mBendPenalty;
+
+	/// Found routes by ends of links, least recently used ones are dropped.
+	QCache<RouteKey, CachedRoute> mCache;
+};
+
+}
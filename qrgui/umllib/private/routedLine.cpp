@@ -0,0 +1,66 @@
+#include "umllib/private/routedLine.h"
+
+#include "umllib/nodeElement.h"
+#include "view/editorViewScene.h"
+
+using namespace qReal;
+
+RoutedLine::RoutedLine(EdgeElement *edge)
+		: SquareLine(edge)
+		, mRouter([this](QRectF const &area) { return obstacles(area); }, margin, 4 * kvadratik)
+{
+}
+
+bool RoutedLine::isObstructedBy(QRectF const &sceneRect) const
+{
+	QPainterPath area;
+	area.addRect(mEdge->mapRectFromScene(sceneRect));
+	return mEdge->collidesWithPath(area);
+}
+
+bool RoutedLine::isRoutedAround(QRectF const &sceneRect) const
+{
+	// Routes around a node go exactly on the margin from it, so a slightly larger rectangle catches them.
+	return isObstructedBy(sceneRect.adjusted(-margin - 1, -margin - 1, margin + 1, margin + 1));
+}
+
+void RoutedLine::improveAppearance()
+{
+	QPolygonF const line = mEdge->line();
+	if (!dynamic_cast<EditorViewScene *>(mEdge->scene()) || line.size() < 2) {
+		SquareLine::improveAppearance();
+		return;
+	}
+
+	QPolygonF const route = mRouter.route(mEdge->mapToScene(line.first()), sceneContents(mEdge->src())
+			, mEdge->mapToScene(line.last()), sceneContents(mEdge->dst()));
+
+	if (route.size() < 2) {
+		SquareLine::improveAppearance();
+		return;
+	}
+
+	mEdge->setLine(mEdge->mapFromScene(route));
+}
+
+QList<QRectF> RoutedLine::obstacles(QRectF const &sceneArea) const
+{
+	QList<QRectF> result;
+	EditorViewScene const * const scene = dynamic_cast<EditorViewScene *>(mEdge->scene());
+	if (!scene) {
+		return result;
+	}
+
+	QPainterPath area;
+	area.addRect(sceneArea);
+	foreach (NodeElement const * const node, scene->nodesIn(area)) {
+		result << sceneContents(node);
+	}
+
+	return result;
+}
+
+QRectF RoutedLine::sceneContents(NodeElement const *node)
+{
+	return node ? node->mapRectToScene(node->contentsRect()) : QRectF();
+}
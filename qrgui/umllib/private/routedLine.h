@@ -0,0 +1,40 @@
+#pragma once
+
+#include "umllib/private/squareLine.h"
+#include "umllib/private/orthogonalRouter.h"
+
+namespace qReal {
+
+/// @brief A strategy class for handling square link routed around all nodes of a diagram, not only around
+/// adjacent ones. Routes are found by OrthogonalRouter among nodes taken from the spatial index of the scene.
+/// Link may be reshaped by the user like square one until it is laid out again.
+class RoutedLine : public SquareLine
+{
+	Q_OBJECT
+public:
+	RoutedLine(EdgeElement *edge);
+
+	/// Distance kept between routes and nodes.
+	static int const margin = 2 * kvadratik;
+
+	/// @return true if the link crosses given rectangle in scene coordinates, so it shall be routed again
+	virtual bool isObstructedBy(QRectF const &sceneRect) const;
+
+	/// @return true if the link goes along given rectangle in scene coordinates at the margin distance
+	virtual bool isRoutedAround(QRectF const &sceneRect) const;
+
+protected:
+	/// Route the link around nodes, lay it out as square link if there is no route
+	virtual void improveAppearance();
+
+private:
+	/// @return contents rectangles of nodes intersecting given area, all in scene coordinates
+	QList<QRectF> obstacles(QRectF const &sceneArea) const;
+
+	/// @return contents rectangle of given node in scene coordinates, null rectangle for no node
+	static QRectF sceneContents(NodeElement const *node);
+
+	OrthogonalRouter mRouter;
+};
+
+}
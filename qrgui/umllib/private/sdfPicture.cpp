@@ -0,0 +1,347 @@
+#include "sdfPicture.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+
+using namespace qReal;
+
+namespace {
+
+/// The number of rendered pictures kept for a shape: a few sizes and property states of elements on a diagram.
+int const renderedCacheSize = 32;
+
+}
+
+SdfPicture::Coordinate::Coordinate()
+	: value(0)
+	, kind(scaled)
+{
+}
+
+SdfPicture::Style::Style()
+	: hasStrokeWidth(false), strokeWidth(1)
+	, hasFill(false)
+	, hasStroke(false)
+	, hasStrokeStyle(false), strokeStyle(Qt::SolidLine)
+	, hasFillStyle(false), fillStyle(Qt::NoBrush)
+	, hasFontFill(false)
+	, hasFontSize(false), fontSize(0), fontSizeKind(Coordinate::scaled)
+	, hasFontName(false)
+	, hasBold(false), bold(false)
+	, hasItalic(false), italic(false)
+	, hasUnderline(false), underline(false)
+{
+}
+
+SdfPicture::Primitive::Primitive()
+	: type(line)
+	, startAngle(0)
+	, spanAngle(0)
+{
+}
+
+SdfPicture::SdfPicture()
+	: mWidth(0)
+	, mHeight(0)
+	, mCacheable(true)
+	, mRendered(renderedCacheSize)
+{
+}
+
+QSharedPointer<SdfPicture> SdfPicture::fromFile(QString const &fileName)
+{
+	static QHash<QString, QSharedPointer<SdfPicture> > compiled;
+	if (compiled.contains(fileName)) {
+		return compiled[fileName];
+	}
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		return QSharedPointer<SdfPicture>();
+	}
+
+	QDomDocument document;
+	if (!document.setContent(&file)) {
+		return QSharedPointer<SdfPicture>();
+	}
+
+	QSharedPointer<SdfPicture> const result = fromDocument(document);
+	compiled[fileName] = result;
+	return result;
+}
+
+QSharedPointer<SdfPicture> SdfPicture::fromDocument(QDomDocument const &document)
+{
+	QSharedPointer<SdfPicture> const result(new SdfPicture());
+	result->compile(document.documentElement());
+	return result;
+}
+
+int SdfPicture::width() const
+{
+	return mWidth;
+}
+
+int SdfPicture::height() const
+{
+	return mHeight;
+}
+
+QList<SdfPicture::Primitive> const &SdfPicture::primitives() const
+{
+	return mPrimitives;
+}
+
+QStringList const &SdfPicture::conditionProperties() const
+{
+	return mConditionProperties;
+}
+
+bool SdfPicture::isCacheable() const
+{
+	return mCacheable;
+}
+
+QPicture *SdfPicture::rendered(QString const &key) const
+{
+	return mRendered.object(key);
+}
+
+void SdfPicture::setRendered(QString const &key, QPicture *picture)
+{
+	mRendered.insert(key, picture);
+}
+
+void SdfPicture::compile(QDomElement const &pictureElement)
+{
+	mWidth = pictureElement.attribute("sizex").toInt();
+	mHeight = pictureElement.attribute("sizey").toInt();
+
+	for (QDomElement element = pictureElement.firstChildElement()
+			; !element.isNull()
+			; element = element.nextSiblingElement())
+	{
+		QList<Condition> const elementConditions = conditions(element);
+		foreach (Condition const &condition, elementConditions) {
+			if (!mConditionProperties.contains(condition.property)) {
+				mConditionProperties << condition.property;
+			}
+		}
+
+		if (element.tagName() == "stylus") {
+			// Lines of a stylus are shown by conditions of the whole stylus.
+			for (QDomElement line = element.firstChildElement("line")
+					; !line.isNull()
+					; line = line.nextSiblingElement("line"))
+			{
+				compileElement(line, elementConditions);
+			}
+		} else {
+			compileElement(element, elementConditions);
+		}
+	}
+}
+
+void SdfPicture::compileElement(QDomElement const &element, QList<Condition> const &conditions)
+{
+	Primitive primitive;
+	QString const tagName = element.tagName();
+	if (tagName == "line") {
+		primitive.type = Primitive::line;
+	} else if (tagName == "ellipse") {
+		primitive.type = Primitive::ellipse;
+	} else if (tagName == "arc") {
+		primitive.type = Primitive::arc;
+		primitive.startAngle = element.attribute("startAngle").toInt();
+		primitive.spanAngle = element.attribute("spanAngle").toInt();
+	} else if (tagName == "background") {
+		primitive.type = Primitive::background;
+		// Background fills the whole paint device, so it can not be recorded once and replayed anywhere.
+		mCacheable = false;
+	} else if (tagName == "text") {
+		primitive.type = Primitive::text;
+		QString text = element.text();
+		if (text.startsWith('\n')) {
+			text.remove(0, 1);
+		}
+
+		if (text.endsWith('\n')) {
+			text.chop(1);
+		}
+
+		primitive.textLines = text.split('\n');
+	} else if (tagName == "rectangle") {
+		primitive.type = Primitive::rectangle;
+	} else if (tagName == "polygon") {
+		primitive.type = Primitive::polygon;
+		int const pointsCount = element.attribute("n").toInt();
+		for (int i = 1; i <= pointsCount; ++i) {
+			primitive.points << qMakePair(coordinate(element.attribute(QString("x%1").arg(i)))
+					, coordinate(element.attribute(QString("y%1").arg(i))));
+		}
+	} else if (tagName == "point") {
+		primitive.type = Primitive::point;
+	} else if (tagName == "path") {
+		primitive.type = Primitive::path;
+		primitive.pathCommands = pathCommands(element.attribute("d"));
+	} else if (tagName == "curve") {
+		primitive.type = Primitive::curve;
+		QDomElement const start = element.firstChildElement("start");
+		QDomElement const end = element.firstChildElement("end");
+		QDomElement const control = element.firstChildElement("ctrl");
+		primitive.curveStart = QPointF(start.attribute("startx").toDouble(), start.attribute("starty").toDouble());
+		primitive.curveEnd = QPointF(end.attribute("endx").toDouble(), end.attribute("endy").toDouble());
+		primitive.curveControl = QPointF(control.attribute("x").toDouble(), control.attribute("y").toDouble());
+	} else if (tagName == "image") {
+		primitive.type = Primitive::image;
+		primitive.imageName = element.attribute("name", "error");
+	} else {
+		return;
+	}
+
+	primitive.x1 = coordinate(element.attribute("x1"));
+	primitive.y1 = coordinate(element.attribute("y1"));
+	primitive.x2 = coordinate(element.attribute("x2"));
+	primitive.y2 = coordinate(element.attribute("y2"));
+	primitive.style = style(element);
+	primitive.conditions = conditions;
+	mPrimitives << primitive;
+}
+
+SdfPicture::Coordinate SdfPicture::coordinate(QString const &value)
+{
+	Coordinate result;
+	QString number = value;
+	if (number.endsWith("%")) {
+		result.kind = Coordinate::percent;
+		number.chop(1);
+	} else if (number.endsWith("a")) {
+		result.kind = Coordinate::absolute;
+		number.chop(1);
+	}
+
+	result.value = number.toFloat();
+	return result;
+}
+
+SdfPicture::Style SdfPicture::style(QDomElement const &element)
+{
+	Style result;
+
+	if (element.hasAttribute("stroke-width")) {
+		result.hasStrokeWidth = true;
+		result.strokeWidth = element.attribute("stroke-width").toInt();
+	}
+
+	if (element.hasAttribute("fill")) {
+		result.hasFill = true;
+		result.fill = QColor(element.attribute("fill"));
+	}
+
+	if (element.hasAttribute("stroke")) {
+		result.hasStroke = true;
+		result.stroke = QColor(element.attribute("stroke"));
+	}
+
+	if (element.hasAttribute("stroke-style")) {
+		QString const strokeStyle = element.attribute("stroke-style");
+		result.hasStrokeStyle = true;
+		if (strokeStyle == "solid") {
+			result.strokeStyle = Qt::SolidLine;
+		} else if (strokeStyle == "dot") {
+			result.strokeStyle = Qt::DotLine;
+		} else if (strokeStyle == "dash") {
+			result.strokeStyle = Qt::DashLine;
+		} else if (strokeStyle == "dashdot") {
+			result.strokeStyle = Qt::DashDotLine;
+		} else if (strokeStyle == "dashdotdot") {
+			result.strokeStyle = Qt::DashDotDotLine;
+		} else if (strokeStyle == "none") {
+			result.strokeStyle = Qt::NoPen;
+		} else {
+			result.hasStrokeStyle = false;
+		}
+	}
+
+	if (element.hasAttribute("fill-style")) {
+		QString const fillStyle = element.attribute("fill-style");
+		result.hasFillStyle = fillStyle == "none" || fillStyle == "solid";
+		result.fillStyle = fillStyle == "solid" ? Qt::SolidPattern : Qt::NoBrush;
+	}
+
+	if (element.hasAttribute("font-fill")) {
+		result.hasFontFill = true;
+		result.fontFill = QColor(element.attribute("font-fill"));
+	}
+
+	if (element.hasAttribute("font-size")) {
+		// Font size is integer, unlike coordinates.
+		Coordinate const fontSize = coordinate(element.attribute("font-size"));
+		QString number = element.attribute("font-size");
+		if (fontSize.kind != Coordinate::scaled) {
+			number.chop(1);
+		}
+
+		result.hasFontSize = true;
+		result.fontSize = number.toInt();
+		result.fontSizeKind = fontSize.kind;
+	}
+
+	if (element.hasAttribute("font-name")) {
+		result.hasFontName = true;
+		result.fontName = element.attribute("font-name");
+	}
+
+	if (element.hasAttribute("b")) {
+		result.hasBold = true;
+		result.bold = element.attribute("b").toInt();
+	}
+
+	if (element.hasAttribute("i")) {
+		result.hasItalic = true;
+		result.italic = element.attribute("i").toInt();
+	}
+
+	if (element.hasAttribute("u")) {
+		result.hasUnderline = true;
+		result.underline = element.attribute("u").toInt();
+	}
+
+	return result;
+}
+
+QList<SdfPicture::Condition> SdfPicture::conditions(QDomElement const &element)
+{
+	QList<Condition> result;
+	QDomNodeList const showConditions = element.elementsByTagName("showIf");
+	for (int i = 0; i < showConditions.length(); ++i) {
+		QDomElement const conditionElement = showConditions.at(i).toElement();
+		Condition condition;
+		condition.property = conditionElement.attribute("property");
+		condition.sign = conditionElement.attribute("sign");
+		condition.value = conditionElement.attribute("value");
+		if (condition.sign == "=~") {
+			condition.regExp = QRegExp(condition.value);
+		}
+
+		result << condition;
+	}
+
+	return result;
+}
+
+QList<SdfPicture::PathCommand> SdfPicture::pathCommands(QString const &d)
+{
+	QList<PathCommand> result;
+	foreach (QString const &token, d.split(' ', QString::SkipEmptyParts)) {
+		if (token == "M" || token == "L" || token == "C" || token == "Z") {
+			PathCommand command;
+			command.type = token.at(0).toLatin1();
+			result << command;
+		} else if (!result.isEmpty()) {
+			result.last().coordinates << token.toFloat();
+		}
+	}
+
+	return result;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <QtCore/QCache>
+#include <QtCore/QPair>
+#include <QtCore/QPointF>
+#include <QtCore/QRegExp>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+#include <QtGui/QColor>
+#include <QtGui/QPicture>
+#include <QtXml/QDomDocument>
+
+namespace qReal {
+
+/// SDF picture compiled into a list of typed primitives, so rendering does not walk DOM, compare tag names
+/// and parse attributes on every paint. Also keeps rendered pictures, which are shared by all renderers
+/// of the same shape.
+class SdfPicture
+{
+public:
+	/// A coordinate or a size as it is written in SDF: scaled with the picture (plain number), in percents
+	/// of the current size ("%" suffix) or absolute ("a" suffix).
+	struct Coordinate
+	{
+		enum Kind
+		{
+			scaled = 0
+			, percent
+			, absolute
+		};
+
+		Coordinate();
+
+		float value;
+		Kind kind;
+	};
+
+	/// "showIf" condition on a logical property of an element.
+	struct Condition
+	{
+		QString property;
+		QString sign;
+		QString value;
+		QRegExp regExp;
+	};
+
+	/// Style attributes of a primitive, only ones present in SDF are applied.
+	struct Style
+	{
+		Style();
+
+		bool hasStrokeWidth;
+		int strokeWidth;
+		bool hasFill;
+		QColor fill;
+		bool hasStroke;
+		QColor stroke;
+		bool hasStrokeStyle;
+		Qt::PenStyle strokeStyle;
+		bool hasFillStyle;
+		Qt::BrushStyle fillStyle;
+		bool hasFontFill;
+		QColor fontFill;
+		bool hasFontSize;
+		int fontSize;
+		Coordinate::Kind fontSizeKind;
+		bool hasFontName;
+		QString fontName;
+		bool hasBold;
+		bool bold;
+		bool hasItalic;
+		bool italic;
+		bool hasUnderline;
+		bool underline;
+	};
+
+	/// One segment of a path, coordinates are in picture units.
+	struct PathCommand
+	{
+		char type;
+		QList<float> coordinates;
+	};
+
+	struct Primitive
+	{
+		enum Type
+		{
+			line = 0
+			, ellipse
+			, arc
+			, background
+			, text
+			, rectangle
+			, polygon
+			, point
+			, path
+			, curve
+			, image
+		};
+
+		Primitive();
+
+		Type type;
+		Style style;
+		QList<Condition> conditions;
+
+		Coordinate x1;
+		Coordinate y1;
+		Coordinate x2;
+		Coordinate y2;
+
+		/// Angles of an arc.
+		int startAngle;
+		int spanAngle;
+
+		/// Vertices of a polygon.
+		QList<QPair<Coordinate, Coordinate> > points;
+
+		/// Lines of a text.
+		QStringList textLines;
+
+		/// Segments of a path.
+		QList<PathCommand> pathCommands;
+
+		/// Start, end and control point of a curve.
+		QPointF curveStart;
+		QPointF curveEnd;
+		QPointF curveControl;
+
+		/// Image file name relative to images folder.
+		QString imageName;
+	};
+
+	/// Returns compiled picture from given SDF file, pictures are compiled once per file, so all elements
+	/// of a type share one.
+	/// @returns null pointer if the file can not be read.
+	static QSharedPointer<SdfPicture> fromFile(QString const &fileName);
+
+	/// Compiles given SDF document, the result is not shared.
+	static QSharedPointer<SdfPicture> fromDocument(QDomDocument const &document);
+
+	int width() const;
+	int height() const;
+
+	QList<Primitive> const &primitives() const;
+
+	/// Returns names of logical properties used by show conditions of primitives.
+	QStringList const &conditionProperties() const;
+
+	/// Returns false if rendered picture can not be reused, for example, when it paints the whole device.
+	bool isCacheable() const;
+
+	/// Returns rendered picture stored with given key, nullptr if there is none.
+	QPicture *rendered(QString const &key) const;
+
+	/// Stores rendered picture with given key, takes ownership.
+	void setRendered(QString const &key, QPicture *picture);
+
+private:
+	SdfPicture();
+
+	void compile(QDomElement const &pictureElement);
+	void compileElement(QDomElement const &element, QList<Condition> const &conditions);
+
+	static Coordinate coordinate(QString const &value);
+	static Style style(QDomElement const &element);
+	static QList<Condition> conditions(QDomElement const &element);
+	static QList<PathCommand> pathCommands(QString const &d);
+
+	int mWidth;
+	int mHeight;
+	QList<Primitive> mPrimitives;
+	QStringList mConditionProperties;
+	bool mCacheable;
+
+	/// Rendered pictures by size, mode and values of condition properties, least recently used ones are dropped.
+	QCache<QString, QPicture> mRendered;
+};
+
+}
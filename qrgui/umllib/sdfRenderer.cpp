@@ -9,18 +9,20 @@
 #include <QtWidgets/QApplication>
 #include <QtGui/QFont>
 #include <QtGui/QIcon>
+#include <QtGui/QPicture>
+#include <QtGui/QPolygon>
 #include <QtSvg/QSvgRenderer>
 
 using namespace qReal;
 
 SdfRenderer::SdfRenderer()
-	: mStartX(0), mStartY(0), mNeedScale(true), mElementRepo(0)
+	: mStartX(0), mStartY(0), painter(0), mNeedScale(true), mNeedCache(true), mElementRepo(0)
 {
 	mWorkingDirName = SettingsManager::value("workingDir").toString();
 }
 
 SdfRenderer::SdfRenderer(QString const path)
-	: mStartX(0), mStartY(0), mNeedScale(true)
+	: mStartX(0), mStartY(0), painter(0), mNeedScale(true), mNeedCache(true), mElementRepo(0)
 {
 	if (!load(path))
 	{
@@ -35,32 +37,13 @@ SdfRenderer::~SdfRenderer()
 
 bool SdfRenderer::load(QString const &filename)
 {
-	QFile file(filename);
-
-	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-		return false;
-
-	if (!doc.setContent(&file))
-	{
-		file.close();
-		return false;
-	}
-	file.close();
-
-	QDomElement docElem = doc.documentElement();
-	first_size_x = docElem.attribute("sizex").toInt();
-	first_size_y = docElem.attribute("sizey").toInt();
-
-	return true;
+	mPicture = SdfPicture::fromFile(filename);
+	return !mPicture.isNull();
 }
 
 bool SdfRenderer::load(QDomDocument const &document)
 {
-	doc = document;
-	QDomElement const docElem = doc.firstChildElement("picture");
-	first_size_x = docElem.attribute("sizex").toInt();
-	first_size_y = docElem.attribute("sizey").toInt();
-
+	mPicture = SdfPicture::fromDocument(document);
 	return true;
 }
 
@@ -70,101 +53,142 @@ void SdfRenderer::setElementRepo(ElementRepoInterface *elementRepo){
 
 void SdfRenderer::render(QPainter *painter, const QRectF &bounds, bool isIcon)
 {
+	if (!mPicture) {
+		return;
+	}
+
 	current_size_x = static_cast<int>(bounds.width());
 	current_size_y = static_cast<int>(bounds.height());
-	mStartX = static_cast<int>(bounds.x());
-	mStartY = static_cast<int>(bounds.y());
-	this->painter = painter;
-	QDomElement docElem = doc.documentElement();
-	QDomNode node = docElem.firstChild();
-	while(!node.isNull())
-	{
-		QDomElement elem = node.toElement();
-		if(!elem.isNull())
-		{
-			if (!checkShowConditions(elem, isIcon)) {
-				node = node.nextSibling();
-				continue;
-			}
-			if (elem.tagName()=="line")
-			{
-				line(elem);
-			}
-			else if(elem.tagName()=="ellipse")
-			{
-				ellipse(elem);
-			}
-			else if (elem.tagName() == "arc") {
-				arc(elem);
-			}
-			else if(elem.tagName()=="background")
-			{
-				background(elem);
-			}
-			else if(elem.tagName()=="text")
-			{
-				draw_text(elem);
-			}
-			else if (elem.tagName()=="rectangle")
-			{
-				rectangle(elem);
-			}
-			else if (elem.tagName()=="polygon")
-			{
-				polygon(elem);
-			}
-			else if (elem.tagName()=="point")
-			{
-				point(elem);
-			}
-			else if(elem.tagName()=="path")
-			{
-				path_draw(elem);
-			}
-			else if(elem.tagName()=="stylus")
-			{
-				stylus_draw(elem);
-			}
-			else if(elem.tagName()=="curve")
-			{
-				curve_draw(elem);
-			}
-			else if(elem.tagName()=="image")
-			{
-				image_draw(elem);
-			}
+	int const startX = static_cast<int>(bounds.x());
+	int const startY = static_cast<int>(bounds.y());
+
+	if (!mNeedCache || !mPicture->isCacheable()) {
+		mStartX = startX;
+		mStartY = startY;
+		this->painter = painter;
+		painter->save();
+		draw(isIcon);
+		painter->restore();
+		this->painter = 0;
+		return;
+	}
+
+	// Pictures are recorded at the origin, so the same one is reused wherever an element is.
+	QString const key = cacheKey(isIcon);
+	QPicture const *picture = mPicture->rendered(key);
+	if (!picture) {
+		QPicture * const recorded = new QPicture();
+		QPainter recorder(recorded);
+		mStartX = 0;
+		mStartY = 0;
+		this->painter = &recorder;
+		draw(isIcon);
+		this->painter = 0;
+		recorder.end();
+		recorded->setBoundingRect(QRect(0, 0, current_size_x, current_size_y));
+		mPicture->setRendered(key, recorded);
+		picture = recorded;
+	}
+
+	painter->drawPicture(QPoint(startX, startY), *picture);
+}
+
+void SdfRenderer::draw(bool isIcon)
+{
+	// Style is not carried over from previous renders, so a recorded picture is the same as a painted one.
+	pen = QPen();
+	font = QFont();
+	brush = QBrush();
+	defaultstyle();
+
+	foreach (SdfPicture::Primitive const &primitive, mPicture->primitives()) {
+		if (!checkShowConditions(primitive, isIcon)) {
+			continue;
+		}
+
+		switch (primitive.type) {
+		case SdfPicture::Primitive::line:
+			line(primitive);
+			break;
+		case SdfPicture::Primitive::ellipse:
+			ellipse(primitive);
+			break;
+		case SdfPicture::Primitive::arc:
+			arc(primitive);
+			break;
+		case SdfPicture::Primitive::background:
+			background(primitive);
+			break;
+		case SdfPicture::Primitive::text:
+			draw_text(primitive);
+			break;
+		case SdfPicture::Primitive::rectangle:
+			rectangle(primitive);
+			break;
+		case SdfPicture::Primitive::polygon:
+			polygon(primitive);
+			break;
+		case SdfPicture::Primitive::point:
+			point(primitive);
+			break;
+		case SdfPicture::Primitive::path:
+			path_draw(primitive);
+			break;
+		case SdfPicture::Primitive::curve:
+			curve_draw(primitive);
+			break;
+		case SdfPicture::Primitive::image:
+			image_draw(primitive);
+			break;
 		}
-		node = node.nextSibling();
 	}
-	this->painter = 0;
 }
 
-bool SdfRenderer::checkShowConditions(QDomElement const &element, bool isIcon) const
+QString SdfRenderer::cacheKey(bool isIcon) const
+{
+	QString key = QString("%1 %2 %3 %4").arg(current_size_x).arg(current_size_y).arg(isIcon).arg(mNeedScale);
+	// Icons do not show conditional primitives at all, elements without repo show all of them.
+	if (isIcon || mPicture->conditionProperties().isEmpty()) {
+		return key;
+	}
+
+	if (!mElementRepo) {
+		return key + " all";
+	}
+
+	foreach (QString const &property, mPicture->conditionProperties()) {
+		QString const value = mElementRepo->logicalProperty(property);
+		key += QString(" %1:%2").arg(value.length()).arg(value);
+	}
+
+	return key;
+}
+
+bool SdfRenderer::checkShowConditions(SdfPicture::Primitive const &primitive, bool isIcon) const
 {
-	QDomNodeList showConditions = element.elementsByTagName("showIf");
 	// a hack, need to be removed when there is another version of icons
-	if (!showConditions.isEmpty() && isIcon) {
+	if (!primitive.conditions.isEmpty() && isIcon) {
 		return false;
 	}
-	if (showConditions.isEmpty() || !mElementRepo) {
+	if (primitive.conditions.isEmpty() || !mElementRepo) {
 		return true;
 	}
-	for (int i = 0; i < showConditions.length(); ++i) {
-		if (!checkCondition(showConditions.at(i).toElement())) {
+	foreach (SdfPicture::Condition const &condition, primitive.conditions) {
+		if (!checkCondition(condition)) {
 			return false;
 		}
 	}
 	return true;
 }
 
-bool SdfRenderer::checkCondition(QDomElement const &condition) const
+bool SdfRenderer::checkCondition(SdfPicture::Condition const &condition) const
 {
-	QString sign = condition.attribute("sign");
-	QString realValue = mElementRepo->logicalProperty(condition.attribute("property"));
-	QString conditionValue = condition.attribute("value");
+	QString const &sign = condition.sign;
+	QString const realValue = mElementRepo->logicalProperty(condition.property);
+	QString const &conditionValue = condition.value;
 
 	if (sign == "=~") {
-		return QRegExp(conditionValue).exactMatch(realValue);
+		return condition.regExp.exactMatch(realValue);
 	} else if (sign == ">") {
 		return realValue.toInt() > conditionValue.toInt();
 	} else if (sign == "<") {
@@ -183,121 +207,101 @@ bool SdfRenderer::checkCondition(QDomElement const &condition) const
 	}
 }
 
-void SdfRenderer::line(QDomElement &element)
+void SdfRenderer::line(SdfPicture::Primitive const &primitive)
 {
-	float x1 = x1_def(element);
-	float y1 = y1_def(element);
-	float x2 = x2_def(element);
-	float y2 = y2_def(element);
-	QLineF line (x1,y1,x2,y2);
-
-	parsestyle(element);
+	QLineF const line(x1_def(primitive), y1_def(primitive), x2_def(primitive), y2_def(primitive));
+	parsestyle(primitive.style);
 	painter->drawLine(line);
 }
 
-void SdfRenderer::ellipse(QDomElement &element)
+void SdfRenderer::ellipse(SdfPicture::Primitive const &primitive)
 {
-	float x1 = x1_def(element);
-	float y1 = y1_def(element);
-	float x2 = x2_def(element);
-	float y2 = y2_def(element);
+	float x1 = x1_def(primitive);
+	float y1 = y1_def(primitive);
+	float x2 = x2_def(primitive);
+	float y2 = y2_def(primitive);
 
 	QRectF rect(x1, y1, x2-x1, y2-y1);
-	parsestyle(element);
+	parsestyle(primitive.style);
 	painter->drawEllipse(rect);
 }
 
-void SdfRenderer::arc(QDomElement &element)
+void SdfRenderer::arc(SdfPicture::Primitive const &primitive)
 {
-	float x1 = x1_def(element);
-	float y1 = y1_def(element);
-	float x2 = x2_def(element);
-	float y2 = y2_def(element);
-	int startAngle = element.attribute("startAngle").toInt();
-	int spanAngle = element.attribute("spanAngle").toInt();
+	float x1 = x1_def(primitive);
+	float y1 = y1_def(primitive);
+	float x2 = x2_def(primitive);
+	float y2 = y2_def(primitive);
 
 	QRectF rect(x1, y1, x2-x1, y2-y1);
-	parsestyle(element);
-	painter->drawArc(rect, startAngle, spanAngle);
+	parsestyle(primitive.style);
+	painter->drawArc(rect, primitive.startAngle, primitive.spanAngle);
 }
 
-void SdfRenderer::background(QDomElement &element)
+void SdfRenderer::background(SdfPicture::Primitive const &primitive)
 {
-	parsestyle(element);
+	parsestyle(primitive.style);
 	painter->setPen(brush.color());
 	painter->drawRect(painter->window());
 	defaultstyle();
 }
 
-void SdfRenderer::draw_text(QDomElement &element)
+void SdfRenderer::draw_text(SdfPicture::Primitive const &primitive)
 {
-	parsestyle(element);
+	parsestyle(primitive.style);
 	pen.setStyle(Qt::SolidLine);
 	painter->setPen(pen);
-	float x1 = x1_def(element);
-	float y1 = y1_def(element);
-	QString str = element.text();
+	float x1 = x1_def(primitive);
+	float y1 = y1_def(primitive);
 
-	// delete "\n" from the beginning of the string
-	if (str[0] == '\n')
-		str.remove(0, 1);
-
-	// delete "\n" from the end of the string
-	if (str[str.length() - 1] == '\n')
-		str.remove(str.length() - 1, 1);
-
-	while (str.contains('\n'))
-	{
-		int i = str.indexOf('\n');
-		QString temp = str.left(i);
-		str.remove(0, i + 1);
-		painter->drawText(static_cast<int>(x1), static_cast<int>(y1), temp);
-		y1 += painter->font().pixelSize() ;
+	QStringList const &lines = primitive.textLines;
+	for (int i = 0; i < lines.size() - 1; ++i) {
+		painter->drawText(static_cast<int>(x1), static_cast<int>(y1), lines[i]);
+		y1 += painter->font().pixelSize();
 	}
+
 	QPointF point(x1, y1);
-	painter->drawText(point, str);
+	painter->drawText(point, lines.last());
 	defaultstyle();
 }
 
-void SdfRenderer::rectangle(QDomElement &element)
+void SdfRenderer::rectangle(SdfPicture::Primitive const &primitive)
 {
-	float x1 = x1_def(element);
-	float y1 = y1_def(element);
-	float x2 = x2_def(element);
-	float y2 = y2_def(element);
+	float x1 = x1_def(primitive);
+	float y1 = y1_def(primitive);
+	float x2 = x2_def(primitive);
+	float y2 = y2_def(primitive);
 
 	QRectF rect;
 	rect.adjust(x1, y1, x2, y2);
-	parsestyle(element);
+	parsestyle(primitive.style);
 	painter->drawRect(rect);
 	defaultstyle();
 }
 
-void SdfRenderer::polygon(QDomElement &element)
+void SdfRenderer::polygon(SdfPicture::Primitive const &primitive)
 {
-	parsestyle(element);
-	// FIXME: init points array here
-	QPoint *points = NULL;
-	int n = element.attribute("n").toInt();
-	if (!element.isNull())
-	{
-		points = getpoints(element, n);
+	parsestyle(primitive.style);
+	QPolygon points;
+	for (int i = 0; i < primitive.points.size(); ++i) {
+		float const x = coord_def(primitive.points[i].first, current_size_x, mPicture->width()) + mStartX;
+		float const y = coord_def(primitive.points[i].second, current_size_y, mPicture->height()) + mStartY;
+		points << QPoint(static_cast<int>(x), static_cast<int>(y));
 	}
-	if (points != NULL)
-	{
-		painter->drawConvexPolygon(points, n);
-		delete[] points;
+
+	if (!points.isEmpty()) {
+		painter->drawConvexPolygon(points);
 	}
 	defaultstyle();
 }
 
-void SdfRenderer::image_draw(QDomElement &element)
+void SdfRenderer::image_draw(SdfPicture::Primitive const &primitive)
 {
-	float x1 = x1_def(element);
-	float y1 = y1_def(element);
-	float x2 = x2_def(element);
-	float y2 = y2_def(element);
-	QString fileName = SettingsManager::value("pathToImages").toString() + "/" + element.attribute("name", "error");
+	float x1 = x1_def(primitive);
+	float y1 = y1_def(primitive);
+	float x2 = x2_def(primitive);
+	float y2 = y2_def(primitive);
+	QString fileName = SettingsManager::value("pathToImages").toString() + "/" + primitive.imageName;
 	// TODO: rewrite this ugly spike
 	if (fileName.startsWith("./")) {
 		fileName = QApplication::applicationDirPath() + "/" + fileName;
@@ -327,70 +331,16 @@ void SdfRenderer::image_draw(QDomElement &element)
 	}
 }
 
-void SdfRenderer::point(QDomElement &element)
+void SdfRenderer::point(SdfPicture::Primitive const &primitive)
 {
-	parsestyle(element);
-	float x = x1_def(element);
-	float y = y1_def(element);
+	parsestyle(primitive.style);
+	float x = x1_def(primitive);
+	float y = y1_def(primitive);
 	QPointF pointf(x,y);
 	painter->drawLine(QPointF(pointf.x()-0.1, pointf.y()-0.1), QPointF(pointf.x()+0.1, pointf.y()+0.1));
 	defaultstyle();
 }
 
-QPoint *SdfRenderer::getpoints(QDomElement &element, int n)
-{
-	QPoint *array = new QPoint[n];
-	float x = 0;
-	float y = 0;
-	for (int i = 0; i < n; i++)
-	{
-		QString str;
-		str.setNum(i + 1);
-		QDomElement elem = element;
-		QString xnum = elem.attribute(QString("x").append(str));
-		if (xnum.endsWith("%"))
-		{
-			xnum.chop(1);
-			x = current_size_x * xnum.toFloat() / 100 + mStartX;
-		}
-		else if (xnum.endsWith("a") && mNeedScale)
-		{
-			xnum.chop(1);
-			x = xnum.toFloat() + mStartX;
-		}
-		else if (xnum.endsWith("a") && !mNeedScale)
-		{
-			xnum.chop(1);
-			x = xnum.toFloat() * current_size_x / first_size_x + mStartX;
-		}
-		else
-			x = xnum.toFloat() * current_size_x / first_size_x + mStartX;
-
-		QString ynum = elem.attribute(QString("y").append(str));
-		if (ynum.endsWith("%"))
-		{
-			ynum.chop(1);
-			y = current_size_y * ynum.toFloat() / 100 + mStartY;
-		}
-		else if (ynum.endsWith("a") && mNeedScale)
-		{
-			ynum.chop(1);
-			y = ynum.toFloat() + mStartY;
-		}
-		else if (ynum.endsWith("a") && !mNeedScale)
-		{
-			ynum.chop(1);
-			y = ynum.toFloat() * current_size_y / first_size_y + mStartY;
-		}
-		else
-			y = ynum.toFloat() * current_size_y / first_size_y + mStartY;
-
-		array[i].setX(static_cast<int>(x));
-		array[i].setY(static_cast<int>(y));
-	}
-	return array;
-}
-
 void SdfRenderer::defaultstyle()
 {
 	pen.setColor(QColor(0,0,0));
@@ -400,379 +350,144 @@ void SdfRenderer::defaultstyle()
 	pen.setWidth(1);
 }
 
-bool SdfRenderer::isNotLCMZ(QString str, int i)
+void SdfRenderer::path_draw(SdfPicture::Primitive const &primitive)
 {
-	return (str[i] != 'L') && (str[i] != 'C') && (str[i] != 'M')
-		&& (str[i] != 'Z') && (i != str.length());
-}
-
-void SdfRenderer::path_draw(QDomElement &element)
-{
-	QPointF end_point;
-	QPointF c1;
-	QPointF c2;
-	QDomElement elem = element;
 	QPainterPath path;
-
-	if (!elem.isNull())
-	{
-		QString d_cont;
-		d_cont = elem.attribute("d").remove(0, 1);
-		d_cont.append(" Z");
-
-		for (i = 0; i < d_cont.length() - 1;)
-		{
-			if (d_cont[i] == 'M')
-			{
-				j = i + 2;
-				while (isNotLCMZ(d_cont, j))
-				{
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					end_point.setX(s1.toFloat() * current_size_x / first_size_x + mStartX);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					end_point.setY(s1.toFloat() * current_size_y / first_size_y + mStartY);
-					++j;
-					s1.clear();
-				}
-
-				path.moveTo(end_point);
-				i = j;
-			}
-			else if (d_cont[i] == 'L')
-			{
-				j = i + 2;
-				while (isNotLCMZ(d_cont, j))
-				{
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					end_point.setX(s1.toFloat() * current_size_x / first_size_x + mStartX);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-					end_point.setY(s1.toFloat() * current_size_y / first_size_y + mStartY);
-					++j;
-					s1.clear();
-				}
-
-				 path.lineTo(end_point);
-				 i = j;
-			}
-			 else if (d_cont[i] == 'C')
-			{
-				j = i + 2;
-				while(isNotLCMZ(d_cont, j))
-				{
-					while (!(d_cont[j] == ' '))
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					c1.setX(s1.toFloat() * current_size_x / first_size_x + mStartX);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					c1.setY(s1.toFloat() * current_size_y / first_size_y + mStartY);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					c2.setX(s1.toFloat() * current_size_x / first_size_x + mStartX);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					c2.setY(s1.toFloat() * current_size_y / first_size_y + mStartY);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					end_point.setX(s1.toFloat() * current_size_x / first_size_x + mStartX);
-					s1.clear();
-					++j;
-
-					while (d_cont[j] != ' ')
-					{
-						s1.append(d_cont[j]);
-						++j;
-					}
-
-					end_point.setY(s1.toFloat() * current_size_y / first_size_y + mStartY);
-					s1.clear();
-					++j;
-				}
-
-				path.cubicTo(c1, c2, end_point);
-				i = j;
-
-			} else if (d_cont[i] == 'Z')
-			{
-				path.closeSubpath();
-				logger ("loggerZ.txt", "DONE");
-			}
+	auto const pathPoint = [this](QList<float> const &coordinates, int index) {
+		return QPointF(coordinates[index] * current_size_x / mPicture->width() + mStartX
+				, coordinates[index + 1] * current_size_y / mPicture->height() + mStartY);
+	};
+
+	foreach (SdfPicture::PathCommand const &command, primitive.pathCommands) {
+		QList<float> const &coordinates = command.coordinates;
+		// Only the last point group of a command is used, as it always was.
+		if (command.type == 'M' && coordinates.size() >= 2) {
+			path.moveTo(pathPoint(coordinates, coordinates.size() - coordinates.size() % 2 - 2));
+		} else if (command.type == 'L' && coordinates.size() >= 2) {
+			path.lineTo(pathPoint(coordinates, coordinates.size() - coordinates.size() % 2 - 2));
+		} else if (command.type == 'C' && coordinates.size() >= 6) {
+			int const last = coordinates.size() - coordinates.size() % 6 - 6;
+			path.cubicTo(pathPoint(coordinates, last), pathPoint(coordinates, last + 2)
+					, pathPoint(coordinates, last + 4));
+		} else if (command.type == 'Z') {
+			path.closeSubpath();
 		}
 	}
 
-	parsestyle(element);
+	parsestyle(primitive.style);
 	painter->drawPath(path);
 }
 
-void SdfRenderer::stylus_draw(QDomElement &element)
-{
-	QDomNode node = element.firstChild();
-	while(!node.isNull())
-	{
-		QDomElement elem = node.toElement();
-		if(!elem.isNull())
-		{
-			if (elem.tagName()=="line")
-			{
-				line(elem);
-			}
-		}
-		node = node.nextSibling();
-	}
-}
-
-void SdfRenderer::curve_draw(QDomElement &element)
+void SdfRenderer::curve_draw(SdfPicture::Primitive const &primitive)
 {
-	QDomNode node = element.firstChild();
-	QPointF start(0, 0);
-	QPointF end(0, 0);
-	QPoint c1(0, 0);
-	while(!node.isNull())
-	{
-		QDomElement elem = node.toElement();
-		if(!elem.isNull())
-		{
-			if (elem.tagName() == "start")
-			{
-				start.setX(elem.attribute("startx").toDouble() * current_size_x / first_size_x);
-				start.setY(elem.attribute("starty").toDouble() * current_size_y / first_size_y);
-			}
-			else if (elem.tagName() == "end")
-			{
-				end.setX(elem.attribute("endx").toDouble() * current_size_x / first_size_x);
-				end.setY(elem.attribute("endy").toDouble() * current_size_y / first_size_y);
-			}
-			else if (elem.tagName() == "ctrl")
-			{
-				c1.setX(elem.attribute("x").toDouble() * current_size_x / first_size_x);
-				c1.setY(elem.attribute("y").toDouble() * current_size_y / first_size_y);
-			}
-		}
-		node = node.nextSibling();
-	}
+	int const firstSizeX = mPicture->width();
+	int const firstSizeY = mPicture->height();
+	QPointF const start(primitive.curveStart.x() * current_size_x / firstSizeX + mStartX
+			, primitive.curveStart.y() * current_size_y / firstSizeY + mStartY);
+	QPointF const end(primitive.curveEnd.x() * current_size_x / firstSizeX + mStartX
+			, primitive.curveEnd.y() * current_size_y / firstSizeY + mStartY);
+	QPoint const c1(static_cast<int>(primitive.curveControl.x() * current_size_x / firstSizeX) + mStartX
+			, static_cast<int>(primitive.curveControl.y() * current_size_y / firstSizeY) + mStartY);
 
 	QPainterPath path(start);
 	path.quadTo(c1, end);
-	parsestyle(element);
+	parsestyle(primitive.style);
 	painter->drawPath(path);
 }
 
-void SdfRenderer::parsestyle(QDomElement &element)
+void SdfRenderer::parsestyle(SdfPicture::Style const &style)
 {
-	QDomElement elem = element;
-	if(!elem.isNull())
-	{
-		if (elem.hasAttribute("stroke-width"))
-		{
-			if (mNeedScale)
-				pen.setWidth(elem.attribute("stroke-width").toInt());
-			else  // for painting icons. width of all lines should be set to 1
-				pen.setWidth(1);
-		}
-
-		if (elem.hasAttribute("fill"))
-		{
-			QColor color = elem.attribute("fill");
-			brush.setStyle(Qt::SolidPattern);
-			brush.setColor(color);
-		}
+	if (style.hasStrokeWidth) {
+		// for painting icons width of all lines should be set to 1
+		pen.setWidth(mNeedScale ? style.strokeWidth : 1);
+	}
 
-		if (elem.hasAttribute("stroke"))
-		{
-			QColor color = elem.attribute("stroke");
-			pen.setColor(color);
-		}
+	if (style.hasFill) {
+		brush.setStyle(Qt::SolidPattern);
+		brush.setColor(style.fill);
+	}
 
-		if (elem.hasAttribute("stroke-style"))
-		{
-			if (elem.attribute("stroke-style") == "solid")
-				pen.setStyle(Qt::SolidLine);
-			if (elem.attribute("stroke-style") == "dot")
-				pen.setStyle(Qt::DotLine);
-			if (elem.attribute("stroke-style") == "dash")
-				pen.setStyle(Qt::DashLine);
-			if (elem.attribute("stroke-style") == "dashdot")
-				pen.setStyle(Qt::DashDotLine);
-			if (elem.attribute("stroke-style") == "dashdotdot")
-				pen.setStyle(Qt::DashDotDotLine);
-			if (elem.attribute("stroke-style") == "none")
-				pen.setStyle(Qt::NoPen);
-		}
+	if (style.hasStroke) {
+		pen.setColor(style.stroke);
+	}
 
-		if (elem.hasAttribute("fill-style"))
-		{
-			if (elem.attribute("fill-style")=="none")
-				brush.setStyle(Qt::NoBrush);
-			else if(elem.attribute("fill-style")=="solid")
-				brush.setStyle(Qt::SolidPattern);
-		}
+	if (style.hasStrokeStyle) {
+		pen.setStyle(style.strokeStyle);
+	}
 
-		if (elem.hasAttribute("font-fill"))
-		{
-			QColor color = elem.attribute("font-fill");
-			pen.setColor(color);
-		}
+	if (style.hasFillStyle) {
+		brush.setStyle(style.fillStyle);
+	}
 
-		if (elem.hasAttribute("font-size"))
-		{
-			QString fontsize = elem.attribute("font-size");
-			if (fontsize.endsWith("%"))
-			{
-				fontsize.chop(1);
-				font.setPixelSize(current_size_y * fontsize.toInt() / 100);
-			}
-			else if (fontsize.endsWith("a") && mNeedScale)
-			{
-				fontsize.chop(1);
-				font.setPixelSize(fontsize.toInt());
-			}
-			else if (fontsize.endsWith("a") && !mNeedScale)
-			{
-				fontsize.chop(1);
-				font.setPixelSize(fontsize.toInt() * current_size_y / first_size_y);
-			}
-			else
-				font.setPixelSize(fontsize.toInt() * current_size_y / first_size_y);
-		}
+	if (style.hasFontFill) {
+		pen.setColor(style.fontFill);
+	}
 
-		if (elem.hasAttribute("font-name"))
-		{
-			font.setFamily(elem.attribute("font-name"));
+	if (style.hasFontSize) {
+		switch (style.fontSizeKind) {
+		case SdfPicture::Coordinate::percent:
+			font.setPixelSize(current_size_y * style.fontSize / 100);
+			break;
+		case SdfPicture::Coordinate::absolute:
+			font.setPixelSize(mNeedScale ? style.fontSize : style.fontSize * current_size_y / mPicture->height());
+			break;
+		default:
+			font.setPixelSize(style.fontSize * current_size_y / mPicture->height());
+			break;
 		}
+	}
 
-		if (elem.hasAttribute("b"))
-		{
-			font.setBold(elem.attribute("b").toInt());
-		}
+	if (style.hasFontName) {
+		font.setFamily(style.fontName);
+	}
 
-		if (elem.hasAttribute("i"))
-		{
-			font.setItalic(elem.attribute("i").toInt());
-		}
+	if (style.hasBold) {
+		font.setBold(style.bold);
+	}
 
-		if (elem.hasAttribute("u"))
-		{
-			font.setUnderline(elem.attribute("u").toInt());
-		}
+	if (style.hasItalic) {
+		font.setItalic(style.italic);
+	}
 
-		painter->setFont(font);
+	if (style.hasUnderline) {
+		font.setUnderline(style.underline);
 	}
+
+	painter->setFont(font);
 	painter->setPen(pen);
 	painter->setBrush(brush);
 }
 
-float SdfRenderer::coord_def(QDomElement &element, QString coordName, int current_size, int first_size)
+float SdfRenderer::coord_def(SdfPicture::Coordinate const &coordinate, int current_size, int first_size) const
 {
-	float coord = 0;
-	QString coordStr = element.attribute(coordName);
-
-	if (coordStr.endsWith("%"))
-	{
-		coordStr.chop(1);
-		coord = current_size * coordStr.toFloat() / 100;
-		return coord;
-	}
-	else if (coordStr.endsWith("a") && mNeedScale)
-	{
-		coordStr.chop(1);
-		coord = coordStr.toFloat();
-		return coord;
-	}
-	else if (coordStr.endsWith("a") && !mNeedScale)
-	{
-		coordStr.chop(1);
-		coord = coordStr.toFloat() * current_size / first_size;
-		return coord;
-	}
-	else
-	{
-		coord = coordStr.toFloat() * current_size / first_size;
-		return coord;
+	switch (coordinate.kind) {
+	case SdfPicture::Coordinate::percent:
+		return current_size * coordinate.value / 100;
+	case SdfPicture::Coordinate::absolute:
+		return mNeedScale ? coordinate.value : coordinate.value * current_size / first_size;
+	default:
+		return coordinate.value * current_size / first_size;
 	}
 }
 
-float SdfRenderer::x1_def(QDomElement &element)
+float SdfRenderer::x1_def(SdfPicture::Primitive const &primitive) const
 {
-	return coord_def(element, "x1", current_size_x, first_size_x) + mStartX;
+	return coord_def(primitive.x1, current_size_x, mPicture->width()) + mStartX;
 }
 
-float SdfRenderer::y1_def(QDomElement &element)
+float SdfRenderer::y1_def(SdfPicture::Primitive const &primitive) const
 {
-	return coord_def(element, "y1", current_size_y, first_size_y) + mStartY;
+	return coord_def(primitive.y1, current_size_y, mPicture->height()) + mStartY;
 }
 
-float SdfRenderer::x2_def(QDomElement &element)
+float SdfRenderer::x2_def(SdfPicture::Primitive const &primitive) const
 {
-	return coord_def(element, "x2", current_size_x, first_size_x) + mStartX;
+	return coord_def(primitive.x2, current_size_x, mPicture->width()) + mStartX;
 }
 
-float SdfRenderer::y2_def(QDomElement &element)
+float SdfRenderer::y2_def(SdfPicture::Primitive const &primitive) const
 {
-	return coord_def(element, "y2", current_size_y, first_size_y) + mStartY;
-}
-
-void SdfRenderer::logger(QString path, QString string)
-{	log.setFileName(path);
-	log.open(QIODevice::Append | QIODevice::Text);
-	logtext.setDevice(&log);
-	logtext << string << "\n";
-	log.close();
+	return coord_def(primitive.y2, current_size_y, mPicture->height()) + mStartY;
 }
 
 QByteArray SdfRenderer::loadPixmap(QString &filePath)
@@ -821,6 +536,10 @@ void SdfRenderer::noScale()
 	mNeedScale = false;
 }
 
+void SdfRenderer::noCache()
+{
+	mNeedCache = false;
+}
 
 SdfIconEngineV2::SdfIconEngineV2(QString const &file)
 {
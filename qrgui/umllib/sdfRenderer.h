@@ -8,12 +8,14 @@
 #include <QtGui/QFont>
 #include <QtCore/QFile>
 #include <QtCore/QTextStream>
+#include <QtCore/QSharedPointer>
 #include <QtGui/QIconEngine>
 
 #include <qrkernel/settingsManager.h>
 
 #include "editorPluginInterface/sdfRendererInterface.h"
 #include "editorPluginInterface/elementRepoInterface.h"
+#include "umllib/private/sdfPicture.h"
 
 namespace qReal {
 
@@ -26,13 +28,17 @@ public:
 	SdfRenderer(QString const path);
 	~SdfRenderer();
 
+	/// Loads a picture from given SDF file, the file is compiled only once and shared by all renderers.
 	bool load (QString const &filename);
 	bool load(QDomDocument const &document);
 	void render(QPainter *painter, QRectF const &bounds, bool isIcon = false);
 	void noScale();
 
-	int pictureWidth() { return first_size_x; }
-	int pictureHeight() { return first_size_y; }
+	/// Disables reuse of rendered pictures, every render() paints primitives anew.
+	void noCache();
+
+	int pictureWidth() { return mPicture ? mPicture->width() : 0; }
+	int pictureHeight() { return mPicture ? mPicture->height() : 0; }
 
 	void setElementRepo(ElementRepoInterface *elementRepo);
 
@@ -40,63 +46,60 @@ private:
 	QString mWorkingDirName;
 	QMap<QString, QString> mReallyUsedFiles;
 	QMap<QString, QByteArray> mMapFileImage;
-	int first_size_x;
-	int first_size_y;
 	int current_size_x;
 	int current_size_y;
 	int mStartX;
 	int mStartY;
-	int i;
-	int j;
-	int sep;
 	QPainter *painter;
 	QPen pen;
 	QBrush brush;
-	QString s1;
-	QString s2;
 	QFont font;
-	QFile log;
-	QTextStream logtext;
-	QDomDocument doc;
+
+	/// Compiled picture, shared with other renderers of the same shape.
+	QSharedPointer<SdfPicture> mPicture;
 
 	/** @brief is false if we don't need to scale according to absolute
 	 * coords, is useful for rendering icons. default is true
 	**/
 	bool mNeedScale;
+
+	/// Is false if rendered pictures shall not be reused. Default is true.
+	bool mNeedCache;
 	ElementRepoInterface *mElementRepo;
 
-	bool checkShowConditions(QDomElement const &element, bool isIcon) const;
-	bool checkCondition(QDomElement const &condition) const;
-
-	void line(QDomElement &element);
-	void ellipse(QDomElement &element);
-	void arc(QDomElement &element);
-	void parsestyle(QDomElement &element);
-	void background(QDomElement &element);
-	void draw_text(QDomElement &element);
-	void rectangle(QDomElement &element);
-	void polygon(QDomElement &element);
-	QPoint *getpoints(QDomElement &element, int n);
-	void point (QDomElement &element);
+	/// Paints all primitives whose show conditions hold with the current painter.
+	void draw(bool isIcon);
+
+	/// Returns the key of the rendered picture for current size, mode and values of properties used
+	/// by show conditions.
+	QString cacheKey(bool isIcon) const;
+
+	bool checkShowConditions(SdfPicture::Primitive const &primitive, bool isIcon) const;
+	bool checkCondition(SdfPicture::Condition const &condition) const;
+
+	void line(SdfPicture::Primitive const &primitive);
+	void ellipse(SdfPicture::Primitive const &primitive);
+	void arc(SdfPicture::Primitive const &primitive);
+	void parsestyle(SdfPicture::Style const &style);
+	void background(SdfPicture::Primitive const &primitive);
+	void draw_text(SdfPicture::Primitive const &primitive);
+	void rectangle(SdfPicture::Primitive const &primitive);
+	void polygon(SdfPicture::Primitive const &primitive);
+	void point(SdfPicture::Primitive const &primitive);
 	void defaultstyle();
-	void path_draw(QDomElement &element);
-	void stylus_draw(QDomElement &element);
-	void curve_draw(QDomElement &element);
-	void image_draw(QDomElement &element);
-	float x1_def(QDomElement &element);
-	float y1_def(QDomElement &element);
-	float x2_def(QDomElement &element);
-	float y2_def(QDomElement &element);
-	float coord_def(QDomElement &element, QString coordName, int current_size, int first_size);
-	void logger(QString path, QString string);
+	void path_draw(SdfPicture::Primitive const &primitive);
+	void curve_draw(SdfPicture::Primitive const &primitive);
+	void image_draw(SdfPicture::Primitive const &primitive);
+	float x1_def(SdfPicture::Primitive const &primitive) const;
+	float y1_def(SdfPicture::Primitive const &primitive) const;
+	float x2_def(SdfPicture::Primitive const &primitive) const;
+	float y2_def(SdfPicture::Primitive const &primitive) const;
+	float coord_def(SdfPicture::Coordinate const &coordinate, int current_size, int first_size) const;
 
 	/// Reads byte array from the file that is obtained by inner rules from the given one.
 	/// Specified file path may be modified with storing into it really read file path.
 	QByteArray loadPixmap(QString &filePath);
 	QByteArray loadPixmapFromExistingFile(QString &filePath);
-
-	/** @brief checks that str[i] is not L, C, M or Z*/
-	bool isNotLCMZ(QString str, int i);
 };
 
 /// Constructs QIcon instance by a given sdf description
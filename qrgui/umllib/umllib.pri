@@ -26,8 +26,12 @@ HEADERS += \
 	$$PWD/private/squareLine.h \
 	$$PWD/private/brokenLine.h \
 	$$PWD/private/curveLine.h \
+	$$PWD/private/routedLine.h \
+	$$PWD/private/orthogonalRouter.h \
 	$$PWD/private/lineFactory.h \
 	$$PWD/private/edgeArrangeCriteria.h \
+	$$PWD/private/sdfPicture.h \
+	$$PWD/private/levelOfDetail.h \
 
 SOURCES += \
 	$$PWD/edgeElement.cpp \
@@ -57,8 +61,12 @@ SOURCES += \
 	$$PWD/private/squareLine.cpp \
 	$$PWD/private/brokenLine.cpp \
 	$$PWD/private/curveLine.cpp \
+	$$PWD/private/routedLine.cpp \
+	$$PWD/private/orthogonalRouter.cpp \
 	$$PWD/private/lineFactory.cpp \
 	$$PWD/private/edgeArrangeCriteria.cpp \
+	$$PWD/private/sdfPicture.cpp \
+	$$PWD/private/levelOfDetail.cpp \
 
 RESOURCES += \
 	$$PWD/contextIcons.qrc \
@@ -10,7 +10,8 @@ using namespace qReal::commands;
 PasteGroupCommand::PasteGroupCommand(EditorViewScene *scene
 		, EditorViewMViface const *mvIface
 		, bool isGraphicalCopy)
-	: mScene(scene), mMVIface(mvIface)
+	: TransactionCommand(*mvIface->logicalAssistApi(), *mvIface->graphicalAssistApi())
+	, mScene(scene), mMVIface(mvIface)
 	, mIsGraphicalCopy(isGraphicalCopy), mIsEmpty(false)
 {
 	prepareCommands();
@@ -69,18 +70,6 @@ void PasteGroupCommand::preparePasteEdgeCommand(EdgeData const &edgeData, QPoint
 	addPreAction(pasteCommand);
 }
 
-bool PasteGroupCommand::execute()
-{
-	// Execution happens in child commands
-	return true;
-}
-
-bool PasteGroupCommand::restoreState()
-{
-	// Restoration happens in child commands
-	return true;
-}
-
 void PasteGroupCommand::pullDataFromClipboard(QList<NodeData> &nodesData, QList<EdgeData> &edgesData) const
 {
 	QClipboard const *clipboard = QApplication::clipboard();
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "controller/commands/abstractCommand.h"
+#include "controller/commands/transactionCommand.h"
 #include "view/editorViewScene.h"
 
 namespace qReal
@@ -8,7 +8,8 @@ namespace qReal
 namespace commands
 {
 
-class PasteGroupCommand : public AbstractCommand
+/// Pastes elements from the clipboard, views are updated once for all of them.
+class PasteGroupCommand : public TransactionCommand
 {
 public:
 	PasteGroupCommand(EditorViewScene *scene
@@ -18,10 +19,6 @@ public:
 
 	bool isEmpty() const;
 
-protected:
-	bool execute();
-	bool restoreState();
-
 private:
 	void prepareCommands();
 	QHash<Id, Id> *preparePasteNodesCommands(QList<NodeData> &nodesData, QPointF const &offset);
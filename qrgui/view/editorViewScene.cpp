@@ -14,6 +14,7 @@
 #include "controller/commands/createGroupCommand.h"
 #include "umllib/private/reshapeEdgeCommand.h"
 #include "umllib/private/resizeCommand.h"
+#include "umllib/private/routedLine.h"
 #include "controller/commands/insertIntoEdgeCommand.h"
 #include "umllib/private/expandCommand.h"
 
@@ -23,6 +24,27 @@ using namespace qReal;
 using namespace qReal::commands;
 using namespace qReal::gui;
 
+namespace {
+
+/// Interval of adjusting links of dragged nodes, one frame at 60 frames per second.
+int const linksAdjustmentInterval = 16;
+
+void collectLinks(NodeElement *node, QSet<EdgeElement *> &links)
+{
+	foreach (EdgeElement * const edge, node->edgeList()) {
+		links.insert(edge);
+	}
+
+	foreach (QGraphicsItem * const child, node->childItems()) {
+		NodeElement * const childNode = dynamic_cast<NodeElement *>(child);
+		if (childNode) {
+			collectLinks(childNode, links);
+		}
+	}
+}
+
+}
+
 EditorViewScene::EditorViewScene(QObject *parent)
 		: QGraphicsScene(parent)
 		, mLastCreatedWithEdge(nullptr)
@@ -31,9 +53,12 @@ EditorViewScene::EditorViewScene(QObject *parent)
 		, mLeftButtonPressed(false)
 		, mHighlightNode(nullptr)
 		, mWindow(nullptr)
+		, mController(nullptr)
 		, mMouseMovementManager(nullptr)
 		, mActionSignalMapper(new QSignalMapper(this))
 		, mTimer(new QTimer(this))
+		, mDragging(false)
+		, mLinksAdjustmentTimer(new QTimer(this))
 		, mTimerForArrowButtons(new QTimer(this))
 		, mOffset(QPointF(0, 0))
 		, mShouldReparentItems(false)
@@ -54,6 +79,10 @@ EditorViewScene::EditorViewScene(QObject *parent)
 
 	connect(mTimer, SIGNAL(timeout()), this, SLOT(getObjectByGesture()));
 	connect(mTimerForArrowButtons, SIGNAL(timeout()), this, SLOT(updateMovedElements()));
+
+	mLinksAdjustmentTimer->setSingleShot(true);
+	mLinksAdjustmentTimer->setInterval(linksAdjustmentInterval);
+	connect(mLinksAdjustmentTimer, SIGNAL(timeout()), this, SLOT(adjustMovedLinks()));
 	connect(this, SIGNAL(selectionChanged()), this, SLOT(deselectLabels()));
 }
 
@@ -176,16 +205,41 @@ Element *EditorViewScene::getElem(qReal::Id const &id) const
 		return nullptr;
 	}
 
-	// FIXME: SLOW!
-	QList < QGraphicsItem *> list = items();
-	for (QList < QGraphicsItem *>::Iterator it = list.begin(); it != list.end(); it++) {
-		if (Element *elem = dynamic_cast < Element *>(*it)) {
-			if (elem->id() == id) {
-				return elem;
-			}
-		}
+	return mElements.value(id);
+}
+
+void EditorViewScene::registerElement(Element *element)
+{
+	mElements.insert(element->id(), element);
+	mSpatialIndex.insert(element);
+}
+
+void EditorViewScene::elementGeometryChanged(Element *element)
+{
+	mSpatialIndex.invalidate(element);
+}
+
+QList<NodeElement *> EditorViewScene::nodesAt(QPointF const &scenePos) const
+{
+	return mSpatialIndex.nodesAt(scenePos);
+}
+
+QList<NodeElement *> EditorViewScene::nodesIn(QPainterPath const &scenePath) const
+{
+	return mSpatialIndex.nodesIn(scenePath);
+}
+
+void EditorViewScene::unregisterElement(Element *element)
+{
+	// Another element with the same id could have been registered later, it shall stay in the registry.
+	if (mElements.value(element->id()) == element) {
+		mElements.remove(element->id());
 	}
-	return nullptr;
+
+	mHighlightedElements.remove(element);
+	mSpatialIndex.remove(element);
+	mNodesWithMovedLinks.remove(element);
+	mEdgesToSave.remove(element);
 }
 
 void EditorViewScene::dragEnterEvent(QGraphicsSceneDragDropEvent *event)
@@ -207,16 +261,11 @@ void EditorViewScene::dragMoveEvent(QGraphicsSceneDragDropEvent *event)
 	in_stream >> uuid;
 	Id id = Id::loadFromString(uuid);
 
-	QList<QGraphicsItem*> elements = items(event->scenePos());
-
 	NodeElement *node = nullptr;
-	foreach (QGraphicsItem *item, elements) {
-		NodeElement *el = dynamic_cast<NodeElement*>(item);
-		if (el) {
-			if (canBeContainedBy(el->id(), id)) {
-				node = el;
-				break;
-			}
+	foreach (NodeElement * const el, nodesAt(event->scenePos())) {
+		if (canBeContainedBy(el->id(), id)) {
+			node = el;
+			break;
 		}
 	}
 
@@ -253,9 +302,8 @@ NodeElement *EditorViewScene::findNewParent(QPointF newParentInnerPoint, NodeEle
 
 		// delete from parents list ones that are selected right now
 		// we get the first valid NodeElement
-		foreach (QGraphicsItem *item, items(newParentInnerPoint)) {
-			NodeElement *e = dynamic_cast<NodeElement *>(item);
-			if (e && e != node && !selected.contains(item)) {
+		foreach (NodeElement * const e, nodesAt(newParentInnerPoint)) {
+			if (e != node && !selected.contains(e)) {
 				// check if we can add element into found parent
 				if (canBeContainedBy(e->id(), id)) {
 					return e;
@@ -495,9 +543,8 @@ void EditorViewScene::createElement(QMimeData const *mimeData, QPointF const &sc
 		if (searchForParents) {
 			// if element is node then we should look for parent for him
 			if (isNode) {
-				foreach (QGraphicsItem *item, items(scenePos - shiftToParent)) {
-					NodeElement *el = dynamic_cast<NodeElement*>(item);
-					if (el && canBeContainedBy(el->id(), id)) {
+				foreach (NodeElement * const el, nodesAt(scenePos - shiftToParent)) {
+					if (canBeContainedBy(el->id(), id)) {
 						newParent = el;
 						break;
 					}
@@ -572,9 +619,8 @@ void EditorViewScene::createSingleElement(Id const &id, QString const &name, boo
 
 EdgeElement * EditorViewScene::edgeForInsertion(QPointF const &scenePos)
 {
-	foreach (QGraphicsItem *item, items(scenePos)) {
-		EdgeElement *edge = dynamic_cast<EdgeElement *>(item);
-		if (edge && edge->isDividable()) {
+	foreach (EdgeElement * const edge, mSpatialIndex.edgesAt(scenePos)) {
+		if (edge->isDividable()) {
 			QSizeF portSize(kvadratik, kvadratik);
 			QRectF startPort(edge->mapToScene(edge->line().first()) - QPointF(kvadratik / 2, kvadratik / 2), portSize);
 			QRectF endPort(edge->mapToScene(edge->line().last()) - QPointF(kvadratik / 2, kvadratik / 2), portSize);
@@ -643,6 +689,99 @@ void EditorViewScene::reConnectLink(EdgeElement * edgeElem)
 	edgeElem->layOut();
 }
 
+bool EditorViewScene::deferLinksAdjustment(NodeElement *node)
+{
+	if (!mDragging) {
+		return false;
+	}
+
+	mNodesWithMovedLinks.insert(node);
+	if (!mLinksAdjustmentTimer->isActive()) {
+		mLinksAdjustmentTimer->start();
+	}
+
+	return true;
+}
+
+bool EditorViewScene::deferModelUpdate(EdgeElement *edge)
+{
+	if (!mDragging) {
+		return false;
+	}
+
+	mEdgesToSave.insert(edge);
+	return true;
+}
+
+void EditorViewScene::adjustMovedLinks()
+{
+	// Links between two moved nodes are adjusted once.
+	QSet<EdgeElement *> links;
+	foreach (Element * const node, mNodesWithMovedLinks) {
+		collectLinks(static_cast<NodeElement *>(node), links);
+	}
+
+	mNodesWithMovedLinks.clear();
+	foreach (EdgeElement * const link, links) {
+		// Links moved together with both their ends need no adjustment.
+		if (link->endsMoved()) {
+			link->adjustLink();
+		}
+	}
+}
+
+void EditorViewScene::finishDragging()
+{
+	if (!mDragging) {
+		return;
+	}
+
+	mLinksAdjustmentTimer->stop();
+	adjustMovedLinks();
+	mDragging = false;
+
+	QSet<Element *> const edges = mEdgesToSave;
+	mEdgesToSave.clear();
+	foreach (Element * const element, edges) {
+		EdgeElement * const edge = static_cast<EdgeElement *>(element);
+		edge->setGraphicApiPos();
+		edge->saveConfiguration();
+	}
+}
+
+void EditorViewScene::layOutLinksAround(NodeElement *node, QRectF const &oldSceneRect
+		, AbstractCommand *moveCommand)
+{
+	QSet<EdgeElement *> ownLinks;
+	collectLinks(node, ownLinks);
+
+	QRectF const newSceneRect = node->mapRectToScene(node->contentsRect());
+	QPainterPath area;
+	area.addRect(newSceneRect);
+	if (!oldSceneRect.isNull()) {
+		int const margin = RoutedLine::margin + 1;
+		area.addRect(oldSceneRect.adjusted(-margin, -margin, margin, margin));
+	}
+
+	foreach (EdgeElement * const edge, mSpatialIndex.edgesIn(area)) {
+		if (ownLinks.contains(edge)) {
+			continue;
+		}
+
+		ReshapeEdgeCommand * const reshapeCommand = new ReshapeEdgeCommand(this, edge->id());
+		reshapeCommand->startTracking();
+		edge->layOutAround(oldSceneRect, newSceneRect);
+		reshapeCommand->stopTracking();
+		if (!reshapeCommand->somethingChanged()) {
+			delete reshapeCommand;
+		} else if (moveCommand) {
+			moveCommand->addPostAction(reshapeCommand);
+		} else {
+			mController->execute(reshapeCommand);
+		}
+	}
+}
+
 void EditorViewScene::arrangeNodeLinks(NodeElement* node) const
 {
 	node->arrangeLinks();
@@ -657,24 +796,12 @@ void EditorViewScene::arrangeNodeLinks(NodeElement* node) const
 
 NodeElement* EditorViewScene::getNodeById(qReal::Id const &itemId) const
 {
-	foreach (QGraphicsItem *item, items()) {
-		NodeElement *node = dynamic_cast<NodeElement*>(item);
-		if (node && node->id() == itemId) {
-			return node;
-		}
-	}
-	return nullptr;
+	return dynamic_cast<NodeElement *>(mElements.value(itemId));
 }
 
 EdgeElement* EditorViewScene::getEdgeById(qReal::Id const &itemId) const
 {
-	foreach (QGraphicsItem *item, items()) {
-		EdgeElement *edge = dynamic_cast<EdgeElement*>(item);
-		if (edge && edge->id() == itemId) {
-			return edge;
-		}
-	}
-	return nullptr;
+	return dynamic_cast<EdgeElement *>(mElements.value(itemId));
 }
 
 QList<NodeElement*> EditorViewScene::getCloseNodes(NodeElement *node) const
@@ -682,11 +809,11 @@ QList<NodeElement*> EditorViewScene::getCloseNodes(NodeElement *node) const
 	QList<NodeElement *> list;
 
 	if (node) {
-		QPolygonF const bounds = node->mapToScene(node->boundingRect());
-		QList<QGraphicsItem *> overlapping = items(bounds);
-		foreach (QGraphicsItem * const item, overlapping) {
-			NodeElement * const closeNode = dynamic_cast<NodeElement *>(item);
-			if (closeNode && (closeNode != node) && !closeNode->isAncestorOf(node) && !node->isAncestorOf(closeNode)) {
+		QPainterPath bounds;
+		bounds.addPolygon(node->mapToScene(node->boundingRect()));
+		bounds.closeSubpath();
+		foreach (NodeElement * const closeNode, nodesIn(bounds)) {
+			if ((closeNode != node) && !closeNode->isAncestorOf(node) && !node->isAncestorOf(closeNode)) {
 				list.append(closeNode);
 			}
 		}
@@ -710,6 +837,13 @@ Element *EditorViewScene::getLastCreated()
 	return mLastCreatedWithEdge;
 }
 
+void EditorViewScene::focusOutEvent(QFocusEvent *event)
+{
+	// The release of the mouse button will not come if the scene loses focus in the middle of dragging.
+	finishDragging();
+	QGraphicsScene::focusOutEvent(event);
+}
+
 void EditorViewScene::keyPressEvent(QKeyEvent *event)
 {
 	if (dynamic_cast<QGraphicsTextItem*>(focusItem())) {
@@ -1083,6 +1217,11 @@ void EditorViewScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 		mLeftButtonPressed = false;
 	}
 
+	if (event->button() == Qt::LeftButton) {
+		// Released elements shall be laid out with their links in place and saved.
+		finishDragging();
+	}
+
 	if (mIsSelectEvent && (event->button() == Qt::LeftButton)) {
 		foreach (QGraphicsItem* item, items()) {
 			item->setAcceptedMouseButtons(Qt::MouseButtons(Qt::RightButton | Qt::LeftButton));
@@ -1173,6 +1312,13 @@ void EditorViewScene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 {
 	mCurrentMousePos = event->scenePos();
 	if ((mLeftButtonPressed && !(event->buttons() & Qt::RightButton))) {
+		if (!mIsSelectEvent && (event->buttons() & Qt::LeftButton)) {
+			mDragging = true;
+		} else {
+			// The release was delivered elsewhere, for example to a popup that grabbed the mouse.
+			finishDragging();
+		}
+
 		QGraphicsScene::mouseMoveEvent(event);
 	} else {
 		// button isn't recognized while mouse moves
@@ -1344,9 +1490,9 @@ void EditorViewScene::dehighlight(Id const &graphicalId)
 
 void EditorViewScene::dehighlight()
 {
+	// Elements leave this set when they leave the scene, so all of them are alive.
 	foreach (Element *element, mHighlightedElements) {
-		if (mainWindow()->getCurrentTab()->scene()->items().contains(element))
-			element->setGraphicsEffect(nullptr);
+		element->setGraphicsEffect(nullptr);
 	}
 	mHighlightedElements.clear();
 }
@@ -13,6 +13,7 @@
 
 #include "view/private/editorViewMVIface.h"
 #include "view/private/exploserView.h"
+#include "view/private/elementSpatialIndex.h"
 
 namespace qReal {
 
@@ -23,6 +24,7 @@ class EditorView;
 class MainWindow;
 
 namespace commands {
+class AbstractCommand;
 class CreateElementCommand;
 }
 
@@ -55,6 +57,7 @@ public:
 
 	// is virtual only to trick linker. is used from plugins and generators and we have no intention of
 	// including the scene (with dependencies) there
+	/// Returns an element with given id from the scene's registry, nullptr if there is no such element on the scene.
 	virtual Element *getElem(qReal::Id const &id) const;
 	Element *getElemAt(const QPointF &position) const;
 
@@ -101,6 +104,28 @@ public:
 
 	QList<NodeElement*> getCloseNodes(NodeElement* node) const;
 
+	/// Returns nodes under given point in scene coordinates, topmost first.
+	QList<NodeElement *> nodesAt(QPointF const &scenePos) const;
+
+	/// Returns nodes intersecting given path in scene coordinates, topmost first.
+	QList<NodeElement *> nodesIn(QPainterPath const &scenePath) const;
+
+	/// Postpones adjusting links of given node and of nodes nested into it to the next frame if the user drags
+	/// elements, so links are adjusted once per frame rather than on every mouse move.
+	/// @returns false if nothing is dragged and links shall be adjusted immediately.
+	bool deferLinksAdjustment(NodeElement *node);
+
+	/// Postpones writing geometry of given edge to the model till the user releases dragged elements.
+	/// @returns false if nothing is dragged and the edge shall write its geometry immediately.
+	bool deferModelUpdate(EdgeElement *edge);
+
+	/// Lays out again links avoiding nodes that cross given node or were routed around its old position, called
+	/// when the node is placed somewhere. Links of the node itself and of nodes nested into it are not touched.
+	/// @param oldSceneRect - contents of the node before it was moved, null rectangle if it is just created.
+	/// @param moveCommand - command moving the node, changes of links are undone together with it. If null,
+	/// changes of links are executed as separate commands.
+	void layOutLinksAround(NodeElement *node, QRectF const &oldSceneRect, commands::AbstractCommand *moveCommand);
+
 	void reConnectLink(EdgeElement * edgeElem);
 	void arrangeNodeLinks(NodeElement* node) const;
 
@@ -141,6 +166,7 @@ protected:
 	void dragLeaveEvent(QGraphicsSceneDragDropEvent *event);
 	void dropEvent(QGraphicsSceneDragDropEvent *event);
 
+	void focusOutEvent(QFocusEvent *event);
 	void keyPressEvent(QKeyEvent *event);
 
 	void mousePressEvent(QGraphicsSceneMouseEvent *event);
@@ -166,9 +192,25 @@ private slots:
 
 	void deselectLabels();
 
+	/// Adjusts links of nodes moved since the last frame.
+	void adjustMovedLinks();
+
 private:
 	void setMVIface(EditorViewMViface *mvIface);
 
+	/// Adds an element to the id registry, called by the element when it is added to the scene.
+	void registerElement(Element *element);
+
+	/// Removes an element from the id registry, called by the element when it leaves the scene or is deleted.
+	void unregisterElement(Element *element);
+
+	/// Marks geometry of an element as changed in the spatial index, called by the element when it is moved
+	/// or resized.
+	void elementGeometryChanged(Element *element);
+
+	/// Adjusts remaining links and writes geometry of edges postponed during dragging to the model.
+	void finishDragging();
+
 	void getLinkByGesture(NodeElement *parent, NodeElement const &child);
 	void drawGesture();
 	void createEdgeMenu(QList<QString> const &ids);
@@ -228,8 +270,28 @@ private:
 	QSignalMapper *mActionSignalMapper;
 
 	QSet<Element *> mHighlightedElements;
+
+	/// Elements on the scene by their ids, maintained by elements themselves, so lookups do not scan all items.
+	QHash<qReal::Id, Element *> mElements;
+
+	/// Geometry of nodes and edges on the scene, so geometric lookups do not scan all items.
+	view::details::ElementSpatialIndex mSpatialIndex;
+
 	QTimer *mTimer;
 
+	/// True while the user drags elements with the mouse.
+	bool mDragging;
+
+	/// Nodes whose links shall be adjusted with the next frame. Kept as elements, so they can be removed
+	/// from ~Element(), when they are not nodes anymore.
+	QSet<Element *> mNodesWithMovedLinks;
+
+	/// Edges whose geometry shall be written to the model when dragging is finished, kept as elements too.
+	QSet<Element *> mEdgesToSave;
+
+	/// Adjusts links of moved nodes once per frame while dragging.
+	QTimer *mLinksAdjustmentTimer;
+
 	/** @brief timer for update moved elements without lags */
 	QTimer *mTimerForArrowButtons;
 	/** @brief shift of the move */
@@ -252,6 +314,7 @@ private:
 	view::details::ExploserView *mExploser; // Takes ownership
 
 	friend class qReal::EditorViewMViface;
+	friend class qReal::Element;
 };
 
 }
@@ -122,6 +122,21 @@ Id EditorViewMViface::rootId() const
 }
 
 void EditorViewMViface::rowsInserted(QModelIndex const &parent, int start, int end)
+{
+	addElements(parent, start, end);
+
+	// Links are adjusted once for the whole inserted subtree, not for every nested level of it. Nodes elsewhere on
+	// the scene are not affected, unless inserted links are connected to them.
+	QSet<NodeElement *> nodes;
+	collectAffectedNodes(parent, start, end, nodes);
+	foreach (NodeElement * const node, nodes) {
+		node->adjustLinks();
+	}
+
+	QAbstractItemView::rowsInserted(parent, start, end);
+}
+
+void EditorViewMViface::addElements(QModelIndex const &parent, int start, int end)
 {
 	for (int row = start; row <= end; ++row) {
 		mScene->setEnabled(true);
@@ -143,7 +158,7 @@ void EditorViewMViface::rowsInserted(QModelIndex const &parent, int start, int e
 			continue;
 		}
 
-		ElementImpl * const elementImpl = mScene->mainWindow()->editorManager().elementImpl(currentId);
+		ElementImpl * const elementImpl = mGraphicalAssistApi->editorManagerInterface().elementImpl(currentId);
 		Element *elem = elementImpl->isNode()
 				? dynamic_cast<Element *>(
 						new NodeElement(elementImpl, currentId, *mGraphicalAssistApi, *mLogicalAssistApi)
@@ -152,7 +167,7 @@ void EditorViewMViface::rowsInserted(QModelIndex const &parent, int start, int e
 						new EdgeElement(elementImpl, currentId, *mGraphicalAssistApi, *mLogicalAssistApi)
 						);
 
-		elem->setController(mScene->mainWindow()->controller());
+		elem->setController(mScene->mController);
 
 		QPointF ePos = model()->data(current, roles::positionRole).toPointF();
 		bool needToProcessChildren = true;
@@ -167,11 +182,13 @@ void EditorViewMViface::rowsInserted(QModelIndex const &parent, int start, int e
 				node->setGeometry(mGraphicalAssistApi->configuration(elem->id()).boundingRect());
 			}
 
-			if (item(parent)) {
-				elem->setParentItem(item(parent));
+			Element * const parentElement = item(parent);
+			if (parentElement) {
+				elem->setParentItem(parentElement);
 				QModelIndex next = current.sibling(current.row() + 1, 0);
-				if(next.isValid() && item(next) != NULL) {
-					elem->stackBefore(item(next));
+				Element * const nextElement = next.isValid() ? item(next) : NULL;
+				if (nextElement) {
+					elem->stackBefore(nextElement);
 				}
 			} else {
 				mScene->addItem(elem);
@@ -220,7 +237,7 @@ void EditorViewMViface::rowsInserted(QModelIndex const &parent, int start, int e
 		}
 
 		if (needToProcessChildren && model()->hasChildren(current)) {
-			rowsInserted(current, 0, model()->rowCount(current) - 1);
+			addElements(current, 0, model()->rowCount(current) - 1);
 		}
 
 		NodeElement * nodeElement = dynamic_cast<NodeElement*>(elem);
@@ -228,26 +245,46 @@ void EditorViewMViface::rowsInserted(QModelIndex const &parent, int start, int e
 			nodeElement->alignToGrid();
 		}
 	}
+}
 
-	foreach (QGraphicsItem *item, mScene->items()) {
-		NodeElement* node = dynamic_cast<NodeElement*>(item);
+void EditorViewMViface::collectAffectedNodes(QModelIndex const &parent, int start, int end
+		, QSet<NodeElement *> &nodes) const
+{
+	for (int row = start; row <= end; ++row) {
+		QModelIndex const current = model()->index(row, 0, parent);
+		Element * const element = item(current);
+
+		NodeElement * const node = dynamic_cast<NodeElement *>(element);
 		if (node) {
-			node->adjustLinks();
+			nodes.insert(node);
 		}
-	}
 
-	QAbstractItemView::rowsInserted(parent, start, end);
+		EdgeElement * const edge = dynamic_cast<EdgeElement *>(element);
+		if (edge && edge->src()) {
+			nodes.insert(edge->src());
+		}
+
+		if (edge && edge->dst()) {
+			nodes.insert(edge->dst());
+		}
+
+		if (model()->hasChildren(current)) {
+			collectAffectedNodes(current, 0, model()->rowCount(current) - 1, nodes);
+		}
+	}
 }
 
 void EditorViewMViface::rowsAboutToBeRemoved(QModelIndex  const &parent, int start, int end)
 {
 	for (int row = start; row <= end; ++row) {
 		QModelIndex curr = model()->index(row, 0, parent);
-		if(item(curr)) {
-			mScene->removeItem(item(curr));
-			delete item(curr);
-		}
+		Element * const element = item(curr);
+		// Nested elements are forgotten while they are still alive, deleting the element deletes them too.
 		removeItem(curr);
+		if (element) {
+			mScene->removeItem(element);
+			delete element;
+		}
 	}
 
 	// elements from model are deleted after GUI ones
@@ -338,42 +375,54 @@ models::LogicalModelAssistApi *EditorViewMViface::logicalAssistApi() const
 void EditorViewMViface::clearItems()
 {
 	QList<QGraphicsItem *> toRemove;
-	foreach (IndexElementPair const &pair, mItems) {
-		if (!pair.second->parentItem()) {
-			toRemove.append(pair.second);
+	foreach (Element * const element, mItems) {
+		if (!element->parentItem()) {
+			toRemove.append(element);
 		}
 	}
 
+	mItems.clear();
+	mIndexes.clear();
+
 	foreach (QGraphicsItem * const item, toRemove) {
 		delete item;
 	}
-
-	mItems.clear();
 }
 
 Element *EditorViewMViface::item(QPersistentModelIndex const &index) const
 {
-	foreach (IndexElementPair const &pair, mItems) {
-		if (pair.first == index) {
-			return pair.second;
-		}
-	}
-	return NULL;
+	return mItems.value(index);
 }
 
 void EditorViewMViface::setItem(QPersistentModelIndex const &index, Element *item)
 {
-	IndexElementPair pair(index, item);
-	if (!mItems.contains(pair)) {
-		mItems.insert(pair);
+	Element * const oldItem = mItems.value(index);
+	if (oldItem && oldItem != item) {
+		mIndexes.remove(oldItem);
 	}
+
+	mItems.insert(index, item);
+	mIndexes.insert(item, index);
 }
 
 void EditorViewMViface::removeItem(QPersistentModelIndex const &index)
 {
-	foreach (IndexElementPair const &pair, mItems) {
-		if (pair.first == index) {
-			mItems.remove(pair);
+	Element * const element = mItems.value(index);
+	if (element) {
+		removeItem(element);
+	} else {
+		mItems.remove(index);
+	}
+}
+
+void EditorViewMViface::removeItem(Element *item)
+{
+	mItems.remove(mIndexes.take(item));
+
+	foreach (QGraphicsItem * const child, item->childItems()) {
+		Element * const childElement = dynamic_cast<Element *>(child);
+		if (childElement && mIndexes.contains(childElement)) {
+			removeItem(childElement);
 		}
 	}
 }
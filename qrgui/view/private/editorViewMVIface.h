@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QtCore/QSet>
 #include <QtWidgets/QAbstractItemView>
 
 #include "models/graphicalModelAssistApi.h"
@@ -12,6 +13,7 @@ namespace qReal {
 class EditorViewScene;
 
 class Element;
+class NodeElement;
 
 namespace models {
 class GraphicalModelAssistApi;
@@ -55,15 +57,17 @@ private slots:
 	void logicalDataChanged(QModelIndex const &topLeft, QModelIndex const &bottomRight);
 
 private:
-	typedef QPair<QPersistentModelIndex, Element*> IndexElementPair;
-
 	EditorViewScene *mScene;
 	qReal::EditorView *mView;
 	models::GraphicalModelAssistApi *mGraphicalAssistApi;
 	models::LogicalModelAssistApi *mLogicalAssistApi;
 
-	/** @brief elements on the scene. their indices change SUDDENLY, so don't use maps, hashes etc. */
-	QSet<IndexElementPair> mItems;
+	/// Elements on the scene by their indexes. Persistent indexes are hashed by their shared data, so they stay
+	/// valid keys when rows are moved.
+	QHash<QPersistentModelIndex, Element *> mItems;
+
+	/// Indexes of elements on the scene, reverse of mItems.
+	QHash<Element *, QPersistentModelIndex> mIndexes;
 
 	QModelIndex moveCursor(QAbstractItemView::CursorAction cursorAction, Qt::KeyboardModifiers modifiers);
 
@@ -76,9 +80,18 @@ private:
 
 	QRegion visualRegionForSelection(const QItemSelection &selection ) const;
 
+	/// Creates elements for given rows and their children.
+	void addElements(QModelIndex const &parent, int start, int end);
+
+	/// Collects nodes among given rows and their children, and nodes connected to links among them.
+	void collectAffectedNodes(QModelIndex const &parent, int start, int end, QSet<NodeElement *> &nodes) const;
+
 	Element *item(QPersistentModelIndex const &index) const;
 	void setItem(QPersistentModelIndex const &index, Element *item);
+
+	/// Forgets the element of given index together with elements nested into it, which are deleted with it.
 	void removeItem(QPersistentModelIndex const &index);
+	void removeItem(Element *item);
 
 	void clearItems();
 };
@@ -0,0 +1,316 @@
+#include "elementSpatialIndex.h"
+
+#include <algorithm>
+
+#include <QtCore/qmath.h>
+#include <QtCore/qnumeric.h>
+
+#include "umllib/nodeElement.h"
+#include "umllib/edgeElement.h"
+
+using namespace qReal;
+using namespace qReal::view::details;
+
+namespace {
+
+/// Elements covering more cells are not spread over the grid.
+int const maxCellsPerElement = 256;
+
+/// Returns the chain of ancestors of given item from the topmost one down to the item itself.
+QList<QGraphicsItem const *> ancestorsChain(QGraphicsItem const *item)
+{
+	QList<QGraphicsItem const *> result;
+	for (QGraphicsItem const *current = item; current; current = current->parentItem()) {
+		result.prepend(current);
+	}
+
+	return result;
+}
+
+bool stacksBehindParent(QGraphicsItem const *item)
+{
+	return item->flags() & QGraphicsItem::ItemStacksBehindParent;
+}
+
+}
+
+ElementSpatialIndex::ElementSpatialIndex(qreal cellSize)
+	: mCellSize(cellSize)
+	, mNextOrder(0)
+{
+}
+
+void ElementSpatialIndex::insert(Element *element)
+{
+	mOrder[element] = mNextOrder++;
+	NodeElement * const node = dynamic_cast<NodeElement *>(element);
+	if (node) {
+		mNodes[element] = node;
+	}
+
+	EdgeElement * const edge = dynamic_cast<EdgeElement *>(element);
+	if (edge) {
+		mEdges[element] = edge;
+	}
+
+	// The element may be not positioned yet, it is placed before the next query.
+	mChanged.insert(element);
+}
+
+void ElementSpatialIndex::remove(Element *element)
+{
+	unplace(element);
+	mChanged.remove(element);
+	mOrder.remove(element);
+	mNodes.remove(element);
+	mEdges.remove(element);
+}
+
+void ElementSpatialIndex::invalidate(Element *element)
+{
+	if (mOrder.contains(element)) {
+		mChanged.insert(element);
+	}
+}
+
+QList<NodeElement *> ElementSpatialIndex::nodesAt(QPointF const &scenePos) const
+{
+	QList<Element *> found;
+	foreach (Element * const element, candidates(QRectF(scenePos - QPointF(0.5, 0.5), QSizeF(1, 1)))) {
+		NodeElement * const node = mNodes.value(element);
+		if (node && node->isVisible() && node->contains(node->mapFromScene(scenePos))) {
+			found << element;
+		}
+	}
+
+	sortByStackingOrder(found);
+	QList<NodeElement *> result;
+	foreach (Element * const element, found) {
+		result << mNodes[element];
+	}
+
+	return result;
+}
+
+QList<NodeElement *> ElementSpatialIndex::nodesIn(QPainterPath const &scenePath) const
+{
+	QList<Element *> found;
+	foreach (Element * const element, candidates(scenePath.boundingRect())) {
+		NodeElement * const node = mNodes.value(element);
+		if (node && node->isVisible() && node->collidesWithPath(node->mapFromScene(scenePath))) {
+			found << element;
+		}
+	}
+
+	sortByStackingOrder(found);
+	QList<NodeElement *> result;
+	foreach (Element * const element, found) {
+		result << mNodes[element];
+	}
+
+	return result;
+}
+
+QList<EdgeElement *> ElementSpatialIndex::edgesAt(QPointF const &scenePos) const
+{
+	QList<Element *> found;
+	foreach (Element * const element, candidates(QRectF(scenePos - QPointF(0.5, 0.5), QSizeF(1, 1)))) {
+		EdgeElement * const edge = mEdges.value(element);
+		if (edge && edge->isVisible() && edge->contains(edge->mapFromScene(scenePos))) {
+			found << element;
+		}
+	}
+
+	sortByStackingOrder(found);
+	QList<EdgeElement *> result;
+	foreach (Element * const element, found) {
+		result << mEdges[element];
+	}
+
+	return result;
+}
+
+QList<EdgeElement *> ElementSpatialIndex::edgesIn(QPainterPath const &scenePath) const
+{
+	QList<Element *> found;
+	foreach (Element * const element, candidates(scenePath.boundingRect())) {
+		EdgeElement * const edge = mEdges.value(element);
+		if (edge && edge->isVisible() && edge->collidesWithPath(edge->mapFromScene(scenePath))) {
+			found << element;
+		}
+	}
+
+	sortByStackingOrder(found);
+	QList<EdgeElement *> result;
+	foreach (Element * const element, found) {
+		result << mEdges[element];
+	}
+
+	return result;
+}
+
+QSet<Element *> ElementSpatialIndex::candidates(QRectF const &sceneRect) const
+{
+	refresh();
+
+	QSet<Element *> result = mOversized;
+	QRect const range = cells(sceneRect);
+	if (static_cast<qint64>(range.width()) * range.height() > mRects.size()) {
+		// The query covers more cells than there are elements, checking rectangles is cheaper.
+		for (QHash<Element *, QRectF>::const_iterator it = mRects.constBegin(); it != mRects.constEnd(); ++it) {
+			if (it.value().intersects(sceneRect)) {
+				result.insert(it.key());
+			}
+		}
+
+		return result;
+	}
+
+	for (int x = range.left(); x <= range.right(); ++x) {
+		for (int y = range.top(); y <= range.bottom(); ++y) {
+			QHash<quint64, QList<Element *> >::const_iterator const cell = mCells.constFind(cellKey(x, y));
+			if (cell != mCells.constEnd()) {
+				foreach (Element * const element, cell.value()) {
+					result.insert(element);
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+void ElementSpatialIndex::sortByStackingOrder(QList<Element *> &elements) const
+{
+	std::sort(elements.begin(), elements.end(), [this](Element const *first, Element const *second) {
+		return isAbove(first, second);
+	});
+}
+
+bool ElementSpatialIndex::isAbove(Element const *first, Element const *second) const
+{
+	if (first == second) {
+		return false;
+	}
+
+	QList<QGraphicsItem const *> const firstChain = ancestorsChain(first);
+	QList<QGraphicsItem const *> const secondChain = ancestorsChain(second);
+	int common = 0;
+	while (common < firstChain.size() && common < secondChain.size()
+			&& firstChain[common] == secondChain[common])
+	{
+		++common;
+	}
+
+	if (common == firstChain.size()) {
+		// The first element is an ancestor of the second one, children are above their parents.
+		return stacksBehindParent(secondChain[common]);
+	}
+
+	if (common == secondChain.size()) {
+		return !stacksBehindParent(firstChain[common]);
+	}
+
+	QGraphicsItem const * const firstSibling = firstChain[common];
+	QGraphicsItem const * const secondSibling = secondChain[common];
+	if (stacksBehindParent(firstSibling) != stacksBehindParent(secondSibling)) {
+		return stacksBehindParent(secondSibling);
+	}
+
+	if (firstSibling->zValue() != secondSibling->zValue()) {
+		return firstSibling->zValue() > secondSibling->zValue();
+	}
+
+	QGraphicsItem const * const parent = firstSibling->parentItem();
+	if (parent) {
+		// Children are listed in stacking order, which also reflects QGraphicsItem::stackBefore().
+		QList<QGraphicsItem *> const siblings = parent->childItems();
+		return siblings.indexOf(const_cast<QGraphicsItem *>(firstSibling))
+				> siblings.indexOf(const_cast<QGraphicsItem *>(secondSibling));
+	}
+
+	return mOrder.value(firstSibling) > mOrder.value(secondSibling);
+}
+
+void ElementSpatialIndex::refresh() const
+{
+	if (mChanged.isEmpty()) {
+		return;
+	}
+
+	// Nested elements move together with their parents without notifications.
+	QSet<Element *> changed;
+	QList<QGraphicsItem *> toVisit;
+	foreach (Element * const element, mChanged) {
+		toVisit << element;
+	}
+
+	mChanged.clear();
+	while (!toVisit.isEmpty()) {
+		QGraphicsItem * const item = toVisit.takeLast();
+		Element * const element = dynamic_cast<Element *>(item);
+		if (element && mOrder.contains(element) && !changed.contains(element)) {
+			changed.insert(element);
+			toVisit << element->childItems();
+		}
+	}
+
+	foreach (Element * const element, changed) {
+		unplace(element);
+		place(element);
+	}
+}
+
+void ElementSpatialIndex::place(Element *element) const
+{
+	QRectF const rect = element->sceneBoundingRect();
+	mRects[element] = rect;
+	bool const isFinite = qIsFinite(rect.left()) && qIsFinite(rect.top())
+			&& qIsFinite(rect.right()) && qIsFinite(rect.bottom());
+	QRect const range = isFinite ? cells(rect) : QRect();
+	if (!isFinite || static_cast<qint64>(range.width()) * range.height() > maxCellsPerElement) {
+		mOversized.insert(element);
+		return;
+	}
+
+	for (int x = range.left(); x <= range.right(); ++x) {
+		for (int y = range.top(); y <= range.bottom(); ++y) {
+			mCells[cellKey(x, y)] << element;
+		}
+	}
+}
+
+void ElementSpatialIndex::unplace(Element *element) const
+{
+	if (!mRects.contains(element)) {
+		return;
+	}
+
+	QRectF const rect = mRects.take(element);
+	if (mOversized.remove(element)) {
+		return;
+	}
+
+	QRect const range = cells(rect);
+	for (int x = range.left(); x <= range.right(); ++x) {
+		for (int y = range.top(); y <= range.bottom(); ++y) {
+			quint64 const key = cellKey(x, y);
+			QList<Element *> &cell = mCells[key];
+			cell.removeOne(element);
+			if (cell.isEmpty()) {
+				mCells.remove(key);
+			}
+		}
+	}
+}
+
+QRect ElementSpatialIndex::cells(QRectF const &sceneRect) const
+{
+	return QRect(QPoint(qFloor(sceneRect.left() / mCellSize), qFloor(sceneRect.top() / mCellSize))
+			, QPoint(qFloor(sceneRect.right() / mCellSize), qFloor(sceneRect.bottom() / mCellSize)));
+}
+
+quint64 ElementSpatialIndex::cellKey(int x, int y)
+{
+	return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QRectF>
+#include <QtCore/QSet>
+#include <QtGui/QPainterPath>
+
+class QGraphicsItem;
+
+namespace qReal {
+
+class Element;
+class NodeElement;
+class EdgeElement;
+
+namespace view {
+namespace details {
+
+/// Uniform grid over scene bounding rectangles of diagram elements, so geometric queries of a scene do not walk
+/// through all its items and cast each of them. Elements report geometry changes, changed ones are reindexed
+/// lazily before the next query. Queries check exact shapes of candidates and return them in stacking order,
+/// topmost first, like QGraphicsScene::items() does.
+class ElementSpatialIndex
+{
+public:
+	/// @param cellSize - side of a grid cell in scene coordinates.
+	explicit ElementSpatialIndex(qreal cellSize = 200);
+
+	/// Adds an element to the index.
+	void insert(Element *element);
+
+	/// Removes an element from the index.
+	void remove(Element *element);
+
+	/// Marks geometry of given element and of elements nested into it as changed.
+	void invalidate(Element *element);
+
+	/// Returns visible nodes whose shapes contain given point in scene coordinates.
+	QList<NodeElement *> nodesAt(QPointF const &scenePos) const;
+
+	/// Returns visible nodes whose shapes intersect given path in scene coordinates.
+	QList<NodeElement *> nodesIn(QPainterPath const &scenePath) const;
+
+	/// Returns visible edges whose shapes contain given point in scene coordinates.
+	QList<EdgeElement *> edgesAt(QPointF const &scenePos) const;
+
+	/// Returns visible edges whose shapes intersect given path in scene coordinates.
+	QList<EdgeElement *> edgesIn(QPainterPath const &scenePath) const;
+
+private:
+	/// Returns elements whose bounding rectangles intersect given rectangle, in no particular order.
+	QSet<Element *> candidates(QRectF const &sceneRect) const;
+
+	/// Sorts elements topmost first.
+	void sortByStackingOrder(QList<Element *> &elements) const;
+
+	/// Returns true if the first element is painted above the second one.
+	bool isAbove(Element const *first, Element const *second) const;
+
+	/// Reindexes elements with changed geometry.
+	void refresh() const;
+
+	void place(Element *element) const;
+	void unplace(Element *element) const;
+
+	/// Returns the range of cells covered by given rectangle.
+	QRect cells(QRectF const &sceneRect) const;
+
+	static quint64 cellKey(int x, int y);
+
+	qreal const mCellSize;
+
+	/// Insertion order of elements, used to order top-level elements with the same z value. The scene does not
+	/// expose the order of top-level items, and elements are not restacked on the top level.
+	QHash<QGraphicsItem const *, quint64> mOrder;
+	quint64 mNextOrder;
+
+	/// Indexed elements that are nodes and edges, elements are cast once when they are inserted.
+	QHash<Element const *, NodeElement *> mNodes;
+	QHash<Element const *, EdgeElement *> mEdges;
+
+	/// Scene bounding rectangles of placed elements.
+	mutable QHash<Element *, QRectF> mRects;
+	mutable QHash<quint64, QList<Element *> > mCells;
+
+	/// Elements covering too many cells, they are candidates of every query.
+	mutable QSet<Element *> mOversized;
+
+	/// Elements whose geometry has changed since they were placed.
+	mutable QSet<Element *> mChanged;
+};
+
+}
+}
+}
@@ -24,6 +24,7 @@ HEADERS += \
 	$$PWD/copyPaste/pasteEdgeCommand.h \
 	$$PWD/private/exploserView.h \
 	$$PWD/private/touchSupportManager.h \
+	$$PWD/private/elementSpatialIndex.h \
 
 SOURCES += \
 	$$PWD/editorView.cpp \
@@ -46,3 +47,4 @@ SOURCES += \
 	$$PWD/copyPaste/pasteEdgeCommand.cpp \
 	$$PWD/private/exploserView.cpp \
 	$$PWD/private/touchSupportManager.cpp \
+	$$PWD/private/elementSpatialIndex.cpp \
@@ -1,10 +1,90 @@
 #include "ids.h"
 
 #include <QtCore/QVariant>
-#include <QtCore/QUuid>
+#include <QtCore/QMutex>
+
+#include <cstring>
 
 using namespace qReal;
 
+namespace {
+
+/// Global table of interned Id parts. Strings are stored in chunks that are never reallocated,
+/// so a string can be read by its index without locking, once the index was obtained.
+class SymbolTable
+{
+public:
+	SymbolTable()
+		: mCount(0)
+	{
+		memset(mChunks, 0, sizeof(mChunks));
+		// Index 0 is reserved for empty string.
+		intern(QString());
+	}
+
+	~SymbolTable()
+	{
+		for (quint32 i = 0; i * chunkSize < mCount; ++i) {
+			delete[] mChunks[i];
+		}
+	}
+
+	quint32 intern(QString const &symbol)
+	{
+		QMutexLocker const lock(&mMutex);
+		QHash<QString, quint32>::const_iterator const existing = mIndices.constFind(symbol);
+		if (existing != mIndices.constEnd()) {
+			return existing.value();
+		}
+
+		if (mCount % chunkSize == 0) {
+			Q_ASSERT(mCount / chunkSize < maxChunks);
+			mChunks[mCount / chunkSize] = new QString[chunkSize];
+		}
+
+		quint32 const index = mCount;
+		mChunks[index / chunkSize][index % chunkSize] = symbol;
+		mIndices.insert(symbol, index);
+		++mCount;
+		return index;
+	}
+
+	QString const &symbol(quint32 index) const
+	{
+		return mChunks[index / chunkSize][index % chunkSize];
+	}
+
+private:
+	static quint32 const chunkSize = 1024;
+	static quint32 const maxChunks = 16384;
+
+	QMutex mMutex;
+	QHash<QString, quint32> mIndices;
+
+	/// Array of chunks has fixed size, so it is never moved while other threads read from it.
+	QString *mChunks[maxChunks];
+	quint32 mCount;
+};
+
+SymbolTable &symbolTable()
+{
+	static SymbolTable table;
+	return table;
+}
+
+/// Returns true if given string is GUID exactly as QUuid prints it, so it can be stored as QUuid without losses.
+bool isGuid(QString const &string)
+{
+	if (string.length() != 38 || string[0] != '{') {
+		return false;
+	}
+
+	QUuid const uuid(string);
+	return !uuid.isNull() && uuid.toString() == string;
+}
+
+}
+
 Id Id::loadFromString(QString const &string)
 {
 	QStringList const path = string.split('/');
@@ -13,13 +93,13 @@ Id Id::loadFromString(QString const &string)
 
 	Id result;
 	switch (path.count()) {
-	case 5: result.mId = path[4];
+	case 5: result.setIdPart(path[4]);
 		// Fall-thru
-	case 4: result.mElement = path[3];
+	case 4: result.mElement = intern(path[3]);
 		// Fall-thru
-	case 3: result.mDiagram = path[2];
+	case 3: result.mDiagram = intern(path[2]);
 		// Fall-thru
-	case 2: result.mEditor = path[1];
+	case 2: result.mEditor = intern(path[1]);
 		// Fall-thru
 	}
 	Q_ASSERT(string == result.toString());
@@ -28,20 +108,24 @@ Id Id::loadFromString(QString const &string)
 
 Id Id::createElementId(QString const &editor, QString const &diagram, QString const &element)
 {
-	return Id(editor, diagram, element, QUuid::createUuid().toString());
+	Id result(editor, diagram, element);
+	result.mGuid = QUuid::createUuid();
+	return result;
 }
 
 Id Id::rootId()
 {
-	return Id("ROOT_ID", "ROOT_ID", "ROOT_ID", "ROOT_ID");
+	static Id const root("ROOT_ID", "ROOT_ID", "ROOT_ID", "ROOT_ID");
+	return root;
 }
 
 Id::Id(QString const &editor, QString  const &diagram, QString  const &element, QString  const &id)
-		: mEditor(editor)
-		, mDiagram(diagram)
-		, mElement(element)
-		, mId(id)
+		: mEditor(intern(editor))
+		, mDiagram(intern(diagram))
+		, mElement(intern(element))
+		, mId(0)
 {
+	setIdPart(id);
 	Q_ASSERT(checkIntegrity());
 }
 
@@ -50,20 +134,21 @@ Id::Id(Id const &base, QString const &additional)
 		, mDiagram(base.mDiagram)
 		, mElement(base.mElement)
 		, mId(base.mId)
+		, mGuid(base.mGuid)
 {
 	unsigned const baseSize = base.idSize();
 	switch (baseSize) {
 	case 0:
-		mEditor = additional;
+		mEditor = intern(additional);
 		break;
 	case 1:
-		mDiagram = additional;
+		mDiagram = intern(additional);
 		break;
 	case 2:
-		mElement = additional;
+		mElement = intern(additional);
 		break;
 	case 3:
-		mId = additional;
+		setIdPart(additional);
 		break;
 	default:
 		Q_ASSERT(!"Can not add a part to Id, it will be too long");
@@ -71,51 +156,108 @@ Id::Id(Id const &base, QString const &additional)
 	Q_ASSERT(checkIntegrity());
 }
 
+quint32 Id::intern(QString const &symbol)
+{
+	return symbol.isEmpty() ? 0 : symbolTable().intern(symbol);
+}
+
+QString const &Id::symbol(quint32 index)
+{
+	return symbolTable().symbol(index);
+}
+
+bool Id::symbolLess(quint32 index1, quint32 index2)
+{
+	return symbol(index1) < symbol(index2);
+}
+
+bool Id::idPartLess(Id const &i1, Id const &i2)
+{
+	if (i1.mGuid.isNull() && i2.mGuid.isNull()) {
+		return i1.mId != i2.mId && symbolLess(i1.mId, i2.mId);
+	}
+
+	if (!i1.mGuid.isNull() && !i2.mGuid.isNull()) {
+		// Fields are printed in this order as fixed width hex numbers, so numeric order is the same as textual one.
+		if (i1.mGuid.data1 != i2.mGuid.data1) {
+			return i1.mGuid.data1 < i2.mGuid.data1;
+		}
+
+		if (i1.mGuid.data2 != i2.mGuid.data2) {
+			return i1.mGuid.data2 < i2.mGuid.data2;
+		}
+
+		if (i1.mGuid.data3 != i2.mGuid.data3) {
+			return i1.mGuid.data3 < i2.mGuid.data3;
+		}
+
+		return memcmp(i1.mGuid.data4, i2.mGuid.data4, sizeof(i1.mGuid.data4)) < 0;
+	}
+
+	return i1.id() < i2.id();
+}
+
+void Id::setIdPart(QString const &id)
+{
+	if (isGuid(id)) {
+		mGuid = QUuid(id);
+		mId = 0;
+	} else {
+		mGuid = QUuid();
+		mId = intern(id);
+	}
+}
+
 bool Id::isNull() const
 {
-	return mEditor.isEmpty() && mDiagram.isEmpty()
-			&& mElement.isEmpty() && mId.isEmpty();
+	return mEditor == 0 && mDiagram == 0 && mElement == 0 && mId == 0 && mGuid.isNull();
 }
 
 QString Id::editor() const
 {
-	return mEditor;
+	return symbol(mEditor);
 }
 
 QString Id::diagram() const
 {
-	return mDiagram;
+	return symbol(mDiagram);
 }
 
 QString Id::element() const
 {
-	return mElement;
+	return symbol(mElement);
 }
 
 QString Id::id() const
 {
-	return mId;
+	return mGuid.isNull() ? symbol(mId) : mGuid.toString();
 }
 
 Id Id::type() const
 {
-	return Id(mEditor, mDiagram, mElement);
+	Id result;
+	result.mEditor = mEditor;
+	result.mDiagram = mDiagram;
+	result.mElement = mElement;
+	return result;
 }
 
 Id Id::sameTypeId() const
 {
-	return Id(mEditor, mDiagram, mElement, QUuid::createUuid().toString());
+	Id result = type();
+	result.mGuid = QUuid::createUuid();
+	return result;
 }
 
 unsigned Id::idSize() const
 {
-	if (!mId.isEmpty()) {
+	if (mId != 0 || !mGuid.isNull()) {
 		return 4;
-	} if (!mElement.isEmpty()) {
+	} if (mElement != 0) {
 		return 3;
-	} if (!mDiagram.isEmpty()) {
+	} if (mDiagram != 0) {
 		return 2;
-	} if (!mEditor.isEmpty()) {
+	} if (mEditor != 0) {
 		return 1;
 	}
 	return 0;
@@ -128,13 +270,13 @@ QUrl Id::toUrl() const
 
 QString Id::toString() const
 {
-	QString path = "qrm:/" + mEditor;
-	if (mDiagram != "") {
-		path += "/" + mDiagram;
-	} if (mElement != "") {
-		path += "/" + mElement;
-	} if (mId != "") {
-		path += "/" + mId;
+	QString path = "qrm:/" + symbol(mEditor);
+	if (mDiagram != 0) {
+		path += "/" + symbol(mDiagram);
+	} if (mElement != 0) {
+		path += "/" + symbol(mElement);
+	} if (mId != 0 || !mGuid.isNull()) {
+		path += "/" + id();
 	}
 	return path;
 }
@@ -143,23 +285,23 @@ bool Id::checkIntegrity() const
 {
 	bool emptyPartsAllowed = true;
 
-	if (!mId.isEmpty()) {
+	if (mId != 0 || !mGuid.isNull()) {
 		emptyPartsAllowed = false;
 	}
 
-	if (!mElement.isEmpty()) {
+	if (mElement != 0) {
 		emptyPartsAllowed = false;
 	} else if (!emptyPartsAllowed) {
 		return false;
 	}
 
-	if (!mDiagram.isEmpty()) {
+	if (mDiagram != 0) {
 		emptyPartsAllowed = false;
 	} else if (!emptyPartsAllowed) {
 		return false;
 	}
 
-	if (mEditor.isEmpty() && !emptyPartsAllowed) {
+	if (mEditor == 0 && !emptyPartsAllowed) {
 		return false;
 	}
 
@@ -6,6 +6,7 @@
 #include <QtCore/QHash>
 #include <QtCore/QMetaType>
 #include <QtCore/QDebug>
+#include <QtCore/QUuid>
 
 #include "kernelDeclSpec.h"
 
@@ -15,6 +16,11 @@ namespace qReal {
 /// editor (metamodel to which our element belongs to), diagram in that editor
 /// (a tab in palette where this element will appear), element (type of
 /// an element, actually), id (id of an element).
+///
+/// Editor, diagram and element parts are interned: they are stored as indices in a global symbol table,
+/// id part is stored as 128-bit value if it is a GUID (as for all ids created by createElementId()). So
+/// copying, equality checks and hashing of ids do not touch strings and do not allocate memory. Ordering
+/// (operator<) keeps textual order of ids and compares strings of parts that differ, see its comment.
 class QRKERNEL_EXPORT Id
 {
 public:
@@ -85,22 +91,47 @@ public:
 
 	// default destructor and copy constuctor are OK
 private:
+	friend bool operator==(Id const &i1, Id const &i2);
+	friend bool operator<(Id const &i1, Id const &i2);
+	friend uint qHash(Id const &key);
+
+	/// Returns index of given string in symbol table, adding it to the table if needed. Empty string has index 0.
+	static quint32 intern(QString const &symbol);
+
+	/// Returns a string with given index in symbol table.
+	static QString const &symbol(quint32 index);
+
+	/// Compares strings with given indices in symbol table.
+	static bool symbolLess(quint32 index1, quint32 index2);
+
+	/// Compares id parts of two ids, GUIDs are compared as their string representations would be.
+	static bool idPartLess(Id const &i1, Id const &i2);
+
+	/// Sets id part, storing it as GUID if possible.
+	void setIdPart(QString const &id);
+
 	/// Used only for debug. Checks that Id is correct.
 	bool checkIntegrity() const;
 
-	QString mEditor;
-	QString mDiagram;
-	QString mElement;
-	QString mId;
+	quint32 mEditor;
+	quint32 mDiagram;
+	quint32 mElement;
+
+	/// Interned id part, 0 if id part is empty or is a GUID.
+	quint32 mId;
+
+	/// Id part if it is a GUID, null otherwise.
+	QUuid mGuid;
 };
 
 /// Id equality operator. Ids are equal when all their parts are equal.
 inline bool operator==(Id const &i1, Id const &i2)
 {
-	return i1.editor() == i2.editor()
-			&& i1.diagram() == i2.diagram()
-			&& i1.element() == i2.element()
-			&& i1.id() == i2.id();
+	return i1.mElement == i2.mElement
+			&& i1.mId == i2.mId
+			&& i1.mGuid == i2.mGuid
+			&& i1.mDiagram == i2.mDiagram
+			&& i1.mEditor == i2.mEditor;
 }
 
 /// Id inequality operator.
@@ -109,17 +140,37 @@ inline bool operator!=(Id const &i1, Id const &i2)
 	return !(i1 == i2);
 }
 
-/// Comparison operator for using Id in maps
+/// Comparison operator for using Id in maps. Ids are ordered by their parts, each part is compared as a string,
+/// but equal parts are detected without looking at strings and GUIDs are compared as numbers. Order of interned
+/// indices is not used on purpose: it depends on the order in which strings were met, so iteration over
+/// QMap<Id, ...> and sorted lists of ids (in saved files, for example) would differ from run to run. Ids
+/// of elements of one diagram usually share editor and diagram parts, so only element names are compared
+/// as strings.
 inline bool operator<(Id const &i1, Id const &i2)
 {
-	return i1.toString() < i2.toString();
+	if (i1.mEditor != i2.mEditor) {
+		return Id::symbolLess(i1.mEditor, i2.mEditor);
+	}
+
+	if (i1.mDiagram != i2.mDiagram) {
+		return Id::symbolLess(i1.mDiagram, i2.mDiagram);
+	}
+
+	if (i1.mElement != i2.mElement) {
+		return Id::symbolLess(i1.mElement, i2.mElement);
+	}
+
+	return Id::idPartLess(i1, i2);
 }
 
 /// Hash function for Id for using it in QHash.
 inline uint qHash(Id const &key)
 {
-	return qHash(key.editor()) ^ qHash(key.diagram()) ^ qHash(key.element())
-			^ qHash(key.id());
+	uint result = key.mEditor;
+	result = result * 31 + key.mDiagram;
+	result = result * 31 + key.mElement;
+	result = result * 31 + key.mId;
+	return result * 31 + qHash(key.mGuid);
 }
 
 /// Operator for printing Id in QDebug.
@@ -12,6 +12,7 @@ SettingsManager* SettingsManager::mInstance = nullptr;
 SettingsManager::SettingsManager()
 	: mSettings("SPbSU", "QReal")
 	, mUXInfoInterface(NULL)
+	, mReadOnly(false)
 {
 	initDefaultValues();
 	load();
@@ -81,6 +82,10 @@ void SettingsManager::reportValueSetting(QString const &name, QVariant const &ol
 
 void SettingsManager::saveData()
 {
+	if (mReadOnly) {
+		return;
+	}
+
 	foreach (QString const &name, mData.keys()) {
 		mSettings.setValue(name, mData[name]);
 	}
@@ -112,6 +117,11 @@ void SettingsManager::loadSettings(QString  const &fileNameForImport)
 	saveData();
 }
 
+void SettingsManager::setReadOnly(bool readOnly)
+{
+	mReadOnly = readOnly;
+}
+
 void SettingsManager::initDefaultValues()
 {
 	QSettings values(":/settingsDefaultValues", QSettings::IniFormat);
@@ -57,6 +57,10 @@ public:
 	/// Loads settings from selected file with name fileNameForImport.
 	void loadSettings(const QString &fileNameForImport);
 
+	/// In read-only mode settings are changed for the running instance only: saveData() and loading of settings
+	/// from a file leave persistent storage untouched.
+	void setReadOnly(bool readOnly);
+
 private:
 	/// Private constructor.
 	SettingsManager();
@@ -79,6 +83,7 @@ private:
 	/// Persistent settings storage.
 	QSettings mSettings;
 	UXInfoInterface* mUXInfoInterface; // Has ownership
+	bool mReadOnly;
 };
 
 }
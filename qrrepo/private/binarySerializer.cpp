@@ -0,0 +1,756 @@
+#include "binarySerializer.h"
+
+#include <cstring>
+
+#include <QtCore/QBuffer>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QPointF>
+#include <QtCore/QtEndian>
+#include <QtGui/QPolygon>
+
+#include "../../qrkernel/exception/exception.h"
+#include "classes/logicalObject.h"
+#include "classes/graphicalObject.h"
+
+using namespace qReal;
+using namespace qrRepo::details;
+
+QString const BinarySerializer::extension = "qrb";
+
+namespace {
+
+char const magic[4] = { 'Q', 'R', 'B', '1' };
+quint32 const formatVersion = 1;
+
+/// Size of a header: magic, version, strings count, objects count, string table offset, index offset.
+int const headerSize = 4 + 4 + 4 + 4 + 8 + 8;
+
+/// Size of an index entry: id string and record offset.
+int const indexEntrySize = 4 + 8;
+
+/// Marks absent string, used for null ids.
+quint32 const noString = 0xFFFFFFFF;
+
+enum ObjectKind
+{
+	logicalObject = 0
+	, graphicalObject
+};
+
+/// Tags of property value types.
+enum ValueType
+{
+	intValue = 1
+	, uintValue
+	, doubleValue
+	, boolValue
+	, stringValue
+	, stringListValue
+	, charValue
+	, pointFValue
+	, polygonValue
+	, polygonFValue
+	, idValue
+	, idListValue
+};
+
+/// Accumulates object records and a table of strings used by them.
+class Writer
+{
+public:
+	Writer()
+		: mBuffer(&mRecords)
+	{
+		mBuffer.open(QIODevice::WriteOnly);
+		mStream.setDevice(&mBuffer);
+		mStream.setByteOrder(QDataStream::LittleEndian);
+		mStream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+	}
+
+	/// Writes a record for given object, returns its offset relative to the beginning of records.
+	quint64 writeObject(Object const *object)
+	{
+		quint64 const offset = mBuffer.pos();
+		GraphicalObject const * const graphical = dynamic_cast<GraphicalObject const *>(object);
+
+		mStream << static_cast<quint8>(graphical ? graphicalObject : logicalObject);
+		writeId(object->id());
+		writeId(object->parent());
+		if (graphical) {
+			writeId(graphical->logicalId());
+		}
+
+		writeIdList(object->children());
+		writeProperties(object->properties());
+
+		if (graphical) {
+			QList<int> const parts = graphical->graphicalParts();
+			mStream << static_cast<quint32>(parts.size());
+			foreach (int const part, parts) {
+				mStream << static_cast<qint32>(part);
+				writeProperties(graphical->graphicalPartProperties(part));
+			}
+		}
+
+		return offset;
+	}
+
+	quint32 stringIndex(QString const &string)
+	{
+		QHash<QString, quint32>::const_iterator const existing = mStringIndexes.constFind(string);
+		if (existing != mStringIndexes.constEnd()) {
+			return existing.value();
+		}
+
+		quint32 const index = mStrings.size();
+		mStrings << string;
+		mStringIndexes.insert(string, index);
+		return index;
+	}
+
+	QStringList const &strings() const
+	{
+		return mStrings;
+	}
+
+	QByteArray const &records() const
+	{
+		return mRecords;
+	}
+
+private:
+	void writeString(QString const &string)
+	{
+		mStream << stringIndex(string);
+	}
+
+	void writeId(Id const &id)
+	{
+		mStream << (id.isNull() ? noString : stringIndex(id.toString()));
+	}
+
+	void writeIdList(IdList const &ids)
+	{
+		mStream << static_cast<quint32>(ids.size());
+		foreach (Id const &id, ids) {
+			writeId(id);
+		}
+	}
+
+	void writeProperties(QMap<QString, QVariant> const &properties)
+	{
+		mStream << static_cast<quint32>(properties.size());
+		for (QMap<QString, QVariant>::const_iterator i = properties.constBegin(); i != properties.constEnd(); ++i) {
+			writeString(i.key());
+			writeValue(i.key(), i.value());
+		}
+	}
+
+	void writeValue(QString const &name, QVariant const &value)
+	{
+		switch (value.type()) {
+		case QVariant::Int:
+			mStream << static_cast<quint8>(intValue) << static_cast<qint32>(value.toInt());
+			return;
+		case QVariant::UInt:
+			mStream << static_cast<quint8>(uintValue) << static_cast<quint32>(value.toUInt());
+			return;
+		case QVariant::Double:
+			mStream << static_cast<quint8>(doubleValue) << value.toDouble();
+			return;
+		case QVariant::Bool:
+			mStream << static_cast<quint8>(boolValue) << static_cast<quint8>(value.toBool());
+			return;
+		case QVariant::String:
+			mStream << static_cast<quint8>(stringValue);
+			writeString(value.toString());
+			return;
+		case QVariant::StringList: {
+			QStringList const list = value.toStringList();
+			mStream << static_cast<quint8>(stringListValue) << static_cast<quint32>(list.size());
+			foreach (QString const &string, list) {
+				writeString(string);
+			}
+			return;
+		}
+		case QVariant::Char:
+			mStream << static_cast<quint8>(charValue) << static_cast<quint16>(value.toChar().unicode());
+			return;
+		case QVariant::PointF:
+			mStream << static_cast<quint8>(pointFValue) << value.toPointF().x() << value.toPointF().y();
+			return;
+		case QVariant::Polygon: {
+			QPolygon const polygon = value.value<QPolygon>();
+			mStream << static_cast<quint8>(polygonValue) << static_cast<quint32>(polygon.size());
+			foreach (QPoint const &point, polygon) {
+				mStream << static_cast<qint32>(point.x()) << static_cast<qint32>(point.y());
+			}
+			return;
+		}
+		case QVariant::PolygonF: {
+			QPolygonF const polygon = value.value<QPolygonF>();
+			mStream << static_cast<quint8>(polygonFValue) << static_cast<quint32>(polygon.size());
+			foreach (QPointF const &point, polygon) {
+				mStream << point.x() << point.y();
+			}
+			return;
+		}
+		default:
+			break;
+		}
+
+		if (value.userType() == qMetaTypeId<Id>()) {
+			mStream << static_cast<quint8>(idValue);
+			writeId(value.value<Id>());
+		} else if (value.userType() == qMetaTypeId<IdList>()) {
+			mStream << static_cast<quint8>(idListValue);
+			writeIdList(value.value<IdList>());
+		} else {
+			throw Exception(QString("Property %1 has type %2 which can not be saved").arg(name, value.typeName()));
+		}
+	}
+
+	QByteArray mRecords;
+	QBuffer mBuffer;
+	QDataStream mStream;
+	QStringList mStrings;
+	QHash<QString, quint32> mStringIndexes;
+};
+
+/// Bounds-checked sequential reader of a mapped file.
+class Reader
+{
+public:
+	Reader(uchar const *data, qint64 size)
+		: mData(data)
+		, mSize(size)
+		, mPosition(0)
+	{
+	}
+
+	void seek(quint64 position)
+	{
+		if (position > static_cast<quint64>(mSize)) {
+			corrupted();
+		}
+
+		mPosition = position;
+	}
+
+	quint8 readUInt8()
+	{
+		require(1);
+		return mData[mPosition++];
+	}
+
+	quint16 readUInt16()
+	{
+		require(2);
+		quint16 const result = qFromLittleEndian<quint16>(mData + mPosition);
+		mPosition += 2;
+		return result;
+	}
+
+	quint32 readUInt32()
+	{
+		require(4);
+		quint32 const result = qFromLittleEndian<quint32>(mData + mPosition);
+		mPosition += 4;
+		return result;
+	}
+
+	quint64 readUInt64()
+	{
+		require(8);
+		quint64 const result = qFromLittleEndian<quint64>(mData + mPosition);
+		mPosition += 8;
+		return result;
+	}
+
+	double readDouble()
+	{
+		quint64 const bits = readUInt64();
+		double result = 0;
+		memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	QString readUtf8(quint32 length)
+	{
+		require(length);
+		QString const result = QString::fromUtf8(reinterpret_cast<char const *>(mData + mPosition), length);
+		mPosition += length;
+		return result;
+	}
+
+	void skip(quint32 length)
+	{
+		require(length);
+		mPosition += length;
+	}
+
+	qint64 position() const
+	{
+		return mPosition;
+	}
+
+	bool matches(char const *bytes, int length)
+	{
+		require(length);
+		bool const result = memcmp(mData + mPosition, bytes, length) == 0;
+		mPosition += length;
+		return result;
+	}
+
+	static void corrupted()
+	{
+		throw Exception("Binary project file is corrupted");
+	}
+
+private:
+	void require(qint64 bytes) const
+	{
+		if (mPosition + bytes > mSize) {
+			corrupted();
+		}
+	}
+
+	uchar const *mData;
+	qint64 mSize;
+	qint64 mPosition;
+};
+
+/// Binary project file mapped into memory. Objects loaded lazily share it and read their properties from it
+/// on first access, so the file stays mapped until all such objects are materialized or deleted.
+class MappedProject : public LazyPropertiesSource
+{
+public:
+	explicit MappedProject(QString const &fileName)
+		: mFile(fileName)
+		, mData(NULL)
+		, mSize(0)
+		, mObjectsCount(0)
+		, mIndexOffset(0)
+	{
+		if (!mFile.open(QIODevice::ReadOnly)) {
+			throw Exception("Can not open file " + fileName);
+		}
+
+		mSize = mFile.size();
+		mData = mFile.map(0, mSize);
+		if (!mData) {
+			// Some file systems do not support mapping, reading the file in memory then.
+			mContents = mFile.readAll();
+			mData = reinterpret_cast<uchar const *>(mContents.constData());
+		}
+
+		Reader reader(mData, mSize);
+		if (!reader.matches(magic, sizeof(magic)) || reader.readUInt32() != formatVersion) {
+			throw Exception("Unknown binary project file format");
+		}
+
+		quint32 const stringsCount = reader.readUInt32();
+		mObjectsCount = reader.readUInt32();
+		quint64 const stringTableOffset = reader.readUInt64();
+		mIndexOffset = reader.readUInt64();
+
+		// Strings are decoded only when needed, here only their positions are remembered.
+		reader.seek(stringTableOffset);
+		mStringOffsets.reserve(stringsCount);
+		for (quint32 i = 0; i < stringsCount; ++i) {
+			quint32 const length = reader.readUInt32();
+			mStringOffsets << reader.position();
+			reader.skip(length);
+		}
+
+		mStrings.resize(stringsCount);
+		mIds.resize(stringsCount);
+	}
+
+	~MappedProject()
+	{
+		mFile.close();
+	}
+
+	quint32 objectsCount() const
+	{
+		return mObjectsCount;
+	}
+
+	/// Returns absolute path to the file the project is read from.
+	QString filePath() const
+	{
+		return QFileInfo(mFile).absoluteFilePath();
+	}
+
+	/// Reads the whole file in memory and closes it, so the file may be replaced or removed. Objects that are
+	/// not materialized yet get their properties from the copy in memory.
+	void detach()
+	{
+		QMutexLocker const locker(&mMutex);
+		if (!mFile.isOpen()) {
+			return;
+		}
+
+		if (mContents.isEmpty()) {
+			mContents = QByteArray(reinterpret_cast<char const *>(mData), static_cast<int>(mSize));
+			mFile.unmap(const_cast<uchar *>(mData));
+			mData = reinterpret_cast<uchar const *>(mContents.constData());
+		}
+
+		mFile.close();
+	}
+
+	/// Creates an object with given index in a file, reading only its id, parent, logical id and children.
+	/// @param propertiesPosition - will contain the position of object properties in a file.
+	Object *readSkeleton(quint32 index, quint64 &propertiesPosition)
+	{
+		Reader reader(mData, mSize);
+		reader.seek(mIndexOffset + static_cast<quint64>(index) * indexEntrySize);
+		reader.readUInt32();
+		reader.seek(reader.readUInt64());
+
+		quint8 const kind = reader.readUInt8();
+		if (kind != logicalObject && kind != graphicalObject) {
+			Reader::corrupted();
+		}
+
+		Id const id = readId(reader);
+		Id const parent = readId(reader);
+		if (id.isNull()) {
+			Reader::corrupted();
+		}
+
+		Object *object = NULL;
+		if (kind == graphicalObject) {
+			object = new GraphicalObject(id, parent, readId(reader));
+		} else {
+			object = new LogicalObject(id);
+			object->setParent(parent);
+		}
+
+		try {
+			foreach (Id const &child, readIdList(reader)) {
+				object->addChild(child);
+			}
+		} catch (...) {
+			delete object;
+			throw;
+		}
+
+		propertiesPosition = reader.position();
+		return object;
+	}
+
+	// Override.
+	virtual void materialize(Object &object, quint64 position)
+	{
+		QMutexLocker const locker(&mMutex);
+
+		Reader reader(mData, mSize);
+		reader.seek(position);
+		object.setProperties(readProperties(reader));
+
+		GraphicalObject * const graphical = dynamic_cast<GraphicalObject *>(&object);
+		if (graphical) {
+			quint32 const partsCount = reader.readUInt32();
+			for (quint32 i = 0; i < partsCount; ++i) {
+				int const index = static_cast<qint32>(reader.readUInt32());
+				graphical->createGraphicalPart(index);
+				QMap<QString, QVariant> const partProperties = readProperties(reader);
+				for (QMap<QString, QVariant>::const_iterator property = partProperties.constBegin()
+						; property != partProperties.constEnd()
+						; ++property)
+				{
+					graphical->setGraphicalPartProperty(index, property.key(), property.value());
+				}
+			}
+		}
+	}
+
+private:
+	QString const &string(quint32 index)
+	{
+		if (index >= static_cast<quint32>(mStringOffsets.size())) {
+			Reader::corrupted();
+		}
+
+		if (mStrings[index].isNull()) {
+			Reader reader(mData, mSize);
+			reader.seek(mStringOffsets[index] - 4);
+			mStrings[index] = reader.readUtf8(reader.readUInt32());
+		}
+
+		return mStrings[index];
+	}
+
+	QString const &readString(Reader &reader)
+	{
+		return string(reader.readUInt32());
+	}
+
+	Id readId(Reader &reader)
+	{
+		quint32 const index = reader.readUInt32();
+		if (index == noString) {
+			return Id();
+		}
+
+		QString const &idString = string(index);
+
+		// Same ids are met many times (as parents, children, link ends), so they are parsed only once.
+		if (mIds[index].isNull()) {
+			mIds[index] = Id::loadFromString(idString);
+		}
+
+		return mIds[index];
+	}
+
+	IdList readIdList(Reader &reader)
+	{
+		quint32 const size = reader.readUInt32();
+		IdList result;
+		result.reserve(size);
+		for (quint32 i = 0; i < size; ++i) {
+			result << readId(reader);
+		}
+
+		return result;
+	}
+
+	QMap<QString, QVariant> readProperties(Reader &reader)
+	{
+		QMap<QString, QVariant> result;
+		quint32 const size = reader.readUInt32();
+		for (quint32 i = 0; i < size; ++i) {
+			QString const &name = readString(reader);
+			result.insert(name, readValue(reader));
+		}
+
+		return result;
+	}
+
+	QVariant readValue(Reader &reader)
+	{
+		switch (reader.readUInt8()) {
+		case intValue:
+			return static_cast<int>(static_cast<qint32>(reader.readUInt32()));
+		case uintValue:
+			return static_cast<uint>(reader.readUInt32());
+		case doubleValue:
+			return reader.readDouble();
+		case boolValue:
+			return reader.readUInt8() != 0;
+		case stringValue:
+			return readString(reader);
+		case stringListValue: {
+			QStringList result;
+			quint32 const size = reader.readUInt32();
+			for (quint32 i = 0; i < size; ++i) {
+				result << readString(reader);
+			}
+
+			return result;
+		}
+		case charValue:
+			return QChar(reader.readUInt16());
+		case pointFValue: {
+			double const x = reader.readDouble();
+			return QPointF(x, reader.readDouble());
+		}
+		case polygonValue: {
+			QPolygon result;
+			quint32 const size = reader.readUInt32();
+			for (quint32 i = 0; i < size; ++i) {
+				int const x = static_cast<qint32>(reader.readUInt32());
+				result << QPoint(x, static_cast<qint32>(reader.readUInt32()));
+			}
+
+			return result;
+		}
+		case polygonFValue: {
+			QPolygonF result;
+			quint32 const size = reader.readUInt32();
+			for (quint32 i = 0; i < size; ++i) {
+				double const x = reader.readDouble();
+				result << QPointF(x, reader.readDouble());
+			}
+
+			return result;
+		}
+		case idValue:
+			return readId(reader).toVariant();
+		case idListValue:
+			return IdListHelper::toVariant(readIdList(reader));
+		default:
+			Reader::corrupted();
+			return QVariant();
+		}
+	}
+
+	QFile mFile;
+	uchar const *mData;
+	qint64 mSize;
+	QByteArray mContents;
+	quint32 mObjectsCount;
+	quint64 mIndexOffset;
+
+	QVector<quint64> mStringOffsets;
+	QVector<QString> mStrings;
+	QVector<Id> mIds;
+
+	/// Lazily loaded objects may be materialized by background readers.
+	QMutex mMutex;
+};
+
+/// Guards the list of mapped projects.
+QMutex &mappedProjectsMutex()
+{
+	static QMutex mutex;
+	return mutex;
+}
+
+/// Projects that have lazily loaded objects, so their files can be released before they are overwritten.
+QList<QWeakPointer<MappedProject> > &mappedProjects()
+{
+	static QList<QWeakPointer<MappedProject> > projects;
+	return projects;
+}
+
+void registerMappedProject(QSharedPointer<MappedProject> const &project)
+{
+	QMutexLocker const locker(&mappedProjectsMutex());
+	mappedProjects() << project.toWeakRef();
+}
+
+/// Detaches all projects read from given file. A mapped file can not be removed on Windows, and on other systems
+/// its mapping would keep the replaced contents alive.
+void releaseMappings(QString const &fileName)
+{
+	QString const path = QFileInfo(fileName).absoluteFilePath();
+	QMutexLocker const locker(&mappedProjectsMutex());
+	QList<QWeakPointer<MappedProject> > &projects = mappedProjects();
+	for (QList<QWeakPointer<MappedProject> >::iterator i = projects.begin(); i != projects.end(); ) {
+		QSharedPointer<MappedProject> const project = i->toStrongRef();
+		if (project.isNull()) {
+			i = projects.erase(i);
+			continue;
+		}
+
+		if (project->filePath() == path) {
+			project->detach();
+		}
+
+		++i;
+	}
+}
+
+}
+
+bool BinarySerializer::isBinaryFile(QString const &fileName)
+{
+	return QFileInfo(fileName).suffix() == extension;
+}
+
+void BinarySerializer::save(QString const &fileName, QList<Object *> const &objects)
+{
+	Writer writer;
+	QList<QPair<quint32, quint64> > index;
+	foreach (Object const * const object, objects) {
+		quint64 const offset = writer.writeObject(object);
+		index << qMakePair(writer.stringIndex(object->id().toString()), offset);
+	}
+
+	QByteArray strings;
+	{
+		QDataStream stream(&strings, QIODevice::WriteOnly);
+		stream.setByteOrder(QDataStream::LittleEndian);
+		foreach (QString const &string, writer.strings()) {
+			QByteArray const utf8 = string.toUtf8();
+			stream << static_cast<quint32>(utf8.size());
+			stream.writeRawData(utf8.constData(), utf8.size());
+		}
+	}
+
+	quint64 const stringTableOffset = headerSize;
+	quint64 const recordsOffset = stringTableOffset + strings.size();
+	quint64 const indexOffset = recordsOffset + writer.records().size();
+
+	// New contents are written aside, so a file which is currently mapped by a reader stays valid.
+	QString const partFileName = fileName + ".part";
+	QFile file(partFileName);
+	if (!file.open(QIODevice::WriteOnly)) {
+		throw Exception("Can not open file " + partFileName + " for writing");
+	}
+
+	QDataStream stream(&file);
+	stream.setByteOrder(QDataStream::LittleEndian);
+	stream.writeRawData(magic, sizeof(magic));
+	stream << formatVersion
+			<< static_cast<quint32>(writer.strings().size())
+			<< static_cast<quint32>(objects.size())
+			<< stringTableOffset
+			<< indexOffset;
+
+	stream.writeRawData(strings.constData(), strings.size());
+	stream.writeRawData(writer.records().constData(), writer.records().size());
+
+	for (int i = 0; i < index.size(); ++i) {
+		stream << index[i].first << recordsOffset + index[i].second;
+	}
+
+	file.close();
+	if (stream.status() != QDataStream::Ok) {
+		QFile::remove(partFileName);
+		throw Exception("Failed to write file " + fileName);
+	}
+
+	releaseMappings(fileName);
+	QFile::remove(fileName);
+	if (!QFile::rename(partFileName, fileName)) {
+		throw Exception("Failed to write file " + fileName);
+	}
+}
+
+void BinarySerializer::load(QString const &fileName, QHash<Id, Object *> &objectsHash, bool lazy)
+{
+	if (!QFile::exists(fileName)) {
+		return;
+	}
+
+	QSharedPointer<MappedProject> const project(new MappedProject(fileName));
+	quint32 const objectsCount = project->objectsCount();
+
+	if (lazy) {
+		registerMappedProject(project);
+	}
+
+	QHash<Id, Object *> loaded;
+	loaded.reserve(objectsCount);
+	try {
+		for (quint32 i = 0; i < objectsCount; ++i) {
+			quint64 propertiesPosition = 0;
+			Object * const object = project->readSkeleton(i, propertiesPosition);
+			delete loaded.value(object->id());
+			loaded.insert(object->id(), object);
+
+			if (lazy) {
+				object->setLazyPropertiesSource(project, propertiesPosition);
+			} else {
+				project->materialize(*object, propertiesPosition);
+			}
+		}
+	} catch (...) {
+		qDeleteAll(loaded);
+		throw;
+	}
+
+	for (QHash<Id, Object *>::const_iterator i = loaded.constBegin(); i != loaded.constEnd(); ++i) {
+		delete objectsHash.value(i.key());
+		objectsHash.insert(i.key(), i.value());
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include "../../qrkernel/ids.h"
+#include "classes/object.h"
+
+namespace qrRepo {
+namespace details {
+
+/// Saves and loads repository contents as a single indexed binary file (.qrb) --- an alternative to
+/// XML-per-object .qrs file. Binary file consists of a header, a table of all strings used in a model (ids,
+/// property names, string values), object records with typed property values and an index of record offsets.
+/// File is read through memory mapping, without decompressing it into temporary directory.
+class BinarySerializer
+{
+public:
+	/// Extension of binary project files.
+	static QString const extension;
+
+	/// Returns true if given file is a binary project file (judging by its extension).
+	static bool isBinaryFile(QString const &fileName);
+
+	/// Writes given objects to a binary file. Existing file is replaced only when new one is completely written.
+	/// Throws qReal::Exception if file can not be written or objects have properties of unsupported types.
+	static void save(QString const &fileName, QList<Object *> const &objects);
+
+	/// Reads objects from a binary file and adds them to given hash. Missing file is treated as empty one.
+	/// Throws qReal::Exception if file is corrupted.
+	/// @param lazy - if true, only ids, parents and children of objects are read, properties of each object are
+	///        read from mapped file when they are accessed for the first time.
+	static void load(QString const &fileName, QHash<qReal::Id, Object *> &objectsHash, bool lazy = false);
+
+private:
+	/// Creating is prohibited, utility class instances can not be created.
+	BinarySerializer();
+};
+
+}
+}
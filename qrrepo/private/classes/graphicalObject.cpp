@@ -36,6 +36,17 @@ GraphicalObject::GraphicalObject(QDomElement const &element)
 	}
 }
 
+GraphicalObject::GraphicalObject(QXmlStreamReader &reader)
+	: Object(reader)
+{
+	mLogicalId = Id::loadFromString(reader.attributes().value("logicalId").toString());
+	if (mLogicalId.isNull()) {
+		throw Exception("Logical id not found for graphical object");
+	}
+
+	readElements(reader);
+}
+
 GraphicalObject::~GraphicalObject()
 {
 	qDeleteAll(mGraphicalParts.values());
@@ -43,6 +54,7 @@ GraphicalObject::~GraphicalObject()
 
 QDomElement GraphicalObject::serialize(QDomDocument &document) const
 {
+	// Base class serialization materializes graphical parts too.
 	QDomElement result = Object::serialize(document);
 	result.setAttribute("logicalId", mLogicalId.toString());
 
@@ -60,8 +72,50 @@ QDomElement GraphicalObject::serialize(QDomDocument &document) const
 	return result;
 }
 
+void GraphicalObject::writeAttributes(QXmlStreamWriter &writer) const
+{
+	Object::writeAttributes(writer);
+	writer.writeAttribute("logicalId", mLogicalId.toString());
+}
+
+void GraphicalObject::writeElements(QXmlStreamWriter &writer) const
+{
+	writer.writeStartElement("graphicalParts");
+
+	// Parts are written in order of indexes, so output does not depend on hash order.
+	QList<int> indexes = mGraphicalParts.keys();
+	qSort(indexes);
+	foreach (int const index, indexes) {
+		mGraphicalParts[index]->serialize(index, writer);
+	}
+
+	writer.writeEndElement();
+}
+
+bool GraphicalObject::readElement(QXmlStreamReader &reader)
+{
+	if (reader.name() != "graphicalParts") {
+		return false;
+	}
+
+	while (reader.readNextStartElement()) {
+		QString const indexString = reader.attributes().value("index").toString();
+		if (indexString.isEmpty()) {
+			throw Exception("No \"index\" attribute in graphical part");
+		}
+
+		GraphicalPart * const deserializedPart = new GraphicalPart(reader);
+		delete mGraphicalParts.value(indexString.toInt());
+		mGraphicalParts.insert(indexString.toInt(), deserializedPart);
+	}
+
+	return true;
+}
+
 void GraphicalObject::createGraphicalPart(int index)
 {
+	materialize();
+
 	if (mGraphicalParts.contains(index)) {
 		throw Exception("Part with that index already exists");
 	}
@@ -72,11 +126,15 @@ void GraphicalObject::createGraphicalPart(int index)
 
 QList<int> GraphicalObject::graphicalParts() const
 {
+	materialize();
+
 	return mGraphicalParts.keys();
 }
 
 QVariant GraphicalObject::graphicalPartProperty(int index, QString const &name) const
 {
+	materialize();
+
 	if (!mGraphicalParts.contains(index)) {
 		throw Exception("Tryng to get property of non-existing graphical part");
 	}
@@ -86,6 +144,8 @@ QVariant GraphicalObject::graphicalPartProperty(int index, QString const &name)
 
 void GraphicalObject::setGraphicalPartProperty(int index, QString const &name, QVariant const &value)
 {
+	materialize();
+
 	if (!mGraphicalParts.contains(index)) {
 		throw Exception("Tryng to set property of non-existing graphical part");
 	}
@@ -93,8 +153,21 @@ void GraphicalObject::setGraphicalPartProperty(int index, QString const &name, Q
 	mGraphicalParts[index]->setProperty(name, value);
 }
 
+QMap<QString, QVariant> GraphicalObject::graphicalPartProperties(int index) const
+{
+	materialize();
+
+	if (!mGraphicalParts.contains(index)) {
+		throw Exception("Tryng to get properties of non-existing graphical part");
+	}
+
+	return mGraphicalParts[index]->properties();
+}
+
 Object *GraphicalObject::createClone() const
 {
+	materialize();
+
 	GraphicalObject * const clone = new GraphicalObject(mId.sameTypeId(), mParent, mLogicalId);
 
 	for (QHash<int, GraphicalPart *>::const_iterator i = mGraphicalParts.constBegin();
@@ -108,6 +181,20 @@ Object *GraphicalObject::createClone() const
 	return clone;
 }
 
+Object *GraphicalObject::createCopy() const
+{
+	GraphicalObject * const copy = new GraphicalObject(mId, mParent, mLogicalId);
+
+	for (QHash<int, GraphicalPart *>::const_iterator i = mGraphicalParts.constBegin();
+			i != mGraphicalParts.constEnd();
+			++i)
+	{
+		copy->mGraphicalParts.insert(i.key(), i.value()->clone());
+	}
+
+	return copy;
+}
+
 Id GraphicalObject::logicalId() const
 {
 	return mLogicalId;
@@ -23,6 +23,10 @@ public:
 	/// @param element - root of XML DOM subtree with serialized object.
 	explicit GraphicalObject(QDomElement const &element);
 
+	/// Streaming deserializing constructor.
+	/// @param reader - reader positioned on a start of an object element, after the call it is positioned on its end.
+	explicit GraphicalObject(QXmlStreamReader &reader);
+
 	virtual ~GraphicalObject();
 
 	/// Returns id of corresponding logical object.
@@ -33,6 +37,7 @@ public:
 
 	// Override.
 	virtual QDomElement serialize(QDomDocument &document) const;
+	using Object::serialize;
 
 	/// Creates empty graphical part with given index inside this object.
 	void createGraphicalPart(int index);
@@ -52,10 +57,25 @@ public:
 	/// @param value - new value of a property.
 	void setGraphicalPartProperty(int index, QString const &name, QVariant const &value);
 
+	/// Returns all properties of a graphical part with given index.
+	QMap<QString, QVariant> graphicalPartProperties(int index) const;
+
 protected:
 	// Override.
 	virtual Object *createClone() const;
 
+	// Override.
+	virtual Object *createCopy() const;
+
+	// Override.
+	virtual void writeAttributes(QXmlStreamWriter &writer) const;
+
+	// Override.
+	virtual void writeElements(QXmlStreamWriter &writer) const;
+
+	// Override.
+	virtual bool readElement(QXmlStreamReader &reader);
+
 private:
 	/// Id of logical object corresponding to this graphical object.
 	qReal::Id mLogicalId;
@@ -15,6 +15,11 @@ GraphicalPart::GraphicalPart(QDomElement const &element)
 	ValuesSerializer::deserializeNamedVariantsMap(mProperties, element);
 }
 
+GraphicalPart::GraphicalPart(QXmlStreamReader &reader)
+{
+	ValuesSerializer::deserializeNamedVariantsMap(mProperties, reader);
+}
+
 QVariant GraphicalPart::property(QString const &name) const
 {
 	if (!mProperties.contains(name)) {
@@ -29,6 +34,11 @@ void GraphicalPart::setProperty(QString const &name, const QVariant &value)
 	mProperties.insert(name, value);
 }
 
+QMap<QString, QVariant> GraphicalPart::properties() const
+{
+	return mProperties;
+}
+
 GraphicalPart *GraphicalPart::clone() const
 {
 	GraphicalPart * const result = new GraphicalPart();
@@ -42,3 +52,11 @@ QDomElement GraphicalPart::serialize(int index, QDomDocument &document) const
 	result.setAttribute("index", index);
 	return result;
 }
+
+void GraphicalPart::serialize(int index, QXmlStreamWriter &writer) const
+{
+	writer.writeStartElement("graphicalPart");
+	writer.writeAttribute("index", QString::number(index));
+	ValuesSerializer::serializeNamedVariants(mProperties, writer);
+	writer.writeEndElement();
+}
@@ -2,6 +2,8 @@
 
 #include <QtCore/QVariant>
 #include <QtCore/QString>
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QXmlStreamWriter>
 #include <QtXml/QDomDocument>
 #include <QtXml/QDomElement>
 
@@ -19,6 +21,11 @@ public:
 	/// @param element - root of XML DOM subtree with serialized graphical part.
 	explicit GraphicalPart(QDomElement const &element);
 
+	/// Streaming deserializing constructor.
+	/// @param reader - reader positioned on a start of graphical part element, after the call it is positioned
+	///        on its end.
+	explicit GraphicalPart(QXmlStreamReader &reader);
+
 	/// Returns value of a property with given name or throws an exception if there is no such property in this part.
 	QVariant property(QString const &name) const;
 
@@ -26,6 +33,9 @@ public:
 	/// otherwise new property will be created with given value.
 	void setProperty(QString const &name, const QVariant &value);
 
+	/// Returns all properties of this part.
+	QMap<QString, QVariant> properties() const;
+
 	/// Creates deep copy of object.
 	GraphicalPart *clone() const;
 
@@ -34,6 +44,11 @@ public:
 	/// @param document - document to which will belong created subtree.
 	QDomElement serialize(int index, QDomDocument &document) const;
 
+	/// Writes contents of an object as XML element, the same as serialize() to DOM does.
+	/// @param index - index of a part in its parent graphical object.
+	/// @param writer - writer to write element to.
+	void serialize(int index, QXmlStreamWriter &writer) const;
+
 private:
 	/// A list of properties in a form of pairs (name, value).
 	QMap<QString, QVariant> mProperties;
@@ -12,11 +12,22 @@ LogicalObject::LogicalObject(QDomElement const &element)
 {
 }
 
+LogicalObject::LogicalObject(QXmlStreamReader &reader)
+	: Object(reader)
+{
+	readElements(reader);
+}
+
 Object *LogicalObject::createClone() const
 {
 	return new LogicalObject(mId.sameTypeId());
 }
 
+Object *LogicalObject::createCopy() const
+{
+	return new LogicalObject(mId);
+}
+
 bool LogicalObject::isLogicalObject() const
 {
 	return true;
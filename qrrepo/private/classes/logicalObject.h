@@ -17,6 +17,10 @@ public:
 	/// @param element - root of XML DOM subtree with serialized object.
 	explicit LogicalObject(QDomElement const &element);
 
+	/// Streaming deserializing constructor.
+	/// @param reader - reader positioned on a start of an object element, after the call it is positioned on its end.
+	explicit LogicalObject(QXmlStreamReader &reader);
+
 	// Override.
 	virtual bool isLogicalObject() const;
 
@@ -24,6 +28,9 @@ protected:
 	// Override.
 	virtual Object *createClone() const;
 
+	// Override.
+	virtual Object *createCopy() const;
+
 };
 
 }
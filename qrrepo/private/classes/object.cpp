@@ -1,6 +1,7 @@
 #include "object.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QMutex>
 
 #include "../../../qrkernel/exception/exception.h"
 #include "../../../qrkernel/ids.h"
@@ -11,13 +12,27 @@
 using namespace qrRepo::details;
 using namespace qReal;
 
+namespace {
+
+/// Serializes materialization of lazily loaded objects. Recursive, because lazy source fills an object using its
+/// setters, which call materialize() again.
+QMutex &materializationMutex()
+{
+	static QMutex mutex(QMutex::Recursive);
+	return mutex;
+}
+
+}
+
 Object::Object(const Id &id)
 	: mId(id)
+	, mLazyPosition(0)
 {
 }
 
 Object::Object(QDomElement const &element)
 	: mId(Id::loadFromString(element.attribute("id", "")))
+	, mLazyPosition(0)
 {
 	if (mId.isNull()) {
 		throw Exception("Id deserialization failed");
@@ -38,12 +53,25 @@ Object::Object(QDomElement const &element)
 	ValuesSerializer::deserializeNamedVariantsMap(mProperties, properties);
 }
 
+Object::Object(QXmlStreamReader &reader)
+	: mId(Id::loadFromString(reader.attributes().value("id").toString()))
+	, mLazyPosition(0)
+{
+	if (mId.isNull()) {
+		throw Exception("Id deserialization failed");
+	}
+
+	mParent = ValuesSerializer::deserializeId(reader.attributes().value("parent").toString());
+}
+
 Object::~Object()
 {
 }
 
 void Object::replaceProperties(QString const value, QString const &newValue)
 {
+	materialize();
+
 	foreach (QVariant const &val, mProperties.values()) {
 		if (val.toString().contains(value)) {
 			mProperties[mProperties.key(val)] = newValue;
@@ -53,6 +81,8 @@ void Object::replaceProperties(QString const value, QString const &newValue)
 
 Object *Object::clone(QHash<Id, Object*> &objHash) const
 {
+	materialize();
+
 	Object * const result = createClone();
 	objHash.insert(result->id(), result);
 
@@ -70,6 +100,18 @@ Object *Object::clone(QHash<Id, Object*> &objHash) const
 	return result;
 }
 
+Object *Object::copy() const
+{
+	materialize();
+
+	Object * const result = createCopy();
+	result->mParent = mParent;
+	result->mChildren = mChildren;
+	result->mProperties = mProperties;
+	result->mTemporaryRemovedLinks = mTemporaryRemovedLinks;
+	return result;
+}
+
 void Object::setParent(const Id &parent)
 {
 	mParent = parent;
@@ -95,6 +137,9 @@ void Object::removeChild(const Id &child)
 
 void Object::copyPropertiesFrom(const Object &src)
 {
+	materialize();
+	src.materialize();
+
 	mProperties = src.mProperties;
 }
 
@@ -134,16 +179,22 @@ void Object::setProperty(QString const &name, const QVariant &value)
 		Q_ASSERT(!"Empty QVariant set as a property");
 	}
 
+	materialize();
+
 	mProperties.insert(name,value);
 }
 
 void Object::setProperties(QMap<QString, QVariant> const &properties)
 {
+	materialize();
+
 	mProperties = properties;
 }
 
 QVariant Object::property(QString const &name) const
 {
+	materialize();
+
 	if (mProperties.contains(name)) {
 		return mProperties[name];
 	} else if (name == "backReferences") {
@@ -156,6 +207,8 @@ QVariant Object::property(QString const &name) const
 
 void Object::setBackReference(qReal::Id const &reference)
 {
+	materialize();
+
 	IdList references = mProperties["backReferences"].value<IdList>();
 	references << reference;
 	mProperties.insert("backReferences", qReal::IdListHelper::toVariant(references));
@@ -163,6 +216,8 @@ void Object::setBackReference(qReal::Id const &reference)
 
 void Object::removeBackReference(qReal::Id const &reference)
 {
+	materialize();
+
 	if (!mProperties.contains("backReferences")) {
 		throw Exception("Object " + mId.toString() + ": removing nonexsistent reference " + reference.toString());
 	}
@@ -194,6 +249,7 @@ IdList Object::temporaryRemovedLinks() const
 void Object::removeTemporaryRemovedLinksAt(QString const &direction)
 {
 	if (mTemporaryRemovedLinks.contains(direction)) {
+		materialize();
 		mProperties.remove(direction);
 	}
 }
@@ -207,6 +263,8 @@ void Object::removeTemporaryRemovedLinks()
 
 bool Object::hasProperty(QString const &name, bool sensitivity, bool regExpression) const
 {
+	materialize();
+
 	QStringList properties = mProperties.keys();
 	Qt::CaseSensitivity caseSensitivity;
 
@@ -227,6 +285,8 @@ bool Object::hasProperty(QString const &name, bool sensitivity, bool regExpressi
 
 void Object::removeProperty(QString const &name)
 {
+	materialize();
+
 	if (mProperties.contains(name)) {
 		mProperties.remove(name);
 	} else {
@@ -241,16 +301,22 @@ Id Object::id() const
 
 QMapIterator<QString, QVariant> Object::propertiesIterator() const
 {
+	materialize();
+
 	return QMapIterator<QString, QVariant>(mProperties);
 }
 
 QMap<QString, QVariant> Object::properties() const
 {
+	materialize();
+
 	return mProperties;
 }
 
 QDomElement Object::serialize(QDomDocument &document) const
 {
+	materialize();
+
 	QDomElement result = document.createElement("object");
 	result.setAttribute("id", id().toString());
 	result.setAttribute("parent", parent().toString());
@@ -258,3 +324,89 @@ QDomElement Object::serialize(QDomDocument &document) const
 	result.appendChild(ValuesSerializer::serializeNamedVariantsMap("properties", mProperties, document));
 	return result;
 }
+
+void Object::serialize(QXmlStreamWriter &writer) const
+{
+	materialize();
+
+	writer.writeStartElement("object");
+	writeAttributes(writer);
+	ValuesSerializer::serializeIdList("children", children(), writer);
+	writer.writeStartElement("properties");
+	ValuesSerializer::serializeNamedVariants(mProperties, writer);
+	writer.writeEndElement();
+	writeElements(writer);
+	writer.writeEndElement();
+}
+
+void Object::writeAttributes(QXmlStreamWriter &writer) const
+{
+	writer.writeAttribute("id", id().toString());
+	writer.writeAttribute("parent", parent().toString());
+}
+
+void Object::writeElements(QXmlStreamWriter &writer) const
+{
+	Q_UNUSED(writer)
+}
+
+bool Object::readElement(QXmlStreamReader &reader)
+{
+	Q_UNUSED(reader)
+	return false;
+}
+
+void Object::readElements(QXmlStreamReader &reader)
+{
+	int propertiesCount = 0;
+	while (reader.readNextStartElement()) {
+		if (reader.name() == "children") {
+			mChildren.append(ValuesSerializer::deserializeIdList(reader));
+		} else if (reader.name() == "properties") {
+			++propertiesCount;
+			ValuesSerializer::deserializeNamedVariantsMap(mProperties, reader);
+		} else if (!readElement(reader)) {
+			reader.skipCurrentElement();
+		}
+	}
+
+	if (reader.hasError()) {
+		throw Exception("Incorrect element: " + reader.errorString());
+	}
+
+	if (propertiesCount != 1) {
+		throw Exception("Incorrect element: properties list must appear once");
+	}
+}
+
+void Object::setLazyPropertiesSource(QSharedPointer<LazyPropertiesSource> const &source, quint64 position)
+{
+	mLazySource = source;
+	mLazyPosition = position;
+	mLazy.storeRelease(source.isNull() ? 0 : 1);
+}
+
+bool Object::isMaterialized() const
+{
+	return mLazy.loadAcquire() == 0;
+}
+
+void Object::materialize() const
+{
+	if (mLazy.loadAcquire() == 0) {
+		return;
+	}
+
+	QMutexLocker const locker(&materializationMutex());
+	if (mLazySource.isNull()) {
+		return;
+	}
+
+	// Source is detached first, so setters called by it do not try to materialize the object again.
+	QSharedPointer<LazyPropertiesSource> const source = mLazySource;
+	mLazySource.clear();
+
+	// Reading properties does not change the logical state of an object, so it is allowed for const objects.
+	source->materialize(*const_cast<Object *>(this), mLazyPosition);
+	mLazy.storeRelease(0);
+}
@@ -2,15 +2,31 @@
 
 #include "../../../qrkernel/ids.h"
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QMap>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QVariant>
 #include <QtCore/QString>
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QXmlStreamWriter>
 #include <QtXml/QDomDocument>
 #include <QtXml/QDomElement>
 
 namespace qrRepo {
 namespace details {
 
+class Object;
+
+/// Persistent storage from which properties of lazily loaded objects are read on first access.
+class LazyPropertiesSource
+{
+public:
+	virtual ~LazyPropertiesSource() {}
+
+	/// Reads properties of given object stored at given position and sets them to the object.
+	virtual void materialize(Object &object, quint64 position) = 0;
+};
+
 /// Abstract class, general object in repository. Has id, parent, children and properties, able to
 /// serialize/deserialize and clone itself.
 class Object
@@ -24,6 +40,11 @@ public:
 	/// @param element - root of XML DOM subtree with serialized object.
 	explicit Object(QDomElement const &element);
 
+	/// Streaming deserializing constructor, reads only attributes of an object element, derived classes shall
+	/// read the rest by readElements().
+	/// @param reader - reader positioned on a start of an object element.
+	explicit Object(QXmlStreamReader &reader);
+
 	virtual ~Object();
 
 	/// Replacing property values that contains input value with new value.
@@ -36,10 +57,18 @@ public:
 	///        about children and to add clone (and clones of all children).
 	Object *clone(QHash<qReal::Id, Object *> &objHash) const;
 
+	/// Creates a copy of this object with the same id, parent, children and properties. Used to preserve
+	/// the state of an object for repository snapshots.
+	Object *copy() const;
+
 	/// Serializes contents of an object to XML DOM subtree.
 	/// @param document - document to which will belong created subtree.
 	virtual QDomElement serialize(QDomDocument &document) const;
 
+	/// Writes contents of an object as XML element, the same as serialize() to DOM does, but without building
+	/// a tree in memory.
+	void serialize(QXmlStreamWriter &writer) const;
+
 	void setParent(qReal::Id const &parent);
 	void addChild(qReal::Id const &child);
 	void removeChild(qReal::Id const &child);
@@ -72,15 +101,52 @@ public:
 	/// Returns true, if it is logical object, false, if graphical.
 	virtual bool isLogicalObject() const = 0;
 
+	/// Makes this object to read its properties from given source when they are accessed for the first time.
+	/// @param position - position of object properties in a source.
+	void setLazyPropertiesSource(QSharedPointer<LazyPropertiesSource> const &source, quint64 position);
+
+	/// Returns true if properties of this object are loaded in memory.
+	bool isMaterialized() const;
+
 protected:
 	/// Implemented in derived classes to create a clone and init it with specific fields.
 	virtual Object *createClone() const = 0;
 
+	/// Implemented in derived classes to create an object with the same id and specific fields.
+	virtual Object *createCopy() const = 0;
+
+	/// Writes attributes of an object element. Derived classes may add their own attributes.
+	virtual void writeAttributes(QXmlStreamWriter &writer) const;
+
+	/// Writes child elements of an object element after children and properties. Does nothing by default.
+	virtual void writeElements(QXmlStreamWriter &writer) const;
+
+	/// Reads child element of an object element that is not known to base class.
+	/// @param reader - reader positioned on a start of an element, shall be left on its end.
+	/// @returns false if element is unknown and shall be skipped.
+	virtual bool readElement(QXmlStreamReader &reader);
+
+	/// Reads children, properties and other child elements of an object element, shall be called by streaming
+	/// deserializing constructors of derived classes. Throws qReal::Exception if XML is incorrect.
+	void readElements(QXmlStreamReader &reader);
+
+	/// Reads properties from lazy properties source if they are not loaded yet. Shall be called before any
+	/// access to properties or other data that is read together with them. Thread-safe, so snapshot readers
+	/// may access objects that were not materialized yet.
+	void materialize() const;
+
 	const qReal::Id mId;
 	qReal::Id mParent;
 	qReal::IdList mChildren;
 	QMap<QString, QVariant> mProperties;
 	QMap<QString, qReal::IdList> mTemporaryRemovedLinks;
+
+	/// Source of not yet loaded properties, null if properties are already in memory.
+	mutable QSharedPointer<LazyPropertiesSource> mLazySource;
+	quint64 mLazyPosition;
+
+	/// Non-zero while properties are not loaded, checked without locking before materialization.
+	mutable QAtomicInt mLazy;
 };
 
 }
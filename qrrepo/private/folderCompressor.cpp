@@ -1,5 +1,7 @@
 #include "folderCompressor.h"
 
+#include <QtConcurrent/QtConcurrentMap>
+
 bool FolderCompressor::compressFolder(QString const &sourceFolder, QString const &destinationFile)
 {
 	if (!QDir(sourceFolder).exists()) {
@@ -106,3 +108,151 @@ bool FolderCompressor::decompressFolder(QString const &sourceFile, QString const
 	return true;
 }
 
+
+bool FolderCompressor::writeArchive(QString const &destinationFile, QMap<QString, QByteArray> const &entries)
+{
+	// QMap::values() is ordered by keys and blockingMapped() keeps order, so output is deterministic.
+	QList<QByteArray> const compressed = QtConcurrent::blockingMapped(entries.values(), compressData);
+
+	QString const partFileName = destinationFile + ".part";
+	QFile file(partFileName);
+	if (!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+
+	QDataStream dataStream(&file);
+	int index = 0;
+	for (QMap<QString, QByteArray>::const_iterator i = entries.constBegin(); i != entries.constEnd(); ++i, ++index) {
+		dataStream << i.key() << compressed[index];
+	}
+
+	file.close();
+
+	if (dataStream.status() != QDataStream::Ok || file.error() != QFile::NoError
+			|| (QFile::exists(destinationFile) && !QFile::remove(destinationFile)))
+	{
+		QFile::remove(partFileName);
+		return false;
+	}
+
+	return QFile::rename(partFileName, destinationFile);
+}
+
+bool FolderCompressor::readArchive(QString const &sourceFile, QList<QPair<QString, QByteArray> > &entries)
+{
+	QFile file(sourceFile);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+
+	QDataStream dataStream(&file);
+
+	QStringList names;
+	QList<QByteArray> compressed;
+	while (!dataStream.atEnd()) {
+		QString fileName;
+		QByteArray data;
+
+		dataStream >> fileName >> data;
+		if (dataStream.status() != QDataStream::Ok) {
+			return false;
+		}
+
+		names << fileName;
+		compressed << data;
+	}
+
+	file.close();
+
+	QList<QByteArray> const uncompressed = QtConcurrent::blockingMapped(compressed, uncompressData);
+	for (int i = 0; i < names.size(); ++i) {
+		entries << qMakePair(names[i], uncompressed[i]);
+	}
+
+	return true;
+}
+
+bool FolderCompressor::updateArchive(QString const &archiveFile
+		, QMap<QString, QByteArray> const &changedEntries
+		, QSet<QString> const &removedEntries
+		, qint64 &bytesWritten)
+{
+	bytesWritten = 0;
+
+	QFile source(archiveFile);
+	if (!source.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+
+	QString const updatedFileName = archiveFile + ".part";
+	QFile updated(updatedFileName);
+	if (!updated.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+
+	QDataStream in(&source);
+	QDataStream out(&updated);
+
+	QList<QByteArray> const compressedList = QtConcurrent::blockingMapped(changedEntries.values(), compressData);
+	QMap<QString, QByteArray> compressedEntries;
+	int index = 0;
+	foreach (QString const &name, changedEntries.keys()) {
+		compressedEntries.insert(name, compressedList[index++]);
+	}
+
+	QSet<QString> written;
+	while (!in.atEnd()) {
+		QString fileName;
+		QByteArray data;
+
+		// Data is kept compressed, unchanged entries are copied as is.
+		in >> fileName >> data;
+		if (in.status() != QDataStream::Ok) {
+			updated.close();
+			QFile::remove(updatedFileName);
+			return false;
+		}
+
+		if (removedEntries.contains(fileName) || written.contains(fileName)) {
+			continue;
+		}
+
+		if (compressedEntries.contains(fileName)) {
+			data = compressedEntries[fileName];
+			bytesWritten += data.size();
+		}
+
+		out << fileName << data;
+		written.insert(fileName);
+	}
+
+	for (QMap<QString, QByteArray>::const_iterator i = compressedEntries.constBegin()
+			; i != compressedEntries.constEnd()
+			; ++i)
+	{
+		if (!written.contains(i.key())) {
+			bytesWritten += i.value().size();
+			out << i.key() << i.value();
+		}
+	}
+
+	source.close();
+	updated.close();
+
+	if (out.status() != QDataStream::Ok || !QFile::remove(archiveFile)) {
+		QFile::remove(updatedFileName);
+		return false;
+	}
+
+	return QFile::rename(updatedFileName, archiveFile);
+}
+
+QByteArray FolderCompressor::compressData(QByteArray const &data)
+{
+	return qCompress(data);
+}
+
+QByteArray FolderCompressor::uncompressData(QByteArray const &data)
+{
+	return qUncompress(data);
+}
@@ -2,6 +2,9 @@
 
 #include <QtCore/QFile>
 #include <QtCore/QDir>
+#include <QtCore/QMap>
+#include <QtCore/QSet>
+#include <QtCore/QPair>
 
 /// Utility to compress and decompress folder uzing qCompress function.
 class FolderCompressor {
@@ -17,11 +20,45 @@ public:
 	/// @returns true if operation was successful.
 	static bool decompressFolder(QString const &sourceFile, QString const &destinationFolder);
 
+	/// Writes given entries into a single compressed file in the same format as compressFolder() does, without
+	/// creating files for them. Entries are compressed in parallel on global thread pool and written in order of
+	/// their names, so the result does not depend on the number of threads. Existing file is replaced only when
+	/// new one is completely written.
+	/// @param destinationFile - file to write.
+	/// @param entries - map from entry name (path starting with '/') to uncompressed contents.
+	/// @returns true if operation was successful.
+	static bool writeArchive(QString const &destinationFile, QMap<QString, QByteArray> const &entries);
+
+	/// Reads all entries of a compressed file, decompressing them in parallel on global thread pool.
+	/// @param sourceFile - file created by compressFolder(), writeArchive() or updateArchive().
+	/// @param entries - will contain entry names and uncompressed contents in order they are stored in file.
+	/// @returns true if operation was successful.
+	static bool readArchive(QString const &sourceFile, QList<QPair<QString, QByteArray> > &entries);
+
+	/// Rewrites given entries of already compressed file without touching other entries: they are copied
+	/// in compressed form, so only changed data is compressed again.
+	/// @param archiveFile - file previously created by compressFolder().
+	/// @param changedEntries - map from entry name (path relative to compressed folder, starting with '/')
+	///        to uncompressed new contents. Entries that were not present in archive are appended to it.
+	/// @param removedEntries - names of entries that shall be dropped from archive.
+	/// @param bytesWritten - will contain the size of compressed data written for changed entries.
+	/// @returns true if operation was successful.
+	static bool updateArchive(QString const &archiveFile
+			, QMap<QString, QByteArray> const &changedEntries
+			, QSet<QString> const &removedEntries
+			, qint64 &bytesWritten);
+
 private:
 	/// Creating is prohibited, utility class instances can not be created.
 	FolderCompressor();
 
 	static bool compress(QString const &sourceFolder, QString const &prefix, QDataStream &dataStream);
+
+	/// Compresses given data with default compression level, suitable for QtConcurrent algorithms.
+	static QByteArray compressData(QByteArray const &data);
+
+	/// Decompresses given data, suitable for QtConcurrent algorithms.
+	static QByteArray uncompressData(QByteArray const &data);
 };
 
 
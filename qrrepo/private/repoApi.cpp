@@ -419,14 +419,14 @@ QString RepoApi::workingFile() const
 	return mRepository.workingFile();
 }
 
+SaveStatistics RepoApi::lastSaveStatistics() const
+{
+	return mRepository.lastSaveStatistics();
+}
+
 IdList RepoApi::graphicalElements() const
 {
-	IdList result;
-	foreach (Id const &id, mRepository.elements()) {
-		if (!mRepository.isLogicalId(id))
-			result.append(id);
-	}
-	return result;
+	return mRepository.graphicalElements();
 }
 
 void RepoApi::addToIdList(Id const &target, QString const &listName, Id const &data, QString const &direction)
@@ -479,48 +479,19 @@ IdList RepoApi::logicalElements(Id const &type) const
 {
 	Q_ASSERT(type.idSize() == 3);
 
-	IdList result;
-	foreach (Id id, mRepository.elements()) {
-		if (id.element() == type.element() && mRepository.isLogicalId(id))
-			result.append(id);
-	}
-	return result;
+	return mRepository.logicalElements(type);
 }
 
 IdList RepoApi::graphicalElements(Id const &type) const
 {
 	Q_ASSERT(type.idSize() == 3);
 
-	IdList result;
-	foreach (Id id, mRepository.elements()) {
-		if (id.element() == type.element() && !mRepository.isLogicalId(id))
-			result.append(id);
-	}
-	return result;
+	return mRepository.graphicalElements(type);
 }
 
 IdList RepoApi::elementsByType(QString const &type, bool sensitivity, bool regExpression) const
 {
-	Qt::CaseSensitivity const caseSensitivity = sensitivity ? Qt::CaseSensitive : Qt::CaseInsensitive;
-
-	QRegExp *regExp = new QRegExp(type,caseSensitivity);
-
-	IdList result;
-
-	if (regExpression) {
-		foreach (Id const &id, mRepository.elements()) {
-			if (id.element().contains(*regExp)) {
-				result.append(id);
-			}
-		}
-	} else {
-		foreach (Id const &id, mRepository.elements()) {
-			if (id.element().contains(type, caseSensitivity)) {
-				result.append(id);
-			}
-		}
-	}
-	return result;
+	return mRepository.elementsByType(type, sensitivity, regExpression);
 }
 
 qReal::IdList RepoApi::elementsByProperty(QString const &property, bool sensitivity, bool regExpression) const
@@ -533,6 +504,21 @@ int RepoApi::elementsCount() const
 	return mRepository.elements().size();
 }
 
+int RepoApi::residentElementsCount() const
+{
+	return mRepository.residentObjectsCount();
+}
+
+void RepoApi::setJournalEnabled(bool enabled)
+{
+	mRepository.setJournalEnabled(enabled);
+}
+
+QSharedPointer<details::RepositorySnapshot> RepoApi::snapshot() const
+{
+	return QSharedPointer<details::RepositorySnapshot>(mRepository.createSnapshot());
+}
+
 bool RepoApi::exist(Id const &id) const
 {
 	return mRepository.exist(id);
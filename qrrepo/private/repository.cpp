@@ -3,6 +3,7 @@
 #include <QtCore/QDebug>
 
 #include "../../qrkernel/exception/exception.h"
+#include "../../qrkernel/settingsManager.h"
 #include "singleXmlSerializer.h"
 
 using namespace qReal;
@@ -12,9 +13,19 @@ using namespace qrRepo::details;
 Repository::Repository(QString const &workingFile)
 		: mWorkingFile(workingFile)
 		, mSerializer(workingFile)
+		, mIndex(mObjects)
+		, mGeneration(0)
+		, mLock(new QReadWriteLock(QReadWriteLock::Recursive))
+		, mJournalEnabled(false)
+		, mJournalCompactionThreshold(0)
+		, mModificationDepth(0)
 {
 	init();
 	loadFromDisk();
+	resetChanges();
+	if (!mWorkingFile.isEmpty()) {
+		markSaved(mSerializer.targetFile());
+	}
 }
 
 
@@ -22,12 +33,27 @@ void Repository::init()
 {
 	mObjects.insert(Id::rootId(), new LogicalObject(Id::rootId()));
 	mObjects[Id::rootId()]->setProperty("name", Id::rootId().toString());
+	mIndex.rebuild();
 }
 
 Repository::~Repository()
 {
 	mSerializer.clearWorkingDir();
 
+	// Repository is closed normally, so unsaved changes are discarded, the journal is needed only after a crash.
+	mJournal.discard();
+
+	{
+		// Snapshots get copies of everything they share with the repository and continue on their own.
+		QWriteLocker const locker(mLock.data());
+		preserveAll();
+		foreach (RepositorySnapshot * const snapshot, mSnapshots) {
+			snapshot->mRepository = NULL;
+		}
+
+		mSnapshots.clear();
+	}
+
 	foreach (Id id, mObjects.keys()) {
 		delete mObjects[id];
 	}
@@ -35,79 +61,31 @@ Repository::~Repository()
 
 IdList Repository::findElementsByName(QString const &name, bool sensitivity, bool regExpression) const
 {
-	Qt::CaseSensitivity const caseSensitivity = sensitivity ? Qt::CaseSensitive : Qt::CaseInsensitive;
-
-	QRegExp const regExp(name, caseSensitivity);
-	IdList result;
-
-	if (regExpression){
-		foreach (Object * const element, mObjects.values()) {
-			if (element->property("name").toString().contains(regExp)
-					&& !isLogicalId(mObjects.key(element))) {
-				result.append(mObjects.key(element));
-			}
-		}
-	} else {
-		foreach (Object * const element, mObjects.values()) {
-			if (element->property("name").toString().contains(name, caseSensitivity)
-					&& !isLogicalId(mObjects.key(element))) {
-				result.append(mObjects.key(element));
-			}
-		}
-	}
-
-	return result;
+	QReadLocker const locker(mLock.data());
+	return mIndex.findElementsByName(name, sensitivity, regExpression);
 }
 
 qReal::IdList Repository::elementsByProperty(QString const &property, bool sensitivity
 		, bool regExpression) const
 {
-	IdList result;
-
-	foreach (Object *element, mObjects.values()) {
-		if ((element->hasProperty(property, sensitivity, regExpression))
-				&& (!isLogicalId(mObjects.key(element)))) {
-			result.append(mObjects.key(element));
-		}
-	}
-
-	return result;
+	QReadLocker const locker(mLock.data());
+	return mIndex.elementsByProperty(property, sensitivity, regExpression);
 }
 
 qReal::IdList Repository::elementsByPropertyContent(QString const &propertyValue, bool sensitivity
 		, bool regExpression) const
 {
-	Qt::CaseSensitivity const caseSensitivity = sensitivity ? Qt::CaseSensitive : Qt::CaseInsensitive;
-
-	QRegExp const regExp(propertyValue, caseSensitivity);
-	IdList result;
-
-	foreach (Object * const element, mObjects.values()) {
-		QMapIterator<QString, QVariant> iterator = element->propertiesIterator();
-		if (regExpression) {
-			while (iterator.hasNext()) {
-				if (iterator.next().value().toString().contains(regExp)) {
-					result.append(mObjects.key(element));
-					break;
-				}
-			}
-		} else {
-			while (iterator.hasNext()) {
-				if (iterator.next().value().toString().contains(propertyValue, caseSensitivity)) {
-					result.append(mObjects.key(element));
-					break;
-				}
-			}
-		}
-	}
-
-	return result;
+	QReadLocker const locker(mLock.data());
+	return mIndex.elementsByPropertyContent(propertyValue, sensitivity, regExpression);
 }
 
 void Repository::replaceProperties(qReal::IdList const &toReplace, QString const value, QString const newValue)
 {
+	Modification const modification(*this);
 	foreach (qReal::Id const &currentId, toReplace) {
+		preserve(currentId);
 		mObjects[currentId]->replaceProperties(value, newValue);
+		markChanged(currentId);
 	}
 }
 
@@ -131,7 +109,14 @@ Id Repository::parent(Id const &id) const
 
 Id Repository::cloneObject(qReal::Id const &id)
 {
+	Modification const modification(*this);
 	Object const * const result = mObjects[id]->clone(mObjects);
+	IdList const clonedIds = idsOfAllChildrenOf(result->id());
+	preserveCreated(clonedIds);
+	foreach (Id const &clonedId, clonedIds) {
+		markChanged(clonedId);
+	}
+
 	return result->id();
 }
 
@@ -139,9 +124,14 @@ void Repository::setParent(Id const &id, Id const &parent)
 {
 	if (mObjects.contains(id)) {
 		if (mObjects.contains(parent)) {
+			Modification const modification(*this);
+			preserve(id);
+			preserve(parent);
 			mObjects[id]->setParent(parent);
 			if (!mObjects[parent]->children().contains(id))
 				mObjects[parent]->addChild(id);
+			markChanged(id);
+			markChanged(parent);
 		} else {
 			throw Exception("Repository: Adding nonexistent parent " + parent.toString() + " to  object " + id.toString());
 		}
@@ -158,6 +148,9 @@ void Repository::addChild(const Id &id, const Id &child)
 void Repository::addChild(const Id &id, const Id &child, Id const &logicalId)
 {
 	if (mObjects.contains(id)) {
+		Modification const modification(*this);
+		preserve(id);
+		preserve(child);
 		if (!mObjects[id]->children().contains(child))
 			mObjects[id]->addChild(child);
 
@@ -173,6 +166,9 @@ void Repository::addChild(const Id &id, const Id &child, Id const &logicalId)
 
 			mObjects.insert(child, object);
 		}
+
+		markChanged(id);
+		markChanged(child);
 	} else {
 		throw Exception("Repository: Adding child " + child.toString() + " to nonexistent object " + id.toString());
 	}
@@ -191,7 +187,10 @@ void Repository::stackBefore(qReal::Id const &id, qReal::Id const &child, qReal:
 		throw Exception("Repository: Stacking before nonexistent child " + sibling.toString());
 	}
 
+	Modification const modification(*this);
+	preserve(id);
 	mObjects[id]->stackBefore(child, sibling);
+	markChanged(id);
 }
 
 void Repository::removeParent(const Id &id)
@@ -199,8 +198,13 @@ void Repository::removeParent(const Id &id)
 	if (mObjects.contains(id)) {
 		Id const parent = mObjects[id]->parent();
 		if (mObjects.contains(parent)) {
+			Modification const modification(*this);
+			preserve(id);
+			preserve(parent);
 			mObjects[id]->setParent(Id());
 			mObjects[parent]->removeChild(id);
+			markChanged(id);
+			markChanged(parent);
 		} else {
 			throw Exception("Repository: Removing nonexistent parent " + parent.toString() + " from object " + id.toString());
 		}
@@ -213,7 +217,10 @@ void Repository::removeChild(const Id &id, const Id &child)
 {
 	if (mObjects.contains(id)) {
 		if (mObjects.contains(child)) {
+			Modification const modification(*this);
+			preserve(id);
 			mObjects[id]->removeChild(child);
+			markChanged(id);
 		} else {
 			throw Exception("Repository: removing nonexistent child " + child.toString() + " from object " + id.toString());
 		}
@@ -229,7 +236,10 @@ void Repository::setProperty(const Id &id, QString const &name, const QVariant &
 //		Q_ASSERT(mObjects[id]->hasProperty(name)
 //				 ? mObjects[id]->property(name).userType() == value.userType()
 //				 : true);
+		Modification const modification(*this);
+		preserve(id);
 		mObjects[id]->setProperty(name, value);
+		markPropertyChanged(id, name, value);
 	} else {
 		throw Exception("Repository: Setting property of nonexistent object " + id.toString());
 	}
@@ -237,7 +247,10 @@ void Repository::setProperty(const Id &id, QString const &name, const QVariant &
 
 void Repository::copyProperties(const Id &dest, const Id &src)
 {
+	Modification const modification(*this);
+	preserve(dest);
 	mObjects[dest]->copyPropertiesFrom(*mObjects[src]);
+	markChanged(dest);
 }
 
 QMap<QString, QVariant> Repository::properties(Id const &id)
@@ -247,7 +260,10 @@ QMap<QString, QVariant> Repository::properties(Id const &id)
 
 void Repository::setProperties(Id const &id, QMap<QString, QVariant> const &properties)
 {
+	Modification const modification(*this);
+	preserve(id);
 	mObjects[id]->setProperties(properties);
+	markChanged(id);
 }
 
 QVariant Repository::property( const Id &id, QString const &name ) const
@@ -262,7 +278,10 @@ QVariant Repository::property( const Id &id, QString const &name ) const
 void Repository::removeProperty( const Id &id, QString const &name )
 {
 	if (mObjects.contains(id)) {
-		return mObjects[id]->removeProperty(name);
+		Modification const modification(*this);
+		preserve(id);
+		mObjects[id]->removeProperty(name);
+		markPropertyChanged(id, name, QVariant());
 	} else {
 		throw Exception("Repository: Removing property of nonexistent object " + id.toString());
 	}
@@ -281,7 +300,10 @@ void Repository::setBackReference(Id const &id, Id const &reference) const
 {
 	if (mObjects.contains(id)) {
 		if (mObjects.contains(reference)) {
+			Modification const modification(*this);
+			preserve(id);
 			mObjects[id]->setBackReference(reference);
+			markChanged(id);
 		} else {
 			throw Exception("Repository: setting nonexistent back reference " + reference.toString()
 							+ " to object " + id.toString());
@@ -295,7 +317,10 @@ void Repository::removeBackReference(Id const &id, Id const &reference) const
 {
 	if (mObjects.contains(id)) {
 		if (mObjects.contains(reference)) {
+			Modification const modification(*this);
+			preserve(id);
 			mObjects[id]->removeBackReference(reference);
+			markChanged(id);
 		} else {
 			throw Exception("Repository: removing nonexistent back reference " + reference.toString()
 							+ " of object " + id.toString());
@@ -308,7 +333,10 @@ void Repository::removeBackReference(Id const &id, Id const &reference) const
 void Repository::setTemporaryRemovedLinks(Id const &id, QString const &direction, qReal::IdList const &linkIdList)
 {
 	if (mObjects.contains(id)) {
+		Modification const modification(*this);
+		preserve(id);
 		mObjects[id]->setTemporaryRemovedLinks(direction, linkIdList);
+		markChanged(id);
 	} else {
 		throw Exception("Repository: Setting temporaryRemovedLinks of nonexistent object " + id.toString());
 	}
@@ -335,7 +363,10 @@ IdList Repository::temporaryRemovedLinks(Id const &id) const
 void Repository::removeTemporaryRemovedLinks(Id const &id)
 {
 	if (mObjects.contains(id)) {
-		return mObjects[id]->removeTemporaryRemovedLinks();
+		Modification const modification(*this);
+		preserve(id);
+		mObjects[id]->removeTemporaryRemovedLinks();
+		markChanged(id);
 	} else {
 		throw Exception("Repository: Removing temporaryRemovedLinks of nonexistent object " + id.toString());
 	}
@@ -343,23 +374,42 @@ void Repository::removeTemporaryRemovedLinks(Id const &id)
 
 void Repository::loadFromDisk()
 {
+	QWriteLocker const locker(mLock.data());
+
+	// Loaded objects replace existing objects with the same ids.
+	preserveAll();
 	mSerializer.loadFromDisk(mObjects);
+	preserveCreated(mObjects.keys());
+
+	mIndex.rebuild();
 	addChildrenToRootObject();
 }
 
 void Repository::importFromDisk(QString const &importedFile)
 {
+	QWriteLocker const locker(mLock.data());
 	mSerializer.setWorkingFile(importedFile);
 	loadFromDisk();
 	mSerializer.setWorkingFile(mWorkingFile);
+
+	if (mJournal.isActive()) {
+		foreach (Object const * const object, mObjects.values()) {
+			mJournal.writeObject(*object);
+		}
+	}
+
+	// Imported objects are not tracked, so no save file can be updated incrementally.
+	resetChanges();
 }
 
 void Repository::addChildrenToRootObject()
 {
 	foreach (Object *object, mObjects.values()) {
 		if (object->parent() == Id::rootId()) {
-			if (!mObjects[Id::rootId()]->children().contains(object->id()))
+			if (!mObjects[Id::rootId()]->children().contains(object->id())) {
 				mObjects[Id::rootId()]->addChild(object->id());
+				markChanged(Id::rootId());
+			}
 		}
 	}
 }
@@ -404,7 +454,38 @@ bool Repository::exist(const Id &id) const
 
 void Repository::saveAll() const
 {
+	QString const targetFile = mSerializer.targetFile();
+	if (mSavedGenerations.contains(targetFile)) {
+		quint64 const savedGeneration = mSavedGenerations[targetFile];
+
+		QList<Object *> changedObjects;
+		for (QHash<Id, quint64>::const_iterator i = mChangeGenerations.constBegin()
+				; i != mChangeGenerations.constEnd()
+				; ++i)
+		{
+			if (i.value() > savedGeneration && mObjects.contains(i.key())) {
+				changedObjects << mObjects[i.key()];
+			}
+		}
+
+		IdList removedObjects;
+		for (QHash<Id, quint64>::const_iterator i = mRemovalGenerations.constBegin()
+				; i != mRemovalGenerations.constEnd()
+				; ++i)
+		{
+			if (i.value() > savedGeneration) {
+				removedObjects << i.key();
+			}
+		}
+
+		if (mSerializer.saveChangesToDisk(changedObjects, removedObjects)) {
+			markSaved(targetFile);
+			return;
+		}
+	}
+
 	mSerializer.saveToDisk(mObjects.values());
+	markSaved(targetFile);
 }
 
 void Repository::save(IdList const &list) const
@@ -414,6 +495,9 @@ void Repository::save(IdList const &list) const
 		toSave.append(allChildrenOf(id));
 
 	mSerializer.saveToDisk(toSave);
+
+	// Target file now contains only a part of the repository, it can not be updated incrementally.
+	mSavedGenerations.remove(mSerializer.targetFile());
 }
 
 void Repository::saveWithLogicalId(qReal::IdList const &list) const
@@ -423,6 +507,237 @@ void Repository::saveWithLogicalId(qReal::IdList const &list) const
 		toSave.append(allChildrenOfWithLogicalId(id));
 
 	mSerializer.saveToDisk(toSave);
+	mSavedGenerations.remove(mSerializer.targetFile());
+}
+
+SaveStatistics Repository::lastSaveStatistics() const
+{
+	return mSerializer.lastSaveStatistics();
+}
+
+int Repository::residentObjectsCount() const
+{
+	int result = 0;
+	foreach (Object const * const object, mObjects) {
+		if (object->isMaterialized()) {
+			++result;
+		}
+	}
+
+	return result;
+}
+
+RepositorySnapshot *Repository::createSnapshot() const
+{
+	QWriteLocker const locker(mLock.data());
+	RepositorySnapshot * const snapshot = new RepositorySnapshot(*this, mLock);
+	mSnapshots << snapshot;
+	return snapshot;
+}
+
+void Repository::preserve(Id const &id) const
+{
+	// One copy is shared by all snapshots that need it.
+	QSharedPointer<Object> copy;
+	bool copied = false;
+	foreach (RepositorySnapshot * const snapshot, mSnapshots) {
+		if (!snapshot->mPreserved.contains(id)) {
+			if (!copied) {
+				Object const * const object = mObjects.value(id);
+				if (object) {
+					copy = QSharedPointer<Object>(object->copy());
+				}
+
+				copied = true;
+			}
+
+			snapshot->mPreserved.insert(id, copy);
+		}
+	}
+}
+
+void Repository::preserveAll() const
+{
+	if (mSnapshots.isEmpty()) {
+		return;
+	}
+
+	foreach (Id const &id, mObjects.keys()) {
+		preserve(id);
+	}
+}
+
+void Repository::preserveCreated(IdList const &ids) const
+{
+	foreach (RepositorySnapshot * const snapshot, mSnapshots) {
+		foreach (Id const &id, ids) {
+			if (!snapshot->mPreserved.contains(id)) {
+				snapshot->mPreserved.insert(id, QSharedPointer<Object>());
+			}
+		}
+	}
+}
+
+void Repository::markChanged(Id const &id) const
+{
+	trackChange(id);
+	if (mJournal.isActive() && mObjects.contains(id)) {
+		mJournal.writeObject(*mObjects[id]);
+	}
+}
+
+void Repository::markRemoved(Id const &id) const
+{
+	trackRemoval(id);
+	if (mJournal.isActive()) {
+		mJournal.writeRemoval(id);
+	}
+}
+
+void Repository::markPropertyChanged(Id const &id, QString const &name, QVariant const &value) const
+{
+	trackChange(id);
+	if (mJournal.isActive()) {
+		if (value.isValid()) {
+			mJournal.writeProperty(id, name, value);
+		} else {
+			mJournal.writePropertyRemoval(id, name);
+		}
+	}
+}
+
+void Repository::markGraphicalPartChanged(Id const &id, int partIndex, QString const &name
+		, QVariant const &value) const
+{
+	trackChange(id);
+	if (mJournal.isActive()) {
+		mJournal.writeGraphicalPartProperty(id, partIndex, name, value);
+	}
+}
+
+void Repository::trackChange(Id const &id) const
+{
+	mChangeGenerations[id] = ++mGeneration;
+	mRemovalGenerations.remove(id);
+	mIndex.update(id);
+}
+
+void Repository::trackRemoval(Id const &id) const
+{
+	mChangeGenerations.remove(id);
+	mRemovalGenerations[id] = ++mGeneration;
+	mIndex.remove(id);
+}
+
+void Repository::setJournalEnabled(bool enabled)
+{
+	QWriteLocker const locker(mLock.data());
+	if (enabled == mJournalEnabled) {
+		return;
+	}
+
+	mJournalEnabled = enabled;
+	mJournalCompactionThreshold = SettingsManager::value("JournalCompactionThreshold").toLongLong() * 1024;
+	if (enabled) {
+		openJournal();
+	} else {
+		mJournal.discard();
+	}
+}
+
+void Repository::compactJournal()
+{
+	QWriteLocker const locker(mLock.data());
+	saveAll();
+}
+
+qint64 Repository::journalSize() const
+{
+	return mJournal.size();
+}
+
+void Repository::openJournal()
+{
+	if (mWorkingFile.isEmpty()) {
+		return;
+	}
+
+	QString const saveFile = mSerializer.targetFile();
+	QSet<Id> changed;
+	QSet<Id> removed;
+
+	preserveAll();
+	int const replayed = RepositoryJournal::replay(saveFile, mObjects, changed, removed);
+	preserveCreated(mObjects.keys());
+
+	if (replayed > 0) {
+		qDebug() << "Repository: replayed" << replayed << "journal records of" << saveFile;
+	}
+
+	foreach (Id const &id, changed) {
+		trackChange(id);
+	}
+
+	foreach (Id const &id, removed) {
+		trackRemoval(id);
+	}
+
+	mJournal.open(saveFile, mObjects, changed, removed);
+}
+
+void Repository::compactJournalIfNeeded() const
+{
+	if (mJournalCompactionThreshold > 0 && mJournal.size() > mJournalCompactionThreshold
+			&& mJournal.saveFile() == mSerializer.targetFile())
+	{
+		saveAll();
+	}
+}
+
+Repository::Modification::Modification(Repository const &repository)
+	: mRepository(repository)
+	, mLocker(repository.mLock.data())
+{
+	++mRepository.mModificationDepth;
+}
+
+Repository::Modification::~Modification()
+{
+	if (--mRepository.mModificationDepth == 0) {
+		mRepository.compactJournalIfNeeded();
+	}
+}
+
+void Repository::resetChanges() const
+{
+	mChangeGenerations.clear();
+	mRemovalGenerations.clear();
+	mSavedGenerations.clear();
+}
+
+void Repository::markSaved(QString const &file) const
+{
+	mSavedGenerations[file] = mGeneration;
+
+	// The file contains all changes, so they are not needed in the journal anymore. Copies of the project written
+	// elsewhere do not make the journal of the working file obsolete.
+	if (mJournal.isActive() && file == mJournal.saveFile()) {
+		mJournal.restart(file);
+	}
+
+	// Changes that are already written to every tracked file are not needed anymore.
+	quint64 oldestSave = mGeneration;
+	foreach (quint64 const generation, mSavedGenerations) {
+		oldestSave = qMin(oldestSave, generation);
+	}
+
+	for (QHash<Id, quint64>::iterator i = mChangeGenerations.begin(); i != mChangeGenerations.end(); ) {
+		i = i.value() <= oldestSave ? mChangeGenerations.erase(i) : i + 1;
+	}
+
+	for (QHash<Id, quint64>::iterator i = mRemovalGenerations.begin(); i != mRemovalGenerations.end(); ) {
+		i = i.value() <= oldestSave ? mRemovalGenerations.erase(i) : i + 1;
+	}
 }
 
 void Repository::saveDiagramsById(QHash<QString, IdList> const &diagramIds)
@@ -430,7 +745,7 @@ void Repository::saveDiagramsById(QHash<QString, IdList> const &diagramIds)
 	QString const currentWorkingFile = mWorkingFile;
 	foreach (QString const &savePath, diagramIds.keys()) {
 		qReal::IdList diagrams = diagramIds[savePath];
-		setWorkingFile(savePath);
+		mSerializer.setWorkingFile(savePath);
 		qReal::IdList elementsToSave;
 		foreach (qReal::Id const &id, diagrams) {
 			elementsToSave += idsOfAllChildrenOf(id);
@@ -441,7 +756,7 @@ void Repository::saveDiagramsById(QHash<QString, IdList> const &diagramIds)
 		}
 		saveWithLogicalId(elementsToSave);
 	}
-	setWorkingFile(currentWorkingFile);
+	mSerializer.setWorkingFile(currentWorkingFile);
 }
 
 void Repository::remove(IdList list) const
@@ -455,8 +770,11 @@ void Repository::remove(IdList list) const
 void Repository::remove(const qReal::Id &id)
 {
 	if (mObjects.contains(id)) {
+		Modification const modification(*this);
+		preserve(id);
 		delete mObjects[id];
 		mObjects.remove(id);
+		markRemoved(id);
 	} else {
 		throw Exception("Repository: Trying to remove nonexistent object " + id.toString());
 	}
@@ -466,6 +784,11 @@ void Repository::setWorkingFile(QString const &workingFile)
 {
 	mSerializer.setWorkingFile(workingFile);
 	mWorkingFile = workingFile;
+
+	// The journal protects the working file, so it follows the project to its new file.
+	if (mJournalEnabled && !mWorkingFile.isEmpty() && mJournal.saveFile() != mSerializer.targetFile()) {
+		mJournal.restart(mSerializer.targetFile());
+	}
 }
 
 void Repository::exportToXml(QString const &targetFile) const
@@ -495,19 +818,38 @@ void Repository::printDebug() const
 void Repository::exterminate()
 {
 	printDebug();
+	QWriteLocker const locker(mLock.data());
+	preserveAll();
 	mObjects.clear();
 	//serializer.clearWorkingDir();
 	mSerializer.saveToDisk(mObjects.values());
+	resetChanges();
+	markSaved(mSerializer.targetFile());
 	init();
+	preserveCreated(mObjects.keys());
+	markChanged(Id::rootId());
 	printDebug();
 }
 
 void Repository::open(QString const &saveFile)
 {
+	QWriteLocker const locker(mLock.data());
+
+	// Changes of the previous project were either saved or discarded by user.
+	mJournal.discard();
+
+	preserveAll();
 	mObjects.clear();
 	init();
+	preserveCreated(mObjects.keys());
+	mWorkingFile = saveFile;
 	mSerializer.setWorkingFile(saveFile);
 	loadFromDisk();
+	resetChanges();
+	markSaved(mSerializer.targetFile());
+	if (mJournalEnabled) {
+		openJournal();
+	}
 }
 
 qReal::IdList Repository::elements() const
@@ -515,6 +857,30 @@ qReal::IdList Repository::elements() const
 	return mObjects.keys();
 }
 
+qReal::IdList Repository::graphicalElements() const
+{
+	QReadLocker const locker(mLock.data());
+	return mIndex.graphicalElements();
+}
+
+qReal::IdList Repository::logicalElements(qReal::Id const &type) const
+{
+	QReadLocker const locker(mLock.data());
+	return mIndex.logicalElements(type.element());
+}
+
+qReal::IdList Repository::graphicalElements(qReal::Id const &type) const
+{
+	QReadLocker const locker(mLock.data());
+	return mIndex.graphicalElements(type.element());
+}
+
+qReal::IdList Repository::elementsByType(QString const &type, bool sensitivity, bool regExpression) const
+{
+	QReadLocker const locker(mLock.data());
+	return mIndex.elementsByType(type, sensitivity, regExpression);
+}
+
 bool Repository::isLogicalId(qReal::Id const &elem) const
 {
 	return mObjects[elem]->isLogicalObject();
@@ -542,7 +908,10 @@ void Repository::createGraphicalPart(qReal::Id const &id, int partIndex)
 		throw Exception("Trying to create graphical part for non-graphical object");
 	}
 
+	Modification const modification(*this);
+	preserve(id);
 	graphicalObject->createGraphicalPart(partIndex);
+	markChanged(id);
 }
 
 QList<int> Repository::graphicalParts(qReal::Id const &id) const
@@ -577,5 +946,8 @@ void Repository::setGraphicalPartProperty(
 		throw Exception("Trying to obtain graphical part property for non-graphical item");
 	}
 
+	Modification const modification(*this);
+	preserve(id);
 	graphicalObject->setGraphicalPartProperty(partIndex, propertyName, value);
+	markGraphicalPartChanged(id, partIndex, propertyName, value);
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSharedPointer>
 
 #include "../../qrkernel/definitions.h"
 #include "../../qrkernel/ids.h"
@@ -8,11 +10,15 @@
 #include "classes/logicalObject.h"
 #include "qrRepoGlobal.h"
 #include "serializer.h"
+#include "repositoryIndex.h"
+#include "repositoryJournal.h"
+#include "repositorySnapshot.h"
 
 namespace qrRepo {
 namespace details {
 
 /// Class that actually contains all data, supports low-level queries and can serialize/deserialize data.
+/// Queries by names, properties and types may be called from several threads and return ids sorted by Id::operator<.
 class Repository
 {
 public:
@@ -73,6 +79,19 @@ public:
 	void removeTemporaryRemovedLinks(qReal::Id const &id);
 
 	qReal::IdList elements() const;
+
+	/// Returns ids of all graphical elements.
+	qReal::IdList graphicalElements() const;
+
+	/// Returns ids of logical elements of given type (only element part of type id is taken into account).
+	qReal::IdList logicalElements(qReal::Id const &type) const;
+
+	/// Returns ids of graphical elements of given type (only element part of type id is taken into account).
+	qReal::IdList graphicalElements(qReal::Id const &type) const;
+
+	/// Returns ids of elements whose type names contain given string or match given regular expression.
+	qReal::IdList elementsByType(QString const &type, bool sensitivity, bool regExpression) const;
+
 	bool isLogicalId(qReal::Id const &elem) const;
 	qReal::Id logicalId(qReal::Id const &elem) const;
 
@@ -87,6 +106,8 @@ public:
 	/// @param importedFile - name of file to be imported
 	void importFromDisk(QString const &importedFile);
 
+	/// Saves all repository contents to the working file. If the working file was already written by this
+	/// repository, only objects changed since then are rewritten inside it.
 	void saveAll() const;
 	void save(qReal::IdList const &list) const;
 	void saveWithLogicalId(qReal::IdList const &list) const;
@@ -98,6 +119,30 @@ public:
 	/// Returns current working file name
 	QString workingFile() const;
 
+	/// Returns how many objects and bytes were written by the last save operation.
+	SaveStatistics lastSaveStatistics() const;
+
+	/// Returns the number of objects whose properties are loaded in memory. Objects of lazily loaded projects
+	/// become resident when their properties are accessed for the first time.
+	int residentObjectsCount() const;
+
+	/// Turns on or off journaling of changes. When turned on, a journal left next to the working file after a crash
+	/// is replayed, then every modification is appended to the journal. The journal is folded into the working file
+	/// by each save to it, or automatically when it exceeds "JournalCompactionThreshold" setting (in kilobytes,
+	/// zero disables automatic compaction). Turning journaling off removes the journal.
+	/// Shall be turned on before the model is modified, otherwise earlier changes are not journaled.
+	void setJournalEnabled(bool enabled);
+
+	/// Writes all changes to the working file and starts the journal anew.
+	void compactJournal();
+
+	/// Returns the size of the journal file in bytes.
+	qint64 journalSize() const;
+
+	/// Creates a read-only snapshot of current repository state in constant time. Snapshot may be read from other
+	/// threads while the repository is modified. Caller takes ownership.
+	RepositorySnapshot *createSnapshot() const;
+
 	/// Creates empty graphical part with given index inside given object.
 	/// @param id - id of an object where we shall create graphical part.
 	/// @param partIndex - index of created part in given object.
@@ -126,11 +171,71 @@ public:
 			);
 
 private:
+	friend class RepositorySnapshot;
+
+	/// Holds the write lock for a modification of objects. When the outermost modification is finished, compacts
+	/// the journal if needed, so the project is never saved in the middle of a modification.
+	class Modification
+	{
+	public:
+		explicit Modification(Repository const &repository);
+		~Modification();
+
+	private:
+		Repository const &mRepository;
+		QWriteLocker mLocker;
+	};
+
 	void init();
 
 	void loadFromDisk();
 	void addChildrenToRootObject();
 
+	/// Remembers that given object was created or modified and shall be rewritten by the next save.
+	void markChanged(qReal::Id const &id) const;
+
+	/// Remembers that given object was removed and shall be dropped from save files by the next save.
+	void markRemoved(qReal::Id const &id) const;
+
+	/// Remembers that a property of given object was set to given value or removed if the value is invalid.
+	/// Unlike markChanged(), journals only the property instead of the whole object.
+	void markPropertyChanged(qReal::Id const &id, QString const &name, QVariant const &value) const;
+
+	/// Remembers that a property of a graphical part of given object was set to given value.
+	void markGraphicalPartChanged(qReal::Id const &id, int partIndex, QString const &name
+			, QVariant const &value) const;
+
+	/// Updates change tracking and indexes for a created or modified object, without journaling.
+	void trackChange(qReal::Id const &id) const;
+
+	/// Updates change tracking and indexes for a removed object, without journaling.
+	void trackRemoval(qReal::Id const &id) const;
+
+	/// Replays the journal of the working file, if any, and starts journaling.
+	void openJournal();
+
+	/// Folds the journal into the working file if the journal has grown over the threshold. Called only when no
+	/// modification is in progress, see Modification.
+	void compactJournalIfNeeded() const;
+
+	/// Forgets all information about changes, so the next save to any file will be a full one.
+	void resetChanges() const;
+
+	/// Remembers that given file contains all objects in their current state.
+	void markSaved(QString const &file) const;
+
+	/// Gives a copy of given object to every snapshot that does not have its own copy yet, so snapshots keep seeing
+	/// the object as it was before a modification that is about to happen. Nonexistent object is remembered as
+	/// absent. Shall be called under a write lock.
+	void preserve(qReal::Id const &id) const;
+
+	/// Preserves all objects, called before operations that replace repository contents.
+	void preserveAll() const;
+
+	/// Remembers given objects as absent in every snapshot that does not know them yet. Called under a write lock
+	/// after operations that create objects with ids unknown beforehand.
+	void preserveCreated(qReal::IdList const &ids) const;
+
 	qReal::IdList idsOfAllChildrenOf(qReal::Id id) const;
 	QList<Object*> allChildrenOf(qReal::Id id) const;
 	QList<Object*> allChildrenOfWithLogicalId(qReal::Id id) const;
@@ -140,6 +245,39 @@ private:
 	/// Name of the current save file for project.
 	QString mWorkingFile;
 	Serializer mSerializer;
+
+	/// Secondary indexes over mObjects, updated together with change tracking. Queried under a read lock, so
+	/// queries from other threads do not meet a modification in progress.
+	mutable RepositoryIndex mIndex;
+
+	/// Counter of modifications, incremented on each change of any object.
+	mutable quint64 mGeneration;
+
+	/// Maps ids of changed objects to the generation of their last change.
+	mutable QHash<qReal::Id, quint64> mChangeGenerations;
+
+	/// Maps ids of removed objects to the generation of their removal.
+	mutable QHash<qReal::Id, quint64> mRemovalGenerations;
+
+	/// Maps save files written by this repository to the generation they correspond to.
+	mutable QHash<QString, quint64> mSavedGenerations;
+
+	/// Guards objects against modification while snapshots read them. Held for writing by every modification of
+	/// objects, recursive since modifications call each other. Shared with snapshots, so they may outlive repository.
+	QSharedPointer<QReadWriteLock> mLock;
+
+	/// Snapshots that share objects with this repository.
+	mutable QList<RepositorySnapshot *> mSnapshots;
+
+	/// Log of changes not written to the working file yet, inactive unless journaling is enabled.
+	mutable RepositoryJournal mJournal;
+	bool mJournalEnabled;
+
+	/// Size of the journal in bytes that triggers its compaction, zero if compaction is done only by saves.
+	qint64 mJournalCompactionThreshold;
+
+	/// Number of nested modifications in progress, see Modification.
+	mutable int mModificationDepth;
 };
 
 }
@@ -0,0 +1,347 @@
+#include "repositoryIndex.h"
+
+using namespace qReal;
+using namespace qrRepo::details;
+
+RepositoryIndex::RepositoryIndex(QHash<Id, Object *> const &objects)
+		: mObjects(objects)
+		, mPropertyIndexesBuilt(false)
+{
+}
+
+void RepositoryIndex::rebuild()
+{
+	mLogicalByElement.clear();
+	mGraphicalByElement.clear();
+	mGraphical.clear();
+
+	{
+		QMutexLocker const locker(&mPropertyIndexesMutex);
+		mPropertyIndexesBuilt = false;
+		mStale.clear();
+		mNames.clear();
+		mNameTrigrams.clear();
+		mByPropertyName.clear();
+		mPropertyNames.clear();
+		mContentTrigrams.clear();
+		mObjectContentTrigrams.clear();
+	}
+
+	foreach (Id const &id, mObjects.keys()) {
+		update(id);
+	}
+}
+
+void RepositoryIndex::update(Id const &id)
+{
+	Object const * const object = mObjects.value(id);
+	if (!object) {
+		return;
+	}
+
+	if (object->isLogicalObject()) {
+		mLogicalByElement[id.element()].insert(id);
+	} else {
+		mGraphicalByElement[id.element()].insert(id);
+		mGraphical.insert(id);
+	}
+
+	QMutexLocker const locker(&mPropertyIndexesMutex);
+	if (mPropertyIndexesBuilt) {
+		mStale.insert(id);
+	}
+}
+
+void RepositoryIndex::remove(Id const &id)
+{
+	QString const element = id.element();
+	if (mLogicalByElement.contains(element)) {
+		mLogicalByElement[element].remove(id);
+	}
+
+	if (mGraphicalByElement.contains(element)) {
+		mGraphicalByElement[element].remove(id);
+	}
+
+	mGraphical.remove(id);
+
+	QMutexLocker const locker(&mPropertyIndexesMutex);
+	if (mPropertyIndexesBuilt) {
+		unindexProperties(id);
+		mStale.remove(id);
+	}
+}
+
+IdList RepositoryIndex::graphicalElements() const
+{
+	return sorted(mGraphical);
+}
+
+IdList RepositoryIndex::logicalElements(QString const &element) const
+{
+	return sorted(mLogicalByElement.value(element));
+}
+
+IdList RepositoryIndex::graphicalElements(QString const &element) const
+{
+	return sorted(mGraphicalByElement.value(element));
+}
+
+IdList RepositoryIndex::elementsByType(QString const &type, bool sensitivity, bool regExpression) const
+{
+	Qt::CaseSensitivity const caseSensitivity = sensitivity ? Qt::CaseSensitive : Qt::CaseInsensitive;
+	QRegExp const regExp(type, caseSensitivity);
+
+	// There are much less element types than elements, so matching types one by one is cheap.
+	QSet<QString> elements = mLogicalByElement.keys().toSet();
+	elements.unite(mGraphicalByElement.keys().toSet());
+
+	QSet<Id> result;
+	foreach (QString const &element, elements) {
+		if (regExpression ? element.contains(regExp) : element.contains(type, caseSensitivity)) {
+			result.unite(mLogicalByElement.value(element)).unite(mGraphicalByElement.value(element));
+		}
+	}
+
+	return sorted(result);
+}
+
+IdList RepositoryIndex::findElementsByName(QString const &name, bool sensitivity, bool regExpression) const
+{
+	QMutexLocker const locker(&mPropertyIndexesMutex);
+	refreshPropertyIndexes();
+
+	Qt::CaseSensitivity const caseSensitivity = sensitivity ? Qt::CaseSensitive : Qt::CaseInsensitive;
+	QRegExp const regExp(name, caseSensitivity);
+
+	QSet<Id> const candidateIds = regExpression || name.length() < 3
+			? mGraphical
+			: candidates(mNameTrigrams, name);
+
+	QSet<Id> result;
+	foreach (Id const &id, candidateIds) {
+		if (!mGraphical.contains(id)) {
+			continue;
+		}
+
+		QString const elementName = mNames.value(id);
+		if (regExpression ? elementName.contains(regExp) : elementName.contains(name, caseSensitivity)) {
+			result.insert(id);
+		}
+	}
+
+	return sorted(result);
+}
+
+IdList RepositoryIndex::elementsByProperty(QString const &property, bool sensitivity, bool regExpression) const
+{
+	QMutexLocker const locker(&mPropertyIndexesMutex);
+	refreshPropertyIndexes();
+
+	Qt::CaseSensitivity const caseSensitivity = sensitivity ? Qt::CaseSensitive : Qt::CaseInsensitive;
+	QRegExp const regExp(property, caseSensitivity);
+
+	QSet<Id> matched;
+	for (QHash<QString, QSet<Id> >::const_iterator i = mByPropertyName.constBegin()
+			; i != mByPropertyName.constEnd()
+			; ++i)
+	{
+		bool const matches = regExpression
+				? i.key().contains(regExp)
+				: i.key().compare(property, caseSensitivity) == 0;
+		if (matches) {
+			matched.unite(i.value());
+		}
+	}
+
+	return sorted(matched.intersect(mGraphical));
+}
+
+IdList RepositoryIndex::elementsByPropertyContent(QString const &propertyValue, bool sensitivity
+		, bool regExpression) const
+{
+	QMutexLocker const locker(&mPropertyIndexesMutex);
+	refreshPropertyIndexes();
+
+	Qt::CaseSensitivity const caseSensitivity = sensitivity ? Qt::CaseSensitive : Qt::CaseInsensitive;
+	QRegExp const regExp(propertyValue, caseSensitivity);
+
+	QSet<Id> result;
+	if (regExpression || propertyValue.length() < 3) {
+		foreach (Id const &id, mObjects.keys()) {
+			if (hasPropertyContent(id, propertyValue, caseSensitivity, regExpression ? &regExp : NULL)) {
+				result.insert(id);
+			}
+		}
+	} else {
+		foreach (Id const &id, candidates(mContentTrigrams, propertyValue)) {
+			if (hasPropertyContent(id, propertyValue, caseSensitivity, NULL)) {
+				result.insert(id);
+			}
+		}
+	}
+
+	return sorted(result);
+}
+
+IdList RepositoryIndex::sorted(QSet<Id> const &ids)
+{
+	IdList result = ids.toList();
+	qSort(result);
+	return result;
+}
+
+QSet<RepositoryIndex::Trigram> RepositoryIndex::trigrams(QString const &string)
+{
+	// Characters are folded one by one, the same way case insensitive QString::contains() compares them.
+	QSet<Trigram> result;
+	for (int i = 0; i + 2 < string.length(); ++i) {
+		result.insert((static_cast<Trigram>(string[i].toCaseFolded().unicode()) << 32)
+				| (static_cast<Trigram>(string[i + 1].toCaseFolded().unicode()) << 16)
+				| string[i + 2].toCaseFolded().unicode());
+	}
+
+	return result;
+}
+
+QSet<Id> RepositoryIndex::candidates(QHash<Trigram, QSet<Id> > const &index, QString const &string)
+{
+	QList<QSet<Id> const *> postings;
+	foreach (Trigram const trigram, trigrams(string)) {
+		QHash<Trigram, QSet<Id> >::const_iterator const posting = index.constFind(trigram);
+		if (posting == index.constEnd()) {
+			return QSet<Id>();
+		}
+
+		postings << &posting.value();
+	}
+
+	// Intersection is started from the rarest trigram, so the least number of ids is checked.
+	int rarest = 0;
+	for (int i = 1; i < postings.size(); ++i) {
+		if (postings[i]->size() < postings[rarest]->size()) {
+			rarest = i;
+		}
+	}
+
+	QSet<Id> result;
+	foreach (Id const &id, *postings[rarest]) {
+		bool inAll = true;
+		foreach (QSet<Id> const *posting, postings) {
+			if (!posting->contains(id)) {
+				inAll = false;
+				break;
+			}
+		}
+
+		if (inAll) {
+			result.insert(id);
+		}
+	}
+
+	return result;
+}
+
+void RepositoryIndex::addTrigrams(QHash<Trigram, QSet<Id> > &index, Id const &id, QSet<Trigram> const &objectTrigrams)
+{
+	foreach (Trigram const trigram, objectTrigrams) {
+		index[trigram].insert(id);
+	}
+}
+
+void RepositoryIndex::removeTrigrams(QHash<Trigram, QSet<Id> > &index, Id const &id
+		, QSet<Trigram> const &objectTrigrams)
+{
+	foreach (Trigram const trigram, objectTrigrams) {
+		QHash<Trigram, QSet<Id> >::iterator const posting = index.find(trigram);
+		if (posting != index.end()) {
+			posting.value().remove(id);
+			if (posting.value().isEmpty()) {
+				index.erase(posting);
+			}
+		}
+	}
+}
+
+void RepositoryIndex::refreshPropertyIndexes() const
+{
+	if (!mPropertyIndexesBuilt) {
+		foreach (Id const &id, mObjects.keys()) {
+			indexProperties(id);
+		}
+
+		mPropertyIndexesBuilt = true;
+		return;
+	}
+
+	foreach (Id const &id, mStale) {
+		unindexProperties(id);
+		indexProperties(id);
+	}
+
+	mStale.clear();
+}
+
+void RepositoryIndex::indexProperties(Id const &id) const
+{
+	Object const * const object = mObjects.value(id);
+	if (!object) {
+		return;
+	}
+
+	QString const name = object->property("name").toString();
+	mNames.insert(id, name);
+	addTrigrams(mNameTrigrams, id, trigrams(name));
+
+	QStringList propertyNames;
+	QSet<Trigram> contentTrigrams;
+	QMapIterator<QString, QVariant> iterator = object->propertiesIterator();
+	while (iterator.hasNext()) {
+		iterator.next();
+		propertyNames << iterator.key();
+		mByPropertyName[iterator.key()].insert(id);
+		contentTrigrams.unite(trigrams(iterator.value().toString()));
+	}
+
+	mPropertyNames.insert(id, propertyNames);
+	addTrigrams(mContentTrigrams, id, contentTrigrams);
+	mObjectContentTrigrams.insert(id, contentTrigrams);
+}
+
+void RepositoryIndex::unindexProperties(Id const &id) const
+{
+	if (mNames.contains(id)) {
+		removeTrigrams(mNameTrigrams, id, trigrams(mNames.take(id)));
+	}
+
+	foreach (QString const &propertyName, mPropertyNames.take(id)) {
+		QHash<QString, QSet<Id> >::iterator const ids = mByPropertyName.find(propertyName);
+		if (ids != mByPropertyName.end()) {
+			ids.value().remove(id);
+			if (ids.value().isEmpty()) {
+				mByPropertyName.erase(ids);
+			}
+		}
+	}
+
+	removeTrigrams(mContentTrigrams, id, mObjectContentTrigrams.take(id));
+}
+
+bool RepositoryIndex::hasPropertyContent(Id const &id, QString const &propertyValue
+		, Qt::CaseSensitivity caseSensitivity, QRegExp const *regExp) const
+{
+	Object const * const object = mObjects.value(id);
+	if (!object) {
+		return false;
+	}
+
+	QMapIterator<QString, QVariant> iterator = object->propertiesIterator();
+	while (iterator.hasNext()) {
+		QString const value = iterator.next().value().toString();
+		if (regExp ? value.contains(*regExp) : value.contains(propertyValue, caseSensitivity)) {
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QRegExp>
+
+#include "../../qrkernel/ids.h"
+#include "classes/object.h"
+
+namespace qrRepo {
+namespace details {
+
+/// Secondary indexes over repository objects, used to answer queries without scanning all objects.
+/// Type and logical/graphical indexes are always maintained. Indexes of names, property names and property values
+/// need properties of objects, so they are built on the first query that needs them (this way lazily loaded
+/// projects are not loaded entirely just to be indexed) and then are kept up to date.
+/// Substring search over names and property values uses trigram indexes: only objects that contain all trigrams of
+/// a searched string are checked. Regular expressions and strings shorter than three characters are matched against
+/// all indexed names or properties.
+/// Queries return ids sorted by Id::operator<, so results do not depend on hash order.
+/// Queries may be called from several threads at once, but not together with update(), remove() or rebuild(); the
+/// repository guarantees that with its lock. Property indexes, which queries build and refresh, have their own mutex.
+class RepositoryIndex
+{
+public:
+	/// Constructor.
+	/// @param objects - objects of a repository, shall live longer than the index.
+	explicit RepositoryIndex(QHash<qReal::Id, Object *> const &objects);
+
+	/// Reindexes all objects, shall be called after objects were added or removed without notifying the index.
+	void rebuild();
+
+	/// Notifies index that given object was added or its properties were changed.
+	void update(qReal::Id const &id);
+
+	/// Notifies index that given object was removed.
+	void remove(qReal::Id const &id);
+
+	/// Returns ids of all graphical objects.
+	qReal::IdList graphicalElements() const;
+
+	/// Returns ids of logical objects with given element type name.
+	qReal::IdList logicalElements(QString const &element) const;
+
+	/// Returns ids of graphical objects with given element type name.
+	qReal::IdList graphicalElements(QString const &element) const;
+
+	/// Returns ids of objects whose element type names contain given string or match given regular expression.
+	qReal::IdList elementsByType(QString const &type, bool sensitivity, bool regExpression) const;
+
+	/// Returns ids of graphical objects whose names contain given string or match given regular expression.
+	qReal::IdList findElementsByName(QString const &name, bool sensitivity, bool regExpression) const;
+
+	/// Returns ids of graphical objects that have a property with given name (or a name matching given regular
+	/// expression).
+	qReal::IdList elementsByProperty(QString const &property, bool sensitivity, bool regExpression) const;
+
+	/// Returns ids of objects that have a property whose value contains given string or matches given
+	/// regular expression.
+	qReal::IdList elementsByPropertyContent(QString const &propertyValue, bool sensitivity, bool regExpression) const;
+
+private:
+	typedef quint64 Trigram;
+
+	/// Returns given ids as a list sorted by Id::operator<.
+	static qReal::IdList sorted(QSet<qReal::Id> const &ids);
+
+	/// Returns all trigrams of a string with case folded.
+	static QSet<Trigram> trigrams(QString const &string);
+
+	/// Returns ids of objects that contain all trigrams of given string according to given trigram index.
+	static QSet<qReal::Id> candidates(QHash<Trigram, QSet<qReal::Id> > const &index, QString const &string);
+
+	/// Adds trigrams of an object to given trigram index.
+	static void addTrigrams(QHash<Trigram, QSet<qReal::Id> > &index, qReal::Id const &id
+			, QSet<Trigram> const &objectTrigrams);
+
+	/// Removes trigrams of an object from given trigram index.
+	static void removeTrigrams(QHash<Trigram, QSet<qReal::Id> > &index, qReal::Id const &id
+			, QSet<Trigram> const &objectTrigrams);
+
+	/// Builds indexes of names and properties if they are not built yet, reindexes objects changed since last query.
+	/// Shall be called with mPropertyIndexesMutex locked.
+	void refreshPropertyIndexes() const;
+
+	/// Adds names and properties of an object to property indexes.
+	void indexProperties(qReal::Id const &id) const;
+
+	/// Removes names and properties of an object from property indexes.
+	void unindexProperties(qReal::Id const &id) const;
+
+	/// Returns true if given object has a property value that contains given string or matches given expression.
+	bool hasPropertyContent(qReal::Id const &id, QString const &propertyValue
+			, Qt::CaseSensitivity caseSensitivity, QRegExp const *regExp) const;
+
+	QHash<qReal::Id, Object *> const &mObjects;
+
+	/// Ids of logical objects by their element type names.
+	QHash<QString, QSet<qReal::Id> > mLogicalByElement;
+
+	/// Ids of graphical objects by their element type names.
+	QHash<QString, QSet<qReal::Id> > mGraphicalByElement;
+
+	/// Ids of all graphical objects.
+	QSet<qReal::Id> mGraphical;
+
+	/// Guards all indexes below.
+	mutable QMutex mPropertyIndexesMutex;
+
+	/// True if indexes below are built.
+	mutable bool mPropertyIndexesBuilt;
+
+	/// Objects which properties were changed after the last query to property indexes.
+	mutable QSet<qReal::Id> mStale;
+
+	/// Names of indexed objects.
+	mutable QHash<qReal::Id, QString> mNames;
+
+	/// Trigram index of names.
+	mutable QHash<Trigram, QSet<qReal::Id> > mNameTrigrams;
+
+	/// Ids of objects by names of their properties.
+	mutable QHash<QString, QSet<qReal::Id> > mByPropertyName;
+
+	/// Property names of indexed objects, needed to remove objects from mByPropertyName.
+	mutable QHash<qReal::Id, QStringList> mPropertyNames;
+
+	/// Trigram index of string representations of property values.
+	mutable QHash<Trigram, QSet<qReal::Id> > mContentTrigrams;
+
+	/// Trigrams of property values of indexed objects, needed to remove objects from mContentTrigrams.
+	mutable QHash<qReal::Id, QSet<Trigram> > mObjectContentTrigrams;
+};
+
+}
+}
@@ -0,0 +1,426 @@
+#include "repositoryJournal.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+
+#include "../../qrkernel/exception/exception.h"
+#include "classes/logicalObject.h"
+#include "classes/graphicalObject.h"
+
+using namespace qReal;
+using namespace qrRepo::details;
+
+namespace {
+
+char const magic[4] = { 'Q', 'R', 'J', '1' };
+quint32 const formatVersion = 1;
+QDataStream::Version const streamVersion = QDataStream::Qt_5_0;
+
+/// Size of a header: magic, version, save file size and modification time.
+int const headerSize = 4 + 4 + 8 + 8;
+
+enum RecordType
+{
+	objectRecord = 1
+	, removalRecord
+	, propertyRecord
+	, propertyRemovalRecord
+	, graphicalPartPropertyRecord
+};
+
+enum ObjectKind
+{
+	logicalObject = 0
+	, graphicalObject
+};
+
+/// Ids and id lists are stored in properties, so QVariant needs stream operators for them.
+bool registerStreamOperators()
+{
+	qRegisterMetaTypeStreamOperators<Id>("qReal::Id");
+	qRegisterMetaTypeStreamOperators<IdList>("qReal::IdList");
+	return true;
+}
+
+void ensureStreamOperators()
+{
+	static bool const registered = registerStreamOperators();
+	Q_UNUSED(registered)
+}
+
+/// Reads object state record, returns NULL if the record is corrupted.
+Object *readObject(QDataStream &stream)
+{
+	quint8 kind = 0;
+	Id id;
+	Id parent;
+	stream >> kind >> id >> parent;
+
+	Id logicalId;
+	if (kind == graphicalObject) {
+		stream >> logicalId;
+	}
+
+	IdList children;
+	QMap<QString, QVariant> properties;
+	stream >> children >> properties;
+	if (stream.status() != QDataStream::Ok || id.isNull() || kind > graphicalObject) {
+		return NULL;
+	}
+
+	Object * const object = kind == graphicalObject
+			? static_cast<Object *>(new GraphicalObject(id, parent, logicalId))
+			: static_cast<Object *>(new LogicalObject(id))
+			;
+
+	try {
+		object->setParent(parent);
+		foreach (Id const &child, children) {
+			object->addChild(child);
+		}
+
+		object->setProperties(properties);
+
+		if (kind == graphicalObject) {
+			GraphicalObject * const graphical = static_cast<GraphicalObject *>(object);
+			quint32 partsCount = 0;
+			stream >> partsCount;
+			for (quint32 i = 0; i < partsCount && stream.status() == QDataStream::Ok; ++i) {
+				qint32 index = 0;
+				QMap<QString, QVariant> partProperties;
+				stream >> index >> partProperties;
+				graphical->createGraphicalPart(index);
+				for (QMap<QString, QVariant>::const_iterator property = partProperties.constBegin()
+						; property != partProperties.constEnd()
+						; ++property)
+				{
+					graphical->setGraphicalPartProperty(index, property.key(), property.value());
+				}
+			}
+		}
+	} catch (Exception const &) {
+		delete object;
+		return NULL;
+	}
+
+	if (stream.status() != QDataStream::Ok) {
+		delete object;
+		return NULL;
+	}
+
+	return object;
+}
+
+/// Applies one record to objects, returns false if the record is corrupted or does not match objects.
+bool applyRecord(QByteArray const &payload, QHash<Id, Object *> &objects, QSet<Id> &changed, QSet<Id> &removed)
+{
+	QDataStream stream(payload);
+	stream.setVersion(streamVersion);
+
+	quint8 type = 0;
+	stream >> type;
+
+	if (type == objectRecord) {
+		Object * const object = readObject(stream);
+		if (!object) {
+			return false;
+		}
+
+		delete objects.value(object->id());
+		objects.insert(object->id(), object);
+		changed.insert(object->id());
+		removed.remove(object->id());
+		return true;
+	}
+
+	Id id;
+	stream >> id;
+
+	if (type == removalRecord) {
+		delete objects.take(id);
+		changed.remove(id);
+		removed.insert(id);
+		return stream.status() == QDataStream::Ok;
+	}
+
+	Object * const object = objects.value(id);
+	if (!object) {
+		return false;
+	}
+
+	try {
+		if (type == propertyRecord) {
+			QString name;
+			QVariant value;
+			stream >> name >> value;
+			if (stream.status() != QDataStream::Ok || !value.isValid()) {
+				return false;
+			}
+
+			object->setProperty(name, value);
+		} else if (type == propertyRemovalRecord) {
+			QString name;
+			stream >> name;
+			if (stream.status() != QDataStream::Ok) {
+				return false;
+			}
+
+			object->removeProperty(name);
+		} else if (type == graphicalPartPropertyRecord) {
+			qint32 partIndex = 0;
+			QString name;
+			QVariant value;
+			stream >> partIndex >> name >> value;
+			GraphicalObject * const graphical = dynamic_cast<GraphicalObject *>(object);
+			if (stream.status() != QDataStream::Ok || !value.isValid() || !graphical) {
+				return false;
+			}
+
+			graphical->setGraphicalPartProperty(partIndex, name, value);
+		} else {
+			return false;
+		}
+	} catch (Exception const &) {
+		return false;
+	}
+
+	changed.insert(id);
+	return true;
+}
+
+}
+
+RepositoryJournal::RepositoryJournal()
+{
+	mStamp.size = -1;
+	mStamp.modified = 0;
+}
+
+RepositoryJournal::~RepositoryJournal()
+{
+	mFile.close();
+}
+
+QString RepositoryJournal::journalFile(QString const &saveFile)
+{
+	return saveFile + ".journal";
+}
+
+int RepositoryJournal::replay(QString const &saveFile, QHash<Id, Object *> &objects
+		, QSet<Id> &changed, QSet<Id> &removed)
+{
+	ensureStreamOperators();
+
+	QFile file(journalFile(saveFile));
+	if (!file.open(QIODevice::ReadOnly)) {
+		return 0;
+	}
+
+	QDataStream stream(&file);
+	stream.setVersion(streamVersion);
+
+	char fileMagic[4];
+	quint32 version = 0;
+	Stamp fileStamp;
+	if (stream.readRawData(fileMagic, sizeof(fileMagic)) != sizeof(fileMagic)
+			|| qstrncmp(fileMagic, magic, sizeof(magic)) != 0)
+	{
+		qDebug() << "RepositoryJournal:" << file.fileName() << "is not a journal";
+		return 0;
+	}
+
+	stream >> version >> fileStamp.size >> fileStamp.modified;
+	Stamp const saveFileStamp = stamp(saveFile);
+	if (stream.status() != QDataStream::Ok || version != formatVersion
+			|| fileStamp.size != saveFileStamp.size || fileStamp.modified != saveFileStamp.modified)
+	{
+		// Journal was started for other contents of the save file, so its records can not be applied.
+		return 0;
+	}
+
+	int replayed = 0;
+	while (!stream.atEnd()) {
+		quint32 length = 0;
+		quint16 checksum = 0;
+		stream >> length >> checksum;
+		if (stream.status() != QDataStream::Ok || length > file.bytesAvailable()) {
+			break;
+		}
+
+		QByteArray const payload = file.read(length);
+		if (payload.size() != static_cast<int>(length) || qChecksum(payload.constData(), length) != checksum) {
+			break;
+		}
+
+		if (!applyRecord(payload, objects, changed, removed)) {
+			qDebug() << "RepositoryJournal: record" << replayed << "of" << file.fileName() << "can not be applied";
+			break;
+		}
+
+		++replayed;
+	}
+
+	return replayed;
+}
+
+void RepositoryJournal::open(QString const &saveFile, QHash<Id, Object *> const &objects
+		, QSet<Id> const &changed, QSet<Id> const &removed)
+{
+	if (mSaveFile != saveFile) {
+		discard();
+	}
+
+	mFile.close();
+	mSaveFile = saveFile;
+	mStamp = stamp(saveFile);
+
+	foreach (Id const &id, removed) {
+		writeRemoval(id);
+	}
+
+	foreach (Id const &id, changed) {
+		if (objects.contains(id)) {
+			writeObject(*objects[id]);
+		}
+	}
+}
+
+void RepositoryJournal::restart(QString const &saveFile)
+{
+	discard();
+	mSaveFile = saveFile;
+	mStamp = stamp(saveFile);
+}
+
+void RepositoryJournal::discard()
+{
+	if (mSaveFile.isEmpty()) {
+		return;
+	}
+
+	mFile.close();
+	QFile::remove(journalFile(mSaveFile));
+	mSaveFile.clear();
+}
+
+bool RepositoryJournal::isActive() const
+{
+	return !mSaveFile.isEmpty();
+}
+
+QString RepositoryJournal::saveFile() const
+{
+	return mSaveFile;
+}
+
+qint64 RepositoryJournal::size() const
+{
+	return mFile.isOpen() ? mFile.size() : 0;
+}
+
+void RepositoryJournal::writeObject(Object const &object)
+{
+	QByteArray payload;
+	QDataStream stream(&payload, QIODevice::WriteOnly);
+	stream.setVersion(streamVersion);
+
+	GraphicalObject const * const graphical = dynamic_cast<GraphicalObject const *>(&object);
+	stream << static_cast<quint8>(objectRecord)
+			<< static_cast<quint8>(graphical ? graphicalObject : logicalObject)
+			<< object.id()
+			<< object.parent();
+
+	if (graphical) {
+		stream << graphical->logicalId();
+	}
+
+	stream << object.children() << object.properties();
+
+	if (graphical) {
+		QList<int> const parts = graphical->graphicalParts();
+		stream << static_cast<quint32>(parts.size());
+		foreach (int const part, parts) {
+			stream << static_cast<qint32>(part) << graphical->graphicalPartProperties(part);
+		}
+	}
+
+	append(payload);
+}
+
+void RepositoryJournal::writeRemoval(Id const &id)
+{
+	QByteArray payload;
+	QDataStream stream(&payload, QIODevice::WriteOnly);
+	stream.setVersion(streamVersion);
+	stream << static_cast<quint8>(removalRecord) << id;
+	append(payload);
+}
+
+void RepositoryJournal::writeProperty(Id const &id, QString const &name, QVariant const &value)
+{
+	QByteArray payload;
+	QDataStream stream(&payload, QIODevice::WriteOnly);
+	stream.setVersion(streamVersion);
+	stream << static_cast<quint8>(propertyRecord) << id << name << value;
+	append(payload);
+}
+
+void RepositoryJournal::writePropertyRemoval(Id const &id, QString const &name)
+{
+	QByteArray payload;
+	QDataStream stream(&payload, QIODevice::WriteOnly);
+	stream.setVersion(streamVersion);
+	stream << static_cast<quint8>(propertyRemovalRecord) << id << name;
+	append(payload);
+}
+
+void RepositoryJournal::writeGraphicalPartProperty(Id const &id, int partIndex, QString const &name
+		, QVariant const &value)
+{
+	QByteArray payload;
+	QDataStream stream(&payload, QIODevice::WriteOnly);
+	stream.setVersion(streamVersion);
+	stream << static_cast<quint8>(graphicalPartPropertyRecord) << id << static_cast<qint32>(partIndex)
+			<< name << value;
+	append(payload);
+}
+
+RepositoryJournal::Stamp RepositoryJournal::stamp(QString const &saveFile)
+{
+	QFileInfo const info(saveFile);
+	Stamp result;
+	result.size = info.exists() ? info.size() : -1;
+	result.modified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+	return result;
+}
+
+void RepositoryJournal::append(QByteArray const &payload)
+{
+	if (mSaveFile.isEmpty()) {
+		return;
+	}
+
+	ensureStreamOperators();
+
+	QDataStream stream(&mFile);
+	stream.setVersion(streamVersion);
+
+	if (!mFile.isOpen()) {
+		// Journal is created on the first change, so opening a project without editing it leaves no files.
+		mFile.setFileName(journalFile(mSaveFile));
+		if (!mFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+			qDebug() << "RepositoryJournal: can not write" << mFile.fileName();
+			return;
+		}
+
+		stream.writeRawData(magic, sizeof(magic));
+		stream << formatVersion << mStamp.size << mStamp.modified;
+		Q_ASSERT(mFile.pos() == headerSize);
+	}
+
+	stream << static_cast<quint32>(payload.size()) << qChecksum(payload.constData(), payload.size());
+	stream.writeRawData(payload.constData(), payload.size());
+	mFile.flush();
+}
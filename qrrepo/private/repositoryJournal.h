@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+
+#include "../../qrkernel/ids.h"
+#include "classes/object.h"
+
+namespace qrRepo {
+namespace details {
+
+/// Append-only log of repository changes, kept next to a save file. Each modification appends a record, so changes
+/// not yet written to the save file survive a crash: when the save file is opened again, the journal is replayed
+/// over it. After the save file is rewritten the journal is started anew (compacted).
+/// Journal file consists of a header, which identifies the save file contents it was started for, and records,
+/// each prefixed with its length and checksum, so a record torn by a crash is detected and ignored together with
+/// everything after it. Property changes are logged as single values; structural changes (children, creation,
+/// graphical parts) are logged as complete states of affected objects.
+class RepositoryJournal
+{
+public:
+	RepositoryJournal();
+
+	/// Closes journal file, leaving it on disk.
+	~RepositoryJournal();
+
+	/// Returns the name of the journal file kept for given save file.
+	static QString journalFile(QString const &saveFile);
+
+	/// Applies records of a journal kept for given save file to given objects. Journal is ignored if it was started
+	/// for other contents of the save file.
+	/// @param changed - receives ids of objects created or modified by replayed records.
+	/// @param removed - receives ids of objects removed by replayed records.
+	/// @returns the number of replayed records.
+	static int replay(QString const &saveFile, QHash<qReal::Id, Object *> &objects
+			, QSet<qReal::Id> &changed, QSet<qReal::Id> &removed);
+
+	/// Starts journaling changes of given save file. Journal is rewritten with states of objects changed or removed
+	/// by replay(), so records left after a crash are not lost and a torn tail of the journal is dropped.
+	void open(QString const &saveFile, QHash<qReal::Id, Object *> const &objects
+			, QSet<qReal::Id> const &changed, QSet<qReal::Id> const &removed);
+
+	/// Starts an empty journal for given save file, called after the save file was written with all changes.
+	/// Journal of another save file, if any, is removed.
+	void restart(QString const &saveFile);
+
+	/// Stops journaling and removes journal file.
+	void discard();
+
+	/// Returns true if changes are being journaled.
+	bool isActive() const;
+
+	/// Returns the save file this journal is kept for, empty if journal is not active.
+	QString saveFile() const;
+
+	/// Returns the size of journal file in bytes.
+	qint64 size() const;
+
+	/// Logs complete state of given object.
+	void writeObject(Object const &object);
+
+	/// Logs removal of an object.
+	void writeRemoval(qReal::Id const &id);
+
+	/// Logs a change of a property value.
+	void writeProperty(qReal::Id const &id, QString const &name, QVariant const &value);
+
+	/// Logs removal of a property.
+	void writePropertyRemoval(qReal::Id const &id, QString const &name);
+
+	/// Logs a change of a graphical part property value.
+	void writeGraphicalPartProperty(qReal::Id const &id, int partIndex, QString const &name
+			, QVariant const &value);
+
+private:
+	/// Identifies contents of a save file: its size and modification time, size is -1 if the file does not exist.
+	struct Stamp
+	{
+		qint64 size;
+		qint64 modified;
+	};
+
+	static Stamp stamp(QString const &saveFile);
+
+	/// Appends a record with given payload, creating the journal file with a header first if needed.
+	void append(QByteArray const &payload);
+
+	QString mSaveFile;
+	Stamp mStamp;
+
+	/// Journal file, opened on the first record.
+	QFile mFile;
+};
+
+}
+}
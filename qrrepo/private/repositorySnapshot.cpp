@@ -0,0 +1,184 @@
+#include "repositorySnapshot.h"
+
+#include "../../qrkernel/exception/exception.h"
+#include "classes/graphicalObject.h"
+#include "repository.h"
+#include "serializer.h"
+
+using namespace qReal;
+using namespace qrRepo::details;
+
+RepositorySnapshot::RepositorySnapshot(Repository const &repository, QSharedPointer<QReadWriteLock> const &lock)
+		: mRepository(&repository)
+		, mLock(lock)
+{
+}
+
+RepositorySnapshot::~RepositorySnapshot()
+{
+	QWriteLocker const locker(mLock.data());
+	if (mRepository) {
+		mRepository->mSnapshots.removeAll(this);
+	}
+}
+
+IdList RepositorySnapshot::elements() const
+{
+	QReadLocker const locker(mLock.data());
+
+	IdList result;
+	if (mRepository) {
+		foreach (Id const &id, mRepository->mObjects.keys()) {
+			if (!mPreserved.contains(id)) {
+				result << id;
+			}
+		}
+	}
+
+	for (QHash<Id, QSharedPointer<Object> >::const_iterator i = mPreserved.constBegin()
+			; i != mPreserved.constEnd()
+			; ++i)
+	{
+		if (!i.value().isNull()) {
+			result << i.key();
+		}
+	}
+
+	return result;
+}
+
+bool RepositorySnapshot::exist(Id const &id) const
+{
+	QReadLocker const locker(mLock.data());
+	return object(id) != NULL;
+}
+
+IdList RepositorySnapshot::children(Id const &id) const
+{
+	QReadLocker const locker(mLock.data());
+	return existingObject(id).children();
+}
+
+Id RepositorySnapshot::parent(Id const &id) const
+{
+	QReadLocker const locker(mLock.data());
+	return existingObject(id).parent();
+}
+
+QVariant RepositorySnapshot::property(Id const &id, QString const &name) const
+{
+	QReadLocker const locker(mLock.data());
+	return existingObject(id).property(name);
+}
+
+QMap<QString, QVariant> RepositorySnapshot::properties(Id const &id) const
+{
+	QReadLocker const locker(mLock.data());
+	return existingObject(id).properties();
+}
+
+bool RepositorySnapshot::hasProperty(Id const &id, QString const &name) const
+{
+	QReadLocker const locker(mLock.data());
+	return existingObject(id).hasProperty(name);
+}
+
+bool RepositorySnapshot::isLogicalId(Id const &id) const
+{
+	QReadLocker const locker(mLock.data());
+	return existingObject(id).isLogicalObject();
+}
+
+Id RepositorySnapshot::logicalId(Id const &id) const
+{
+	QReadLocker const locker(mLock.data());
+	GraphicalObject const * const graphicalObject = dynamic_cast<GraphicalObject const *>(&existingObject(id));
+	if (!graphicalObject) {
+		throw Exception("Trying to get logical id from non-graphical object");
+	}
+
+	return graphicalObject->logicalId();
+}
+
+QList<int> RepositorySnapshot::graphicalParts(Id const &id) const
+{
+	QReadLocker const locker(mLock.data());
+	GraphicalObject const * const graphicalObject = dynamic_cast<GraphicalObject const *>(&existingObject(id));
+	if (!graphicalObject) {
+		return QList<int>();
+	}
+
+	return graphicalObject->graphicalParts();
+}
+
+QVariant RepositorySnapshot::graphicalPartProperty(Id const &id, int partIndex, QString const &name) const
+{
+	QReadLocker const locker(mLock.data());
+	GraphicalObject const * const graphicalObject = dynamic_cast<GraphicalObject const *>(&existingObject(id));
+	if (!graphicalObject) {
+		throw Exception("Trying to obtain graphical part property for non-graphical item");
+	}
+
+	return graphicalObject->graphicalPartProperty(partIndex, name);
+}
+
+Object *RepositorySnapshot::copyObject(Id const &id) const
+{
+	QReadLocker const locker(mLock.data());
+	return existingObject(id).copy();
+}
+
+void RepositorySnapshot::saveTo(QString const &fileName) const
+{
+	QList<Object *> objects;
+	foreach (Id const &id, elements()) {
+		objects << copyObject(id);
+	}
+
+	SaveStatistics statistics;
+	try {
+		statistics = Serializer::writeToFile(fileName, objects);
+	} catch (Exception const &) {
+		qDeleteAll(objects);
+		throw;
+	}
+
+	qDeleteAll(objects);
+	if (statistics.objectsWritten != objects.size()) {
+		throw Exception("RepositorySnapshot: Can not write " + fileName);
+	}
+}
+
+int RepositorySnapshot::preservedObjectsCount() const
+{
+	QReadLocker const locker(mLock.data());
+
+	int result = 0;
+	foreach (QSharedPointer<Object> const &object, mPreserved) {
+		if (!object.isNull()) {
+			++result;
+		}
+	}
+
+	return result;
+}
+
+Object const *RepositorySnapshot::object(Id const &id) const
+{
+	QHash<Id, QSharedPointer<Object> >::const_iterator const preserved = mPreserved.constFind(id);
+	if (preserved != mPreserved.constEnd()) {
+		return preserved.value().data();
+	}
+
+	return mRepository ? mRepository->mObjects.value(id) : NULL;
+}
+
+Object const &RepositorySnapshot::existingObject(Id const &id) const
+{
+	Object const * const result = object(id);
+	if (!result) {
+		throw Exception("RepositorySnapshot: Requesting nonexistent object " + id.toString());
+	}
+
+	return *result;
+}
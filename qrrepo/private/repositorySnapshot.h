@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSharedPointer>
+
+#include "../../qrkernel/ids.h"
+#include "classes/object.h"
+#include "qrRepoGlobal.h"
+
+namespace qrRepo {
+namespace details {
+
+class Repository;
+
+/// Read-only view of a repository as it was at the moment of snapshot creation. Creation takes constant time:
+/// snapshot shares objects with the repository and gets its own copy of an object only when the repository is
+/// about to modify or remove it, so memory consumption grows with the number of objects changed after creation.
+/// Snapshot may be read from any thread while the repository is modified by its owner; each query holds a read
+/// lock of the repository only for the time of the query. Snapshot remains valid after the repository is deleted.
+class RepositorySnapshot
+{
+public:
+	QRREPO_EXPORT ~RepositorySnapshot();
+
+	/// Returns ids of all objects of the snapshot.
+	QRREPO_EXPORT qReal::IdList elements() const;
+
+	/// Returns true if given object existed at the moment of snapshot creation.
+	QRREPO_EXPORT bool exist(qReal::Id const &id) const;
+
+	QRREPO_EXPORT qReal::IdList children(qReal::Id const &id) const;
+	QRREPO_EXPORT qReal::Id parent(qReal::Id const &id) const;
+
+	QRREPO_EXPORT QVariant property(qReal::Id const &id, QString const &name) const;
+	QRREPO_EXPORT QMap<QString, QVariant> properties(qReal::Id const &id) const;
+	QRREPO_EXPORT bool hasProperty(qReal::Id const &id, QString const &name) const;
+
+	QRREPO_EXPORT bool isLogicalId(qReal::Id const &id) const;
+	QRREPO_EXPORT qReal::Id logicalId(qReal::Id const &id) const;
+
+	/// Returns a list of indexes of graphical parts for given element, empty for logical elements.
+	QRREPO_EXPORT QList<int> graphicalParts(qReal::Id const &id) const;
+
+	/// Returns the value of graphical part property of a given object.
+	QRREPO_EXPORT QVariant graphicalPartProperty(qReal::Id const &id, int partIndex, QString const &name) const;
+
+	/// Returns a copy of given object as it was at the moment of snapshot creation. Caller takes ownership.
+	/// Throws qReal::Exception if object did not exist.
+	QRREPO_EXPORT Object *copyObject(qReal::Id const &id) const;
+
+	/// Writes all objects of the snapshot to given .qrs or .qrb file. Intended to be called from a background
+	/// thread: repository is locked only while each single object is copied, not during serialization.
+	/// Throws qReal::Exception if the file can not be written.
+	QRREPO_EXPORT void saveTo(QString const &fileName) const;
+
+	/// Returns the number of objects copied into this snapshot because they were changed in the repository.
+	QRREPO_EXPORT int preservedObjectsCount() const;
+
+private:
+	friend class Repository;
+
+	/// Constructor, snapshots are created only by Repository::createSnapshot().
+	RepositorySnapshot(Repository const &repository, QSharedPointer<QReadWriteLock> const &lock);
+
+	/// Returns given object as it was at the moment of snapshot creation, or NULL if it did not exist.
+	/// Shall be called under a read lock.
+	Object const *object(qReal::Id const &id) const;
+
+	/// Returns given object as it was at the moment of snapshot creation, throws qReal::Exception if it did not
+	/// exist. Shall be called under a read lock.
+	Object const &existingObject(qReal::Id const &id) const;
+
+	/// Repository this snapshot is taken from, NULL if the repository is already deleted.
+	Repository const *mRepository;
+
+	/// Lock of the repository, shared to outlive it.
+	QSharedPointer<QReadWriteLock> mLock;
+
+	/// Copies of objects changed after snapshot creation, null pointers denote objects that did not exist.
+	/// Filled by the repository under a write lock.
+	QHash<qReal::Id, QSharedPointer<Object> > mPreserved;
+};
+
+}
+}
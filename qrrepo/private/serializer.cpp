@@ -4,14 +4,14 @@
 #include <QtCore/QDebug>
 #include <QtCore/QPointF>
 #include <QtGui/QPolygon>
+#include <QtConcurrent/QtConcurrentMap>
 
 #include "../../qrkernel/settingsManager.h"
 #include "../../qrkernel/exception/exception.h"
-#include "../../qrutils/outFile.h"
-#include "../../qrutils/xmlUtils.h"
 #include "../../qrutils/fileSystemUtils.h"
 
 #include "folderCompressor.h"
+#include "binarySerializer.h"
 #include "classes/logicalObject.h"
 #include "classes/graphicalObject.h"
 
@@ -49,78 +49,190 @@ void Serializer::saveToDisk(QList<Object*> const &objects) const
 		, "Serializer::saveToDisk(...)"
 		, "may be Repository of RepoApi (see Models constructor also) has been initialised with empty filename?");
 
-	foreach (Object const * const object, objects) {
-		QString const filePath = createDirectory(object->id(), object->isLogicalObject());
+	mLastSaveStatistics = writeToFile(targetFile(), objects);
+}
 
-		QDomDocument doc;
-		QDomElement root = object->serialize(doc);
-		doc.appendChild(root);
+SaveStatistics Serializer::writeToFile(QString const &filePath, QList<Object *> const &objects)
+{
+	SaveStatistics statistics;
+	if (BinarySerializer::isBinaryFile(filePath)) {
+		BinarySerializer::save(filePath, objects);
+		statistics.objectsWritten = objects.size();
+		statistics.bytesWritten = QFileInfo(filePath).size();
+		return statistics;
+	}
+
+	// Objects are serialized in parallel, entries are then compressed in parallel and written in order of names,
+	// so the file is the same for any number of threads.
+	QList<QPair<QString, QByteArray> > const serialized = QtConcurrent::blockingMapped(objects, serializeEntry);
+	QMap<QString, QByteArray> entries;
+	for (int i = 0; i < serialized.size(); ++i) {
+		entries.insert(serialized[i].first, serialized[i].second);
+	}
 
-		OutFile out(filePath);
-		doc.save(out(), 2);
+	if (!FolderCompressor::writeArchive(filePath, entries)) {
+		qDebug() << "Serializer: can not write" << filePath;
+		return statistics;
 	}
 
-	QFileInfo fileInfo(mWorkingFile);
-	QString fileName = fileInfo.baseName();
+	// Hiding autosaved files
+	if (QFileInfo(filePath).baseName().contains("~")) {
+		FileSystemUtils::makeHidden(filePath);
+	}
 
-	QDir compressDir(SettingsManager::value("temp").toString());
-	QDir dir = fileInfo.absolutePath();
+	statistics.objectsWritten = objects.size();
+	statistics.bytesWritten = QFileInfo(filePath).size();
+	return statistics;
+}
 
-	QFile previousSave(dir.absolutePath() + "/" + fileName +".qrs");
-	if (previousSave.exists()) {
-		previousSave.remove();
+bool Serializer::saveChangesToDisk(QList<Object *> const &changedObjects, IdList const &removedObjects) const
+{
+	QString const filePath = targetFile();
+	if (BinarySerializer::isBinaryFile(filePath) || !QFile::exists(filePath)) {
+		return false;
 	}
 
-	QString const filePath = fileInfo.absolutePath() + "/" + fileName + ".qrs";
-	FolderCompressor::compressFolder(compressDir.absolutePath(), filePath);
+	QMap<QString, QByteArray> changedEntries;
+	QSet<QString> removedEntries;
 
-	// Hiding autosaved files
-	if (fileName.contains("~")) {
+	foreach (Object const * const object, changedObjects) {
+		changedEntries.insert(entryName(object->id(), object->isLogicalObject()), serializeObject(object));
+		// Object could have been recreated with other kind, so an entry of the other kind is dropped.
+		removedEntries.insert(entryName(object->id(), !object->isLogicalObject()));
+	}
+
+	foreach (Id const &id, removedObjects) {
+		removedEntries.insert(entryName(id, true));
+		removedEntries.insert(entryName(id, false));
+	}
+
+	qint64 bytesWritten = 0;
+	if (!FolderCompressor::updateArchive(filePath, changedEntries, removedEntries, bytesWritten)) {
+		return false;
+	}
+
+	if (QFileInfo(mWorkingFile).baseName().contains("~")) {
 		FileSystemUtils::makeHidden(filePath);
 	}
 
-	clearDir(mWorkingDir);
+	mLastSaveStatistics = SaveStatistics();
+	mLastSaveStatistics.objectsWritten = changedObjects.size();
+	mLastSaveStatistics.bytesWritten = bytesWritten;
+	mLastSaveStatistics.incremental = true;
+	return true;
 }
 
-void Serializer::loadFromDisk(QHash<qReal::Id, Object*> &objectsHash)
+QString Serializer::targetFile() const
 {
-	clearWorkingDir();
-	if (!mWorkingFile.isEmpty()) {
-		decompressFile(mWorkingFile);
+	QFileInfo const fileInfo(mWorkingFile);
+	QString const extension = BinarySerializer::isBinaryFile(mWorkingFile) ? BinarySerializer::extension : "qrs";
+	return fileInfo.absolutePath() + "/" + fileInfo.baseName() + "." + extension;
+}
+
+SaveStatistics Serializer::lastSaveStatistics() const
+{
+	return mLastSaveStatistics;
+}
+
+QString Serializer::entryName(Id const &id, bool logical)
+{
+	QString result = logical ? "/tree/logical" : "/tree/graphical";
+
+	QStringList const partsList = id.toString().split('/');
+	Q_ASSERT(partsList.size() >= 1 && partsList.size() <= 5);
+	for (int i = 1; i < partsList.size(); ++i) {
+		result += "/" + partsList[i];
 	}
 
-	loadFromDisk(SettingsManager::value("temp").toString(), objectsHash);
+	return result;
 }
 
-void Serializer::loadFromDisk(QString const &currentPath, QHash<qReal::Id, Object*> &objectsHash)
+QByteArray Serializer::serializeObject(Object const *object)
 {
-	QDir dir(currentPath + "/tree");
-	if (dir.cd("logical")) {
-		loadModel(dir, objectsHash);
-		dir.cdUp();
-		dir.cd("graphical");
-		loadModel(dir, objectsHash);
+	QByteArray result;
+	QXmlStreamWriter writer(&result);
+	writer.setAutoFormatting(true);
+	writer.setAutoFormattingIndent(2);
+	object->serialize(writer);
+	writer.writeEndDocument();
+	return result;
+}
+
+QPair<QString, QByteArray> Serializer::serializeEntry(Object const *object)
+{
+	return qMakePair(entryName(object->id(), object->isLogicalObject()), serializeObject(object));
+}
+
+Serializer::ParsedEntry Serializer::parseEntry(QPair<QString, QByteArray> const &entry)
+{
+	ParsedEntry result;
+	result.object = NULL;
+
+	if (!entry.first.startsWith("/tree/logical/") && !entry.first.startsWith("/tree/graphical/")) {
+		return result;
+	}
+
+	QXmlStreamReader reader(entry.second);
+	if (!reader.readNextStartElement()) {
+		result.error = QString("parse error in %1 at (%2, %3): %4")
+				.arg(entry.first).arg(reader.lineNumber()).arg(reader.columnNumber()).arg(reader.errorString());
+		return result;
+	}
+
+	try {
+		// To ensure backwards compatibility. Replace this by separate tag names when save updating mechanism
+		// will be implemented.
+		QXmlStreamAttributes const attributes = reader.attributes();
+		result.object = attributes.hasAttribute("logicalId") && attributes.value("logicalId") != "qrm:/"
+				? dynamic_cast<Object *>(new GraphicalObject(reader))
+				: dynamic_cast<Object *>(new LogicalObject(reader))
+				;
+	} catch (Exception const &exception) {
+		result.error = entry.first + ": " + exception.message();
 	}
+
+	return result;
 }
 
-void Serializer::loadModel(QDir const &dir, QHash<qReal::Id, Object*> &objectsHash)
+void Serializer::loadFromDisk(QHash<qReal::Id, Object*> &objectsHash)
 {
-	foreach (QFileInfo const &fileInfo, dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot)) {
-		QString const path = fileInfo.filePath();
-		if (fileInfo.isDir()) {
-			loadModel(path, objectsHash);
-		} else if (fileInfo.isFile()) {
-			QDomDocument doc = xmlUtils::loadDocument(path);
-			QDomElement const element = doc.documentElement();
-
-			// To ensure backwards compatibility. Replace this by separate tag names when save updating mechanism
-			// will be implemented.
-			Object * const object = element.hasAttribute("logicalId") && element.attribute("logicalId") != "qrm:/"
-					? dynamic_cast<Object *>(new GraphicalObject(element))
-					: dynamic_cast<Object *>(new LogicalObject(element))
-					;
-
-			objectsHash.insert(object->id(), object);
+	clearWorkingDir();
+	if (BinarySerializer::isBinaryFile(mWorkingFile)) {
+		BinarySerializer::load(mWorkingFile, objectsHash, SettingsManager::value("LazyProjectLoading").toBool());
+		return;
+	}
+
+	QList<QPair<QString, QByteArray> > entries;
+	if (mWorkingFile.isEmpty() || !FolderCompressor::readArchive(mWorkingFile, entries)) {
+		return;
+	}
+
+	// Entries are decompressed and parsed on thread pool, objects are merged into the hash in file order,
+	// so when an entry is duplicated the last one wins, as it was when entries were unpacked into a folder.
+	QList<ParsedEntry> const parsed = QtConcurrent::blockingMapped(entries, parseEntry);
+
+	QString error;
+	foreach (ParsedEntry const &entry, parsed) {
+		if (!entry.error.isEmpty()) {
+			qDebug() << "Serializer:" << entry.error;
+			if (error.isEmpty()) {
+				error = entry.error;
+			}
+		}
+	}
+
+	if (!error.isEmpty()) {
+		foreach (ParsedEntry const &entry, parsed) {
+			delete entry.object;
+		}
+
+		throw Exception("Serializer: can not load " + mWorkingFile + ", " + error);
+	}
+
+	foreach (ParsedEntry const &entry, parsed) {
+		if (entry.object) {
+			delete objectsHash.value(entry.object->id());
+			objectsHash.insert(entry.object->id(), entry.object);
 		}
 	}
 }
@@ -159,25 +271,26 @@ QString Serializer::pathToElement(Id const &id) const
 	return dirName + "/" + partsList[partsList.size() - 1];
 }
 
-QString Serializer::createDirectory(Id const &id, bool logical) const
+void Serializer::decompressFile(QString const &fileName)
 {
-	QString dirName = mWorkingDir + "/tree";
-	dirName += logical ? "/logical" : "/graphical";
-
-	QStringList const partsList = id.toString().split('/');
-	Q_ASSERT(partsList.size() >= 1 && partsList.size() <= 5);
-	for (int i = 1; i < partsList.size() - 1; ++i) {
-		dirName += "/" + partsList[i];
-	}
-
-	QDir dir;
-	dir.rmdir(mWorkingDir);
-	dir.mkpath(dirName);
-
-	return dirName + "/" + partsList[partsList.size() - 1];
+	FolderCompressor::decompressFolder(fileName, mWorkingDir);
 }
 
-void Serializer::decompressFile(QString const &fileName)
+void Serializer::convert(QString const &sourceFile, QString const &targetFile)
 {
-	FolderCompressor::decompressFolder(fileName, mWorkingDir);
+	Serializer serializer(sourceFile);
+	QHash<Id, Object *> objects;
+
+	try {
+		serializer.loadFromDisk(objects);
+		serializer.setWorkingFile(targetFile);
+		serializer.saveToDisk(objects.values());
+	} catch (...) {
+		qDeleteAll(objects);
+		serializer.clearWorkingDir();
+		throw;
+	}
+
+	qDeleteAll(objects);
+	serializer.clearWorkingDir();
 }
@@ -12,6 +12,26 @@
 namespace qrRepo {
 namespace details {
 
+/// Describes the amount of work done by the last save operation.
+struct SaveStatistics
+{
+	SaveStatistics()
+		: objectsWritten(0)
+		, bytesWritten(0)
+		, incremental(false)
+	{
+	}
+
+	/// Number of objects that were serialized.
+	int objectsWritten;
+
+	/// Number of bytes written to disk.
+	qint64 bytesWritten;
+
+	/// True if only changed objects were rewritten inside existing save file.
+	bool incremental;
+};
+
 /// Class that is responsible for saving repository contents to disk as .qrs file.
 class Serializer
 {
@@ -23,21 +43,62 @@ public:
 
 	void removeFromDisk(qReal::Id const &id) const;
 	void saveToDisk(QList<Object *> const &objects) const;
+
+	/// Rewrites inside existing save file only entries of given objects, keeping all other entries as is.
+	/// @param changedObjects - objects that were created or modified since the save file was written.
+	/// @param removedObjects - ids of objects that were removed since the save file was written.
+	/// @returns false if save file can not be updated, in this case full save shall be performed.
+	bool saveChangesToDisk(QList<Object *> const &changedObjects, qReal::IdList const &removedObjects) const;
+
+	/// Returns the path to .qrs file that will be written by save operations.
+	QString targetFile() const;
+
+	/// Returns statistics of the last saveToDisk() or saveChangesToDisk() call.
+	SaveStatistics lastSaveStatistics() const;
 	void loadFromDisk(QHash<qReal::Id, Object *> &objectsHash);
 
 	void decompressFile(QString const &fileName);
 
+	/// Writes given objects to given file, .qrs or .qrb judging by extension. Unlike saveToDisk(), does not depend
+	/// on working file and directory, so it may be called from any thread.
+	/// Throws qReal::Exception if binary file can not be written.
+	/// @returns statistics of written data, number of written objects is zero if .qrs file can not be written.
+	static SaveStatistics writeToFile(QString const &filePath, QList<Object *> const &objects);
+
+	/// Converts a project file from one format to another: both XML-based .qrs and binary .qrb formats are
+	/// supported, format is determined by file extension. Throws qReal::Exception on failure.
+	static void convert(QString const &sourceFile, QString const &targetFile);
+
 private:
+	/// Result of parsing of one .qrs entry in a worker thread.
+	struct ParsedEntry
+	{
+		/// Parsed object, NULL if entry does not describe an object or can not be parsed.
+		Object *object;
+
+		/// Error that occured while parsing, empty if there were no errors.
+		QString error;
+	};
+
 	static void clearDir(QString const &path);
 
-	void loadFromDisk(QString const &currentPath, QHash<qReal::Id, Object *> &objectsHash);
-	void loadModel(QDir const &dir, QHash<qReal::Id, Object *> &objectsHash);
+	/// Returns the name of an entry in .qrs file under which given object is stored.
+	static QString entryName(qReal::Id const &id, bool logical);
+
+	/// Serializes given object into XML document contents.
+	static QByteArray serializeObject(Object const *object);
+
+	/// Serializes given object into a pair of .qrs entry name and entry contents. Called from worker threads.
+	static QPair<QString, QByteArray> serializeEntry(Object const *object);
+
+	/// Parses .qrs entry and creates an object described by it. Called from worker threads, so never throws.
+	static ParsedEntry parseEntry(QPair<QString, QByteArray> const &entry);
 
 	QString pathToElement(qReal::Id const &id) const;
-	QString createDirectory(qReal::Id const &id, bool logical) const;
 
 	QString mWorkingDir;
 	QString mWorkingFile;
+	mutable SaveStatistics mLastSaveStatistics;
 };
 
 }
@@ -1,6 +1,8 @@
 #include "singleXmlSerializer.h"
 
-#include "../../qrutils/outFile.h"
+#include <QtCore/QFile>
+
+#include "../../qrkernel/exception/exception.h"
 #include "classes/logicalObject.h"
 #include "classes/graphicalObject.h"
 #include "valuesSerializer.h"
@@ -12,9 +14,16 @@ void SingleXmlSerializer::exportToXml(QString const &targetFile, QHash<qReal::Id
 {
 	Q_ASSERT_X(!targetFile.isEmpty(), "XmlSerializer::exportTo(...)", "target filename is empty");
 
-	QDomDocument doc;
-	QDomElement root = doc.createElement("project");
-	doc.appendChild(root);
+	QFile file(targetFile);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		throw Exception("File open operation failed");
+	}
+
+	QXmlStreamWriter writer(&file);
+	writer.setAutoFormatting(true);
+	writer.setAutoFormattingIndent(4);
+
+	writer.writeStartElement("project");
 
 	foreach (Id const &id, objects[Id::rootId()]->children()) {
 
@@ -23,55 +32,54 @@ void SingleXmlSerializer::exportToXml(QString const &targetFile, QHash<qReal::Id
 			continue;
 		}
 
-		exportDiagram(id, doc, root, objects);
+		exportDiagram(id, writer, objects);
 	}
 
-	utils::OutFile out(targetFile);
-	doc.save(out(), 4);
+	writer.writeEndDocument();
 }
 
-void SingleXmlSerializer::exportDiagram(Id const &diagramId, QDomDocument &doc, QDomElement &root, QHash<qReal::Id, Object*> const &objects)
+void SingleXmlSerializer::exportDiagram(Id const &diagramId, QXmlStreamWriter &writer, QHash<qReal::Id, Object*> const &objects)
 {
-	QDomElement diagram = doc.createElement("diagram");
+	writer.writeStartElement("diagram");
 
 	GraphicalObject const * const graphicalObject = dynamic_cast<GraphicalObject const *>(objects[diagramId]);
 	if (graphicalObject) {
-		diagram.setAttribute("logical_id", graphicalObject->logicalId().toString());
+		writer.writeAttribute("logical_id", graphicalObject->logicalId().toString());
 	}
 
-	diagram.setAttribute("graphical_id", diagramId.toString());
-	diagram.setAttribute("name", objects[diagramId]->properties()["name"].toString());
-	exportProperties(diagramId, doc, diagram, objects);
+	writer.writeAttribute("graphical_id", diagramId.toString());
+	writer.writeAttribute("name", objects[diagramId]->property("name").toString());
+	exportProperties(diagramId, writer, objects);
 
-	QDomElement elements = doc.createElement("elements");
+	writer.writeStartElement("elements");
 
 	foreach (Id const &id, objects[diagramId]->children()) {
-		exportElement(id, doc, elements, objects);
+		exportElement(id, writer, objects);
 	}
 
-	diagram.appendChild(elements);
+	writer.writeEndElement();
 
-	root.appendChild(diagram);
+	writer.writeEndElement();
 }
 
-void SingleXmlSerializer::exportElement(Id const &id, QDomDocument &doc, QDomElement &root, QHash<qReal::Id, Object*> const &objects)
+void SingleXmlSerializer::exportElement(Id const &id, QXmlStreamWriter &writer, QHash<qReal::Id, Object*> const &objects)
 {
-	QDomElement element = doc.createElement("element");
-	element.setAttribute("name", objects[id]->properties()["name"].toString());
-	element.setAttribute("graphical_id", id.toString());
+	writer.writeStartElement("element");
+	writer.writeAttribute("name", objects[id]->property("name").toString());
+	writer.writeAttribute("graphical_id", id.toString());
 
 	GraphicalObject const * const graphicalObject = dynamic_cast<GraphicalObject const *>(objects[id]);
 	if (graphicalObject) {
-		element.setAttribute("logical_id", graphicalObject->logicalId().toString());
+		writer.writeAttribute("logical_id", graphicalObject->logicalId().toString());
 	}
 
-	exportProperties(id, doc, element, objects);
-	exportChildren(id, doc, element, objects);
+	exportProperties(id, writer, objects);
+	exportChildren(id, writer, objects);
 
-	root.appendChild(element);
+	writer.writeEndElement();
 }
 
-void SingleXmlSerializer::exportChildren(Id const &id, QDomDocument &doc, QDomElement &root, QHash<qReal::Id, Object*> const &objects)
+void SingleXmlSerializer::exportChildren(Id const &id, QXmlStreamWriter &writer, QHash<qReal::Id, Object*> const &objects)
 {
 	Object *object = objects[id];
 	int size = object->children().size();
@@ -79,19 +87,19 @@ void SingleXmlSerializer::exportChildren(Id const &id, QDomDocument &doc, QDomEl
 		return;
 	}
 
-	QDomElement children = doc.createElement("children");
-	children.setAttribute("count", size);
+	writer.writeStartElement("children");
+	writer.writeAttribute("count", QString::number(size));
 
 	foreach (Id const &id, object->children()) {
-		exportElement(id, doc, children, objects);
+		exportElement(id, writer, objects);
 	}
 
-	root.appendChild(children);
+	writer.writeEndElement();
 }
 
-void SingleXmlSerializer::exportProperties(Id const&id, QDomDocument &doc, QDomElement &root, QHash<Id, Object *> const &objects)
+void SingleXmlSerializer::exportProperties(Id const&id, QXmlStreamWriter &writer, QHash<Id, Object *> const &objects)
 {
-	QDomElement props = doc.createElement("properties");
+	writer.writeStartElement("properties");
 
 	GraphicalObject const * const graphicalObject = dynamic_cast<GraphicalObject const *>(objects[id]);
 	LogicalObject const * const logicalObject
@@ -113,25 +121,25 @@ void SingleXmlSerializer::exportProperties(Id const&id, QDomDocument &doc, QDomE
 	}
 
 	foreach (QString const &key, properties.keys()) {
-		QDomElement prop = doc.createElement("property");
-
 		QString typeName = properties[key].typeName();
 		QVariant value = properties[key];
 		if (typeName == "qReal::IdList" && (value.value<IdList>().size() != 0)) {
-			QDomElement list = ValuesSerializer::serializeIdList("list", value.value<IdList>(), doc);
-			prop.appendChild(list);
+			writer.writeStartElement("property");
+			writer.writeAttribute("name", key);
+			ValuesSerializer::serializeIdList("list", value.value<IdList>(), writer);
+			writer.writeEndElement();
 		} else if (typeName == "qReal::Id"){
-			prop.setAttribute("value", value.value<Id>().toString());
+			writer.writeEmptyElement("property");
+			writer.writeAttribute("value", value.value<Id>().toString());
+			writer.writeAttribute("name", key);
 		} else if (value.toString().isEmpty()) {
 			continue;
 		} else {
-			prop.setAttribute("value", properties[key].toString());
+			writer.writeEmptyElement("property");
+			writer.writeAttribute("value", properties[key].toString());
+			writer.writeAttribute("name", key);
 		}
-
-		prop.setAttribute("name", key);
-
-		props.appendChild(prop);
 	}
 
-	root.appendChild(props);
+	writer.writeEndElement();
 }
@@ -1,21 +1,22 @@
 #pragma once
 
-#include <QtXml/QDomDocument>
+#include <QtCore/QXmlStreamWriter>
 
 #include "classes/object.h"
 
 namespace qrRepo {
 namespace details {
 
-/// Class that saves repository contents as one oncompressed XML file.
+/// Class that saves repository contents as one oncompressed XML file. XML is written as a stream, without building
+/// a document in memory, so exporting does not need memory proportional to the size of a repository.
 class SingleXmlSerializer
 {
 public:
 	static void exportToXml(QString const &targetFile, QHash<qReal::Id, Object*> const &objects);
-	static void exportDiagram(qReal::Id const &diagramId, QDomDocument &doc, QDomElement &root, QHash<qReal::Id, Object*> const &objects);
-	static void exportElement(qReal::Id const &id, QDomDocument &doc, QDomElement &root, QHash<qReal::Id, Object*> const &objects);
-	static void exportChildren(qReal::Id const &id, QDomDocument &doc, QDomElement &root, QHash<qReal::Id, Object*> const &objects);
-	static void exportProperties(qReal::Id const &id, QDomDocument &doc, QDomElement &root, QHash<qReal::Id, Object*> const &objects);
+	static void exportDiagram(qReal::Id const &diagramId, QXmlStreamWriter &writer, QHash<qReal::Id, Object*> const &objects);
+	static void exportElement(qReal::Id const &id, QXmlStreamWriter &writer, QHash<qReal::Id, Object*> const &objects);
+	static void exportChildren(qReal::Id const &id, QXmlStreamWriter &writer, QHash<qReal::Id, Object*> const &objects);
+	static void exportProperties(qReal::Id const &id, QXmlStreamWriter &writer, QHash<qReal::Id, Object*> const &objects);
 
 private:
 	/// Creating is prohibited, utility class instances can not be created.
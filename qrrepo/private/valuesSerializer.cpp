@@ -195,3 +195,81 @@ void ValuesSerializer::deserializeNamedVariantsMap(QMap<QString, QVariant> &map,
 		}
 	}
 }
+
+void ValuesSerializer::serializeIdList(QString const &tagName, IdList const &idList, QXmlStreamWriter &writer)
+{
+	writer.writeStartElement(tagName);
+	foreach (Id const &id, idList) {
+		writer.writeEmptyElement("object");
+		writer.writeAttribute("id", id.toString());
+	}
+
+	writer.writeEndElement();
+}
+
+void ValuesSerializer::serializeNamedVariants(QMap<QString, QVariant> const &map, QXmlStreamWriter &writer)
+{
+	for (QMap<QString, QVariant>::const_iterator i = map.constBegin(); i != map.constEnd(); ++i) {
+		QString const typeName = i.value().typeName();
+		if (typeName == "qReal::IdList") {
+			writer.writeStartElement(i.key());
+			writer.writeAttribute("type", "qReal::IdList");
+			foreach (Id const &id, i.value().value<IdList>()) {
+				writer.writeEmptyElement("object");
+				writer.writeAttribute("id", id.toString());
+			}
+
+			writer.writeEndElement();
+		} else {
+			writer.writeEmptyElement(typeName);
+			writer.writeAttribute("key", i.key());
+			writer.writeAttribute("value", ValuesSerializer::serializeQVariant(i.value()));
+		}
+	}
+}
+
+IdList ValuesSerializer::deserializeIdList(QXmlStreamReader &reader)
+{
+	IdList result;
+	while (reader.readNextStartElement()) {
+		QString const elementStr = reader.attributes().value("id").toString();
+		reader.skipCurrentElement();
+		if (elementStr.isEmpty()) {
+			qDebug() << "Incorrect Child XML node";
+			while (reader.readNextStartElement()) {
+				reader.skipCurrentElement();
+			}
+
+			return IdList();
+		}
+
+		result.append(Id::loadFromString(elementStr));
+	}
+
+	return result;
+}
+
+void ValuesSerializer::deserializeNamedVariantsMap(QMap<QString, QVariant> &map, QXmlStreamReader &reader)
+{
+	while (reader.readNextStartElement()) {
+		QXmlStreamAttributes const attributes = reader.attributes();
+		if (attributes.hasAttribute("type")) {
+			if (attributes.value("type") == "qReal::IdList") {
+				QString const key = reader.name().toString();
+				map.insert(key, IdListHelper::toVariant(deserializeIdList(reader)));
+			} else {
+				throw Exception("Unknown list type");
+			}
+		} else {
+			QString const type = reader.name().toString();
+			QString const key = attributes.value("key").toString();
+			if (key.isEmpty()) {
+				throw Exception("Missing property name");
+			}
+
+			QString const valueStr = attributes.value("value").toString();
+			map.insert(key, ValuesSerializer::deserializeQVariant(type, valueStr));
+			reader.skipCurrentElement();
+		}
+	}
+}
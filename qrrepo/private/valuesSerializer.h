@@ -2,6 +2,8 @@
 
 #include <QtXml/QDomDocument>
 #include <QtXml/QDomElement>
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QXmlStreamWriter>
 #include <QtCore/QVariant>
 #include <QtCore/QFile>
 #include <QtCore/QDir>
@@ -37,11 +39,22 @@ public:
 	static QDomElement serializeNamedVariantsMap(
 			QString const &tagName, QMap<QString, QVariant> const &map, QDomDocument &document);
 
+	/// Writes given IdList as an element with given tag name, the same as serializeIdList() for DOM does.
+	static void serializeIdList(QString const &tagName, qReal::IdList const &idList, QXmlStreamWriter &writer);
+
+	/// Writes elements for each value of given map into current element of a writer, the same way as
+	/// serializeNamedVariantsMap() for DOM fills the element it creates.
+	static void serializeNamedVariants(QMap<QString, QVariant> const &map, QXmlStreamWriter &writer);
+
 	/// Deserializes IdList from XML subtree.
 	/// @param elem - XML subtree which contains a list being deserialized, so this parameter shall be a parent to
 	///        a root of a list.
 	static qReal::IdList deserializeIdList(QDomElement const &elem, QString const &name);
 
+	/// Reads IdList from an element written by serializeIdList().
+	/// @param reader - reader positioned on a start of list element, after the call it is positioned on its end.
+	static qReal::IdList deserializeIdList(QXmlStreamReader &reader);
+
 	/// Loads Id from a string with correct processing of empty strings.
 	/// @returns Id(), if a string is empty, or loaded id. Throws exception, if id can not be loaded.
 	static qReal::Id deserializeId(QString const &elementStr);
@@ -59,6 +72,11 @@ public:
 	/// @param element - XML DOM subtree to deserialize.
 	static void deserializeNamedVariantsMap(QMap<QString, QVariant> &map, QDomElement const &element);
 
+	/// Reads map from QString to QVariant from an element filled by serializeNamedVariants().
+	/// @param map - a map to put deserialized values to.
+	/// @param reader - reader positioned on a start of map element, after the call it is positioned on its end.
+	static void deserializeNamedVariantsMap(QMap<QString, QVariant> &map, QXmlStreamReader &reader);
+
 private:
 	/// Creating is prohibited, utility class instances can not be created.
 	ValuesSerializer();
@@ -1,6 +1,6 @@
 DEFINES += QRREPO_LIBRARY
 
-QT += xml
+QT += xml concurrent
 
 LIBS += -L$$PWD/../bin/ -lqrkernel -lqrutils
 
@@ -9,9 +9,13 @@ INCLUDEPATH += \
 
 HEADERS += \
 	$$PWD/private/repository.h \
+	$$PWD/private/repositoryIndex.h \
+	$$PWD/private/repositoryJournal.h \
+	$$PWD/private/repositorySnapshot.h \
 	$$PWD/private/folderCompressor.h \
 	$$PWD/private/qrRepoGlobal.h \
 	$$PWD/private/serializer.h \
+	$$PWD/private/binarySerializer.h \
 	$$PWD/private/singleXmlSerializer.h \
 	$$PWD/private/valuesSerializer.h \
 	$$PWD/private/classes/object.h \
@@ -21,9 +25,13 @@ HEADERS += \
 
 SOURCES += \
 	$$PWD/private/repository.cpp \
+	$$PWD/private/repositoryIndex.cpp \
+	$$PWD/private/repositoryJournal.cpp \
+	$$PWD/private/repositorySnapshot.cpp \
 	$$PWD/private/folderCompressor.cpp \
 	$$PWD/private/repoApi.cpp \
 	$$PWD/private/serializer.cpp \
+	$$PWD/private/binarySerializer.cpp \
 	$$PWD/private/singleXmlSerializer.cpp \
 	$$PWD/private/valuesSerializer.cpp \
 	$$PWD/private/classes/object.cpp \
@@ -9,6 +9,7 @@
 #include "logicalRepoApi.h"
 
 #include <QtCore/QSet>
+#include <QtCore/QSharedPointer>
 
 namespace qrRepo {
 
@@ -124,6 +125,21 @@ public:
 
 	virtual QString workingFile() const;
 
+	/// Returns how many objects and bytes were written by the last save operation.
+	details::SaveStatistics lastSaveStatistics() const;
+
+	/// Returns the number of elements whose properties are loaded in memory, \see elementsCount() for the number
+	/// of all elements.
+	int residentElementsCount() const;
+
+	/// Creates a read-only snapshot of the current model state in constant time. Snapshot can be read from
+	/// another thread (for example, by autosave) while the model is being edited.
+	virtual QSharedPointer<details::RepositorySnapshot> snapshot() const;
+
+	/// Turns on or off journaling of changes into a file next to the working file, so unsaved changes can be
+	/// recovered after a crash. Shall be turned on before the model is modified.
+	void setJournalEnabled(bool enabled);
+
 	// "Глобальные" методы, позволяющие делать запросы к модели в целом.
 	//Returns all elements with .element() == type.element()
 	virtual qReal::IdList graphicalElements() const;
@@ -1,9 +1,15 @@
 #pragma once
 
+#include <QtCore/QSharedPointer>
+
 #include "../qrkernel/roles.h"
 
 namespace qrRepo {
 
+namespace details {
+class RepositorySnapshot;
+}
+
 /// Provides repository control methods, like save or open saved contents.
 class RepoControlInterface
 {
@@ -43,6 +49,10 @@ public:
 
 	/// Returns current working file name, to which model is saved
 	virtual QString workingFile() const = 0;
+
+	/// Captures current repository contents in constant time. Returned snapshot can be read or saved to a file
+	/// from another thread while the model is being edited.
+	virtual QSharedPointer<details::RepositorySnapshot> snapshot() const = 0;
 };
 
 }
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <pluginManager/editorManagerInterface.h>
+#include <gmock/gmock.h>
+
+namespace qrTest {
+
+class EditorManagerInterfaceMock : public qReal::EditorManagerInterface {
+public:
+	typedef QPair<qReal::Id, qReal::Id> IdPair;
+
+	MOCK_CONST_METHOD0(editors, qReal::IdList());
+	MOCK_CONST_METHOD1(diagrams, qReal::IdList(qReal::Id const &editor));
+	MOCK_CONST_METHOD1(elements, qReal::IdList(qReal::Id const &diagram));
+	MOCK_METHOD1(loadPlugin, bool(QString const &pluginName));
+	MOCK_METHOD1(unloadPlugin, bool(QString const &pluginName));
+
+	MOCK_CONST_METHOD1(mouseGesture, QString(qReal::Id const &id));
+	MOCK_CONST_METHOD1(friendlyName, QString(qReal::Id const &id));
+	MOCK_CONST_METHOD1(description, QString(qReal::Id const &id));
+	MOCK_CONST_METHOD2(propertyDescription, QString(qReal::Id const &id, QString const &propertyName));
+	MOCK_CONST_METHOD2(propertyDisplayedName, QString(qReal::Id const &id, QString const &propertyName));
+	MOCK_CONST_METHOD1(icon, QIcon(qReal::Id const &id));
+	MOCK_CONST_METHOD1(elementImpl, qReal::ElementImpl *(qReal::Id const &id));
+
+	MOCK_CONST_METHOD1(containedTypes, qReal::IdList(qReal::Id const &id));
+	MOCK_CONST_METHOD1(explosions, QList<qReal::Explosion>(qReal::Id const &source));
+	MOCK_CONST_METHOD2(enumValues, QStringList(qReal::Id const &id, QString const &name));
+	MOCK_CONST_METHOD2(typeName, QString(qReal::Id const &id, QString const &name));
+	MOCK_CONST_METHOD1(allChildrenTypesOf, QStringList(qReal::Id const &parent));
+
+	MOCK_CONST_METHOD1(isEditor, bool(qReal::Id const &id));
+	MOCK_CONST_METHOD1(isDiagram, bool(qReal::Id const &id));
+	MOCK_CONST_METHOD1(isElement, bool(qReal::Id const &id));
+
+	MOCK_CONST_METHOD1(propertyNames, QStringList(qReal::Id const &id));
+	MOCK_CONST_METHOD1(portTypes, QStringList(qReal::Id const &id));
+	MOCK_CONST_METHOD2(defaultPropertyValue, QString(qReal::Id const &id, QString name));
+	MOCK_CONST_METHOD1(propertiesWithDefaultValues, QStringList(qReal::Id const &id));
+
+	MOCK_CONST_METHOD2(checkNeededPlugins, qReal::IdList(qrRepo::LogicalRepoApi const &logicalApi
+			, qrRepo::GraphicalRepoApi const &graphicalApi));
+	MOCK_CONST_METHOD1(hasElement, bool(qReal::Id const &element));
+
+	MOCK_CONST_METHOD1(findElementByType, qReal::Id(QString const &type));
+	MOCK_CONST_METHOD0(listeners, QList<qReal::ListenerInterface *>());
+
+	MOCK_CONST_METHOD1(isDiagramNode, bool(qReal::Id const &id));
+
+	MOCK_CONST_METHOD2(isParentOf, bool(qReal::Id const &child, qReal::Id const &parent));
+	MOCK_CONST_METHOD1(isGraphicalElementNode, bool(qReal::Id const &id));
+
+	MOCK_CONST_METHOD0(theOnlyDiagram, qReal::Id());
+	MOCK_CONST_METHOD2(diagramNodeNameString, QString(qReal::Id const &editor, qReal::Id const &diagram));
+
+	MOCK_CONST_METHOD2(possibleEdges, QList<qReal::StringPossibleEdge>(QString const &editor
+			, QString const &element));
+	MOCK_CONST_METHOD2(elements, QStringList(QString const &editor, QString const &diagram));
+	MOCK_CONST_METHOD2(isNodeOrEdge, int(QString const &editor, QString const &element));
+	MOCK_CONST_METHOD5(isParentOf, bool(QString const &editor, QString const &parentDiagram
+			, QString const &parentElement, QString const &childDiagram, QString const &childElement));
+	MOCK_CONST_METHOD2(diagramName, QString(QString const &editor, QString const &diagram));
+	MOCK_CONST_METHOD2(diagramNodeName, QString(QString const &editor, QString const &diagram));
+	MOCK_CONST_METHOD0(isInterpretationMode, bool());
+	MOCK_CONST_METHOD2(isParentProperty, bool(qReal::Id const &id, QString const &propertyName));
+	MOCK_CONST_METHOD1(deleteProperty, void(QString const &propDisplayedName));
+	MOCK_CONST_METHOD2(addProperty, void(qReal::Id const &id, QString const &propDisplayedName));
+	MOCK_CONST_METHOD5(updateProperties, void(qReal::Id const &id, QString const &property
+			, QString const &propertyType, QString const &propertyDefaultValue
+			, QString const &propertyDisplayedName));
+	MOCK_CONST_METHOD2(propertyNameByDisplayedName, QString(qReal::Id const &id
+			, QString const &displayedPropertyName));
+	MOCK_CONST_METHOD1(children, qReal::IdList(qReal::Id const &parent));
+	MOCK_CONST_METHOD1(shape, QString(qReal::Id const &id));
+	MOCK_CONST_METHOD2(updateShape, void(qReal::Id const &id, QString const &graphics));
+	MOCK_CONST_METHOD2(deleteElement, void(qReal::MainWindow *mainWindow, qReal::Id const &id));
+	MOCK_CONST_METHOD1(isRootDiagramNode, bool(qReal::Id const &id));
+	MOCK_CONST_METHOD3(addNodeElement, void(qReal::Id const &diagram, QString const &name
+			, bool isRootDiagramNode));
+	MOCK_CONST_METHOD7(addEdgeElement, void(qReal::Id const &diagram, QString const &name
+			, QString const &labelText, QString const &labelType, QString const &lineType
+			, QString const &beginType, QString const &endType));
+	MOCK_CONST_METHOD1(createEditorAndDiagram, IdPair(QString const &name));
+	MOCK_METHOD1(saveMetamodel, void(QString const &newMetamodelFileName));
+	MOCK_CONST_METHOD0(saveMetamodelFilePath, QString());
+	MOCK_CONST_METHOD2(paletteGroups, QStringList(qReal::Id const &editor, qReal::Id const &diagram));
+	MOCK_CONST_METHOD3(paletteGroupList, QStringList(qReal::Id const &editor, qReal::Id const &diagram
+			, QString const &group));
+	MOCK_CONST_METHOD3(paletteGroupDescription, QString(qReal::Id const &editor, qReal::Id const &diagram
+			, QString const &group));
+	MOCK_CONST_METHOD2(shallPaletteBeSorted, bool(qReal::Id const &editor, qReal::Id const &diagram));
+	MOCK_CONST_METHOD1(referenceProperties, QStringList(qReal::Id const &id));
+	MOCK_METHOD1(groups, qReal::IdList(qReal::Id const &diagram));
+	MOCK_CONST_METHOD1(getPatternByName, qReal::Pattern(QString const &str));
+	MOCK_CONST_METHOD0(getPatternNames, QList<QString>());
+	MOCK_CONST_METHOD1(iconSize, QSize(qReal::Id const &id));
+};
+
+}
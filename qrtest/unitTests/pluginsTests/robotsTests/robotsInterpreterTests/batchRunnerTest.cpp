@@ -0,0 +1,331 @@
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTextStream>
+#include <QtWidgets/QApplication>
+#include <gtest/gtest.h>
+
+#include <qrkernel/exception/exception.h>
+#include <qrkernel/settingsManager.h>
+#include <qrrepo/repoApi.h>
+#include <models/models.h>
+
+#include <plugins/robots/robotsInterpreter/details/batchRunner.h>
+
+#include "../../../mocks/grgui/pluginManager/editorManagerInterfaceMock.h"
+
+using namespace qReal;
+using namespace interpreters::robots::details;
+
+namespace {
+
+QString const projectFile = "batchRunnerTest.qrs";
+QString const batchFile = "batchRunnerTest.xml";
+QString const outputFile = "batchRunnerTest.txt";
+QStringList const worldFiles = QStringList() << "batchRunnerTestWorld1.xml" << "batchRunnerTestWorld2.xml";
+
+/// Writes a project with two robot diagrams, "First" and "Second", both waiting for a moment and finishing.
+class BatchRunnerTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		static int argc = 0;
+		static char *argv[] = {const_cast<char *>("")};
+		mApplication = new QApplication(argc, argv);
+
+		qrRepo::RepoApi repoApi(projectFile);
+		mFirst = addDiagram(repoApi, "First");
+		mSecond = addDiagram(repoApi, "Second");
+		repoApi.saveAll();
+
+		foreach (QString const &world, worldFiles) {
+			writeFile(world, emptyWorld());
+		}
+
+		mModels.reset(new models::Models(projectFile, mEditorManager));
+		mRunner.reset(new BatchRunner(mModels->graphicalModelAssistApi(), mModels->logicalModelAssistApi()));
+	}
+
+	void TearDown() override
+	{
+		mRunner.reset();
+		mModels.reset();
+		QFile::remove(projectFile);
+		QFile::remove(batchFile);
+		QFile::remove(outputFile);
+		foreach (QString const &world, worldFiles) {
+			QFile::remove(world);
+		}
+
+		delete mApplication;
+	}
+
+	/// Empty world with the robot at the origin looking along x axis.
+	static QString emptyWorld()
+	{
+		return "<root><world/><robot position=\"0:0\" direction=\"0\"/></root>";
+	}
+
+	static void writeFile(QString const &fileName, QString const &contents)
+	{
+		QFile file(fileName);
+		file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+		QTextStream(&file) << contents;
+	}
+
+	static QStringList readLines(QString const &fileName)
+	{
+		QFile file(fileName);
+		file.open(QIODevice::ReadOnly | QIODevice::Text);
+		return QString::fromUtf8(file.readAll()).split("\n", QString::SkipEmptyParts);
+	}
+
+	/// Adds a diagram with a program waiting for 100 ms, returns its graphical id.
+	static Id addDiagram(qrRepo::RepoApi &repoApi, QString const &name)
+	{
+		Id const logicalDiagram = Id::createElementId("RobotsMetamodel", "RobotsDiagram", "RobotsDiagramNode");
+		Id const diagram = logicalDiagram.sameTypeId();
+		repoApi.addChild(Id::rootId(), logicalDiagram);
+		repoApi.addChild(Id::rootId(), diagram, logicalDiagram);
+		repoApi.setName(diagram, name);
+		repoApi.setProperty(logicalDiagram, "worldModel", emptyWorld());
+
+		Id const initial = addBlock(repoApi, logicalDiagram, diagram, "InitialNode");
+		Id const timer = addBlock(repoApi, logicalDiagram, diagram, "Timer");
+		repoApi.setProperty(repoApi.logicalId(timer), "Delay", "100");
+		Id const finalNode = addBlock(repoApi, logicalDiagram, diagram, "FinalNode");
+
+		addLink(repoApi, logicalDiagram, diagram, initial, timer);
+		addLink(repoApi, logicalDiagram, diagram, timer, finalNode);
+		return diagram;
+	}
+
+	static Id addBlock(qrRepo::RepoApi &repoApi, Id const &logicalDiagram, Id const &diagram, QString const &type)
+	{
+		Id const logicalId = Id::createElementId("RobotsMetamodel", "RobotsDiagram", type);
+		Id const graphicalId = logicalId.sameTypeId();
+		repoApi.addChild(logicalDiagram, logicalId);
+		repoApi.addChild(diagram, graphicalId, logicalId);
+		return graphicalId;
+	}
+
+	static void addLink(qrRepo::RepoApi &repoApi, Id const &logicalDiagram, Id const &diagram
+			, Id const &from, Id const &to)
+	{
+		Id const logicalLink = Id::createElementId("RobotsMetamodel", "RobotsDiagram", "ControlFlow");
+		Id const link = logicalLink.sameTypeId();
+		repoApi.addChild(logicalDiagram, logicalLink);
+		repoApi.addChild(diagram, link, logicalLink);
+		repoApi.setFrom(link, from);
+		repoApi.setTo(link, to);
+	}
+
+	/// Writes a batch running both diagrams without and with noise of motors.
+	static void writeBatch()
+	{
+		writeFile(batchFile, "<batch timeLimit=\"1000\"><diagram name=\"First\"/><diagram name=\"Second\"/>"
+				"<noise/><noise motors=\"true\"/></batch>");
+	}
+
+	/// Returns a command line of QReal running the batch of the test.
+	static QStringList commandLine()
+	{
+		return QStringList() << "qreal" << projectFile << "--2d-batch" << batchFile
+				<< "--2d-batch-output" << outputFile;
+	}
+
+	QApplication *mApplication;
+	testing::NiceMock<qrTest::EditorManagerInterfaceMock> mEditorManager;
+	QScopedPointer<models::Models> mModels;
+	QScopedPointer<BatchRunner> mRunner;
+	Id mFirst;
+	Id mSecond;
+};
+
+}
+
+TEST_F(BatchRunnerTest, readBatchTest)
+{
+	writeFile(batchFile, QString("<batch timeLimit=\"5000\" seed=\"10\">"
+			"<diagram name=\"Second\"/><diagram name=\"First\"/>"
+			"<world file=\"%1\"/><world file=\"%2\"/>"
+			"<noise sensors=\"true\" motors=\"false\" approximationLevel=\"1\"/><noise motors=\"true\"/>"
+			"<start x=\"100\" y=\"50\" direction=\"90\"/><start x=\"-10\" y=\"20\"/>"
+			"</batch>").arg(worldFiles[0], worldFiles[1]));
+
+	QList<Experiment> const experiments = mRunner->readBatch(batchFile);
+	ASSERT_EQ(16, experiments.size());
+
+	// Diagrams vary the slowest and start poses the fastest.
+	for (int i = 0; i < experiments.size(); ++i) {
+		Experiment const &experiment = experiments[i];
+		bool const isFirstNoise = (i / 2) % 2 == 0;
+		bool const isFirstPose = i % 2 == 0;
+
+		EXPECT_EQ(i < 8 ? mSecond : mFirst, experiment.diagram) << "experiment " << i;
+		EXPECT_EQ(QFileInfo(worldFiles[(i / 4) % 2]).absoluteFilePath(), experiment.worldFile) << "experiment " << i;
+		EXPECT_EQ(isFirstNoise, experiment.sensorNoise) << "experiment " << i;
+		EXPECT_EQ(!isFirstNoise, experiment.motorNoise) << "experiment " << i;
+		EXPECT_EQ(isFirstNoise ? 1 : 0, experiment.approximationLevel) << "experiment " << i;
+		EXPECT_TRUE(experiment.hasStartPose) << "experiment " << i;
+		EXPECT_EQ(isFirstPose ? QPointF(100, 50) : QPointF(-10, 20), experiment.startPosition) << "experiment " << i;
+		EXPECT_EQ(isFirstPose ? 90.0 : 0.0, experiment.startDirection) << "experiment " << i;
+		EXPECT_EQ(5000u, experiment.timeLimit) << "experiment " << i;
+
+		// Every experiment is seeded differently, but the same batch is seeded the same way every time.
+		EXPECT_EQ(10u + i, experiment.noiseSeed) << "experiment " << i;
+	}
+}
+
+TEST_F(BatchRunnerTest, readBatchDefaultsTest)
+{
+	QVariant const sensorNoise = SettingsManager::value("enableNoiseOfSensors");
+	QVariant const motorNoise = SettingsManager::value("enableNoiseOfMotors");
+	QVariant const approximationLevel = SettingsManager::value("approximationLevel");
+	SettingsManager::setValue("enableNoiseOfSensors", false);
+	SettingsManager::setValue("enableNoiseOfMotors", true);
+	SettingsManager::setValue("approximationLevel", 3);
+	writeFile(batchFile, "<batch/>");
+
+	QList<Experiment> const experiments = mRunner->readBatch(batchFile);
+	SettingsManager::setValue("enableNoiseOfSensors", sensorNoise);
+	SettingsManager::setValue("enableNoiseOfMotors", motorNoise);
+	SettingsManager::setValue("approximationLevel", approximationLevel);
+
+	// Every robot diagram of the project is run in the world saved in it with current noise settings.
+	ASSERT_EQ(2, experiments.size());
+	EXPECT_EQ(QSet<Id>() << mFirst << mSecond, QSet<Id>() << experiments[0].diagram << experiments[1].diagram);
+	for (int i = 0; i < experiments.size(); ++i) {
+		EXPECT_TRUE(experiments[i].worldFile.isEmpty()) << "experiment " << i;
+		EXPECT_FALSE(experiments[i].sensorNoise) << "experiment " << i;
+		EXPECT_TRUE(experiments[i].motorNoise) << "experiment " << i;
+		EXPECT_EQ(3, experiments[i].approximationLevel) << "experiment " << i;
+		EXPECT_FALSE(experiments[i].hasStartPose) << "experiment " << i;
+		EXPECT_EQ(60000u, experiments[i].timeLimit) << "experiment " << i;
+		EXPECT_EQ(1u + i, experiments[i].noiseSeed) << "experiment " << i;
+	}
+}
+
+TEST_F(BatchRunnerTest, readBatchErrorsTest)
+{
+	EXPECT_THROW(mRunner->readBatch(batchFile), Exception) << "missing batch";
+
+	writeFile(batchFile, emptyWorld());
+	EXPECT_THROW(mRunner->readBatch(batchFile), Exception) << "not a batch";
+
+	writeFile(batchFile, "<batch><diagram name=\"First\"/><diagram name=\"Third\"/></batch>");
+	EXPECT_THROW(mRunner->readBatch(batchFile), Exception) << "unknown diagram";
+
+	writeFile(batchFile, QString("<batch><world file=\"%1\"/><world file=\"missing.xml\"/></batch>")
+			.arg(worldFiles[0]));
+	EXPECT_THROW(mRunner->readBatch(batchFile), Exception) << "missing world";
+}
+
+TEST_F(BatchRunnerTest, workerShareTest)
+{
+	EXPECT_EQ(QList<int>() << 0 << 3 << 6, BatchRunner::workerShare(7, 3, 0));
+	EXPECT_EQ(QList<int>() << 1 << 4, BatchRunner::workerShare(7, 3, 1));
+	EXPECT_EQ(QList<int>() << 2 << 5, BatchRunner::workerShare(7, 3, 2));
+	EXPECT_TRUE(BatchRunner::workerShare(2, 3, 2).isEmpty());
+	EXPECT_EQ(QList<int>() << 0 << 1 << 2, BatchRunner::workerShare(3, 1, 0));
+}
+
+TEST_F(BatchRunnerTest, mergeWorkerOutputsTest)
+{
+	QList<Experiment> experiments;
+	for (int i = 0; i < 6; ++i) {
+		Experiment experiment;
+		experiment.diagram = i % 2 == 0 ? mFirst : mSecond;
+		experiment.noiseSeed = i + 1;
+		experiments << experiment;
+	}
+
+	// The first worker has run all its experiments, the second has failed without any output
+	// and the third has been killed after the first experiment.
+	QStringList const outputs = QStringList() << "batchRunnerTest0.txt" << "batchRunnerTest1.txt"
+			<< "batchRunnerTest2.txt";
+	writeFile(outputs[0], "3\trow 3\n0\trow 0\n");
+	writeFile(outputs[2], "2\trow 2\n");
+
+	QStringList const rows = mRunner->mergeWorkerOutputs(experiments, outputs, QSet<int>() << 2);
+	ASSERT_EQ(experiments.size(), rows.size());
+	EXPECT_EQ("row 0", rows[0]);
+	EXPECT_EQ("row 2", rows[2]);
+	EXPECT_EQ("row 3", rows[3]);
+
+	HeadlessRunResult failed;
+	failed.errors << QObject::tr("Worker process failed");
+	EXPECT_EQ(mRunner->tableRow(experiments[1], failed), rows[1]);
+	EXPECT_EQ(mRunner->tableRow(experiments[4], failed), rows[4]);
+
+	HeadlessRunResult killed;
+	killed.errors << QObject::tr("Worker process did not finish in time and was killed");
+	EXPECT_EQ(mRunner->tableRow(experiments[5], killed), rows[5]);
+
+	foreach (QString const &output, outputs) {
+		EXPECT_FALSE(QFile::exists(output)) << output.toStdString();
+	}
+}
+
+TEST_F(BatchRunnerTest, tableRowTest)
+{
+	Experiment experiment;
+	experiment.diagram = mFirst;
+	experiment.worldFile = "maze\t1.xml";
+	experiment.noiseSeed = 7;
+
+	HeadlessRunResult result;
+	result.finished = true;
+	result.time = 100;
+	result.errors << "Unknown\tblock" << "Line\nbreak";
+
+	// Tabs and line breaks of texts do not split the row.
+	QStringList const row = mRunner->tableRow(experiment, result).split("\t");
+	ASSERT_EQ(BatchRunner::tableHeader().split("\t").size(), row.size());
+	EXPECT_EQ("First", row[0]);
+	EXPECT_EQ("maze 1.xml", row[1]);
+	EXPECT_EQ("7", row[5]);
+	EXPECT_EQ(QStringList() << "" << "" << "", row.mid(6, 3)) << "start pose saved in the world";
+	EXPECT_EQ("1", row[9]);
+	EXPECT_EQ("100", row[10]);
+	EXPECT_EQ("Unknown block; Line break", row.last());
+}
+
+TEST_F(BatchRunnerTest, runFromCommandLineTest)
+{
+	writeBatch();
+	ASSERT_EQ(0, mRunner->runFromCommandLine(commandLine() << "--2d-batch-jobs" << "1"));
+
+	QStringList const lines = readLines(outputFile);
+	ASSERT_EQ(5, lines.size());
+	EXPECT_EQ(BatchRunner::tableHeader(), lines[0]);
+	for (int i = 1; i < lines.size(); ++i) {
+		QStringList const row = lines[i].split("\t");
+		EXPECT_EQ(i <= 2 ? "First" : "Second", row[0]) << "line " << i;
+		EXPECT_EQ(i % 2 == 0 ? "1" : "0", row[3]) << "motor noise, line " << i;
+		EXPECT_EQ(QString::number(i), row[5]) << "noise seed, line " << i;
+		EXPECT_EQ("1", row[9]) << "finished, line " << i;
+		EXPECT_TRUE(row.last().isEmpty()) << "errors, line " << i;
+	}
+}
+
+TEST_F(BatchRunnerTest, workerTest)
+{
+	writeBatch();
+	ASSERT_EQ(0, mRunner->runFromCommandLine(commandLine() << "--2d-batch-jobs" << "1"));
+	QStringList const expected = readLines(outputFile);
+
+	// A worker writes rows of its experiments only, each marked with the number of the experiment.
+	ASSERT_EQ(0, mRunner->runFromCommandLine(commandLine() << "--2d-batch-jobs" << "3" << "--2d-batch-worker" << "1"));
+
+	QStringList const lines = readLines(outputFile);
+	ASSERT_EQ(1, lines.size());
+	EXPECT_EQ("1\t" + expected[2], lines[0]);
+}
+
+TEST_F(BatchRunnerTest, invalidBatchTest)
+{
+	writeFile(batchFile, "<batch><diagram name=\"Third\"/></batch>");
+	EXPECT_EQ(1, mRunner->runFromCommandLine(commandLine() << "--2d-batch-jobs" << "1"));
+	EXPECT_FALSE(QFile::exists(outputFile));
+}
@@ -0,0 +1,151 @@
+#include <QtCore/QFile>
+#include <QtWidgets/QApplication>
+#include <gtest/gtest.h>
+
+#include <qrkernel/settingsManager.h>
+#include <qrrepo/repoApi.h>
+#include <models/models.h>
+
+#include <plugins/robots/robotsInterpreter/sensorConstants.h>
+#include <plugins/robots/robotsInterpreter/details/headlessRunner.h>
+
+#include "../../../mocks/grgui/pluginManager/editorManagerInterfaceMock.h"
+
+using namespace qReal;
+using namespace interpreters::robots::details;
+
+namespace {
+
+QString const projectFile = "headlessRunnerTest.qrs";
+Id const logicalDiagram("RobotsMetamodel", "RobotsDiagram", "RobotsDiagramNode", "logicalDiagram");
+Id const diagram("RobotsMetamodel", "RobotsDiagram", "RobotsDiagramNode", "diagram");
+
+/// Writes a project with a program which drives forward for a second and stops.
+class HeadlessRunnerTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		static int argc = 0;
+		static char *argv[] = {const_cast<char *>("")};
+		mApplication = new QApplication(argc, argv);
+
+		qrRepo::RepoApi repoApi(projectFile);
+		repoApi.addChild(Id::rootId(), logicalDiagram);
+		repoApi.addChild(Id::rootId(), diagram, logicalDiagram);
+
+		Id const initial = addBlock(repoApi, "InitialNode");
+		Id const forward = addBlock(repoApi, "EnginesForward");
+		setProperty(repoApi, forward, "Ports", "B, C");
+		setProperty(repoApi, forward, "Power", "100");
+		Id const timer = addBlock(repoApi, "Timer");
+		setProperty(repoApi, timer, "Delay", "1000");
+		Id const stop = addBlock(repoApi, "EnginesStop");
+		setProperty(repoApi, stop, "Ports", "B, C");
+		Id const finalNode = addBlock(repoApi, "FinalNode");
+
+		addLink(repoApi, initial, forward);
+		addLink(repoApi, forward, timer);
+		addLink(repoApi, timer, stop);
+		addLink(repoApi, stop, finalNode);
+		repoApi.saveAll();
+
+		mModels.reset(new models::Models(projectFile, mEditorManager));
+	}
+
+	void TearDown() override
+	{
+		mModels.reset();
+		QFile::remove(projectFile);
+		delete mApplication;
+	}
+
+	/// Empty world with the robot at the origin looking along x axis.
+	static QDomDocument emptyWorld()
+	{
+		QDomDocument world;
+		world.setContent(QString("<root><world/><robot position=\"0:0\" direction=\"0\"/></root>"));
+		return world;
+	}
+
+	Id addBlock(qrRepo::RepoApi &repoApi, QString const &type)
+	{
+		Id const logicalId = Id::createElementId("RobotsMetamodel", "RobotsDiagram", type);
+		Id const graphicalId = logicalId.sameTypeId();
+		repoApi.addChild(logicalDiagram, logicalId);
+		repoApi.addChild(diagram, graphicalId, logicalId);
+		return graphicalId;
+	}
+
+	void setProperty(qrRepo::RepoApi &repoApi, Id const &block, QString const &name, QString const &value)
+	{
+		repoApi.setProperty(repoApi.logicalId(block), name, value);
+	}
+
+	void addLink(qrRepo::RepoApi &repoApi, Id const &from, Id const &to)
+	{
+		Id const logicalLink = Id::createElementId("RobotsMetamodel", "RobotsDiagram", "ControlFlow");
+		Id const link = logicalLink.sameTypeId();
+		repoApi.addChild(logicalDiagram, logicalLink);
+		repoApi.addChild(diagram, link, logicalLink);
+		repoApi.setFrom(link, from);
+		repoApi.setTo(link, to);
+	}
+
+	QApplication *mApplication;
+	testing::NiceMock<qrTest::EditorManagerInterfaceMock> mEditorManager;
+	QScopedPointer<models::Models> mModels;
+};
+
+}
+
+TEST_F(HeadlessRunnerTest, emptyWorldTest)
+{
+	int const sonar = interpreters::robots::enums::sensorType::sonar;
+	SettingsManager::setValue("port1SensorType", sonar);
+
+	HeadlessRunner runner(mModels->graphicalModelAssistApi(), mModels->logicalModelAssistApi());
+	HeadlessRunResult const result = runner.run(diagram, emptyWorld());
+
+	ASSERT_TRUE(result.errors.isEmpty()) << result.errors.join("\n").toStdString();
+	ASSERT_TRUE(result.finished);
+	EXPECT_GE(result.time, 1000u);
+	EXPECT_LT(result.time, 2000u);
+	EXPECT_EQ(0, result.collisions);
+	EXPECT_FALSE(result.trace.isEmpty());
+
+	// Both motors have the same power, so the robot drives straight along x axis.
+	EXPECT_GT(result.position.x(), 10);
+	EXPECT_NEAR(0, result.position.y(), 0.001);
+	EXPECT_NEAR(0, result.direction, 0.001);
+
+	// Sensors of the diagram are set for the run only.
+	EXPECT_EQ(sonar, SettingsManager::value("port1SensorType").toInt());
+
+	// The clock of 2D model is virtual, so the same program ends in the same place.
+	HeadlessRunResult const repeated = runner.run(diagram, emptyWorld());
+	EXPECT_EQ(result.time, repeated.time);
+	EXPECT_EQ(result.position, repeated.position);
+	EXPECT_EQ(result.direction, repeated.direction);
+}
+
+TEST_F(HeadlessRunnerTest, noiseSeedTest)
+{
+	SettingsManager::setValue("enableNoiseOfMotors", true);
+	HeadlessRunner runner(mModels->graphicalModelAssistApi(), mModels->logicalModelAssistApi());
+
+	runner.setNoiseSeed(1);
+	HeadlessRunResult const first = runner.run(diagram, emptyWorld());
+	HeadlessRunResult const repeated = runner.run(diagram, emptyWorld());
+	runner.setNoiseSeed(2);
+	HeadlessRunResult const reseeded = runner.run(diagram, emptyWorld());
+	SettingsManager::setValue("enableNoiseOfMotors", false);
+
+	ASSERT_TRUE(first.finished);
+	ASSERT_TRUE(reseeded.finished);
+
+	// Noise is repeated with the same seed only, so experiments of a batch seeded differently differ.
+	EXPECT_EQ(first.position, repeated.position);
+	EXPECT_EQ(first.direction, repeated.direction);
+	EXPECT_NE(first.position, reseeded.position);
+}
@@ -0,0 +1,235 @@
+#include <QtCore/QFile>
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include <qrkernel/exception/exception.h>
+#include <plugins/robots/robotsInterpreter/details/interpreterTrace.h>
+
+using namespace qReal;
+using namespace interpreters::robots;
+using namespace interpreters::robots::details;
+
+namespace {
+
+QString const traceFile = "interpreterTraceTest.trace";
+
+class InterpreterTraceTest : public testing::Test
+{
+protected:
+	void TearDown() override
+	{
+		QFile::remove(traceFile);
+	}
+
+	/// Returns contents of the saved trace.
+	static QByteArray fileContents()
+	{
+		QFile file(traceFile);
+		file.open(QIODevice::ReadOnly);
+		return file.readAll();
+	}
+
+	static void setFileContents(QByteArray const &contents)
+	{
+		QFile file(traceFile);
+		file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+		file.write(contents);
+	}
+
+	/// Replaces a byte of the saved trace, counting from the end of the file.
+	static void setByteFromEnd(int offset, char value)
+	{
+		QByteArray contents = fileContents();
+		contents[contents.size() - offset] = value;
+		setFileContents(contents);
+	}
+
+	/// Saves a trace with a single event at 5 ms. The event is at the end of the file: a byte of the type, the time
+	/// and the source, then the reading for sensor responses, one byte each.
+	static void saveSingleEvent(TraceEvent::Type type)
+	{
+		InterpreterTrace trace;
+		switch (type) {
+		case TraceEvent::sensorResponse:
+			trace.addSensorResponse(5, 1, 2);
+			break;
+		case TraceEvent::timerTimeout:
+			trace.addTimerTimeout(5, 2);
+			break;
+		case TraceEvent::blockStarted:
+			trace.addBlockStarted(5, Id("RobotsMetamodel", "RobotsDiagram", "Timer", "timer"));
+			break;
+		}
+
+		trace.save(traceFile);
+	}
+};
+
+}
+
+TEST_F(InterpreterTraceTest, roundTripTest)
+{
+	Id const diagram("RobotsMetamodel", "RobotsDiagram", "RobotsDiagramNode", "diagram");
+	Id const initial("RobotsMetamodel", "RobotsDiagram", "InitialNode", "initial");
+	Id const timer("RobotsMetamodel", "RobotsDiagram", "Timer", "timer");
+	int const minReading = std::numeric_limits<int>::min();
+	int const maxReading = std::numeric_limits<int>::max();
+
+	InterpreterTrace trace;
+	trace.setDiagram(diagram);
+	trace.setSensorType(enums::inputPort::port1, enums::sensorType::sonar);
+	trace.setSensorType(enums::inputPort::port3, enums::sensorType::colorFull);
+	trace.setFinished(true);
+
+	// Times and readings around the boundaries of one, two and more bytes of varints and zigzag encoding.
+	trace.addBlockStarted(0, initial);
+	trace.addSensorResponse(0, 0, 0);
+	trace.addSensorResponse(127, 1, -1);
+	trace.addSensorResponse(128, 2, 63);
+	trace.addSensorResponse(128, 3, -64);
+	trace.addSensorResponse(16511, TraceEvent::encoderA, 64);
+	trace.addSensorResponse(16512, TraceEvent::encoderB, -65);
+	trace.addSensorResponse(1ull << 40, TraceEvent::encoderC, maxReading);
+	trace.addSensorResponse((1ull << 40) + 1, 0, minReading);
+	trace.addSensorResponse((1ull << 40) + 300, 1, -300000);
+	trace.addTimerTimeout((1ull << 40) + 1000, 0);
+	trace.addTimerTimeout((1ull << 40) + 1000, 200);
+	trace.addBlockStarted((1ull << 40) + 1000, timer);
+	trace.addBlockStarted((1ull << 40) + 2000, initial);
+	trace.save(traceFile);
+
+	InterpreterTrace loaded;
+	loaded.addTimerTimeout(1, 1);
+	loaded.load(traceFile);
+
+	EXPECT_EQ(diagram, loaded.diagram());
+	EXPECT_EQ(enums::sensorType::sonar, loaded.sensorType(enums::inputPort::port1));
+	EXPECT_EQ(enums::sensorType::unused, loaded.sensorType(enums::inputPort::port2));
+	EXPECT_EQ(enums::sensorType::colorFull, loaded.sensorType(enums::inputPort::port3));
+	EXPECT_EQ(enums::sensorType::unused, loaded.sensorType(enums::inputPort::port4));
+	EXPECT_TRUE(loaded.finished());
+
+	ASSERT_EQ(trace.events().size(), loaded.events().size());
+	for (int i = 0; i < trace.events().size(); ++i) {
+		TraceEvent const &expected = trace.events()[i];
+		TraceEvent const &actual = loaded.events()[i];
+		EXPECT_EQ(expected.type, actual.type) << "event " << i;
+		EXPECT_EQ(expected.time, actual.time) << "event " << i;
+		EXPECT_EQ(expected.source, actual.source) << "event " << i;
+		EXPECT_EQ(expected.value, actual.value) << "event " << i;
+	}
+
+	EXPECT_EQ(initial, loaded.block(loaded.events().first().source));
+	EXPECT_EQ(timer, loaded.block(loaded.events()[loaded.events().size() - 2].source));
+	EXPECT_EQ(initial, loaded.block(loaded.events().last().source));
+}
+
+TEST_F(InterpreterTraceTest, compactEventsTest)
+{
+	saveSingleEvent(TraceEvent::sensorResponse);
+	int const singleEventSize = fileContents().size();
+
+	// Small readings coming often take a byte for the type and a byte for each number.
+	InterpreterTrace trace;
+	for (int i = 1; i <= 100; ++i) {
+		trace.addSensorResponse(25 * i, i % 4, i % 2 == 0 ? 60 : -60);
+	}
+
+	trace.save(traceFile);
+	EXPECT_EQ(singleEventSize + 99 * 4, fileContents().size());
+}
+
+TEST_F(InterpreterTraceTest, missingFileTest)
+{
+	InterpreterTrace trace;
+	EXPECT_THROW(trace.load(traceFile), Exception);
+}
+
+TEST_F(InterpreterTraceTest, notTraceTest)
+{
+	setFileContents("<root><world/></root>");
+	InterpreterTrace trace;
+	EXPECT_THROW(trace.load(traceFile), Exception);
+
+	saveSingleEvent(TraceEvent::timerTimeout);
+	QByteArray contents = fileContents();
+	contents[0] = 'X';
+	setFileContents(contents);
+	EXPECT_THROW(trace.load(traceFile), Exception);
+}
+
+TEST_F(InterpreterTraceTest, truncatedFileTest)
+{
+	saveSingleEvent(TraceEvent::sensorResponse);
+	QByteArray const contents = fileContents();
+
+	InterpreterTrace trace;
+	for (int size = 0; size < contents.size(); ++size) {
+		setFileContents(contents.left(size));
+		EXPECT_THROW(trace.load(traceFile), Exception) << "of " << size << " bytes";
+	}
+
+	setFileContents(contents);
+	EXPECT_NO_THROW(trace.load(traceFile));
+}
+
+TEST_F(InterpreterTraceTest, truncatedEventsTest)
+{
+	// Count of events precedes the events and the size of their data.
+	saveSingleEvent(TraceEvent::timerTimeout);
+	setByteFromEnd(3 + 4 + 1, 2);
+	InterpreterTrace trace;
+	EXPECT_THROW(trace.load(traceFile), Exception);
+
+	// The last number of the event is cut: its last byte says that more bytes follow.
+	saveSingleEvent(TraceEvent::timerTimeout);
+	setByteFromEnd(1, static_cast<char>(0x82));
+	EXPECT_THROW(trace.load(traceFile), Exception);
+}
+
+TEST_F(InterpreterTraceTest, corruptedEventsTest)
+{
+	InterpreterTrace trace;
+
+	saveSingleEvent(TraceEvent::timerTimeout);
+	setByteFromEnd(3, 7);
+	EXPECT_THROW(trace.load(traceFile), Exception) << "unknown type of event";
+
+	saveSingleEvent(TraceEvent::blockStarted);
+	setByteFromEnd(1, 1);
+	EXPECT_THROW(trace.load(traceFile), Exception) << "reference to a missing block";
+
+	// More than 64 bits of a number.
+	saveSingleEvent(TraceEvent::timerTimeout);
+	QByteArray contents = fileContents();
+	QByteArray const tooLong(10, static_cast<char>(0xff));
+	contents.replace(contents.size() - 2, 2, tooLong + QByteArray(1, 1));
+	int const eventsSizeOffset = contents.size() - tooLong.size() - 2 - 4;
+	contents[eventsSizeOffset + 3] = static_cast<char>(contents[eventsSizeOffset + 3] + tooLong.size() - 1);
+	setFileContents(contents);
+	EXPECT_THROW(trace.load(traceFile), Exception) << "too long number";
+}
+
+TEST_F(InterpreterTraceTest, failedLoadTest)
+{
+	Id const diagram("RobotsMetamodel", "RobotsDiagram", "RobotsDiagramNode", "diagram");
+	Id const timer("RobotsMetamodel", "RobotsDiagram", "Timer", "timer");
+
+	InterpreterTrace trace;
+	trace.setDiagram(diagram);
+	trace.setSensorType(enums::inputPort::port2, enums::sensorType::touchBoolean);
+	trace.addBlockStarted(1, timer);
+	trace.addSensorResponse(2, 1, 42);
+
+	// The header of a corrupted file is read fine, the error is found among its events.
+	saveSingleEvent(TraceEvent::timerTimeout);
+	setByteFromEnd(3, 7);
+	EXPECT_THROW(trace.load(traceFile), Exception);
+
+	EXPECT_EQ(diagram, trace.diagram());
+	EXPECT_EQ(enums::sensorType::touchBoolean, trace.sensorType(enums::inputPort::port2));
+	ASSERT_EQ(2, trace.events().size());
+	EXPECT_EQ(timer, trace.block(trace.events().first().source));
+	EXPECT_EQ(42, trace.events().last().value);
+}
@@ -0,0 +1,197 @@
+#include <QtCore/QFile>
+#include <QtWidgets/QApplication>
+#include <gtest/gtest.h>
+
+#include <qrrepo/repoApi.h>
+#include <models/models.h>
+
+#include <plugins/robots/robotsInterpreter/sensorConstants.h>
+#include <plugins/robots/robotsInterpreter/details/headlessRunner.h>
+#include <plugins/robots/robotsInterpreter/details/replayRunner.h>
+
+#include "../../../mocks/grgui/pluginManager/editorManagerInterfaceMock.h"
+
+using namespace qReal;
+using namespace interpreters::robots;
+using namespace interpreters::robots::details;
+
+namespace {
+
+QString const projectFile = "replayRunnerTest.qrs";
+Id const logicalDiagram("RobotsMetamodel", "RobotsDiagram", "RobotsDiagramNode", "logicalDiagram");
+Id const diagram("RobotsMetamodel", "RobotsDiagram", "RobotsDiagramNode", "diagram");
+
+/// Writes a project with a program which waits for a while and then drives forward if the sonar sees
+/// nothing near or stops otherwise. The trace of a run of the program is recorded on 2D model.
+class ReplayRunnerTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		static int argc = 0;
+		static char *argv[] = {const_cast<char *>("")};
+		mApplication = new QApplication(argc, argv);
+
+		qrRepo::RepoApi repoApi(projectFile);
+		repoApi.addChild(Id::rootId(), logicalDiagram);
+		repoApi.addChild(Id::rootId(), diagram, logicalDiagram);
+		repoApi.setProperty(logicalDiagram, "sensor1Value", static_cast<int>(enums::sensorType::sonar));
+		repoApi.setProperty(logicalDiagram, "worldModel"
+				, "<root><world/><robot position=\"0:0\" direction=\"0\"/></root>");
+
+		Id const initial = addBlock(repoApi, "InitialNode");
+		Id const timer = addBlock(repoApi, "Timer");
+		setProperty(repoApi, timer, "Delay", "100");
+		mIf = addBlock(repoApi, "IfBlock");
+		setProperty(repoApi, mIf, "Condition", "Sensor1 > 50");
+		Id const forward = addBlock(repoApi, "EnginesForward");
+		setProperty(repoApi, forward, "Ports", "B, C");
+		setProperty(repoApi, forward, "Power", "100");
+		Id const driving = addBlock(repoApi, "Timer");
+		setProperty(repoApi, driving, "Delay", "100");
+		Id const stop = addBlock(repoApi, "EnginesStop");
+		setProperty(repoApi, stop, "Ports", "B, C");
+		Id const finalNode = addBlock(repoApi, "FinalNode");
+
+		addLink(repoApi, initial, timer);
+		addLink(repoApi, timer, mIf);
+		addLink(repoApi, mIf, forward, QString::fromUtf8("истина"));
+		addLink(repoApi, mIf, stop, QString::fromUtf8("ложь"));
+		addLink(repoApi, forward, driving);
+		addLink(repoApi, driving, stop);
+		addLink(repoApi, stop, finalNode);
+		repoApi.saveAll();
+
+		mModels.reset(new models::Models(projectFile, mEditorManager));
+	}
+
+	void TearDown() override
+	{
+		mModels.reset();
+		QFile::remove(projectFile);
+		delete mApplication;
+	}
+
+	/// Runs the program on 2D model and returns its trace.
+	InterpreterTrace record()
+	{
+		HeadlessRunner runner(mModels->graphicalModelAssistApi(), mModels->logicalModelAssistApi());
+		runner.setRecording(true);
+		HeadlessRunResult const result = runner.run(diagram);
+		EXPECT_TRUE(result.errors.isEmpty()) << result.errors.join("\n").toStdString();
+		EXPECT_TRUE(result.finished);
+		return result.interpreterTrace;
+	}
+
+	ReplayResult replay(InterpreterTrace const &trace)
+	{
+		ReplayRunner runner(mModels->graphicalModelAssistApi(), mModels->logicalModelAssistApi());
+		return runner.run(trace);
+	}
+
+	Id addBlock(qrRepo::RepoApi &repoApi, QString const &type)
+	{
+		Id const logicalId = Id::createElementId("RobotsMetamodel", "RobotsDiagram", type);
+		Id const graphicalId = logicalId.sameTypeId();
+		repoApi.addChild(logicalDiagram, logicalId);
+		repoApi.addChild(diagram, graphicalId, logicalId);
+		return graphicalId;
+	}
+
+	void setProperty(qrRepo::RepoApi &repoApi, Id const &element, QString const &name, QString const &value)
+	{
+		repoApi.setProperty(repoApi.logicalId(element), name, value);
+	}
+
+	void addLink(qrRepo::RepoApi &repoApi, Id const &from, Id const &to, QString const &guard = QString())
+	{
+		Id const logicalLink = Id::createElementId("RobotsMetamodel", "RobotsDiagram", "ControlFlow");
+		Id const link = logicalLink.sameTypeId();
+		repoApi.addChild(logicalDiagram, logicalLink);
+		repoApi.addChild(diagram, link, logicalLink);
+		repoApi.setFrom(link, from);
+		repoApi.setTo(link, to);
+		if (!guard.isEmpty()) {
+			repoApi.setProperty(logicalLink, "Guard", guard);
+		}
+	}
+
+	QApplication *mApplication;
+	testing::NiceMock<qrTest::EditorManagerInterfaceMock> mEditorManager;
+	QScopedPointer<models::Models> mModels;
+	Id mIf;
+};
+
+}
+
+TEST_F(ReplayRunnerTest, reproducedRunTest)
+{
+	InterpreterTrace const trace = record();
+	ASSERT_TRUE(trace.finished());
+	EXPECT_EQ(diagram, trace.diagram());
+	EXPECT_EQ(enums::sensorType::sonar, trace.sensorType(enums::inputPort::port1));
+
+	bool hasReadings = false;
+	bool hasTimeouts = false;
+	foreach (TraceEvent const &event, trace.events()) {
+		hasReadings |= event.type == TraceEvent::sensorResponse && event.source == 0;
+		hasTimeouts |= event.type == TraceEvent::timerTimeout;
+	}
+
+	EXPECT_TRUE(hasReadings);
+	EXPECT_TRUE(hasTimeouts);
+
+	ReplayResult const result = replay(trace);
+	EXPECT_TRUE(result.reproduced) << result.divergence.toStdString();
+	EXPECT_TRUE(result.divergence.isEmpty());
+	EXPECT_TRUE(result.errors.isEmpty()) << result.errors.join("\n").toStdString();
+	EXPECT_EQ(trace.events().size(), result.eventsReplayed);
+}
+
+TEST_F(ReplayRunnerTest, changedReadingTest)
+{
+	InterpreterTrace const recorded = record();
+	QList<TraceEvent> const &events = recorded.events();
+
+	// The branch is chosen by the last reading of the sonar before the condition is checked.
+	int ifEvent = -1;
+	int lastReading = -1;
+	for (int i = 0; i < events.size() && ifEvent == -1; ++i) {
+		if (events[i].type == TraceEvent::blockStarted && recorded.block(events[i].source) == mIf) {
+			ifEvent = i;
+		} else if (events[i].type == TraceEvent::sensorResponse && events[i].source == 0) {
+			lastReading = i;
+		}
+	}
+
+	ASSERT_NE(-1, ifEvent);
+	ASSERT_NE(-1, lastReading);
+	ASSERT_LT(ifEvent + 1, events.size());
+
+	InterpreterTrace changed;
+	changed.setDiagram(recorded.diagram());
+	changed.setSensorType(enums::inputPort::port1, recorded.sensorType(enums::inputPort::port1));
+	changed.setFinished(recorded.finished());
+	for (int i = 0; i < events.size(); ++i) {
+		TraceEvent const &event = events[i];
+		switch (event.type) {
+		case TraceEvent::sensorResponse:
+			changed.addSensorResponse(event.time, event.source
+					, i != lastReading ? event.value : event.value > 50 ? 0 : 255);
+			break;
+		case TraceEvent::timerTimeout:
+			changed.addTimerTimeout(event.time, event.source);
+			break;
+		case TraceEvent::blockStarted:
+			changed.addBlockStarted(event.time, recorded.block(event.source));
+			break;
+		}
+	}
+
+	// The other branch starts right after the condition instead of the recorded one.
+	ReplayResult const result = replay(changed);
+	EXPECT_FALSE(result.reproduced);
+	EXPECT_FALSE(result.divergence.isEmpty());
+	EXPECT_EQ(ifEvent + 1, result.eventsReplayed) << result.divergence.toStdString();
+	EXPECT_EQ(events[ifEvent].time, result.time);
+}
@@ -0,0 +1,18 @@
+TARGET = robotsInterpreter_unittests
+
+INCLUDEPATH += \
+	# Generated .ui files of qrgui include other files by relative path based on qrgui/.ui \
+	../../../../../qrgui/icons \
+
+include(../../../common.pri)
+
+include(../../../../../qrgui/qrgui.pri)
+
+include(../../../../../plugins/robots/robotsInterpreter/robotsInterpreter.pri)
+
+SOURCES += \
+	batchRunnerTest.cpp \
+	headlessRunnerTest.cpp \
+	interpreterTraceTest.cpp \
+	replayRunnerTest.cpp \
+	worldModelTest.cpp \
@@ -0,0 +1,301 @@
+#include <QtCore/QHash>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <QtGui/QPainterPathStroker>
+#include <QtGui/QTransform>
+#include <QtWidgets/QApplication>
+#include <QtWidgets/QGraphicsScene>
+#include <gtest/gtest.h>
+
+#include <plugins/robots/robotsInterpreter/details/d2RobotModel/worldModel.h>
+#include <plugins/robots/robotsInterpreter/details/d2RobotModel/wallItem.h>
+#include <plugins/robots/robotsInterpreter/details/d2RobotModel/lineItem.h>
+#include <plugins/robots/robotsInterpreter/details/d2RobotModel/ellipseItem.h>
+#include <plugins/robots/robotsInterpreter/details/d2RobotModel/stylusItem.h>
+
+using namespace qReal::interpreters::robots::details::d2Model;
+
+namespace {
+
+/// Side of the square of floor a color or light sensor sees, in pixels.
+int const sensorWidth = 12;
+
+int const maxSonarRangeCms = 255;
+
+/// All walls as one path, the way WorldModel checked them before the grid.
+QPainterPath wallPath(QList<WallItem *> const &walls)
+{
+	QPainterPath result;
+	foreach (WallItem * const wall, walls) {
+		result.moveTo(wall->begin());
+		result.lineTo(wall->end());
+	}
+
+	return result;
+}
+
+/// Sonar reading as WorldModel computed it before the grid: the least range whose sector touches walls,
+/// found by bisection.
+int referenceSonarReading(WorldModel const &worldModel, QPointF const &position, qreal direction)
+{
+	QPainterPath const walls = wallPath(worldModel.walls());
+	auto reaches = [&](int range) {
+		return worldModel.sonarScanningRegion(position, direction, range).intersects(walls);
+	};
+
+	if (!reaches(maxSonarRangeCms)) {
+		return maxSonarRangeCms;
+	}
+
+	int min = 0;
+	int max = maxSonarRangeCms;
+	while (min < max) {
+		int const middle = (min + max) / 2;
+		if (reaches(middle)) {
+			max = middle;
+		} else {
+			min = middle + 1;
+		}
+	}
+
+	return min;
+}
+
+/// Collision check as WorldModel did it before the grid: walls stroked by given width intersected with the robot.
+bool referenceCheckCollision(WorldModel const &worldModel, QPainterPath const &robotPath, int stroke)
+{
+	QPainterPathStroker stroker;
+	stroker.setWidth(stroke);
+	return stroker.createStroke(wallPath(worldModel.walls())).intersects(robotPath);
+}
+
+/// Outline of the robot body at given position and direction.
+QPainterPath robotPath(QPointF const &position, qreal direction)
+{
+	QPainterPath path;
+	path.addRect(-25, -25, 50, 50);
+	return QTransform().translate(position.x(), position.y()).rotate(direction).map(path);
+}
+
+/// World model with its items placed on a scene, so the scene can render what the model rasterizes itself.
+class WorldModelTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		static int argc = 0;
+		static char *argv[] = {const_cast<char *>("")};
+		mApplication = new QApplication(argc, argv);
+		mScene = new QGraphicsScene();
+	}
+
+	void TearDown() override
+	{
+		// Items belong to the scene.
+		mWorldModel.clearScene();
+		delete mScene;
+		delete mApplication;
+	}
+
+	void addWall(QPointF const &begin, QPointF const &end)
+	{
+		WallItem * const wall = new WallItem(begin, end);
+		mScene->addItem(wall);
+		mWorldModel.addWall(wall);
+	}
+
+	void addColorField(ColorFieldItem * const colorField, QString const &color, int width, bool filled = false)
+	{
+		colorField->setPenBrush("Solid", width, color, filled ? "Solid" : "None", color);
+		mScene->addItem(colorField);
+		mWorldModel.addColorField(colorField);
+	}
+
+	/// A trace of the stylus, a zigzag of given color starting at given point.
+	void addStylus(QPointF const &start, QString const &color, int width)
+	{
+		StylusItem * const stylus = new StylusItem(start.x(), start.y());
+		stylus->setPenBrush("Solid", width, color, "None", color);
+		for (int i = 1; i <= 10; ++i) {
+			stylus->addLine(start.x() + 15 * i, start.y() + (i % 2 == 0 ? 0 : 25));
+		}
+
+		mScene->addItem(stylus);
+		mWorldModel.addColorField(stylus);
+	}
+
+	/// Pixels of given rect as color and light sensors read them before the floor map: the scene is rendered
+	/// over a white background.
+	QVector<uint> renderedColors(QRect const &rect) const
+	{
+		QImage image(rect.size(), QImage::Format_RGB32);
+		image.fill(Qt::white);
+		QPainter painter(&image);
+		mScene->render(&painter, QRectF(), rect);
+		painter.end();
+
+		QVector<uint> result;
+		for (int y = 0; y < rect.height(); ++y) {
+			uint const *line = reinterpret_cast<uint const *>(image.constScanLine(y));
+			for (int x = 0; x < rect.width(); ++x) {
+				result << line[x];
+			}
+		}
+
+		return result;
+	}
+
+	/// The color seen by a color sensor, the one of most pixels. Ties are broken the same way for any order.
+	static uint dominantColor(QVector<uint> const &colors)
+	{
+		QHash<uint, int> counts;
+		foreach (uint const color, colors) {
+			++counts[color];
+		}
+
+		uint result = 0;
+		int maxCount = 0;
+		foreach (uint const color, counts.keys()) {
+			if (counts[color] > maxCount || (counts[color] == maxCount && color < result)) {
+				maxCount = counts[color];
+				result = color;
+			}
+		}
+
+		return result;
+	}
+
+	/// Mean brightness as a light sensor sees it.
+	static qreal brightness(QVector<uint> const &colors)
+	{
+		qreal sum = 0;
+		foreach (uint const color, colors) {
+			sum += qRed(color) + qGreen(color) + qBlue(color);
+		}
+
+		return sum / (3 * colors.size());
+	}
+
+	QApplication *mApplication;
+	QGraphicsScene *mScene;
+	WorldModel mWorldModel;
+};
+
+}
+
+TEST_F(WorldModelTest, floorColorsTest)
+{
+	addColorField(new LineItem(QPointF(-40, 30), QPointF(400, 30)), "black", 6);
+	addColorField(new LineItem(QPointF(250, -50), QPointF(262, 320)), "red", 20);
+	addColorField(new EllipseItem(QPointF(80, 80), QPointF(180, 160)), "green", 3, true);
+	addColorField(new EllipseItem(QPointF(230, 200), QPointF(290, 280)), "blue", 2);
+	addStylus(QPointF(20, 180), "black", 4);
+	addStylus(QPointF(200, 240), "yellow", 8);
+	addWall(QPointF(0, 300), QPointF(300, 300));
+	addWall(QPointF(120, 0), QPointF(120, 60));
+
+	// Points cover color fields, their borders, walls and boundaries of floor tiles.
+	for (int x = -30; x <= 330; x += 9) {
+		for (int y = -30; y <= 330; y += 9) {
+			QRect const rect(x, y, sensorWidth, sensorWidth);
+			QVector<uint> const expected = renderedColors(rect);
+			QVector<uint> const actual = mWorldModel.floorColors(rect);
+			ASSERT_EQ(expected.size(), actual.size());
+
+			int mismatches = 0;
+			for (int i = 0; i < expected.size(); ++i) {
+				if (expected[i] != actual[i]) {
+					++mismatches;
+				}
+			}
+
+			// Edges of antialiased items may be rasterized a bit differently, readings shall be the same.
+			EXPECT_LE(mismatches, expected.size() / 20) << "at " << x << ":" << y;
+			EXPECT_EQ(dominantColor(expected), dominantColor(actual)) << "at " << x << ":" << y;
+			EXPECT_NEAR(brightness(expected), brightness(actual), 5) << "at " << x << ":" << y;
+		}
+	}
+
+	// Items changed in place are seen after the caches are dropped.
+	mWorldModel.colorFields().first()->setPenColor("blue");
+	mWorldModel.invalidateCaches();
+	QRect const changed(100, 24, sensorWidth, sensorWidth);
+	EXPECT_EQ(dominantColor(renderedColors(changed)), dominantColor(mWorldModel.floorColors(changed)));
+	EXPECT_EQ(qRgb(0, 0, 255), dominantColor(mWorldModel.floorColors(changed)));
+}
+
+TEST_F(WorldModelTest, sonarReadingTest)
+{
+	// A box, a long diagonal crossing many cells of the grid, walls along cell borders and zero-length walls.
+	addWall(QPointF(-200, -200), QPointF(400, -200));
+	addWall(QPointF(400, -200), QPointF(400, 400));
+	addWall(QPointF(400, 400), QPointF(-200, 400));
+	addWall(QPointF(-200, 400), QPointF(-200, -200));
+	addWall(QPointF(-150, 350), QPointF(350, -150));
+	addWall(QPointF(128, -100), QPointF(128, 100));
+	addWall(QPointF(0, 256), QPointF(256, 256));
+	addWall(QPointF(60, 60), QPointF(60, 60));
+	addWall(QPointF(300, 20), QPointF(300, 20));
+
+	for (int x = -180; x <= 380; x += 40) {
+		for (int y = -180; y <= 380; y += 40) {
+			for (int direction = 0; direction < 360; direction += 15) {
+				QPointF const position(x, y);
+				// The sector of the old implementation has an arc approximated by curves, so the range
+				// where it first touches a wall may differ by a centimeter.
+				EXPECT_NEAR(referenceSonarReading(mWorldModel, position, direction)
+						, mWorldModel.sonarReading(position, direction), 1)
+						<< "at " << x << ":" << y << " looking at " << direction;
+			}
+		}
+	}
+}
+
+TEST_F(WorldModelTest, sonarReadingOutOfRangeTest)
+{
+	addWall(QPointF(2000, -100), QPointF(2000, 100));
+	addWall(QPointF(-500, -500), QPointF(-500, -500));
+
+	EXPECT_EQ(maxSonarRangeCms, referenceSonarReading(mWorldModel, QPointF(0, 0), 0));
+	EXPECT_EQ(maxSonarRangeCms, mWorldModel.sonarReading(QPointF(0, 0), 0));
+	EXPECT_EQ(maxSonarRangeCms, mWorldModel.sonarReading(QPointF(0, 0), 225));
+}
+
+TEST_F(WorldModelTest, checkCollisionTest)
+{
+	addWall(QPointF(-300, 0), QPointF(500, 0));
+	addWall(QPointF(-250, -250), QPointF(450, 450));
+	addWall(QPointF(256, -300), QPointF(256, 300));
+	addWall(QPointF(100, 200), QPointF(100, 200));
+	addWall(QPointF(-120, 130), QPointF(-120, 130));
+	addWall(QPointF(-200, -100), QPointF(-60, -180));
+
+	int const stroke = 3;
+	int checked = 0;
+	int collisions = 0;
+	for (int x = -280; x <= 480; x += 13) {
+		for (int y = -280; y <= 480; y += 13) {
+			for (int direction = 0; direction < 90; direction += 30) {
+				QPainterPath const robot = robotPath(QPointF(x, y), direction);
+
+				// Ends of walls were stroked with square caps and are round now, so the robot passing
+				// within a pixel of the stroke may be seen differently.
+				bool const near = mWorldModel.checkCollision(robot, stroke + 4);
+				bool const touching = mWorldModel.checkCollision(robot, 1);
+				if (near != touching) {
+					continue;
+				}
+
+				++checked;
+				bool const collision = mWorldModel.checkCollision(robot, stroke);
+				collisions += collision ? 1 : 0;
+				EXPECT_EQ(referenceCheckCollision(mWorldModel, robot, stroke), collision)
+						<< "at " << x << ":" << y << " turned by " << direction;
+			}
+		}
+	}
+
+	// The layout is dense enough for both outcomes to be checked many times.
+	EXPECT_GT(collisions, 100);
+	EXPECT_GT(checked - collisions, 100);
+}
@@ -1,5 +1,7 @@
 SOURCES += \
 	$$PWD/graphicalPartViewMock.cpp \
+	$$PWD/nodeElementImplStub.cpp \
 
 HEADERS += \
 	$$PWD/graphicalPartViewMock.h \
+	$$PWD/nodeElementImplStub.h \
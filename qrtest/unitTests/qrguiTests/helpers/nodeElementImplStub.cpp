@@ -0,0 +1,154 @@
+#include "nodeElementImplStub.h"
+
+#include <QtGui/QPainter>
+
+using namespace qrguiTests::helpers;
+using namespace qReal;
+
+void NodeElementImplStub::init(QRectF &contents, PortFactoryInterface const &portFactory
+		, QList<PortInterface *> &ports, LabelFactoryInterface &labelFactory
+		, QList<LabelInterface *> &labels, SdfRendererInterface *renderer
+		, ElementRepoInterface *elementRepo)
+{
+	Q_UNUSED(portFactory)
+	Q_UNUSED(ports)
+	Q_UNUSED(labelFactory)
+	Q_UNUSED(labels)
+	Q_UNUSED(renderer)
+	Q_UNUSED(elementRepo)
+	contents.setWidth(50);
+	contents.setHeight(50);
+}
+
+void NodeElementImplStub::init(LabelFactoryInterface &factory, QList<LabelInterface*> &titles)
+{
+	Q_UNUSED(factory)
+	Q_UNUSED(titles)
+}
+
+void NodeElementImplStub::paint(QPainter *painter, QRectF &contents)
+{
+	painter->drawRoundedRect(contents, 5, 5);
+	painter->drawEllipse(contents.adjusted(10, 10, -10, -10));
+	painter->drawText(contents, Qt::AlignCenter, "stub");
+}
+
+void NodeElementImplStub::updateData(ElementRepoInterface *repo) const
+{
+	Q_UNUSED(repo)
+}
+
+bool NodeElementImplStub::isNode() const
+{
+	return true;
+}
+
+bool NodeElementImplStub::isResizeable() const
+{
+	return true;
+}
+
+Qt::PenStyle NodeElementImplStub::getPenStyle() const
+{
+	return Qt::SolidLine;
+}
+
+int NodeElementImplStub::getPenWidth() const
+{
+	return 1;
+}
+
+QColor NodeElementImplStub::getPenColor() const
+{
+	return Qt::black;
+}
+
+void NodeElementImplStub::drawStartArrow(QPainter *painter) const
+{
+	Q_UNUSED(painter)
+}
+
+void NodeElementImplStub::drawEndArrow(QPainter *painter) const
+{
+	Q_UNUSED(painter)
+}
+
+bool NodeElementImplStub::isDividable() const
+{
+	return false;
+}
+
+bool NodeElementImplStub::isContainer() const
+{
+	return true;
+}
+
+bool NodeElementImplStub::isSortingContainer() const
+{
+	return false;
+}
+
+QVector<int> NodeElementImplStub::sizeOfForestalling() const
+{
+	return QVector<int>(4, 0);
+}
+
+int NodeElementImplStub::sizeOfChildrenForestalling() const
+{
+	return 0;
+}
+
+bool NodeElementImplStub::hasMovableChildren() const
+{
+	return true;
+}
+
+bool NodeElementImplStub::minimizesToChildren() const
+{
+	return false;
+}
+
+bool NodeElementImplStub::maximizesChildren() const
+{
+	return false;
+}
+
+QStringList NodeElementImplStub::fromPortTypes() const
+{
+	return QStringList();
+}
+
+QStringList NodeElementImplStub::toPortTypes() const
+{
+	return QStringList();
+}
+
+enums::linkShape::LinkShape NodeElementImplStub::shapeType() const
+{
+	return enums::linkShape::broken;
+}
+
+bool NodeElementImplStub::isPort() const
+{
+	return false;
+}
+
+bool NodeElementImplStub::hasPin() const
+{
+	return false;
+}
+
+bool NodeElementImplStub::createChildrenFromMenu() const
+{
+	return false;
+}
+
+QList<double> NodeElementImplStub::border() const
+{
+	return QList<double>() << 0 << 0 << 0 << 0;
+}
+
+QStringList NodeElementImplStub::bonusContextMenuFields() const
+{
+	return QStringList();
+}
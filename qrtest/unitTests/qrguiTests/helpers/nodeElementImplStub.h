@@ -0,0 +1,99 @@
+#pragma once
+
+#include <editorPluginInterface/elementImpl.h>
+
+namespace qrguiTests {
+namespace helpers {
+
+/// Implementation of a plain resizeable node without ports and labels, with a shape of a few primitives.
+/// Used to put nodes on a scene without loading editor plugins.
+class NodeElementImplStub : public qReal::ElementImpl
+{
+public:
+	// Override.
+	virtual void init(QRectF &contents, qReal::PortFactoryInterface const &portFactory
+			, QList<qReal::PortInterface *> &ports, qReal::LabelFactoryInterface &labelFactory
+			, QList<qReal::LabelInterface *> &labels, qReal::SdfRendererInterface *renderer
+			, qReal::ElementRepoInterface *elementRepo = 0);
+
+	// Override.
+	virtual void init(qReal::LabelFactoryInterface &factory, QList<qReal::LabelInterface*> &titles);
+
+	// Override.
+	virtual void paint(QPainter *painter, QRectF &contents);
+
+	// Override.
+	virtual void updateData(qReal::ElementRepoInterface *repo) const;
+
+	// Override.
+	virtual bool isNode() const;
+
+	// Override.
+	virtual bool isResizeable() const;
+
+	// Override.
+	virtual Qt::PenStyle getPenStyle() const;
+
+	// Override.
+	virtual int getPenWidth() const;
+
+	// Override.
+	virtual QColor getPenColor() const;
+
+	// Override.
+	virtual void drawStartArrow(QPainter *painter) const;
+
+	// Override.
+	virtual void drawEndArrow(QPainter *painter) const;
+
+	// Override.
+	virtual bool isDividable() const;
+
+	// Override.
+	virtual bool isContainer() const;
+
+	// Override.
+	virtual bool isSortingContainer() const;
+
+	// Override.
+	virtual QVector<int> sizeOfForestalling() const;
+
+	// Override.
+	virtual int sizeOfChildrenForestalling() const;
+
+	// Override.
+	virtual bool hasMovableChildren() const;
+
+	// Override.
+	virtual bool minimizesToChildren() const;
+
+	// Override.
+	virtual bool maximizesChildren() const;
+
+	// Override.
+	virtual QStringList fromPortTypes() const;
+
+	// Override.
+	virtual QStringList toPortTypes() const;
+
+	// Override.
+	virtual enums::linkShape::LinkShape shapeType() const;
+
+	// Override.
+	virtual bool isPort() const;
+
+	// Override.
+	virtual bool hasPin() const;
+
+	// Override.
+	virtual bool createChildrenFromMenu() const;
+
+	// Override.
+	virtual QList<double> border() const;
+
+	// Override.
+	virtual QStringList bonusContextMenuFields() const;
+};
+
+}
+}
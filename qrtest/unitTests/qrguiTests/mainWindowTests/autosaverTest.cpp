@@ -0,0 +1,144 @@
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTimer>
+#include <QtWidgets/QApplication>
+#include <gtest/gtest.h>
+
+#include <qrrepo/repoApi.h>
+#include <mainwindow/projectManager/projectManager.h>
+#include <mainwindow/projectManager/autosaver.h>
+
+using namespace qReal;
+
+namespace {
+
+/// Project manager without main window, takes snapshots of given repository.
+class ProjectManagerStub : public ProjectManager
+{
+public:
+	explicit ProjectManagerStub(qrRepo::RepoApi &repoApi)
+		: ProjectManager(nullptr, nullptr)
+		, mRepoApi(repoApi)
+	{
+	}
+
+	QSharedPointer<qrRepo::details::RepositorySnapshot> snapshot() const override
+	{
+		return mRepoApi.snapshot();
+	}
+
+private:
+	qrRepo::RepoApi &mRepoApi;
+};
+
+class AutosaverTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		static int argc = 0;
+		static char *argv[] = {const_cast<char *>("")};
+		mApplication = new QApplication(argc, argv);
+
+		mRepoApi = new qrRepo::RepoApi("autosaverTest.qrs", true);
+		mElement = Id("editor", "diagram", "element", "element");
+		mRepoApi->addChild(Id::rootId(), mElement);
+		mRepoApi->setName(mElement, "autosaved");
+
+		mProjectManager = new ProjectManagerStub(*mRepoApi);
+		mProjectManager->setSaveFilePath("autosaverTest.qrs");
+		mAutosaver = new Autosaver(mProjectManager);
+		mSavesCount = 0;
+		QObject::connect(mAutosaver, &Autosaver::saved, [this]() { ++mSavesCount; });
+	}
+
+	void TearDown() override
+	{
+		delete mAutosaver;
+		delete mProjectManager;
+		delete mRepoApi;
+		QFile::remove(autosaveFile());
+		delete mApplication;
+	}
+
+	QString autosaveFile() const
+	{
+		return QFileInfo("autosaverTest.qrs").absolutePath() + "/~autosaverTest.qrs";
+	}
+
+	/// Requests an autosave like the timer of the autosaver does.
+	void requestAutosave()
+	{
+		QMetaObject::invokeMethod(mAutosaver, "saveAutoSave");
+	}
+
+	/// Runs event loop until the background save is finished or a second passes.
+	void waitForSave()
+	{
+		QEventLoop loop;
+		QObject::connect(mAutosaver, &Autosaver::saved, &loop, &QEventLoop::quit);
+		QTimer::singleShot(1000, &loop, SLOT(quit()));
+		loop.exec();
+	}
+
+	QApplication *mApplication;
+	qrRepo::RepoApi *mRepoApi;
+	ProjectManagerStub *mProjectManager;
+	Autosaver *mAutosaver;
+	Id mElement;
+	int mSavesCount;
+};
+
+}
+
+TEST_F(AutosaverTest, backgroundSaveTest)
+{
+	requestAutosave();
+	waitForSave();
+
+	ASSERT_EQ(mSavesCount, 1);
+	EXPECT_GE(mAutosaver->lastSaveDuration(), 0);
+	EXPECT_GE(mAutosaver->lastGuiStall(), 0);
+	ASSERT_TRUE(QFile::exists(autosaveFile()));
+
+	qrRepo::RepoApi const saved(autosaveFile(), true);
+	EXPECT_TRUE(saved.exist(mElement));
+	EXPECT_EQ(saved.name(mElement), "autosaved");
+}
+
+TEST_F(AutosaverTest, mergedRequestsTest)
+{
+	requestAutosave();
+	requestAutosave();
+	requestAutosave();
+	waitForSave();
+	waitForSave();
+
+	// The first request is running, the others are merged into one.
+	EXPECT_EQ(mSavesCount, 2);
+}
+
+TEST_F(AutosaverTest, userSaveTest)
+{
+	requestAutosave();
+	requestAutosave();
+	mAutosaver->projectSaved();
+	waitForSave();
+
+	// The running save is discarded, the pending one is dropped.
+	EXPECT_EQ(mSavesCount, 1);
+	EXPECT_EQ(mAutosaver->lastSaveDuration(), -1);
+	EXPECT_FALSE(QFile::exists(autosaveFile()));
+
+	// Nothing is autosaved until the project is modified again.
+	requestAutosave();
+	waitForSave();
+	EXPECT_EQ(mSavesCount, 1);
+
+	mAutosaver->setUnsavedChanges(true);
+	requestAutosave();
+	waitForSave();
+	EXPECT_EQ(mSavesCount, 2);
+	EXPECT_TRUE(QFile::exists(autosaveFile()));
+}
@@ -0,0 +1,199 @@
+#include <cmath>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QProcess>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTextStream>
+#include <QtCore/QRectF>
+#include <gtest/gtest.h>
+
+#include <mainwindow/layout/layeredLayout.h>
+#include <mainwindow/layout/forceDirectedLayout.h>
+
+using namespace qReal::layout;
+
+namespace {
+
+/// Returns a graph with given number of nodes of given size placed at the same point, without edges.
+LayoutGraph nodes(int count, QSizeF const &size = QSizeF(50, 30))
+{
+	LayoutGraph result;
+	for (int i = 0; i < count; ++i) {
+		result.sizes << size;
+		result.positions << QPointF();
+	}
+
+	return result;
+}
+
+QRectF rect(LayoutGraph const &graph, QVector<QPointF> const &positions, int node)
+{
+	return QRectF(positions[node], graph.sizes[node]);
+}
+
+/// Returns true if some nodes placed to given positions overlap.
+bool overlap(LayoutGraph const &graph, QVector<QPointF> const &positions)
+{
+	for (int i = 0; i < positions.size(); ++i) {
+		for (int j = i + 1; j < positions.size(); ++j) {
+			if (rect(graph, positions, i).intersects(rect(graph, positions, j))) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+qreal distance(QPointF const &a, QPointF const &b)
+{
+	QPointF const delta = a - b;
+	return std::sqrt(delta.x() * delta.x() + delta.y() * delta.y());
+}
+
+/// Returns a graph resembling a big diagram: a random tree where nodes are linked to recently added ones,
+/// with additional links between close nodes.
+LayoutGraph bigGraph(int nodesCount)
+{
+	qsrand(42);
+	LayoutGraph result = nodes(nodesCount);
+	int const side = std::sqrt(static_cast<qreal>(nodesCount));
+	for (int i = 0; i < nodesCount; ++i) {
+		result.positions[i] = QPointF(qrand() % side, qrand() % side) * 100;
+		if (i > 0) {
+			result.edges << qMakePair(qMax(0, i - 1 - qrand() % 50), i);
+		}
+
+		if (i % 2 == 0 && i + 30 < nodesCount) {
+			result.edges << qMakePair(i, i + 1 + qrand() % 30);
+		}
+	}
+
+	return result;
+}
+
+/// Runs dot the same way DotRunner does on given graph.
+/// @returns time taken in ms, -1 if dot is not installed.
+qint64 runDot(LayoutGraph const &graph)
+{
+	QString const dotPath = QStandardPaths::findExecutable("dot");
+	if (dotPath.isEmpty()) {
+		return -1;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	QFile file(QDir::temp().filePath("layoutBenchmark.dot"));
+	file.open(QFile::WriteOnly | QFile::Truncate);
+	QTextStream out(&file);
+	out << "digraph G {\n";
+	for (int i = 0; i < graph.sizes.size(); ++i) {
+		out << "n" << i << ";\n";
+	}
+
+	for (int i = 0; i < graph.edges.size(); ++i) {
+		out << "n" << graph.edges[i].first << " -> n" << graph.edges[i].second << ";\n";
+	}
+
+	out << "}";
+	file.close();
+
+	QProcess process;
+	process.start(dotPath, QStringList() << file.fileName());
+	process.waitForFinished(-1);
+	process.readAllStandardOutput();
+	file.remove();
+	return timer.elapsed();
+}
+
+}
+
+TEST(LayoutTest, layeredDirectionsTest)
+{
+	// A diamond with a link back closing a cycle and a loop, which are both ignored when looking for layers.
+	LayoutGraph graph = nodes(5);
+	graph.edges << qMakePair(0, 1) << qMakePair(0, 2) << qMakePair(1, 3) << qMakePair(2, 3) << qMakePair(3, 0)
+			<< qMakePair(3, 4) << qMakePair(4, 4);
+
+	QList<Edge> const forward = QList<Edge>() << qMakePair(0, 1) << qMakePair(0, 2)
+			<< qMakePair(1, 3) << qMakePair(2, 3) << qMakePair(3, 4);
+
+	for (int direction = LayeredLayout::topToBottom; direction <= LayeredLayout::rightToLeft; ++direction) {
+		QVector<QPointF> const positions
+				= LayeredLayout(static_cast<LayeredLayout::Direction>(direction)).arrange(graph);
+		ASSERT_EQ(graph.sizes.size(), positions.size());
+		ASSERT_FALSE(overlap(graph, positions));
+
+		foreach (Edge const &edge, forward) {
+			QRectF const from = rect(graph, positions, edge.first);
+			QRectF const to = rect(graph, positions, edge.second);
+			switch (direction) {
+			case LayeredLayout::topToBottom:
+				ASSERT_LT(from.bottom(), to.top());
+				break;
+			case LayeredLayout::bottomToTop:
+				ASSERT_GT(from.top(), to.bottom());
+				break;
+			case LayeredLayout::leftToRight:
+				ASSERT_LT(from.right(), to.left());
+				break;
+			default:
+				ASSERT_GT(from.left(), to.right());
+			}
+		}
+	}
+}
+
+TEST(LayoutTest, layeredLongLinksTest)
+{
+	// A link over several layers does not make nodes of a layer overlap, and a single chain stays straight.
+	LayoutGraph graph = nodes(6);
+	graph.edges << qMakePair(0, 1) << qMakePair(1, 2) << qMakePair(2, 3) << qMakePair(0, 3)
+			<< qMakePair(0, 4) << qMakePair(4, 5);
+
+	QVector<QPointF> const positions = LayeredLayout().arrange(graph);
+	ASSERT_FALSE(overlap(graph, positions));
+	ASSERT_EQ(positions[0].y(), positions[4].y() - 110);
+	ASSERT_EQ(positions[4].x(), positions[5].x());
+}
+
+TEST(LayoutTest, forceDirectedTest)
+{
+	// A chain of nodes placed at one point is spread, linked nodes stay closer than ends of the chain.
+	LayoutGraph graph = nodes(10);
+	for (int i = 0; i + 1 < 10; ++i) {
+		graph.edges << qMakePair(i, i + 1);
+	}
+
+	QVector<QPointF> const positions = ForceDirectedLayout().arrange(graph);
+	ASSERT_EQ(graph.sizes.size(), positions.size());
+	ASSERT_FALSE(overlap(graph, positions));
+	for (int i = 0; i + 1 < 10; ++i) {
+		ASSERT_LT(distance(positions[i], positions[i + 1]), distance(positions[0], positions[9]));
+	}
+}
+
+/// Measures arrangement of a graph with 10000 nodes by layered and force-directed layouts and by dot
+/// if it is installed, run with --gtest_also_run_disabled_tests.
+TEST(LayoutTest, DISABLED_layoutBenchmark)
+{
+	LayoutGraph const graph = bigGraph(10000);
+
+	QElapsedTimer timer;
+	timer.start();
+	LayeredLayout().arrange(graph);
+	qint64 const layeredTime = timer.elapsed();
+
+	timer.start();
+	ForceDirectedLayout().arrange(graph);
+	qint64 const forceDirectedTime = timer.elapsed();
+
+	qint64 const dotTime = runDot(graph);
+
+	qDebug() << graph.sizes.size() << "nodes," << graph.edges.size() << "links: layered" << layeredTime
+			<< "ms, force-directed" << forceDirectedTime << "ms, dot"
+			<< (dotTime < 0 ? QString("is not installed") : QString("%1 ms").arg(dotTime));
+}
@@ -0,0 +1,3 @@
+SOURCES += \
+	$$PWD/layoutTest.cpp \
+	$$PWD/autosaverTest.cpp \
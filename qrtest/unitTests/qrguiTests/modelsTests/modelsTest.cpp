@@ -0,0 +1,304 @@
+#include "modelsTest.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+
+#include <qrkernel/roles.h>
+
+#include "controller/commands/transactionCommand.h"
+#include "controller/commands/renameCommand.h"
+#include "mainwindow/layout/layeredLayout.h"
+#include "mainwindow/layout/layoutEngine.h"
+
+using namespace qrguiTests;
+using namespace qReal;
+
+namespace {
+
+QString const projectFile = "modelsTest.qrs";
+Id const diagram("editor", "diagram", "diagramNode", "diagram");
+
+Id element(int index)
+{
+	return Id("editor", "diagram", "element", QString("element%1").arg(index));
+}
+
+Id logicalElement(int index)
+{
+	return Id("editor", "diagram", "element", QString("logicalElement%1").arg(index));
+}
+
+}
+
+void ModelsTest::TearDown()
+{
+	mModels.reset();
+	QFile::remove(projectFile);
+}
+
+void ModelsTest::createProject(int elementsCount)
+{
+	qrRepo::RepoApi repoApi(projectFile);
+	Id const logicalDiagram("editor", "diagram", "diagramNode", "logicalDiagram");
+	repoApi.addChild(Id::rootId(), logicalDiagram);
+	repoApi.addChild(Id::rootId(), diagram, logicalDiagram);
+
+	for (int i = 0; i < elementsCount; ++i) {
+		Id const parent = i % 10 == 1 ? element(i - 1) : diagram;
+		repoApi.addChild(Id::rootId(), logicalElement(i));
+		repoApi.addChild(parent, element(i), logicalElement(i));
+		repoApi.setName(logicalElement(i), QString("element %1").arg(i));
+		repoApi.setName(element(i), QString("element %1").arg(i));
+	}
+
+	repoApi.saveAll();
+}
+
+void ModelsTest::checkRows(Id const &parent)
+{
+	models::GraphicalModelAssistApi &api = mModels->graphicalModelAssistApi();
+	QModelIndex const parentIndex = api.indexById(parent);
+	IdList const children = mModels->graphicalRepoApi().children(parent);
+	ASSERT_EQ(children.size(), mModels->graphicalModel()->rowCount(parentIndex));
+
+	for (int row = 0; row < children.size(); ++row) {
+		QModelIndex const index = api.indexById(children[row]);
+		ASSERT_EQ(row, index.row());
+		ASSERT_EQ(parentIndex, index.parent());
+		ASSERT_EQ(index, mModels->graphicalModel()->index(row, 0, parentIndex));
+		ASSERT_EQ(children[row], api.idByIndex(index));
+	}
+}
+
+TEST_F(ModelsTest, loadTest)
+{
+	createProject(25);
+	mModels.reset(new models::Models(projectFile, mEditorManager));
+
+	models::GraphicalModelAssistApi &api = mModels->graphicalModelAssistApi();
+	ASSERT_EQ(QModelIndex(), api.indexById(Id::rootId()));
+	ASSERT_EQ(QModelIndex(), api.indexById(element(100)));
+	ASSERT_EQ(Id(), api.idByIndex(QModelIndex()));
+
+	checkRows(diagram);
+	checkRows(element(10));
+	ASSERT_EQ(element(11), api.indexById(element(11)).data(roles::idRole).value<Id>());
+	ASSERT_EQ(logicalElement(11), api.logicalId(element(11)));
+
+	QModelIndex const logicalIndex = mModels->logicalModelAssistApi().indexById(logicalElement(24));
+	ASSERT_TRUE(logicalIndex.isValid());
+	ASSERT_EQ(logicalElement(24), mModels->logicalModelAssistApi().idByIndex(logicalIndex));
+}
+
+TEST_F(ModelsTest, rowsTest)
+{
+	createProject(10);
+	mModels.reset(new models::Models(projectFile, mEditorManager));
+	models::GraphicalModelAssistApi &api = mModels->graphicalModelAssistApi();
+
+	api.stackBefore(element(9), element(2));
+	checkRows(diagram);
+
+	api.stackBefore(element(3), element(8));
+	checkRows(diagram);
+
+	api.removeElement(element(4));
+	checkRows(diagram);
+	ASSERT_EQ(QModelIndex(), api.indexById(element(4)));
+
+	Id const created("editor", "diagram", "element", "created");
+	api.createElement(diagram, created, false, "created", QPointF());
+	checkRows(diagram);
+
+	api.changeParent(element(5), element(0), QPointF());
+	checkRows(diagram);
+	checkRows(element(0));
+}
+
+TEST_F(ModelsTest, reinitTest)
+{
+	createProject(10);
+	mModels.reset(new models::Models(projectFile, mEditorManager));
+
+	int resets = 0;
+	int insertions = 0;
+	QObject::connect(mModels->graphicalModel(), &QAbstractItemModel::modelReset, [&resets]() { ++resets; });
+	QObject::connect(mModels->graphicalModel(), &QAbstractItemModel::rowsInserted, [&insertions]() { ++insertions; });
+
+	mModels->reinit();
+
+	ASSERT_EQ(1, resets);
+	ASSERT_EQ(0, insertions);
+	checkRows(diagram);
+}
+
+TEST_F(ModelsTest, transactionTest)
+{
+	createProject(10);
+	mModels.reset(new models::Models(projectFile, mEditorManager));
+	models::GraphicalModelAssistApi &graphicalApi = mModels->graphicalModelAssistApi();
+	models::LogicalModelAssistApi &logicalApi = mModels->logicalModelAssistApi();
+
+	QSet<Id> changed;
+	int notifications = 0;
+	QObject::connect(mModels->graphicalModel(), &QAbstractItemModel::dataChanged
+			, [&](QModelIndex const &topLeft, QModelIndex const &bottomRight) {
+				ASSERT_EQ(topLeft, bottomRight);
+				changed.insert(graphicalApi.idByIndex(topLeft));
+				++notifications;
+			});
+
+	graphicalApi.beginTransaction();
+	logicalApi.beginTransaction();
+	for (int i = 0; i < 5; ++i) {
+		graphicalApi.setPosition(element(i), QPointF(i, i));
+		graphicalApi.setConfiguration(element(i), QPolygon());
+		graphicalApi.setToPort(element(i), 1.0);
+		logicalApi.setName(logicalElement(i), "renamed");
+	}
+
+	// Nested transaction does not flush notifications.
+	graphicalApi.beginTransaction();
+	graphicalApi.setName(element(6), "renamed");
+	graphicalApi.commitTransaction();
+
+	graphicalApi.removeElement(element(6));
+
+	// Views are not notified yet, but names of logical and graphical elements are already in sync.
+	ASSERT_EQ(0, notifications);
+	ASSERT_EQ("renamed", graphicalApi.name(element(3)));
+
+	logicalApi.commitTransaction();
+	graphicalApi.commitTransaction();
+
+	ASSERT_EQ(5, notifications);
+	ASSERT_EQ(QSet<Id>() << element(0) << element(1) << element(2) << element(3) << element(4), changed);
+
+	// Without a transaction every change is reported at once.
+	graphicalApi.setPosition(element(0), QPointF());
+	ASSERT_EQ(6, notifications);
+}
+
+TEST_F(ModelsTest, transactionCommandTest)
+{
+	createProject(10);
+	mModels.reset(new models::Models(projectFile, mEditorManager));
+	models::GraphicalModelAssistApi &graphicalApi = mModels->graphicalModelAssistApi();
+	models::LogicalModelAssistApi &logicalApi = mModels->logicalModelAssistApi();
+
+	int notifications = 0;
+	QObject::connect(mModels->graphicalModel(), &QAbstractItemModel::dataChanged, [&notifications]() {
+		++notifications;
+	});
+
+	commands::TransactionCommand command(logicalApi, graphicalApi);
+	for (int i = 0; i < 5; ++i) {
+		command.addPostAction(new commands::RenameCommand(logicalApi, logicalElement(i), "renamed"));
+		command.addPostAction(new commands::RenameCommand(graphicalApi, element(i), "renamed again"));
+	}
+
+	command.redo();
+	ASSERT_EQ(5, notifications);
+	for (int i = 0; i < 5; ++i) {
+		ASSERT_EQ("renamed again", graphicalApi.name(element(i)));
+	}
+
+	command.undo();
+	ASSERT_EQ(10, notifications);
+	for (int i = 0; i < 5; ++i) {
+		ASSERT_EQ(QString("element %1").arg(i), graphicalApi.name(element(i)));
+	}
+}
+
+TEST_F(ModelsTest, arrangeTest)
+{
+	createProject(10);
+	{
+		// A chain of links, the first one starts from a nested element, so it links its container.
+		qrRepo::RepoApi repoApi(projectFile);
+		for (int i = 0; i < 10; ++i) {
+			repoApi.setPosition(element(i), QPointF(100 + 10 * i, 50));
+		}
+
+		for (int i = 1; i < 9; ++i) {
+			Id const logicalLink("editor", "diagram", "link", QString("logicalLink%1").arg(i));
+			Id const link("editor", "diagram", "link", QString("link%1").arg(i));
+			repoApi.addChild(Id::rootId(), logicalLink);
+			repoApi.addChild(diagram, link, logicalLink);
+			repoApi.setFrom(link, element(i));
+			repoApi.setTo(link, element(i + 1));
+		}
+
+		repoApi.saveAll();
+	}
+
+	ON_CALL(mEditorManager, isGraphicalElementNode(testing::_)).WillByDefault(testing::Invoke([](Id const &id) {
+		return id.element() != "link";
+	}));
+
+	mModels.reset(new models::Models(projectFile, mEditorManager));
+	models::GraphicalModelAssistApi &graphicalApi = mModels->graphicalModelAssistApi();
+	models::LogicalModelAssistApi &logicalApi = mModels->logicalModelAssistApi();
+	layout::LayoutEngine const engine(logicalApi, graphicalApi);
+
+	IdList nodes;
+	layout::LayoutGraph const graph = engine.graph(diagram, nodes);
+	ASSERT_EQ(9, nodes.size());
+	ASSERT_FALSE(nodes.contains(element(1)));
+	ASSERT_EQ(8, graph.edges.size());
+	ASSERT_TRUE(graph.edges.contains(qMakePair(nodes.indexOf(element(0)), nodes.indexOf(element(2)))));
+
+	int notifications = 0;
+	QObject::connect(mModels->graphicalModel(), &QAbstractItemModel::dataChanged, [&notifications]() {
+		++notifications;
+	});
+
+	QScopedPointer<commands::AbstractCommand> const command(engine.arrange(diagram, layout::LayeredLayout()));
+	ASSERT_TRUE(command);
+	command->redo();
+
+	// Every moved node is reported once, links go top-bottom and the diagram keeps its top left corner.
+	ASSERT_GE(9, notifications);
+	QPointF topLeft = graphicalApi.position(element(0));
+	for (int i = 2; i < 10; ++i) {
+		QPointF const position = graphicalApi.position(element(i));
+		ASSERT_LT(graphicalApi.position(element(i == 2 ? 0 : i - 1)).y(), position.y());
+		topLeft = QPointF(qMin(topLeft.x(), position.x()), qMin(topLeft.y(), position.y()));
+	}
+
+	ASSERT_EQ(QPointF(100, 50), topLeft);
+	ASSERT_EQ(QPointF(110, 50), graphicalApi.position(element(1)));
+
+	command->undo();
+	for (int i = 0; i < 10; ++i) {
+		ASSERT_EQ(QPointF(100 + 10 * i, 50), graphicalApi.position(element(i)));
+	}
+}
+
+/// Measures opening of projects of growing size, time per element shall stay about the same,
+/// run with --gtest_also_run_disabled_tests.
+TEST_F(ModelsTest, DISABLED_loadBenchmark)
+{
+	foreach (int const elementsCount, QList<int>() << 10000 << 50000 << 100000) {
+		createProject(elementsCount);
+
+		QElapsedTimer timer;
+		timer.start();
+		mModels.reset(new models::Models(projectFile, mEditorManager));
+		qint64 const loadTime = timer.elapsed();
+
+		timer.start();
+		models::GraphicalModelAssistApi &api = mModels->graphicalModelAssistApi();
+		for (int i = 0; i < elementsCount; ++i) {
+			api.indexById(element(i));
+		}
+
+		qint64 const lookupTime = timer.elapsed();
+
+		qDebug() << elementsCount << "elements: load" << loadTime << "ms,"
+				<< loadTime * 1000.0 / elementsCount << "us per element, indexById for all elements" << lookupTime << "ms";
+
+		mModels.reset();
+		QFile::remove(projectFile);
+	}
+}
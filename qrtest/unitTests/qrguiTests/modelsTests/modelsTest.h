@@ -0,0 +1,28 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <models/models.h>
+
+#include "../../mocks/grgui/pluginManager/editorManagerInterfaceMock.h"
+
+namespace qrguiTests {
+
+class ModelsTest : public testing::Test {
+
+protected:
+	virtual void TearDown();
+
+	/// Writes a project with a diagram of given number of elements, each having a logical and a graphical part,
+	/// every tenth element contains a nested one.
+	void createProject(int elementsCount);
+
+	/// Checks that rows of children of given graphical element match their order in the repository.
+	void checkRows(qReal::Id const &parent);
+
+protected:
+	testing::NiceMock<qrTest::EditorManagerInterfaceMock> mEditorManager;
+	QScopedPointer<qReal::models::Models> mModels;
+};
+
+}
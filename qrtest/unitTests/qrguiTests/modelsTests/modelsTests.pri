@@ -3,6 +3,8 @@ HEADERS += \
 
 HEADERS += \
 	$$PWD/detailsTests/graphicalPartModelTest.h \
+	$$PWD/modelsTest.h \
 
 SOURCES += \
 	$$PWD/detailsTests/graphicalPartModelTest.cpp \
+	$$PWD/modelsTest.cpp \
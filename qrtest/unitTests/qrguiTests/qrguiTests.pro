@@ -13,4 +13,10 @@ include(../../../qrgui/qrgui.pri)
 
 include(modelsTests/modelsTests.pri)
 
+include(viewTests/viewTests.pri)
+
 include(helpers/helpers.pri)
+
+include(umllibTests/umllibTests.pri)
+
+include(mainWindowTests/mainWindowTests.pri)
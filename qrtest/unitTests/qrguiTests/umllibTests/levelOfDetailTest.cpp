@@ -0,0 +1,45 @@
+#include <QtCore/QVariant>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <gtest/gtest.h>
+
+#include <qrkernel/settingsManager.h>
+#include <umllib/private/levelOfDetail.h>
+
+using namespace qReal;
+
+TEST(LevelOfDetailTest, thresholdsTest)
+{
+	QVariant const simplifiedDrawingZoom = SettingsManager::value("SimplifiedDrawingZoom");
+	QVariant const minimalDetailSize = SettingsManager::value("MinimalDetailSize");
+	SettingsManager::setValue("SimplifiedDrawingZoom", 30);
+	SettingsManager::setValue("MinimalDetailSize", 4);
+	LevelOfDetail::reloadSettings();
+
+	QImage image(10, 10, QImage::Format_ARGB32);
+	QPainter painter(&image);
+	EXPECT_FALSE(LevelOfDetail::isSimplified(&painter));
+	EXPECT_FALSE(LevelOfDetail::isTooSmall(&painter, 10));
+
+	painter.scale(0.5, 0.5);
+	EXPECT_FALSE(LevelOfDetail::isSimplified(&painter));
+	EXPECT_FALSE(LevelOfDetail::isTooSmall(&painter, 10));
+	EXPECT_TRUE(LevelOfDetail::isTooSmall(&painter, 6));
+
+	painter.scale(0.2, 0.2);
+	EXPECT_TRUE(LevelOfDetail::isSimplified(&painter));
+	EXPECT_TRUE(LevelOfDetail::isTooSmall(&painter, 10));
+
+	// Thresholds are cached until settings are reloaded.
+	SettingsManager::setValue("SimplifiedDrawingZoom", 0);
+	SettingsManager::setValue("MinimalDetailSize", 0);
+	EXPECT_TRUE(LevelOfDetail::isSimplified(&painter));
+
+	LevelOfDetail::reloadSettings();
+	EXPECT_FALSE(LevelOfDetail::isSimplified(&painter));
+	EXPECT_FALSE(LevelOfDetail::isTooSmall(&painter, 10));
+
+	SettingsManager::setValue("SimplifiedDrawingZoom", simplifiedDrawingZoom);
+	SettingsManager::setValue("MinimalDetailSize", minimalDetailSize);
+	LevelOfDetail::reloadSettings();
+}
@@ -0,0 +1,200 @@
+#include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <gtest/gtest.h>
+
+#include <umllib/private/orthogonalRouter.h>
+
+using namespace qReal;
+
+namespace {
+
+/// Returns a provider of obstacles from given list, counting requests.
+OrthogonalRouter::ObstaclesProvider provider(QList<QRectF> const &obstacles, int &requests)
+{
+	return [&obstacles, &requests](QRectF const &area) {
+		++requests;
+		QList<QRectF> result;
+		foreach (QRectF const &obstacle, obstacles) {
+			if (obstacle.intersects(area)) {
+				result << obstacle;
+			}
+		}
+
+		return result;
+	};
+}
+
+/// Returns true if all segments of given route are horizontal or vertical.
+bool isOrthogonal(QPolygonF const &route)
+{
+	for (int i = 1; i < route.size(); ++i) {
+		if (route[i - 1].x() != route[i].x() && route[i - 1].y() != route[i].y()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// Returns true if some segment of given route goes through the inside of given rectangle.
+bool crosses(QPolygonF const &route, QRectF const &rect)
+{
+	for (int i = 1; i < route.size(); ++i) {
+		QRectF const segment = QRectF(route[i - 1], route[i]).normalized();
+		if (segment.left() < rect.right() && segment.right() > rect.left()
+				&& segment.top() < rect.bottom() && segment.bottom() > rect.top())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+}
+
+TEST(OrthogonalRouterTest, straightRouteTest)
+{
+	int requests = 0;
+	QList<QRectF> const obstacles = QList<QRectF>() << QRectF(0, 0, 50, 50) << QRectF(300, 0, 50, 50);
+	OrthogonalRouter router(provider(obstacles, requests));
+
+	QPolygonF const route = router.route(QPointF(50, 25), obstacles[0], QPointF(300, 25), obstacles[1]);
+	EXPECT_EQ(QPolygonF() << QPointF(50, 25) << QPointF(300, 25), route);
+}
+
+TEST(OrthogonalRouterTest, avoidObstacleTest)
+{
+	int requests = 0;
+	QRectF const start(0, 0, 50, 50);
+	QRectF const end(300, 0, 50, 50);
+	QRectF const obstacle(150, -50, 50, 150);
+	QList<QRectF> const obstacles = QList<QRectF>() << start << end << obstacle;
+	OrthogonalRouter router(provider(obstacles, requests));
+
+	QPolygonF const route = router.route(QPointF(50, 25), start, QPointF(300, 25), end);
+	ASSERT_GE(route.size(), 2);
+	EXPECT_EQ(QPointF(50, 25), route.first());
+	EXPECT_EQ(QPointF(300, 25), route.last());
+	EXPECT_TRUE(isOrthogonal(route));
+	EXPECT_FALSE(crosses(route, obstacle));
+
+	// The route leaves the start node and enters the end node perpendicularly to their sides.
+	EXPECT_EQ(route[0].y(), route[1].y());
+	EXPECT_GT(route[1].x(), route[0].x());
+	EXPECT_EQ(route[route.size() - 2].y(), route.last().y());
+	EXPECT_LT(route[route.size() - 2].x(), route.last().x());
+}
+
+TEST(OrthogonalRouterTest, containerTest)
+{
+	int requests = 0;
+	QRectF const start(0, 0, 50, 50);
+	QRectF const end(300, 0, 50, 50);
+	QList<QRectF> const obstacles = QList<QRectF>() << QRectF(-100, -100, 550, 250) << start << end;
+	OrthogonalRouter router(provider(obstacles, requests));
+
+	QPolygonF const route = router.route(QPointF(50, 25), start, QPointF(300, 25), end);
+	EXPECT_EQ(QPolygonF() << QPointF(50, 25) << QPointF(300, 25), route);
+}
+
+TEST(OrthogonalRouterTest, cacheTest)
+{
+	int requests = 0;
+	QRectF const start(0, 0, 50, 50);
+	QRectF const end(300, 0, 50, 50);
+	QList<QRectF> obstacles = QList<QRectF>() << start << end << QRectF(150, -50, 50, 150);
+	OrthogonalRouter router(provider(obstacles, requests));
+
+	QPolygonF const route = router.route(QPointF(50, 25), start, QPointF(300, 25), end);
+	EXPECT_EQ(1, requests);
+
+	// Obstacles are requested once again only to check that the cached route is still valid.
+	EXPECT_EQ(route, router.route(QPointF(50, 25), start, QPointF(300, 25), end));
+	EXPECT_EQ(2, requests);
+
+	// Changed obstacles are noticed by the validation request, then the route is searched again.
+	obstacles[2].moveTop(-120);
+	QPolygonF const changed = router.route(QPointF(50, 25), start, QPointF(300, 25), end);
+	EXPECT_NE(route, changed);
+	EXPECT_FALSE(crosses(changed, obstacles[2]));
+	EXPECT_EQ(3, requests);
+}
+
+TEST(OrthogonalRouterTest, obstacleMovedAwayTest)
+{
+	int requests = 0;
+	QRectF const start(0, 0, 50, 50);
+	QRectF const end(300, 0, 50, 50);
+	QList<QRectF> obstacles = QList<QRectF>() << start << end << QRectF(150, -50, 50, 150);
+	OrthogonalRouter router(provider(obstacles, requests));
+
+	QPolygonF const detour = router.route(QPointF(50, 25), start, QPointF(300, 25), end);
+	EXPECT_GT(detour.size(), 2);
+
+	// When the obstacle leaves the area of the route, the cached detour is dropped.
+	obstacles[2].moveTo(1000, 1000);
+	EXPECT_EQ(QPolygonF() << QPointF(50, 25) << QPointF(300, 25)
+			, router.route(QPointF(50, 25), start, QPointF(300, 25), end));
+}
+
+/// Measures routing of 1000 links on a diagram with 900 nodes, with and without cached routes,
+/// run with --gtest_also_run_disabled_tests.
+TEST(OrthogonalRouterTest, DISABLED_routingBenchmark)
+{
+	int const side = 30;
+	qreal const spacing = 120;
+	qreal const size = 50;
+	int const linksCount = 1000;
+
+	int requests = 0;
+	QList<QRectF> nodes;
+	for (int i = 0; i < side * side; ++i) {
+		nodes << QRectF((i % side) * spacing, (i / side) * spacing, size, size);
+	}
+
+	qsrand(42);
+	QList<QPair<int, int> > links;
+	while (links.size() < linksCount) {
+		int const from = qrand() % nodes.size();
+		int const to = qBound(0, from + (qrand() % 5 - 2) + (qrand() % 5 - 2) * side, nodes.size() - 1);
+		if (from != to) {
+			links << qMakePair(from, to);
+		}
+	}
+
+	OrthogonalRouter router(provider(nodes, requests));
+	auto routeAll = [&]() {
+		int failures = 0;
+		typedef QPair<int, int> Link;
+		foreach (Link const &link, links) {
+			QRectF const &from = nodes[link.first];
+			QRectF const &to = nodes[link.second];
+			if (router.route(QPointF(from.right(), from.center().y()), from
+					, QPointF(to.left(), to.center().y()), to).isEmpty())
+			{
+				++failures;
+			}
+		}
+
+		return failures;
+	};
+
+	QElapsedTimer timer;
+	timer.start();
+	int const failures = routeAll();
+	qint64 const firstTime = timer.elapsed();
+
+	timer.start();
+	routeAll();
+	qint64 const cachedTime = timer.elapsed();
+
+	nodes[side * side / 2].translate(size / 2, size / 2);
+	timer.start();
+	routeAll();
+	qint64 const movedTime = timer.elapsed();
+
+	EXPECT_EQ(0, failures);
+	qDebug() << nodes.size() << "nodes," << links.size() << "links: route" << firstTime << "ms, with cached routes"
+			<< cachedTime << "ms, after moving a node" << movedTime << "ms";
+}
@@ -0,0 +1,256 @@
+#include "sdfRendererTest.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QDirIterator>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QMap>
+#include <QtCore/QTextStream>
+#include <QtGui/QPainter>
+
+#include <editorPluginInterface/elementRepoInterface.h>
+
+using namespace qrguiTests;
+using namespace qReal;
+
+namespace {
+
+QString const shape =
+		"<picture sizex=\"100\" sizey=\"50\">"
+		"<ellipse fill=\"#ff0000\" stroke=\"#000000\" stroke-width=\"2\" x1=\"0\" y1=\"0\" x2=\"100\" y2=\"50\"/>"
+		"<rectangle stroke=\"#0000ff\" stroke-style=\"dash\" fill-style=\"none\" x1=\"10%\" y1=\"10a\" x2=\"90%\" y2=\"40\"/>"
+		"<polygon fill=\"#00ff00\" n=\"3\" x1=\"50\" y1=\"5\" x2=\"60\" y2=\"20\" x3=\"40\" y3=\"20\"/>"
+		"<path stroke=\"#00ffff\" d=\" M 10 45 L 30 30 C 40 20 60 20 70 30 \"/>"
+		"<curve stroke=\"#ff00ff\"><start startx=\"0\" starty=\"50\"/><end endx=\"100\" endy=\"50\"/>"
+				"<ctrl x=\"50\" y=\"25\"/></curve>"
+		"<line stroke=\"#000000\" stroke-width=\"3\" x1=\"0\" y1=\"25\" x2=\"100\" y2=\"25\">"
+				"<showIf property=\"kind\" sign=\"=\" value=\"crossed\"/></line>"
+		"<stylus><line stroke=\"#000000\" x1=\"50\" y1=\"0\" x2=\"50\" y2=\"50\"/>"
+				"<showIf property=\"count\" sign=\"&gt;\" value=\"2\"/></stylus>"
+		"</picture>";
+
+QDomDocument document(QString const &picture)
+{
+	QDomDocument result;
+	result.setContent(picture);
+	return result;
+}
+
+/// Element repo with properties stored in a map.
+class ElementRepoStub : public ElementRepoInterface
+{
+public:
+	// Override.
+	virtual QString logicalProperty(QString const &roleName) const
+	{
+		return mProperties.value(roleName);
+	}
+
+	// Override.
+	virtual Id id() const
+	{
+		return Id();
+	}
+
+	// Override.
+	virtual QString name() const
+	{
+		return QString();
+	}
+
+	void setProperty(QString const &name, QString const &value)
+	{
+		mProperties[name] = value;
+	}
+
+private:
+	QMap<QString, QString> mProperties;
+};
+
+}
+
+void SdfRendererTest::SetUp()
+{
+	static int argc = 0;
+	static char *argv[] = {const_cast<char *>("")};
+	mApplication = new QApplication(argc, argv);
+}
+
+void SdfRendererTest::TearDown()
+{
+	delete mApplication;
+}
+
+QImage SdfRendererTest::paint(SdfRenderer &renderer, QSize const &size, QPoint const &offset) const
+{
+	QImage result(size + QSize(offset.x(), offset.y()), QImage::Format_ARGB32);
+	result.fill(Qt::white);
+	QPainter painter(&result);
+	renderer.render(&painter, QRectF(offset, size));
+	painter.end();
+	return result;
+}
+
+TEST_F(SdfRendererTest, cachedRenderTest)
+{
+	SdfRenderer cached;
+	cached.load(document(shape));
+	SdfRenderer uncached;
+	uncached.load(document(shape));
+	uncached.noCache();
+
+	foreach (QSize const &size, QList<QSize>() << QSize(100, 50) << QSize(230, 70)) {
+		QImage const expected = paint(uncached, size, QPoint(7, 5));
+		EXPECT_EQ(expected, paint(cached, size, QPoint(7, 5)));
+		// The second time the picture is taken from the cache.
+		EXPECT_EQ(expected, paint(cached, size, QPoint(7, 5)));
+		EXPECT_EQ(paint(uncached, size), paint(cached, size));
+	}
+}
+
+TEST_F(SdfRendererTest, showConditionsTest)
+{
+	ElementRepoStub repo;
+	SdfRenderer renderer;
+	renderer.load(document(shape));
+	renderer.setElementRepo(&repo);
+	SdfRenderer uncached;
+	uncached.load(document(shape));
+	uncached.setElementRepo(&repo);
+	uncached.noCache();
+
+	QImage const plain = paint(renderer, QSize(100, 50));
+
+	repo.setProperty("kind", "crossed");
+	QImage const crossed = paint(renderer, QSize(100, 50));
+	EXPECT_NE(plain, crossed);
+	EXPECT_EQ(paint(uncached, QSize(100, 50)), crossed);
+
+	repo.setProperty("count", "3");
+	QImage const crossedTwice = paint(renderer, QSize(100, 50));
+	EXPECT_NE(crossed, crossedTwice);
+	EXPECT_EQ(paint(uncached, QSize(100, 50)), crossedTwice);
+
+	// Properties not used by conditions do not affect the picture.
+	repo.setProperty("name", "renamed");
+	EXPECT_EQ(crossedTwice, paint(renderer, QSize(100, 50)));
+
+	repo.setProperty("kind", "");
+	repo.setProperty("count", "");
+	EXPECT_EQ(plain, paint(renderer, QSize(100, 50)));
+}
+
+TEST_F(SdfRendererTest, sharedFileTest)
+{
+	QFile file("sdfRendererTest.sdf");
+	ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Text));
+	QTextStream(&file) << shape;
+	file.close();
+
+	ElementRepoStub first;
+	ElementRepoStub second;
+	second.setProperty("kind", "crossed");
+
+	SdfRenderer firstRenderer;
+	ASSERT_TRUE(firstRenderer.load("sdfRendererTest.sdf"));
+	firstRenderer.setElementRepo(&first);
+	SdfRenderer secondRenderer;
+	ASSERT_TRUE(secondRenderer.load("sdfRendererTest.sdf"));
+	secondRenderer.setElementRepo(&second);
+	QFile::remove("sdfRendererTest.sdf");
+
+	EXPECT_EQ(100, secondRenderer.pictureWidth());
+	EXPECT_EQ(50, secondRenderer.pictureHeight());
+
+	// Renderers of the same shape share rendered pictures, but only for the same property values.
+	QImage const firstImage = paint(firstRenderer, QSize(100, 50));
+	QImage const secondImage = paint(secondRenderer, QSize(100, 50));
+	EXPECT_NE(firstImage, secondImage);
+	second.setProperty("kind", "");
+	EXPECT_EQ(firstImage, paint(secondRenderer, QSize(100, 50)));
+}
+
+/// Measures compilation and painting of shapes from bundled metamodels with and without reuse
+/// of rendered pictures, run with --gtest_also_run_disabled_tests.
+TEST_F(SdfRendererTest, DISABLED_paintBenchmark)
+{
+	QList<QDomDocument> pictures;
+	QDirIterator metamodels(METAMODELS_DIR, QStringList() << "*.xml", QDir::Files, QDirIterator::Subdirectories);
+	while (metamodels.hasNext()) {
+		QFile file(metamodels.next());
+		QDomDocument metamodel;
+		if (!file.open(QIODevice::ReadOnly) || !metamodel.setContent(&file)) {
+			continue;
+		}
+
+		QDomNodeList const pictureElements = metamodel.elementsByTagName("picture");
+		for (int i = 0; i < pictureElements.length(); ++i) {
+			QDomElement const picture = pictureElements.at(i).toElement();
+			if (picture.attribute("sizex").toInt() > 0 && picture.attribute("sizey").toInt() > 0
+					&& picture.hasChildNodes())
+			{
+				QDomDocument shapeDocument;
+				shapeDocument.appendChild(shapeDocument.importNode(picture, true));
+				pictures << shapeDocument;
+			}
+		}
+	}
+
+	ASSERT_FALSE(pictures.isEmpty()) << "No shapes found in " METAMODELS_DIR;
+
+	int const repeats = 20;
+	QList<QSize> const sizes = QList<QSize>() << QSize(50, 50) << QSize(100, 80) << QSize(200, 150);
+	QImage image(200, 150, QImage::Format_ARGB32_Premultiplied);
+	QPainter painter(&image);
+
+	QElapsedTimer timer;
+	timer.start();
+	QList<SdfRenderer *> renderers;
+	QList<SdfRenderer *> uncachedRenderers;
+	for (int i = 0; i < repeats; ++i) {
+		foreach (QDomDocument const &picture, pictures) {
+			SdfRenderer * const renderer = new SdfRenderer();
+			renderer->load(picture);
+			renderers << renderer;
+		}
+	}
+
+	qint64 const compileTime = timer.elapsed();
+	qDeleteAll(renderers.mid(pictures.size()));
+	renderers = renderers.mid(0, pictures.size());
+	foreach (QDomDocument const &picture, pictures) {
+		SdfRenderer * const renderer = new SdfRenderer();
+		renderer->load(picture);
+		renderer->noCache();
+		uncachedRenderers << renderer;
+	}
+
+	timer.start();
+	for (int i = 0; i < repeats; ++i) {
+		foreach (QSize const &size, sizes) {
+			foreach (SdfRenderer * const renderer, uncachedRenderers) {
+				renderer->render(&painter, QRectF(QPointF(), size));
+			}
+		}
+	}
+
+	qint64 const uncachedTime = timer.elapsed();
+
+	timer.start();
+	for (int i = 0; i < repeats; ++i) {
+		foreach (QSize const &size, sizes) {
+			foreach (SdfRenderer * const renderer, renderers) {
+				renderer->render(&painter, QRectF(QPointF(), size));
+			}
+		}
+	}
+
+	qint64 const cachedTime = timer.elapsed();
+
+	qDebug() << pictures.size() << "shapes," << repeats * sizes.size() << "paints of each: compile"
+			<< compileTime / repeats << "ms per pass, paint" << uncachedTime << "ms, paint with cache"
+			<< cachedTime << "ms";
+
+	qDeleteAll(renderers);
+	qDeleteAll(uncachedRenderers);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QtWidgets/QApplication>
+#include <QtGui/QImage>
+#include <gtest/gtest.h>
+
+#include <umllib/sdfRenderer.h>
+
+namespace qrguiTests {
+
+class SdfRendererTest : public testing::Test {
+
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+	/// Paints given renderer into a new image of given size at given offset.
+	QImage paint(qReal::SdfRenderer &renderer, QSize const &size, QPoint const &offset = QPoint()) const;
+
+	QApplication *mApplication;
+};
+
+}
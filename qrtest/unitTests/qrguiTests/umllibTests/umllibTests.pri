@@ -0,0 +1,10 @@
+# Bundled metamodels, their shapes are painted by the renderer benchmark.
+DEFINES += METAMODELS_DIR=\\\"$$PWD/../../../../plugins\\\"
+
+HEADERS += \
+	$$PWD/sdfRendererTest.h \
+
+SOURCES += \
+	$$PWD/sdfRendererTest.cpp \
+	$$PWD/levelOfDetailTest.cpp \
+	$$PWD/orthogonalRouterTest.cpp \
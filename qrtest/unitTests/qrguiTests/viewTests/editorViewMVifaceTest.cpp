@@ -0,0 +1,138 @@
+#include "editorViewMVifaceTest.h"
+
+#include <QtCore/QElapsedTimer>
+
+#include <view/editorViewScene.h>
+#include <view/private/editorViewMVIface.h>
+
+#include "../helpers/nodeElementImplStub.h"
+
+using namespace qrguiTests;
+using namespace qReal;
+using ::testing::_;
+using ::testing::InvokeWithoutArgs;
+
+namespace {
+
+ElementImpl *createNodeImpl()
+{
+	return new helpers::NodeElementImplStub();
+}
+
+}
+
+void EditorViewMVifaceTest::SetUp()
+{
+	static int argc = 0;
+	static char *argv[] = {const_cast<char *>("")};
+	mApplication = new QApplication(argc, argv);
+
+	ON_CALL(mEditorManager, elementImpl(_)).WillByDefault(InvokeWithoutArgs(&createNodeImpl));
+
+	mModels = new models::Models("", mEditorManager);
+	mView = new EditorView(nullptr);
+	mView->mvIface()->setAssistApi(mModels->graphicalModelAssistApi(), mModels->logicalModelAssistApi());
+	mView->mvIface()->setModel(mModels->graphicalModel());
+	mView->mvIface()->setLogicalModel(mModels->logicalModel());
+
+	mDiagram = Id("editor", "diagram", "diagramNode", "diagram");
+	mModels->graphicalModelAssistApi().createElement(Id::rootId(), mDiagram, false, "diagram", QPointF());
+}
+
+void EditorViewMVifaceTest::TearDown()
+{
+	delete mView;
+	delete mModels;
+	delete mApplication;
+}
+
+Id EditorViewMVifaceTest::createNode(Id const &parent, int index)
+{
+	Id const id("editor", "diagram", "node", QString("node%1").arg(index));
+	mModels->graphicalModelAssistApi().createElement(parent, id, false, QString("node %1").arg(index)
+			, QPointF(60 * (index % 100), 60 * (index / 100)));
+	return id;
+}
+
+void EditorViewMVifaceTest::open(Id const &diagram)
+{
+	mView->mvIface()->setRootIndex(mModels->graphicalModelAssistApi().indexById(diagram));
+}
+
+TEST_F(EditorViewMVifaceTest, resetTest)
+{
+	Id const first = createNode(mDiagram, 1);
+	Id const second = createNode(mDiagram, 2);
+	Id const nested = createNode(second, 3);
+
+	open(mDiagram);
+
+	EditorViewScene * const scene = mView->mvIface()->scene();
+	ASSERT_NE(nullptr, scene->getElem(first));
+	ASSERT_NE(nullptr, scene->getElem(second));
+	ASSERT_NE(nullptr, scene->getElem(nested));
+	ASSERT_EQ(scene->getElem(second), scene->getElem(nested)->parentItem());
+
+	Id const inserted = createNode(second, 4);
+	ASSERT_NE(nullptr, scene->getElem(inserted));
+
+	mView->mvIface()->reset();
+	ASSERT_NE(nullptr, scene->getElem(first));
+	ASSERT_NE(nullptr, scene->getElem(inserted));
+}
+
+TEST_F(EditorViewMVifaceTest, removeTest)
+{
+	Id const parent = createNode(mDiagram, 1);
+	Id const nested = createNode(parent, 2);
+	Id const other = createNode(mDiagram, 3);
+
+	open(mDiagram);
+
+	EditorViewScene * const scene = mView->mvIface()->scene();
+	mModels->graphicalModelAssistApi().removeElement(parent);
+	ASSERT_EQ(nullptr, scene->getElem(parent));
+	ASSERT_EQ(nullptr, scene->getElem(nested));
+	ASSERT_NE(nullptr, scene->getElem(other));
+
+	// Elements nested into the removed one shall be forgotten too, so reset does not touch deleted items.
+	mView->mvIface()->reset();
+	ASSERT_NE(nullptr, scene->getElem(other));
+}
+
+TEST_F(EditorViewMVifaceTest, dataChangedTest)
+{
+	Id const node = createNode(mDiagram, 1);
+	open(mDiagram);
+
+	mModels->graphicalModelAssistApi().setToolTip(node, "tool tip");
+	ASSERT_EQ(QString("tool tip"), mView->mvIface()->scene()->getElem(node)->toolTip());
+}
+
+/// Measures opening of a diagram and a bulk rename of its elements as the diagram grows,
+/// run with --gtest_also_run_disabled_tests.
+TEST_F(EditorViewMVifaceTest, DISABLED_resetBenchmark)
+{
+	open(mDiagram);
+
+	IdList nodes;
+	foreach (int const diagramSize, QList<int>() << 500 << 1000 << 2000 << 5000) {
+		while (nodes.size() < diagramSize) {
+			nodes << createNode(mDiagram, nodes.size());
+		}
+
+		QElapsedTimer timer;
+		timer.start();
+		mView->mvIface()->reset();
+		qint64 const resetTime = timer.elapsed();
+
+		timer.start();
+		foreach (Id const &node, nodes) {
+			mModels->graphicalModelAssistApi().setName(node, "renamed");
+		}
+
+		qint64 const renameTime = timer.elapsed();
+
+		qDebug() << diagramSize << "elements: reset" << resetTime << "ms, rename of all elements" << renameTime << "ms";
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QtWidgets/QApplication>
+#include <gtest/gtest.h>
+
+#include <models/models.h>
+#include <view/editorView.h>
+
+#include "../../mocks/grgui/pluginManager/editorManagerInterfaceMock.h"
+
+namespace qrguiTests {
+
+class EditorViewMVifaceTest : public testing::Test {
+
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+	/// Creates a node in the graphical model.
+	qReal::Id createNode(qReal::Id const &parent, int index);
+
+	/// Shows given diagram in the view.
+	void open(qReal::Id const &diagram);
+
+protected:
+	QApplication *mApplication;
+	testing::NiceMock<qrTest::EditorManagerInterfaceMock> mEditorManager;
+	qReal::models::Models *mModels;
+	qReal::EditorView *mView;
+	qReal::Id mDiagram;
+};
+
+}
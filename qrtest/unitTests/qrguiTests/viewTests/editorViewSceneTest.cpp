@@ -0,0 +1,463 @@
+#include "editorViewSceneTest.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtGui/QFocusEvent>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <QtWidgets/QGraphicsEffect>
+#include <QtWidgets/QGraphicsSceneMouseEvent>
+
+#include <qrkernel/settingsManager.h>
+
+#include <umllib/private/levelOfDetail.h>
+#include <view/private/editorViewMVIface.h>
+
+#include "../helpers/nodeElementImplStub.h"
+
+using namespace qrguiTests;
+using namespace qReal;
+using ::testing::_;
+using ::testing::InvokeWithoutArgs;
+using ::testing::Truly;
+
+namespace {
+
+/// Element without implementation, enough to be found, highlighted and removed by the scene.
+class ElementStub : public Element
+{
+public:
+	ElementStub(Id const &id, models::Models &models)
+		: Element(nullptr, id, models.graphicalModelAssistApi(), models.logicalModelAssistApi())
+	{
+	}
+
+	bool initPossibleEdges() override
+	{
+		return false;
+	}
+
+	void setColorRect(bool bl) override
+	{
+		Q_UNUSED(bl)
+	}
+
+	QRectF boundingRect() const override
+	{
+		return QRectF(0, 0, 10, 10);
+	}
+
+	void paint(QPainter *painter, QStyleOptionGraphicsItem const *option, QWidget *widget) override
+	{
+		Q_UNUSED(painter)
+		Q_UNUSED(option)
+		Q_UNUSED(widget)
+	}
+};
+
+Id elementId(int index)
+{
+	return Id("editor", "diagram", "element", QString("id%1").arg(index));
+}
+
+/// Plain link with the looks of the node stub.
+class EdgeElementImplStub : public helpers::NodeElementImplStub
+{
+public:
+	bool isNode() const override
+	{
+		return false;
+	}
+};
+
+ElementImpl *createNodeImpl()
+{
+	return new helpers::NodeElementImplStub();
+}
+
+ElementImpl *createEdgeImpl()
+{
+	return new EdgeElementImplStub();
+}
+
+bool isEdge(Id const &id)
+{
+	return id.element() == "edge";
+}
+
+void sendMouseEvent(EditorViewScene *scene, QEvent::Type type, Qt::MouseButton button, QPointF const &scenePos)
+{
+	QGraphicsSceneMouseEvent event(type);
+	event.setButton(button);
+	event.setButtons(type == QEvent::GraphicsSceneMouseRelease ? Qt::NoButton : Qt::MouseButtons(Qt::LeftButton));
+	event.setScenePos(scenePos);
+	QApplication::sendEvent(scene, &event);
+}
+
+/// Drags the mouse over an empty part of the diagram without releasing it.
+void startDragging(EditorViewScene *scene)
+{
+	sendMouseEvent(scene, QEvent::GraphicsSceneMousePress, Qt::LeftButton, QPointF(1000, 1000));
+	sendMouseEvent(scene, QEvent::GraphicsSceneMouseMove, Qt::NoButton, QPointF(1100, 1100));
+}
+
+void finishDragging(EditorViewScene *scene)
+{
+	sendMouseEvent(scene, QEvent::GraphicsSceneMouseRelease, Qt::LeftButton, QPointF(1100, 1100));
+}
+
+}
+
+void EditorViewSceneTest::SetUp()
+{
+	static int argc = 0;
+	static char *argv[] = {const_cast<char *>("")};
+	mApplication = new QApplication(argc, argv);
+
+	ON_CALL(mEditorManager, elementImpl(_)).WillByDefault(InvokeWithoutArgs(&createNodeImpl));
+	ON_CALL(mEditorManager, elementImpl(Truly(&isEdge))).WillByDefault(InvokeWithoutArgs(&createEdgeImpl));
+
+	mModels = new models::Models("", mEditorManager);
+	mScene = new EditorViewScene(nullptr);
+
+	mView = new EditorView(nullptr);
+	mView->mvIface()->setAssistApi(mModels->graphicalModelAssistApi(), mModels->logicalModelAssistApi());
+	mView->mvIface()->setModel(mModels->graphicalModel());
+	mView->mvIface()->setLogicalModel(mModels->logicalModel());
+
+	mDiagram = Id("editor", "diagram", "diagramNode", "diagram");
+	mModels->graphicalModelAssistApi().createElement(Id::rootId(), mDiagram, false, "diagram", QPointF());
+}
+
+void EditorViewSceneTest::TearDown()
+{
+	delete mView;
+	delete mScene;
+	delete mModels;
+	delete mApplication;
+}
+
+Element *EditorViewSceneTest::addElement(Id const &id)
+{
+	Element * const element = new ElementStub(id, *mModels);
+	mScene->addItem(element);
+	return element;
+}
+
+Id EditorViewSceneTest::createNode(Id const &parent, int index)
+{
+	Id const id("editor", "diagram", "node", QString("node%1").arg(index));
+	mModels->graphicalModelAssistApi().createElement(parent, id, false, QString("node %1").arg(index)
+			, QPointF(60 * (index % 100), 60 * (index / 100)));
+	return id;
+}
+
+EditorViewScene *EditorViewSceneTest::open(Id const &diagram)
+{
+	mView->mvIface()->setRootIndex(mModels->graphicalModelAssistApi().indexById(diagram));
+	return mView->mvIface()->scene();
+}
+
+TEST_F(EditorViewSceneTest, getElemTest)
+{
+	Element * const first = addElement(elementId(1));
+	Element * const second = addElement(elementId(2));
+
+	ASSERT_EQ(first, mScene->getElem(elementId(1)));
+	ASSERT_EQ(second, mScene->getElem(elementId(2)));
+	ASSERT_EQ(nullptr, mScene->getElem(elementId(3)));
+	ASSERT_EQ(nullptr, mScene->getElem(Id::rootId()));
+	ASSERT_EQ(nullptr, mScene->getNodeById(elementId(1)));
+	ASSERT_EQ(nullptr, mScene->getEdgeById(elementId(1)));
+
+	mScene->removeItem(first);
+	ASSERT_EQ(nullptr, mScene->getElem(elementId(1)));
+
+	mScene->addItem(first);
+	ASSERT_EQ(first, mScene->getElem(elementId(1)));
+
+	delete second;
+	ASSERT_EQ(nullptr, mScene->getElem(elementId(2)));
+}
+
+TEST_F(EditorViewSceneTest, childElementsTest)
+{
+	Element * const parent = addElement(elementId(1));
+	Element * const child = new ElementStub(elementId(2), *mModels);
+
+	child->setParentItem(parent);
+	ASSERT_EQ(child, mScene->getElem(elementId(2)));
+
+	mScene->removeItem(parent);
+	ASSERT_EQ(nullptr, mScene->getElem(elementId(2)));
+
+	mScene->addItem(parent);
+	ASSERT_EQ(child, mScene->getElem(elementId(2)));
+
+	delete parent;
+	ASSERT_EQ(nullptr, mScene->getElem(elementId(1)));
+	ASSERT_EQ(nullptr, mScene->getElem(elementId(2)));
+}
+
+TEST_F(EditorViewSceneTest, highlightTest)
+{
+	Element * const element = addElement(elementId(1));
+
+	mScene->highlight(elementId(1));
+	ASSERT_NE(nullptr, element->graphicsEffect());
+
+	mScene->dehighlight(elementId(1));
+	ASSERT_EQ(nullptr, element->graphicsEffect());
+
+	mScene->highlight(elementId(1));
+	delete element;
+	mScene->highlight(elementId(2));
+}
+
+TEST_F(EditorViewSceneTest, spatialIndexTest)
+{
+	Id const first = createNode(mDiagram, 1);
+	Id const second = createNode(mDiagram, 2);
+	Id const nested = createNode(second, 0);
+
+	EditorViewScene * const scene = open(mDiagram);
+	NodeElement * const firstNode = scene->getNodeById(first);
+	NodeElement * const secondNode = scene->getNodeById(second);
+	NodeElement * const nestedNode = scene->getNodeById(nested);
+
+	// Nested nodes are found before their parents, like the scene itself orders them.
+	EXPECT_EQ(QList<NodeElement *>() << nestedNode << secondNode, scene->nodesAt(QPointF(145, 25)));
+	EXPECT_EQ(QList<NodeElement *>() << firstNode, scene->nodesAt(QPointF(85, 25)));
+	EXPECT_TRUE(scene->nodesAt(QPointF(1000, 1000)).isEmpty());
+
+	firstNode->setPos(QPointF(300, 300));
+	EXPECT_TRUE(scene->nodesAt(QPointF(85, 25)).isEmpty());
+	EXPECT_EQ(QList<NodeElement *>() << firstNode, scene->nodesAt(QPointF(325, 325)));
+
+	// Nested nodes move together with their parent.
+	secondNode->setPos(QPointF(600, 600));
+	EXPECT_TRUE(scene->nodesAt(QPointF(145, 25)).isEmpty());
+	EXPECT_EQ(QList<NodeElement *>() << nestedNode << secondNode, scene->nodesAt(QPointF(625, 625)));
+
+	firstNode->setPos(QPointF(610, 610));
+	QList<NodeElement *> const closeNodes = scene->getCloseNodes(firstNode);
+	EXPECT_EQ(2, closeNodes.size());
+	EXPECT_TRUE(closeNodes.contains(secondNode));
+	EXPECT_TRUE(closeNodes.contains(nestedNode));
+	EXPECT_TRUE(scene->getCloseNodes(nestedNode).contains(firstNode));
+	EXPECT_FALSE(scene->getCloseNodes(nestedNode).contains(secondNode));
+
+	mModels->graphicalModelAssistApi().removeElement(first);
+	EXPECT_EQ(QList<NodeElement *>() << nestedNode << secondNode, scene->nodesAt(QPointF(625, 625)));
+}
+
+TEST_F(EditorViewSceneTest, restackedSiblingsTest)
+{
+	Id const parent = createNode(mDiagram, 1);
+	Id const lower = createNode(parent, 0);
+	Id const upper = createNode(parent, 100);
+
+	EditorViewScene * const scene = open(mDiagram);
+	NodeElement * const parentNode = scene->getNodeById(parent);
+	NodeElement * const lowerNode = scene->getNodeById(lower);
+	NodeElement * const upperNode = scene->getNodeById(upper);
+	upperNode->setPos(lowerNode->pos());
+	QPointF const point = lowerNode->mapToScene(QPointF(5, 5));
+	EXPECT_EQ(QList<NodeElement *>() << upperNode << lowerNode << parentNode, scene->nodesAt(point));
+
+	// Siblings are ordered by their stacking order, not by the order they were created in.
+	upperNode->stackBefore(lowerNode);
+	EXPECT_EQ(QList<NodeElement *>() << lowerNode << upperNode << parentNode, scene->nodesAt(point));
+}
+
+TEST_F(EditorViewSceneTest, deferredLinksTest)
+{
+	Id const node = createNode(mDiagram, 1);
+	EditorViewScene * const scene = open(mDiagram);
+	NodeElement * const nodeElement = scene->getNodeById(node);
+	EXPECT_FALSE(scene->deferLinksAdjustment(nodeElement));
+
+	sendMouseEvent(scene, QEvent::GraphicsSceneMousePress, Qt::LeftButton, QPointF(1000, 1000));
+	EXPECT_FALSE(scene->deferLinksAdjustment(nodeElement));
+
+	sendMouseEvent(scene, QEvent::GraphicsSceneMouseMove, Qt::NoButton, QPointF(1100, 1100));
+	EXPECT_TRUE(scene->deferLinksAdjustment(nodeElement));
+
+	finishDragging(scene);
+	EXPECT_FALSE(scene->deferLinksAdjustment(nodeElement));
+
+	// Dragging is finished when the scene loses focus and the release goes elsewhere.
+	startDragging(scene);
+	EXPECT_TRUE(scene->deferLinksAdjustment(nodeElement));
+	QFocusEvent focusOut(QEvent::FocusOut);
+	QApplication::sendEvent(scene, &focusOut);
+	EXPECT_FALSE(scene->deferLinksAdjustment(nodeElement));
+}
+
+TEST_F(EditorViewSceneTest, deferredEdgeSaveTest)
+{
+	Id const edge("editor", "diagram", "edge", "edge");
+	mModels->graphicalModelAssistApi().createElement(mDiagram, edge, false, "edge", QPointF());
+	EditorViewScene * const scene = open(mDiagram);
+	EdgeElement * const edgeElement = dynamic_cast<EdgeElement *>(scene->getElem(edge));
+	ASSERT_NE(nullptr, edgeElement);
+
+	QPolygonF const line = QPolygonF() << QPointF(0, 0) << QPointF(100, 0) << QPointF(100, 100);
+	startDragging(scene);
+	edgeElement->setLine(line);
+	edgeElement->saveConfiguration();
+	EXPECT_NE(line.toPolygon(), mModels->graphicalModelAssistApi().configuration(edge));
+
+	// The configuration kept by the edge during dragging reaches the model on release.
+	finishDragging(scene);
+	EXPECT_EQ(line.toPolygon(), mModels->graphicalModelAssistApi().configuration(edge));
+}
+
+TEST_F(EditorViewSceneTest, deferredElementsDeletedTest)
+{
+	Id const parent = createNode(mDiagram, 1);
+	Id const nested = createNode(parent, 2);
+	Id const node = createNode(mDiagram, 3);
+	Id const edge("editor", "diagram", "edge", "edge");
+	mModels->graphicalModelAssistApi().createElement(mDiagram, edge, false, "edge", QPointF());
+	EditorViewScene * const scene = open(mDiagram);
+
+	// Nested nodes are deleted together with their parent, without being removed from the scene first.
+	startDragging(scene);
+	EXPECT_TRUE(scene->deferLinksAdjustment(scene->getNodeById(nested)));
+	mModels->graphicalModelAssistApi().removeElement(parent);
+	finishDragging(scene);
+
+	// Reset deletes all elements of the scene the same way.
+	startDragging(scene);
+	EXPECT_TRUE(scene->deferLinksAdjustment(scene->getNodeById(node)));
+	EXPECT_TRUE(scene->deferModelUpdate(scene->getEdgeById(edge)));
+	mView->mvIface()->reset();
+	finishDragging(scene);
+
+	EXPECT_NE(nullptr, scene->getNodeById(node));
+	EXPECT_NE(nullptr, scene->getEdgeById(edge));
+}
+
+/// Measures the cost of a highlight step of an interpreter as a diagram grows,
+/// run with --gtest_also_run_disabled_tests.
+TEST_F(EditorViewSceneTest, DISABLED_highlightBenchmark)
+{
+	int const steps = 10000;
+	int elementsCount = 0;
+	foreach (int const diagramSize, QList<int>() << 100 << 1000 << 5000 << 20000) {
+		for (; elementsCount < diagramSize; ++elementsCount) {
+			addElement(elementId(elementsCount));
+		}
+
+		QElapsedTimer timer;
+		timer.start();
+		for (int step = 0; step < steps; ++step) {
+			Id const id = elementId(qrand() % elementsCount);
+			mScene->highlight(id, false);
+			mScene->dehighlight(id);
+		}
+
+		qDebug() << diagramSize << "elements:" << timer.nsecsElapsed() / 1000.0 / steps << "us per highlight step";
+	}
+}
+
+/// Measures frames per second of panning over a diagram of 10000 nodes at several zoom levels with and without
+/// simplified drawing of zoomed out elements, run with --gtest_also_run_disabled_tests.
+TEST_F(EditorViewSceneTest, DISABLED_paintBenchmark)
+{
+	for (int i = 0; i < 10000; ++i) {
+		createNode(mDiagram, i);
+	}
+
+	EditorViewScene * const scene = open(mDiagram);
+	QVariant const simplifiedDrawingZoom = SettingsManager::value("SimplifiedDrawingZoom");
+	QVariant const minimalDetailSize = SettingsManager::value("MinimalDetailSize");
+	QImage frame(1024, 768, QImage::Format_ARGB32_Premultiplied);
+	int const framesCount = 20;
+
+	foreach (bool const levelOfDetail, QList<bool>() << false << true) {
+		SettingsManager::setValue("SimplifiedDrawingZoom", levelOfDetail ? simplifiedDrawingZoom : 0);
+		SettingsManager::setValue("MinimalDetailSize", levelOfDetail ? minimalDetailSize : 0);
+		LevelOfDetail::reloadSettings();
+
+		foreach (qreal const zoom, QList<qreal>() << 1 << 0.5 << 0.25 << 0.1) {
+			QSizeF const visibleSize(frame.width() / zoom, frame.height() / zoom);
+			QElapsedTimer timer;
+			timer.start();
+			for (int i = 0; i < framesCount; ++i) {
+				frame.fill(Qt::white);
+				QPainter painter(&frame);
+				painter.setRenderHint(QPainter::Antialiasing);
+				// Pans diagonally over the diagram.
+				scene->render(&painter, frame.rect(), QRectF(QPointF(i * 100, i * 100), visibleSize));
+			}
+
+			qDebug() << "zoom" << zoom << (levelOfDetail ? "with" : "without") << "level of detail:"
+					<< framesCount * 1000.0 / qMax<qint64>(timer.elapsed(), 1) << "frames per second";
+		}
+	}
+
+	SettingsManager::setValue("SimplifiedDrawingZoom", simplifiedDrawingZoom);
+	SettingsManager::setValue("MinimalDetailSize", minimalDetailSize);
+	LevelOfDetail::reloadSettings();
+}
+
+/// Measures lookups done while a node is dragged across a diagram of 5000 nodes: searching for a new parent
+/// under the node and for nodes it overlaps, compared with walking through scene items,
+/// run with --gtest_also_run_disabled_tests.
+TEST_F(EditorViewSceneTest, DISABLED_dragBenchmark)
+{
+	for (int i = 0; i < 5000; ++i) {
+		createNode(mDiagram, i);
+	}
+
+	EditorViewScene * const scene = open(mDiagram);
+	NodeElement * const dragged = scene->getNodeById(Id("editor", "diagram", "node", "node0"));
+	int const stepsCount = 500;
+	QPointF const step(6000.0 / stepsCount, 3000.0 / stepsCount);
+
+	QElapsedTimer timer;
+	timer.start();
+	int found = 0;
+	for (int i = 0; i < stepsCount; ++i) {
+		dragged->setPos(step * i);
+		QPointF const center = dragged->mapToScene(dragged->boundingRect().center());
+		foreach (QGraphicsItem * const item, scene->items(center)) {
+			NodeElement * const node = dynamic_cast<NodeElement *>(item);
+			if (node && node != dragged) {
+				++found;
+				break;
+			}
+		}
+
+		foreach (QGraphicsItem * const item, scene->items(dragged->mapToScene(dragged->boundingRect()))) {
+			NodeElement * const node = dynamic_cast<NodeElement *>(item);
+			if (node && node != dragged) {
+				++found;
+			}
+		}
+	}
+
+	qint64 const itemsTime = timer.elapsed();
+
+	timer.start();
+	int foundByIndex = 0;
+	for (int i = 0; i < stepsCount; ++i) {
+		dragged->setPos(step * i);
+		QPointF const center = dragged->mapToScene(dragged->boundingRect().center());
+		foreach (NodeElement * const node, scene->nodesAt(center)) {
+			if (node != dragged) {
+				++foundByIndex;
+				break;
+			}
+		}
+
+		foundByIndex += scene->getCloseNodes(dragged).size();
+	}
+
+	qint64 const indexTime = timer.elapsed();
+
+	EXPECT_EQ(found, foundByIndex);
+	qDebug() << stepsCount << "drag steps over 5000 nodes: scene items" << itemsTime << "ms, spatial index"
+			<< indexTime << "ms";
+}
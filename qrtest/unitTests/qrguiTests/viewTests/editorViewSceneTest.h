@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QtWidgets/QApplication>
+#include <gtest/gtest.h>
+
+#include <models/models.h>
+#include <view/editorView.h>
+#include <view/editorViewScene.h>
+
+#include "../../mocks/grgui/pluginManager/editorManagerInterfaceMock.h"
+
+namespace qrguiTests {
+
+class EditorViewSceneTest : public testing::Test {
+
+protected:
+	virtual void SetUp();
+	virtual void TearDown();
+
+	/// Creates a stub element with given id and adds it to the scene.
+	qReal::Element *addElement(qReal::Id const &id);
+
+	/// Creates a node in the graphical model.
+	qReal::Id createNode(qReal::Id const &parent, int index);
+
+	/// Shows given diagram in the view and returns the scene of the view with nodes and edges of the diagram.
+	qReal::EditorViewScene *open(qReal::Id const &diagram);
+
+protected:
+	QApplication *mApplication;
+	testing::NiceMock<qrTest::EditorManagerInterfaceMock> mEditorManager;
+	qReal::models::Models *mModels;
+
+	/// Scene without a model for stub elements.
+	qReal::EditorViewScene *mScene;
+
+	/// View of diagrams of the model.
+	qReal::EditorView *mView;
+	qReal::Id mDiagram;
+};
+
+}
@@ -0,0 +1,10 @@
+HEADERS += \
+	$$PWD/../../mocks/grgui/pluginManager/editorManagerInterfaceMock.h \
+
+HEADERS += \
+	$$PWD/editorViewSceneTest.h \
+	$$PWD/editorViewMVifaceTest.h \
+
+SOURCES += \
+	$$PWD/editorViewSceneTest.cpp \
+	$$PWD/editorViewMVifaceTest.cpp \
@@ -1,5 +1,7 @@
 #include <QtCore/QFile>
 #include <QtCore/QVariant>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QUuid>
 
 #include "../../../qrkernel/ids.h"
 
@@ -147,3 +149,109 @@ TEST(IdsTest, idInputOutputStreamTest) {
 
 	EXPECT_EQ(in, out);
 }
+
+TEST(IdsTest, guidPartTest) {
+	Id const id = Id::createElementId("editor", "diagram", "element");
+	Id const loaded = Id::loadFromString(id.toString());
+	EXPECT_EQ(loaded, id);
+	EXPECT_EQ(qHash(loaded), qHash(id));
+	EXPECT_EQ(loaded.id(), id.id());
+
+	// Strings that only look like GUIDs must be kept as is.
+	QString const upperCaseGuid = QUuid::createUuid().toString().toUpper();
+	EXPECT_EQ(Id("editor", "diagram", "element", upperCaseGuid).id(), upperCaseGuid);
+	EXPECT_NE(Id("editor", "diagram", "element", upperCaseGuid)
+			, Id("editor", "diagram", "element", upperCaseGuid.toLower()));
+}
+
+TEST(IdsTest, orderingTest) {
+	IdList ids;
+	ids << Id("b") << Id("a", "z") << Id("a", "b", "c") << Id("a", "b", "c", "d") << Id("a", "b", "c", "a")
+			<< Id::loadFromString("qrm:/a/b/c/{00000000-0000-0000-0000-000000000001}")
+			<< Id::loadFromString("qrm:/a/b/c/{10000000-0000-0000-0000-000000000000}")
+			<< Id::loadFromString("qrm:/a/b/c/{00000000-0000-0000-0000-000000000010}");
+
+	foreach (Id const &first, ids) {
+		EXPECT_FALSE(first < first);
+		foreach (Id const &second, ids) {
+			if (first != second) {
+				EXPECT_NE(first < second, second < first);
+				EXPECT_EQ(first < second, first.toString() < second.toString());
+			}
+		}
+	}
+}
+
+namespace {
+
+/// Id as it was before interning its parts, used only for comparison in benchmark.
+struct LegacyId
+{
+	LegacyId(QString const &editor, QString const &diagram, QString const &element, QString const &id)
+		: mEditor(editor), mDiagram(diagram), mElement(element), mId(id)
+	{
+	}
+
+	bool operator==(LegacyId const &other) const
+	{
+		return mEditor == other.mEditor && mDiagram == other.mDiagram
+				&& mElement == other.mElement && mId == other.mId;
+	}
+
+	QString mEditor;
+	QString mDiagram;
+	QString mElement;
+	QString mId;
+};
+
+uint qHash(LegacyId const &key)
+{
+	return qHash(key.mEditor) ^ qHash(key.mDiagram) ^ qHash(key.mElement) ^ qHash(key.mId);
+}
+
+}
+
+/// Compares hash operations on interned and string-based ids, run with --gtest_also_run_disabled_tests.
+TEST(IdsTest, DISABLED_hashBenchmark) {
+	int const count = 200000;
+	QList<Id> ids;
+	QList<LegacyId> legacyIds;
+	for (int i = 0; i < count; ++i) {
+		Id const id = Id::createElementId("editor", "diagram", QString("Element%1").arg(i % 50));
+		ids << id;
+		legacyIds << LegacyId(id.editor(), id.diagram(), id.element(), id.id());
+	}
+
+	QElapsedTimer timer;
+
+	timer.start();
+	QHash<LegacyId, int> legacyHash;
+	for (int i = 0; i < count; ++i) {
+		legacyHash.insert(legacyIds[i], i);
+	}
+
+	int legacyFound = 0;
+	for (int i = 0; i < count; ++i) {
+		legacyFound += legacyHash.contains(legacyIds[i]) ? 1 : 0;
+	}
+
+	qint64 const legacyTime = timer.elapsed();
+
+	timer.start();
+	QHash<Id, int> hash;
+	for (int i = 0; i < count; ++i) {
+		hash.insert(ids[i], i);
+	}
+
+	int found = 0;
+	for (int i = 0; i < count; ++i) {
+		found += hash.contains(ids[i]) ? 1 : 0;
+	}
+
+	qint64 const time = timer.elapsed();
+
+	EXPECT_EQ(legacyFound, count);
+	EXPECT_EQ(found, count);
+	qDebug() << count << "inserts and lookups: string ids" << legacyTime << "ms, interned ids" << time << "ms";
+	qDebug() << "sizeof: string ids" << sizeof(LegacyId) << ", interned ids" << sizeof(Id);
+}
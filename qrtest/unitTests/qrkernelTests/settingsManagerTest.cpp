@@ -1,5 +1,7 @@
 #include "settingsManagerTest.h"
 
+#include <QtCore/QFile>
+
 using namespace qrTest;
 
 void SettingsManagerTest::SetUp() {
@@ -8,6 +10,7 @@ void SettingsManagerTest::SetUp() {
 }
 
 void SettingsManagerTest::TearDown() {
+	mSettingsManager->setReadOnly(false);
 	mSettingsManager->setValue("debugColor", mDebugColor);
 	mSettingsManager->saveData();
 }
@@ -36,3 +39,47 @@ TEST_F(SettingsManagerTest, defaultValueTest) {
 	QString const val = mSettingsManager->value("aabbccTestProperty", "default value").toString();
 	EXPECT_EQ(val, "default value");
 }
+
+TEST_F(SettingsManagerTest, readOnlyTest) {
+	QSettings const persistent("SPbSU", "QReal");
+	QVariant const autosave = persistent.value("Autosave");
+	QVariant const journal = persistent.value("ProjectJournal");
+	QVariant const temp = persistent.value("temp");
+	QVariant const debugColor = persistent.value("debugColor");
+	QVariant const currentAutosave = mSettingsManager->value("Autosave");
+	QVariant const currentJournal = mSettingsManager->value("ProjectJournal");
+	QVariant const currentTemp = mSettingsManager->value("temp");
+
+	mSettingsManager->setReadOnly(true);
+	mSettingsManager->setValue("Autosave", !autosave.toBool());
+	mSettingsManager->setValue("ProjectJournal", !journal.toBool());
+	mSettingsManager->setValue("temp", "/tmp/readOnlyTest");
+	mSettingsManager->setValue("debugColor", "test color");
+	EXPECT_EQ(mSettingsManager->value("temp").toString(), "/tmp/readOnlyTest");
+
+	// Preferences dialog saves settings when they are applied.
+	mSettingsManager->saveData();
+
+	// Importing settings saves them too.
+	QString const importedFile = "settingsManagerTest.ini";
+	{
+		QSettings imported(importedFile, QSettings::IniFormat);
+		imported.setValue("debugColor", "imported color");
+	}
+
+	mSettingsManager->loadSettings(importedFile);
+	QFile::remove(importedFile);
+	EXPECT_EQ(mSettingsManager->value("debugColor").toString(), "imported color");
+
+	QSettings stored("SPbSU", "QReal");
+	stored.sync();
+	EXPECT_EQ(stored.value("Autosave"), autosave);
+	EXPECT_EQ(stored.value("ProjectJournal"), journal);
+	EXPECT_EQ(stored.value("temp"), temp);
+	EXPECT_EQ(stored.value("debugColor"), debugColor);
+
+	// Settings are saved after the test, they shall be as they were.
+	mSettingsManager->setValue("Autosave", currentAutosave);
+	mSettingsManager->setValue("ProjectJournal", currentJournal);
+	mSettingsManager->setValue("temp", currentTemp);
+}
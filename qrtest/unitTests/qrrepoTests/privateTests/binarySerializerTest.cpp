@@ -0,0 +1,270 @@
+#include "../../../qrrepo/private/binarySerializer.h"
+#include "../../../qrrepo/private/serializer.h"
+#include "../../../qrrepo/private/repository.h"
+#include "../../../qrrepo/private/classes/logicalObject.h"
+#include "../../../qrrepo/private/classes/graphicalObject.h"
+#include "../../../qrkernel/exception/exception.h"
+#include "../../../qrkernel/settingsManager.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPointF>
+#include <QtGui/QPolygon>
+#include <gtest/gtest.h>
+
+using namespace qReal;
+using namespace qrRepo::details;
+
+namespace {
+
+/// Generates a model with given number of logical elements, each of them has a graphical representation.
+QList<Object *> generateModel(int elementsCount)
+{
+	QList<Object *> result;
+	Id const diagram = Id::createElementId("editor", "diagram", "Diagram");
+	LogicalObject * const logicalDiagram = new LogicalObject(diagram);
+	logicalDiagram->setParent(Id::rootId());
+	logicalDiagram->setProperty("name", "diagram");
+	result << logicalDiagram;
+
+	for (int i = 0; i < elementsCount; ++i) {
+		Id const logicalId = Id::createElementId("editor", "diagram", "Element");
+		LogicalObject * const logical = new LogicalObject(logicalId);
+		logical->setParent(diagram);
+		logical->setProperty("name", QString("element %1").arg(i));
+		logical->setProperty("links", IdListHelper::toVariant(IdList()));
+		logicalDiagram->addChild(logicalId);
+
+		GraphicalObject * const graphical = new GraphicalObject(logicalId.sameTypeId(), Id::rootId(), logicalId);
+		graphical->setProperty("position", QPointF(i, 2 * i));
+		graphical->setProperty("configuration", QPolygonF() << QPointF(0, 0) << QPointF(50, 50));
+		graphical->setProperty("expanded", false);
+
+		result << logical << graphical;
+	}
+
+	return result;
+}
+
+}
+
+TEST(BinarySerializerTest, saveAndLoadTest)
+{
+	Id const logicalId("editor", "diagram", "element", "logical");
+	Id const graphicalId("editor", "diagram", "element", "graphical");
+	Id const childId("editor", "diagram", "element", "child");
+
+	LogicalObject logical(logicalId);
+	logical.setParent(Id::rootId());
+	logical.addChild(childId);
+	logical.setProperty("int", -5);
+	logical.setProperty("uint", 5u);
+	logical.setProperty("double", 0.1);
+	logical.setProperty("bool", true);
+	logical.setProperty("string", QString::fromUtf8("строка"));
+	logical.setProperty("stringList", QStringList() << "a" << "b");
+	logical.setProperty("char", QChar('c'));
+	logical.setProperty("id", childId.toVariant());
+	logical.setProperty("idList", IdListHelper::toVariant(IdList() << childId << graphicalId));
+
+	GraphicalObject graphical(graphicalId, Id::rootId(), logicalId);
+	graphical.setProperty("position", QPointF(1.5, -2.5));
+	graphical.setProperty("polygon", QPolygon() << QPoint(1, 2) << QPoint(3, 4));
+	graphical.setProperty("polygonF", QPolygonF() << QPointF(0.5, 1) << QPointF(2, 3));
+	graphical.createGraphicalPart(1);
+	graphical.setGraphicalPartProperty(1, "Coord", QPointF(10, 20));
+
+	QList<Object *> list;
+	list << &logical << &graphical;
+	BinarySerializer::save("binaryTest.qrb", list);
+
+	QHash<Id, Object *> map;
+	BinarySerializer::load("binaryTest.qrb", map);
+	QFile::remove("binaryTest.qrb");
+
+	ASSERT_EQ(map.size(), 2);
+	ASSERT_TRUE(map.contains(logicalId));
+	ASSERT_TRUE(map.contains(graphicalId));
+
+	Object const * const loadedLogical = map[logicalId];
+	EXPECT_TRUE(loadedLogical->isLogicalObject());
+	EXPECT_EQ(loadedLogical->parent(), Id::rootId());
+	EXPECT_EQ(loadedLogical->children(), IdList() << childId);
+	EXPECT_EQ(loadedLogical->properties(), logical.properties());
+
+	GraphicalObject const * const loadedGraphical = dynamic_cast<GraphicalObject const *>(map[graphicalId]);
+	ASSERT_TRUE(loadedGraphical != NULL);
+	EXPECT_EQ(loadedGraphical->logicalId(), logicalId);
+	EXPECT_EQ(loadedGraphical->properties(), graphical.properties());
+	EXPECT_EQ(loadedGraphical->graphicalPartProperty(1, "Coord"), QVariant(QPointF(10, 20)));
+
+	qDeleteAll(map);
+}
+
+TEST(BinarySerializerTest, corruptedFileTest)
+{
+	QFile file("corrupted.qrb");
+	file.open(QIODevice::WriteOnly);
+	file.write("QRB1 is not enough");
+	file.close();
+
+	QHash<Id, Object *> map;
+	EXPECT_THROW(BinarySerializer::load("corrupted.qrb", map), Exception);
+	EXPECT_TRUE(map.isEmpty());
+
+	QFile::remove("corrupted.qrb");
+}
+
+TEST(BinarySerializerTest, conversionTest)
+{
+	QString const oldTempFolder = SettingsManager::value("temp").toString();
+	SettingsManager::setValue("temp", QDir::currentPath() + "/unsaved");
+
+	QList<Object *> const model = generateModel(10);
+	BinarySerializer::save("converted.qrb", model);
+
+	Serializer::convert("converted.qrb", "converted.qrs");
+	Serializer::convert("converted.qrs", "reconverted.qrb");
+
+	QHash<Id, Object *> map;
+	BinarySerializer::load("reconverted.qrb", map);
+
+	ASSERT_EQ(map.size(), model.size());
+	foreach (Object const * const object, model) {
+		ASSERT_TRUE(map.contains(object->id()));
+		EXPECT_EQ(map[object->id()]->parent(), object->parent());
+		EXPECT_EQ(map[object->id()]->children(), object->children());
+		EXPECT_EQ(map[object->id()]->properties(), object->properties());
+	}
+
+	qDeleteAll(map);
+	qDeleteAll(model);
+	QFile::remove("converted.qrb");
+	QFile::remove("converted.qrs");
+	QFile::remove("reconverted.qrb");
+	QDir().rmdir("unsaved");
+	SettingsManager::setValue("temp", oldTempFolder);
+}
+
+TEST(BinarySerializerTest, lazyLoadTest)
+{
+	QList<Object *> const model = generateModel(3);
+	BinarySerializer::save("lazy.qrb", model);
+
+	QHash<Id, Object *> map;
+	BinarySerializer::load("lazy.qrb", map, true);
+
+	ASSERT_EQ(map.size(), model.size());
+	foreach (Object const * const object, map) {
+		EXPECT_FALSE(object->isMaterialized());
+	}
+
+	Object const * const diagram = model.first();
+	EXPECT_EQ(map[diagram->id()]->children(), diagram->children());
+	EXPECT_FALSE(map[diagram->id()]->isMaterialized());
+
+	EXPECT_EQ(map[diagram->id()]->property("name"), QVariant("diagram"));
+	EXPECT_TRUE(map[diagram->id()]->isMaterialized());
+	EXPECT_FALSE(map[model.last()->id()]->isMaterialized());
+
+	// Saving over mapped file must not break objects that are not materialized yet.
+	BinarySerializer::save("lazy.qrb", QList<Object *>() << map[diagram->id()]);
+	foreach (Object const * const object, model) {
+		EXPECT_EQ(map[object->id()]->properties(), object->properties());
+	}
+
+	qDeleteAll(map);
+	qDeleteAll(model);
+	QFile::remove("lazy.qrb");
+}
+
+TEST(BinarySerializerTest, lazySaveToSameFileTest)
+{
+	QString const oldTempFolder = SettingsManager::value("temp").toString();
+	bool const oldLazyLoading = SettingsManager::value("LazyProjectLoading").toBool();
+	SettingsManager::setValue("temp", QDir::currentPath() + "/unsaved");
+	SettingsManager::setValue("LazyProjectLoading", true);
+
+	QList<Object *> const model = generateModel(3);
+	BinarySerializer::save("lazySave.qrb", model);
+	Id const diagram = model.first()->id();
+
+	{
+		// Objects of another reader of the same file stay lazy while the file is replaced.
+		QHash<Id, Object *> map;
+		BinarySerializer::load("lazySave.qrb", map, true);
+
+		Repository repository("lazySave.qrb");
+		EXPECT_LT(repository.residentObjectsCount(), model.size());
+		repository.setProperty(diagram, "name", "edited");
+		repository.saveAll();
+
+		EXPECT_FALSE(QFile::exists("lazySave.qrb.part"));
+		foreach (Object const * const object, model) {
+			EXPECT_EQ(map[object->id()]->properties(), object->properties());
+		}
+
+		qDeleteAll(map);
+	}
+
+	Repository const savedRepository("lazySave.qrb");
+	EXPECT_EQ(savedRepository.property(diagram, "name"), QVariant("edited"));
+	foreach (Object const * const object, model.mid(1)) {
+		ASSERT_TRUE(savedRepository.exist(object->id()));
+		EXPECT_EQ(savedRepository.property(object->id(), "name"), object->property("name"));
+	}
+
+	qDeleteAll(model);
+	QFile::remove("lazySave.qrb");
+	SettingsManager::setValue("LazyProjectLoading", oldLazyLoading);
+	SettingsManager::setValue("temp", oldTempFolder);
+}
+
+/// Compares load times of .qrs and .qrb files, run with --gtest_also_run_disabled_tests.
+TEST(BinarySerializerTest, DISABLED_loadBenchmark)
+{
+	QString const oldTempFolder = SettingsManager::value("temp").toString();
+	SettingsManager::setValue("temp", QDir::currentPath() + "/unsaved");
+
+	foreach (int const elementsCount, QList<int>() << 10000 << 100000) {
+		QList<Object *> const model = generateModel(elementsCount);
+
+		Serializer serializer("benchmark.qrs");
+		serializer.saveToDisk(model);
+		BinarySerializer::save("benchmark.qrb", model);
+		qDeleteAll(model);
+
+		QElapsedTimer timer;
+		QHash<Id, Object *> map;
+
+		timer.start();
+		serializer.loadFromDisk(map);
+		qint64 const xmlTime = timer.elapsed();
+		EXPECT_EQ(map.size(), 2 * elementsCount + 1);
+		qDeleteAll(map);
+		map.clear();
+
+		timer.start();
+		BinarySerializer::load("benchmark.qrb", map);
+		qint64 const binaryTime = timer.elapsed();
+		EXPECT_EQ(map.size(), 2 * elementsCount + 1);
+		qDeleteAll(map);
+		map.clear();
+
+		timer.start();
+		BinarySerializer::load("benchmark.qrb", map, true);
+		qint64 const lazyTime = timer.elapsed();
+		EXPECT_EQ(map.size(), 2 * elementsCount + 1);
+		qDeleteAll(map);
+
+		qDebug() << "Loading" << 2 * elementsCount + 1 << "objects: .qrs" << xmlTime << "ms, .qrb" << binaryTime
+				<< "ms, lazy .qrb" << lazyTime << "ms";
+
+		serializer.clearWorkingDir();
+		QFile::remove("benchmark.qrs");
+		QFile::remove("benchmark.qrb");
+	}
+
+	QDir().rmdir("unsaved");
+	SettingsManager::setValue("temp", oldTempFolder);
+}
@@ -56,3 +56,44 @@ TEST(GraphicalObjectTest, graphicalPartsSerializeTest)
 	ASSERT_EQ("Coord", graphicalPart.firstChildElement().attribute("key").toStdString());
 	ASSERT_EQ("10, 20", graphicalPart.firstChildElement().attribute("value").toStdString());
 }
+
+TEST(GraphicalObjectTest, streamSerializationTest)
+{
+	Id const element("editor", "diagram", "element", "id");
+	Id const graphicalElement("editor", "diagram", "element", "graphicalId");
+	Id const child("editor", "diagram", "element", "child");
+
+	GraphicalObject graphicalObject(graphicalElement, Id::rootId(), element);
+	graphicalObject.addChild(child);
+	graphicalObject.setProperty("name", "a \"quoted\" <name> & more");
+	graphicalObject.setProperty("links", IdListHelper::toVariant(IdList() << child << element));
+	graphicalObject.setProperty("position", QPointF(1, 2));
+	graphicalObject.createGraphicalPart(0);
+	graphicalObject.setGraphicalPartProperty(0, "Coord", QPointF(10, 20));
+
+	QByteArray streamed;
+	QXmlStreamWriter writer(&streamed);
+	graphicalObject.serialize(writer);
+	writer.writeEndDocument();
+
+	// Streamed XML shall be readable by DOM-based deserialization and vice versa.
+	QDomDocument document;
+	ASSERT_TRUE(document.setContent(streamed));
+	GraphicalObject const fromDom(document.documentElement());
+
+	QDomDocument serializedDocument;
+	serializedDocument.appendChild(graphicalObject.serialize(serializedDocument));
+	QXmlStreamReader reader(serializedDocument.toByteArray());
+	ASSERT_TRUE(reader.readNextStartElement());
+	GraphicalObject const fromStream(reader);
+	EXPECT_FALSE(reader.hasError());
+
+	foreach (GraphicalObject const *object, QList<GraphicalObject const *>() << &fromDom << &fromStream) {
+		EXPECT_EQ(object->id(), graphicalElement);
+		EXPECT_EQ(object->parent(), Id::rootId());
+		EXPECT_EQ(object->logicalId(), element);
+		EXPECT_EQ(object->children(), IdList() << child);
+		EXPECT_EQ(object->properties(), graphicalObject.properties());
+		EXPECT_EQ(object->graphicalPartProperty(0, "Coord"), QVariant(QPointF(10, 20)));
+	}
+}
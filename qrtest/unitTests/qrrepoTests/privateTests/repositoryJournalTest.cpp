@@ -0,0 +1,387 @@
+#include "../../../qrrepo/private/repository.h"
+#include "../../../qrrepo/private/repositoryJournal.h"
+#include "../../../qrrepo/private/repositorySnapshot.h"
+#include "../../../qrrepo/private/serializer.h"
+#include "../../../qrrepo/private/classes/logicalObject.h"
+#include "../../../qrrepo/private/classes/graphicalObject.h"
+#include "../../../qrkernel/settingsManager.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPointF>
+#include <QtCore/QScopedPointer>
+#include <QtGui/QPolygon>
+#include <gtest/gtest.h>
+
+using namespace qReal;
+using namespace qrRepo::details;
+
+namespace {
+
+Id const diagram("editor", "diagram", "Diagram", "diagram");
+
+/// Sets temporary folder for serializer and writes a project with a diagram and given number of elements.
+class JournalTestProject
+{
+public:
+	JournalTestProject(QString const &fileName, int elementsCount)
+		: mFileName(fileName)
+		, mOldTempFolder(SettingsManager::value("temp").toString())
+	{
+		SettingsManager::setValue("temp", QDir::currentPath() + "/unsaved");
+
+		QList<Object *> objects;
+		LogicalObject * const logicalDiagram = new LogicalObject(diagram);
+		logicalDiagram->setParent(Id::rootId());
+		logicalDiagram->setProperty("name", "diagram");
+		objects << logicalDiagram;
+
+		for (int i = 0; i < elementsCount; ++i) {
+			Id const element = Id(diagram.editor(), diagram.diagram(), "Element", QString("element%1").arg(i));
+			LogicalObject * const logical = new LogicalObject(element);
+			logical->setParent(diagram);
+			logical->setProperty("name", QString("element %1").arg(i));
+			logicalDiagram->addChild(element);
+			objects << logical;
+		}
+
+		Serializer serializer(fileName);
+		serializer.saveToDisk(objects);
+		qDeleteAll(objects);
+	}
+
+	~JournalTestProject()
+	{
+		QFile::remove(mFileName);
+		QFile::remove(RepositoryJournal::journalFile(mFileName));
+		QDir().rmdir("unsaved");
+		SettingsManager::setValue("temp", mOldTempFolder);
+	}
+
+private:
+	QString const mFileName;
+	QString const mOldTempFolder;
+};
+
+/// Checks that two repositories contain the same objects with the same structure and properties.
+void expectSameState(Repository const &expected, Repository const &actual)
+{
+	QScopedPointer<RepositorySnapshot> const expectedSnapshot(expected.createSnapshot());
+	QScopedPointer<RepositorySnapshot> const actualSnapshot(actual.createSnapshot());
+
+	IdList const ids = expectedSnapshot->elements();
+	ASSERT_EQ(ids.toSet(), actualSnapshot->elements().toSet());
+
+	foreach (Id const &id, ids) {
+		QScopedPointer<Object> const expectedObject(expectedSnapshot->copyObject(id));
+		QScopedPointer<Object> const actualObject(actualSnapshot->copyObject(id));
+
+		EXPECT_EQ(expectedObject->isLogicalObject(), actualObject->isLogicalObject()) << qPrintable(id.toString());
+		EXPECT_EQ(expectedObject->parent(), actualObject->parent()) << qPrintable(id.toString());
+		EXPECT_EQ(expectedObject->children(), actualObject->children()) << qPrintable(id.toString());
+		EXPECT_EQ(expectedObject->properties(), actualObject->properties()) << qPrintable(id.toString());
+
+		GraphicalObject const * const expectedGraphical = dynamic_cast<GraphicalObject const *>(expectedObject.data());
+		GraphicalObject const * const actualGraphical = dynamic_cast<GraphicalObject const *>(actualObject.data());
+		if (expectedGraphical && actualGraphical) {
+			EXPECT_EQ(expectedGraphical->logicalId(), actualGraphical->logicalId());
+			QList<int> const parts = expectedGraphical->graphicalParts();
+			EXPECT_EQ(parts.toSet(), actualGraphical->graphicalParts().toSet()) << qPrintable(id.toString());
+			foreach (int const part, parts) {
+				if (actualGraphical->graphicalParts().contains(part)) {
+					EXPECT_EQ(expectedGraphical->graphicalPartProperties(part)
+							, actualGraphical->graphicalPartProperties(part));
+				}
+			}
+		}
+	}
+}
+
+/// Returns a random property value of one of the types stored in models.
+QVariant randomValue()
+{
+	switch (qrand() % 7) {
+	case 0:
+		return qrand() % 1000 - 500;
+	case 1:
+		return QString("value %1").arg(qrand());
+	case 2:
+		return qrand() / 7.0;
+	case 3:
+		return qrand() % 2 == 0;
+	case 4:
+		return QPointF(qrand() % 100, qrand() % 100 / 3.0);
+	case 5:
+		return QVariant::fromValue(QPolygonF() << QPointF(0, 0) << QPointF(qrand() % 100, qrand() % 100));
+	default:
+		return QStringList() << "a" << QString::number(qrand());
+	}
+}
+
+}
+
+TEST(RepositoryJournalTest, replayTest)
+{
+	JournalTestProject const project("journal.qrs", 3);
+	Id const element("editor", "diagram", "Element", "element0");
+	Id const removed("editor", "diagram", "Element", "element1");
+	Id const created("editor", "diagram", "Element", "created");
+	Id const graphical("editor", "diagram", "Element", "graphical");
+
+	Repository direct("journal.qrs");
+	direct.setJournalEnabled(true);
+	EXPECT_EQ(direct.journalSize(), 0);
+
+	direct.setProperty(element, "name", "renamed");
+	direct.removeProperty(element, "name");
+	direct.setProperty(element, "position", QPointF(1, 2));
+	direct.removeChild(diagram, removed);
+	direct.remove(removed);
+	direct.addChild(diagram, created);
+	direct.addChild(diagram, graphical, created);
+	direct.createGraphicalPart(graphical, 1);
+	direct.setGraphicalPartProperty(graphical, 1, "Coord", QPointF(10, 20));
+	EXPECT_GT(direct.journalSize(), 0);
+
+	// A record torn by a crash is ignored.
+	QFile journal(RepositoryJournal::journalFile(QFileInfo("journal.qrs").absoluteFilePath()));
+	ASSERT_TRUE(journal.open(QIODevice::Append));
+	journal.write("\x00\x00\x01\x00garbage", 11);
+	journal.close();
+
+	Repository recovered("journal.qrs");
+	EXPECT_FALSE(recovered.exist(created));
+	recovered.setJournalEnabled(true);
+
+	EXPECT_TRUE(recovered.exist(created));
+	EXPECT_FALSE(recovered.exist(removed));
+	EXPECT_FALSE(recovered.hasProperty(element, "name"));
+	EXPECT_EQ(recovered.property(element, "position"), QVariant(QPointF(1, 2)));
+	EXPECT_EQ(recovered.graphicalPartProperty(graphical, 1, "Coord"), QVariant(QPointF(10, 20)));
+	expectSameState(direct, recovered);
+}
+
+TEST(RepositoryJournalTest, compactionTest)
+{
+	JournalTestProject const project("compaction.qrs", 3);
+	Id const element("editor", "diagram", "Element", "element0");
+	QString const journalFile = RepositoryJournal::journalFile(QFileInfo("compaction.qrs").absoluteFilePath());
+
+	{
+		Repository repository("compaction.qrs");
+		repository.setJournalEnabled(true);
+		repository.setProperty(element, "name", "renamed");
+		EXPECT_TRUE(QFile::exists(journalFile));
+
+		repository.compactJournal();
+		EXPECT_EQ(repository.journalSize(), 0);
+		EXPECT_FALSE(QFile::exists(journalFile));
+
+		repository.setProperty(element, "name", "changed after compaction");
+		EXPECT_TRUE(QFile::exists(journalFile));
+	}
+
+	// Normal close discards unsaved changes together with the journal.
+	EXPECT_FALSE(QFile::exists(journalFile));
+
+	Repository reopened("compaction.qrs");
+	reopened.setJournalEnabled(true);
+	EXPECT_EQ(reopened.property(element, "name").toString(), "renamed");
+}
+
+TEST(RepositoryJournalTest, automaticCompactionTest)
+{
+	JournalTestProject const project("autoCompaction.qrs", 3);
+	Id const element("editor", "diagram", "Element", "element0");
+	QVariant const oldThreshold = SettingsManager::value("JournalCompactionThreshold");
+	SettingsManager::setValue("JournalCompactionThreshold", 1);
+
+	{
+		Repository repository("autoCompaction.qrs");
+		repository.setJournalEnabled(true);
+		for (int i = 0; i < 200; ++i) {
+			repository.setProperty(element, "name", QString("name %1").arg(i));
+			EXPECT_LE(repository.journalSize(), 1024 + 100);
+		}
+
+		// Compactions happened between modifications and wrote the changes made so far.
+		Repository saved("autoCompaction.qrs");
+		EXPECT_TRUE(saved.property(element, "name").toString().startsWith("name "));
+	}
+
+	SettingsManager::setValue("JournalCompactionThreshold", oldThreshold);
+}
+
+TEST(RepositoryJournalTest, temporaryRemovedLinksTest)
+{
+	JournalTestProject const project("temporaryLinks.qrs", 3);
+	Id const element("editor", "diagram", "Element", "element0");
+	Id const link("editor", "diagram", "Element", "element1");
+
+	Repository direct("temporaryLinks.qrs");
+	direct.setProperty(element, "to", link.toVariant());
+	direct.setProperty(element, "from", link.toVariant());
+	direct.saveAll();
+	direct.setJournalEnabled(true);
+
+	direct.setTemporaryRemovedLinks(element, "to", IdList() << link);
+	direct.setTemporaryRemovedLinks(element, "from", IdList() << link);
+	direct.removeTemporaryRemovedLinks(element);
+	EXPECT_GT(direct.journalSize(), 0);
+
+	Repository recovered("temporaryLinks.qrs");
+	EXPECT_TRUE(recovered.hasProperty(element, "to"));
+	recovered.setJournalEnabled(true);
+
+	EXPECT_FALSE(recovered.hasProperty(element, "to"));
+	EXPECT_FALSE(recovered.hasProperty(element, "from"));
+	expectSameState(direct, recovered);
+}
+
+TEST(RepositoryJournalTest, copyKeepsJournalTest)
+{
+	JournalTestProject const project("copied.qrs", 3);
+	Id const element("editor", "diagram", "Element", "element0");
+	Id const graphical("editor", "diagram", "Element", "graphical");
+	QString const journalFile = RepositoryJournal::journalFile(QFileInfo("copied.qrs").absoluteFilePath());
+
+	Repository direct("copied.qrs");
+	direct.setJournalEnabled(true);
+	direct.addChild(diagram, graphical, element);
+	direct.setProperty(element, "name", "renamed");
+
+	QHash<QString, IdList> copies;
+	copies["copy.qrs"] = IdList() << graphical;
+	direct.saveDiagramsById(copies);
+
+	// Changes are written to the copy only, the journal still protects the working file.
+	EXPECT_GT(direct.journalSize(), 0);
+	EXPECT_TRUE(QFile::exists(journalFile));
+	EXPECT_EQ(direct.workingFile(), "copied.qrs");
+
+	Repository recovered("copied.qrs");
+	recovered.setJournalEnabled(true);
+	EXPECT_EQ(recovered.property(element, "name").toString(), "renamed");
+	EXPECT_TRUE(recovered.exist(graphical));
+
+	QFile::remove("copy.qrs");
+}
+
+TEST(RepositoryJournalTest, fuzzTest)
+{
+	qsrand(20141018);
+	QStringList const propertyNames = QStringList() << "name" << "a" << "b" << "c";
+	QStringList const partPropertyNames = QStringList() << "Coord" << "Size";
+
+	for (int round = 0; round < 5; ++round) {
+		JournalTestProject const project("fuzz.qrs", 5);
+		Repository direct("fuzz.qrs");
+		direct.setJournalEnabled(true);
+
+		IdList logical = direct.children(diagram) << diagram;
+		IdList graphical;
+		QHash<Id, QList<int> > parts;
+		int created = 0;
+
+		for (int step = 0; step < 300; ++step) {
+			IdList const all = logical + graphical;
+			Id const id = all[qrand() % all.size()];
+			QString const propertyName = propertyNames[qrand() % propertyNames.size()];
+
+			switch (qrand() % 9) {
+			case 0:
+			case 1:
+				direct.setProperty(id, propertyName, randomValue());
+				break;
+			case 2:
+				if (direct.hasProperty(id, propertyName)) {
+					direct.removeProperty(id, propertyName);
+				}
+				break;
+			case 3: {
+				Id const child("editor", "diagram", "Element", QString("created%1").arg(++created));
+				direct.addChild(id, child);
+				logical << child;
+				break;
+			}
+			case 4: {
+				Id const child("editor", "diagram", "Element", QString("created%1").arg(++created));
+				direct.addChild(id, child, logical[qrand() % logical.size()]);
+				graphical << child;
+				break;
+			}
+			case 5:
+				if (!graphical.isEmpty()) {
+					Id const element = graphical[qrand() % graphical.size()];
+					int const part = parts[element].size();
+					direct.createGraphicalPart(element, part);
+					parts[element] << part;
+				}
+				break;
+			case 6:
+				if (!parts.isEmpty()) {
+					Id const element = parts.keys()[qrand() % parts.size()];
+					direct.setGraphicalPartProperty(element, parts[element][qrand() % parts[element].size()]
+							, partPropertyNames[qrand() % partPropertyNames.size()], randomValue());
+				}
+				break;
+			case 7:
+				if (direct.children(id).size() >= 2) {
+					IdList const children = direct.children(id);
+					direct.stackBefore(id, children.last(), children.first());
+				}
+				break;
+			default:
+				if (id != diagram && direct.children(id).isEmpty() && direct.exist(direct.parent(id))) {
+					direct.removeChild(direct.parent(id), id);
+					direct.remove(id);
+					logical.removeAll(id);
+					graphical.removeAll(id);
+					parts.remove(id);
+				}
+				break;
+			}
+		}
+
+		Repository recovered("fuzz.qrs");
+		recovered.setJournalEnabled(true);
+		expectSameState(direct, recovered);
+	}
+}
+
+/// Measures journaling and replay of property changes against full saves, run with --gtest_also_run_disabled_tests.
+TEST(RepositoryJournalTest, DISABLED_replayBenchmark)
+{
+	int const elementsCount = 10000;
+	foreach (int const changesCount, QList<int>() << 1000 << 10000 << 100000) {
+		JournalTestProject const project("benchmark.qrs", elementsCount);
+		Repository direct("benchmark.qrs");
+		direct.setJournalEnabled(true);
+
+		QElapsedTimer timer;
+		timer.start();
+		for (int i = 0; i < changesCount; ++i) {
+			Id const element("editor", "diagram", "Element", QString("element%1").arg(i % elementsCount));
+			direct.setProperty(element, "position", QPointF(i, i));
+		}
+
+		qint64 const journalingTime = timer.elapsed();
+		qint64 const journalSize = direct.journalSize();
+
+		timer.start();
+		Repository recovered("benchmark.qrs");
+		qint64 const openTime = timer.elapsed();
+		recovered.setJournalEnabled(true);
+		qint64 const replayTime = timer.elapsed() - openTime;
+
+		timer.start();
+		direct.setWorkingFile("benchmarkFull.qrs");
+		direct.saveAll();
+		qint64 const fullSaveTime = timer.elapsed();
+		QFile::remove("benchmarkFull.qrs");
+
+		qDebug() << changesCount << "changes of" << elementsCount << "elements: journaling" << journalingTime
+				<< "ms, journal" << journalSize << "bytes, open" << openTime << "ms, replay" << replayTime
+				<< "ms, full save" << fullSaveTime << "ms";
+	}
+}
@@ -1,8 +1,10 @@
 #include <QtCore/QFile>
 #include <QtCore/QDir>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include "repositoryTest.h"
 #include "../../../qrrepo/private/classes/logicalObject.h"
+#include "../../../qrrepo/private/repositorySnapshot.h"
 #include "../../../qrkernel/exception/exception.h"
 #include "../../../qrkernel/settingsManager.h"
 
@@ -225,6 +227,62 @@ TEST_F(RepositoryTest, elementsByPropertyContentTest) {
 	EXPECT_TRUE(list.contains(root));
 }
 
+TEST_F(RepositoryTest, indexesUpdateTest) {
+	EXPECT_EQ(mRepository->findElementsByName("child1", false, false).size(), 2);
+	EXPECT_EQ(mRepository->elementsByPropertyContent("value2", false, false).size(), 1);
+
+	mRepository->setProperty(child1, "name", "renamed");
+	mRepository->setProperty(child1_child, "property2", "value2");
+	mRepository->remove(child3_child);
+
+	IdList list = mRepository->findElementsByName("child1", false, false);
+	EXPECT_EQ(list, IdList() << child1_child);
+	EXPECT_EQ(mRepository->findElementsByName("RENAMED", false, false), IdList() << child1);
+
+	list = mRepository->elementsByPropertyContent("value2", false, false);
+	EXPECT_EQ(list, IdList() << child1_child);
+
+	Id const newChild("editor1", "diagram2", "element3", "newChild");
+	mRepository->addChild(root, newChild, child2);
+	mRepository->setProperty(newChild, "name", "new child");
+	EXPECT_EQ(mRepository->findElementsByName("new ch", false, false), IdList() << newChild);
+
+	EXPECT_EQ(mRepository->graphicalElements(newChild.type()).size(), 2);
+	EXPECT_TRUE(mRepository->graphicalElements(newChild.type()).contains(child1));
+	EXPECT_EQ(mRepository->logicalElements(child2.type()).size(), 1);
+	EXPECT_EQ(mRepository->elementsByType("ELEMENT3", false, false).size(), 3);
+	EXPECT_EQ(mRepository->elementsByType("ELEMENT3", true, false).size(), 0);
+	EXPECT_EQ(mRepository->graphicalElements().size(), 5);
+
+	IdList const byType = mRepository->elementsByType("element", false, false);
+	IdList sortedByType = byType;
+	qSort(sortedByType);
+	EXPECT_EQ(byType, sortedByType);
+}
+
+TEST_F(RepositoryTest, concurrentQueriesTest) {
+	QList<QFuture<bool> > queries;
+	for (int i = 0; i < 4; ++i) {
+		queries << QtConcurrent::run([this]() {
+			bool result = true;
+			for (int j = 0; j < 100; ++j) {
+				result = result && mRepository->findElementsByName("child", false, false).size() == 3
+						&& mRepository->elementsByPropertyContent("value2", false, false).size() == 1;
+			}
+
+			return result;
+		});
+	}
+
+	for (int i = 0; i < 100; ++i) {
+		mRepository->setProperty(child1, "name", QString("child1 %1").arg(i));
+	}
+
+	foreach (QFuture<bool> const &query, queries) {
+		EXPECT_TRUE(query.result());
+	}
+}
+
 TEST_F(RepositoryTest, parentOperationsTest) {
 	EXPECT_EQ(mRepository->parent(child1), root);
 	EXPECT_EQ(mRepository->parent(child2), root);
@@ -640,3 +698,109 @@ TEST_F(RepositoryTest, saveDiagramsByIdTest) {
 
 	QFile::remove("diagram1.qrs");
 }
+
+TEST_F(RepositoryTest, incrementalSaveTest) {
+	mRepository->saveAll();
+	EXPECT_TRUE(mRepository->lastSaveStatistics().incremental);
+	EXPECT_EQ(mRepository->lastSaveStatistics().objectsWritten, 0);
+
+	mRepository->setProperty(child2, "property3", "newValue");
+	mRepository->removeChild(child3, child3_child);
+	mRepository->remove(child3_child);
+	mRepository->saveAll();
+
+	EXPECT_TRUE(mRepository->lastSaveStatistics().incremental);
+	EXPECT_EQ(mRepository->lastSaveStatistics().objectsWritten, 2);
+	EXPECT_GT(mRepository->lastSaveStatistics().bytesWritten, 0);
+
+	Repository const savedRepository("saveFile.qrs");
+	EXPECT_EQ(savedRepository.property(child2, "property3").toString(), "newValue");
+	EXPECT_EQ(savedRepository.property(root, "property1").toString(), "value1");
+	EXPECT_TRUE(savedRepository.children(child3).isEmpty());
+	EXPECT_FALSE(savedRepository.exist(child3_child));
+
+	mRepository->setWorkingFile("otherSaveFile.qrs");
+	mRepository->saveAll();
+	EXPECT_FALSE(mRepository->lastSaveStatistics().incremental);
+	EXPECT_EQ(mRepository->lastSaveStatistics().objectsWritten, mRepository->elements().size());
+
+	QFile::remove("otherSaveFile.qrs");
+}
+
+TEST_F(RepositoryTest, temporaryRemovedLinksSaveTest) {
+	Id const link("editor", "diagram", "element", "link");
+
+	mRepository->setProperty(root, "to", qReal::IdListHelper::toVariant(IdList() << link));
+	mRepository->saveAll();
+
+	mRepository->setTemporaryRemovedLinks(root, "to", IdList() << link);
+	mRepository->removeTemporaryRemovedLinks(root);
+	mRepository->saveAll();
+
+	EXPECT_TRUE(mRepository->lastSaveStatistics().incremental);
+	EXPECT_EQ(mRepository->lastSaveStatistics().objectsWritten, 1);
+
+	Repository const savedRepository("saveFile.qrs");
+	EXPECT_FALSE(savedRepository.hasProperty(root, "to"));
+	EXPECT_EQ(savedRepository.property(root, "property1").toString(), "value1");
+}
+
+TEST_F(RepositoryTest, snapshotTest) {
+	IdList const elements = mRepository->elements();
+	QScopedPointer<RepositorySnapshot> const snapshot(mRepository->createSnapshot());
+	EXPECT_EQ(snapshot->preservedObjectsCount(), 0);
+
+	mRepository->setProperty(root, "property1", "changed");
+	mRepository->removeChild(child3, child3_child);
+	mRepository->remove(child3_child);
+	Id const newChild("editor1", "diagram2", "element3", "newChild");
+	mRepository->addChild(root, newChild);
+
+	EXPECT_EQ(mRepository->property(root, "property1").toString(), "changed");
+	EXPECT_EQ(snapshot->property(root, "property1").toString(), "value1");
+	EXPECT_EQ(snapshot->children(child3), IdList() << child3_child);
+	EXPECT_TRUE(snapshot->exist(child3_child));
+	EXPECT_EQ(snapshot->parent(child3_child), child3);
+	EXPECT_FALSE(snapshot->exist(newChild));
+	EXPECT_FALSE(snapshot->children(root).contains(newChild));
+	EXPECT_THROW(snapshot->property(newChild, "name"), Exception);
+	EXPECT_EQ(snapshot->elements().toSet(), elements.toSet());
+
+	// Only changed objects are copied: root, child3 and removed child3_child.
+	EXPECT_EQ(snapshot->preservedObjectsCount(), 3);
+
+	QScopedPointer<RepositorySnapshot> const laterSnapshot(mRepository->createSnapshot());
+	EXPECT_TRUE(laterSnapshot->exist(newChild));
+	EXPECT_EQ(laterSnapshot->property(root, "property1").toString(), "changed");
+}
+
+TEST_F(RepositoryTest, snapshotOutlivesRepositoryTest) {
+	QScopedPointer<RepositorySnapshot> const snapshot(mRepository->createSnapshot());
+	IdList const elements = mRepository->elements();
+
+	mRepository->open("newSaveFile.qrs");
+	EXPECT_FALSE(snapshot->exist(newId1));
+	EXPECT_EQ(snapshot->elements().toSet(), elements.toSet());
+
+	delete mRepository;
+	mRepository = NULL;
+
+	EXPECT_EQ(snapshot->elements().toSet(), elements.toSet());
+	EXPECT_EQ(snapshot->property(root, "property1").toString(), "value1");
+	EXPECT_EQ(snapshot->logicalId(child1), child1LogicalId);
+}
+
+TEST_F(RepositoryTest, snapshotSaveToTest) {
+	QSharedPointer<RepositorySnapshot> const snapshot(mRepository->createSnapshot());
+	mRepository->setProperty(root, "property1", "changed");
+	mRepository->remove(child3_child);
+
+	snapshot->saveTo("snapshot.qrs");
+
+	Repository const savedRepository("snapshot.qrs");
+	EXPECT_EQ(savedRepository.elements().toSet(), snapshot->elements().toSet());
+	EXPECT_EQ(savedRepository.property(root, "property1").toString(), "value1");
+	EXPECT_TRUE(savedRepository.exist(child3_child));
+
+	QFile::remove("snapshot.qrs");
+}
@@ -1,6 +1,9 @@
 #include <QtCore/QFile>
 #include <QtCore/QDir>
 #include <QtCore/QPointF>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QElapsedTimer>
 
 #include "serializerTest.h"
 #include "../../../qrrepo/private/classes/logicalObject.h"
@@ -29,6 +32,36 @@ void SerializerTest::removeDirectory(QString const &dirName)
 	dir.rmdir(dir.absolutePath());
 }
 
+namespace {
+
+/// Generates a project with given number of logical elements with graphical representations.
+QList<Object *> generateProject(int elementsCount)
+{
+	QList<Object *> result;
+	for (int i = 0; i < elementsCount; ++i) {
+		Id const logicalId = Id::createElementId("editor", "diagram", "Element");
+		LogicalObject * const logical = new LogicalObject(logicalId);
+		logical->setParent(Id::rootId());
+		logical->setProperty("name", QString("element %1").arg(i));
+
+		GraphicalObject * const graphical = new GraphicalObject(logicalId.sameTypeId(), Id::rootId(), logicalId);
+		graphical->setProperty("position", QPointF(i, i));
+
+		result << logical << graphical;
+	}
+
+	return result;
+}
+
+QByteArray fileContents(QString const &fileName)
+{
+	QFile file(fileName);
+	file.open(QIODevice::ReadOnly);
+	return file.readAll();
+}
+
+}
+
 void SerializerTest::SetUp()
 {
 	mOldTempFolder = SettingsManager::value("temp").toString();
@@ -133,3 +166,76 @@ TEST_F(SerializerTest, saveAndLoadGraphicalPartsTest)
 
 	ASSERT_EQ(QPointF(10, 20), deserializedGraphicalObject->graphicalPartProperty(0, "Coord"));
 }
+
+TEST_F(SerializerTest, parallelSaveIsDeterministicTest)
+{
+	QList<Object *> const project = generateProject(200);
+	int const oldMaxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+
+	QThreadPool::globalInstance()->setMaxThreadCount(1);
+	mSerializer->saveToDisk(project);
+	QByteArray const serialSave = fileContents("saveFile.qrs");
+
+	QThreadPool::globalInstance()->setMaxThreadCount(qMax(4, oldMaxThreadCount));
+	mSerializer->saveToDisk(project);
+	QByteArray const parallelSave = fileContents("saveFile.qrs");
+
+	QThreadPool::globalInstance()->setMaxThreadCount(oldMaxThreadCount);
+
+	EXPECT_FALSE(serialSave.isEmpty());
+	EXPECT_EQ(serialSave, parallelSave);
+
+	QHash<Id, Object *> map;
+	mSerializer->setWorkingFile("saveFile.qrs");
+	mSerializer->loadFromDisk(map);
+	ASSERT_EQ(map.size(), project.size());
+	foreach (Object const * const object, project) {
+		ASSERT_TRUE(map.contains(object->id()));
+		EXPECT_EQ(map[object->id()]->properties(), object->properties());
+	}
+
+	qDeleteAll(map);
+	qDeleteAll(project);
+}
+
+/// Reports save and load times of .qrs project for 1 to N threads, run with --gtest_also_run_disabled_tests.
+TEST_F(SerializerTest, DISABLED_parallelSaveLoadBenchmark)
+{
+	QList<Object *> const project = generateProject(50000);
+	int const oldMaxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+	mSerializer->setWorkingFile("saveFile.qrs");
+
+	QList<int> threadCounts;
+	for (int threads = 1; threads < QThread::idealThreadCount(); threads *= 2) {
+		threadCounts << threads;
+	}
+
+	threadCounts << QThread::idealThreadCount();
+
+	qint64 serialTime = 0;
+	foreach (int const threads, threadCounts) {
+		QThreadPool::globalInstance()->setMaxThreadCount(threads);
+		QElapsedTimer timer;
+
+		timer.start();
+		mSerializer->saveToDisk(project);
+		qint64 const saveTime = timer.elapsed();
+
+		QHash<Id, Object *> map;
+		timer.start();
+		mSerializer->loadFromDisk(map);
+		qint64 const loadTime = timer.elapsed();
+		EXPECT_EQ(map.size(), project.size());
+		qDeleteAll(map);
+
+		if (threads == 1) {
+			serialTime = saveTime + loadTime;
+		}
+
+		qDebug() << threads << "threads: save" << saveTime << "ms, load" << loadTime << "ms, speedup"
+				<< static_cast<double>(serialTime) / qMax<qint64>(1, saveTime + loadTime);
+	}
+
+	QThreadPool::globalInstance()->setMaxThreadCount(oldMaxThreadCount);
+	qDeleteAll(project);
+}
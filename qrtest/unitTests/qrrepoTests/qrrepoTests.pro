@@ -10,7 +10,9 @@ SOURCES += \
 	repoApiTest.cpp \
 	privateTests/folderCompressorTest.cpp \
 	privateTests/serializerTest.cpp \
+	privateTests/binarySerializerTest.cpp \
 	privateTests/repositoryTest.cpp \
+	privateTests/repositoryJournalTest.cpp \
 	privateTests/classesTests/objectTest.cpp \
 	privateTests/classesTests/graphicalObjectTest.cpp \
 
@@ -0,0 +1,42 @@
+#include "../../../qrutils/mathUtils/gaussNoise.h"
+
+#include "gtest/gtest.h"
+
+using namespace mathUtils;
+
+TEST(GaussNoiseTest, seedTest) {
+	GaussNoise first(12, 1);
+	GaussNoise second(12, 1);
+	first.setSeed(42);
+	second.setSeed(42);
+
+	for (int i = 0; i < 100; ++i) {
+		ASSERT_EQ(first.generate(), second.generate());
+	}
+
+	// Generators do not share a sequence, so numbers taken from one do not change numbers of another.
+	GaussNoise third(12, 1);
+	third.setSeed(42);
+	qreal const expected = third.generate();
+	first.setSeed(42);
+	second.setSeed(7);
+	second.generate();
+	ASSERT_EQ(expected, first.generate());
+}
+
+TEST(GaussNoiseTest, distributionTest) {
+	GaussNoise noise(12, 4);
+	noise.setSeed(1);
+	int const count = 10000;
+	qreal sum = 0;
+	qreal squaresSum = 0;
+	for (int i = 0; i < count; ++i) {
+		qreal const value = noise.generate();
+		sum += value;
+		squaresSum += value * value;
+	}
+
+	qreal const mean = sum / count;
+	ASSERT_NEAR(0, mean, 0.1);
+	ASSERT_NEAR(4, squaresSum / count - mean * mean, 0.3);
+}
@@ -9,6 +9,7 @@ include(../../../qrutils/qrutils.pri)
 SOURCES += \
 	expressionsParser/expressionsParserTest.cpp \
 	expressionsParser/numberTest.cpp \
+	gaussNoiseTest.cpp \
 	metamodelGeneratorSupportTest.cpp \
 	inFileTest.cpp \
 	outFileTest.cpp \
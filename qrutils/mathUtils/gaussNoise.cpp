@@ -1,8 +1,7 @@
-#include <QtCore/QTime>
 #include <QtCore/QtGlobal>
 
 #include <math.h>
-#include "time.h"
+#include <time.h>
 
 #include "gaussNoise.h"
 
@@ -11,15 +10,15 @@ using namespace mathUtils;
 GaussNoise::GaussNoise()
 	: mApproximationLevel(defaultApproximationLevel)
 	, mDispersion(defaultDispersion)
+	, mState(static_cast<quint32>(time(0)))
 {
-	qsrand(time(0));
 }
 
 GaussNoise::GaussNoise(unsigned int const approximationLevel, qreal const variance)
+	: mApproximationLevel(approximationLevel)
+	, mDispersion(variance)
+	, mState(static_cast<quint32>(time(0)))
 {
-	qsrand(time(0));
-	mApproximationLevel = approximationLevel;
-	mDispersion = variance;
 }
 
 GaussNoise::~GaussNoise()
@@ -46,12 +45,24 @@ qreal GaussNoise::dispersion() const
 	return mDispersion;
 }
 
+void GaussNoise::setSeed(quint32 seed)
+{
+	mState = seed;
+}
+
+qreal GaussNoise::uniform() const
+{
+	// Constants of Numerical Recipes, high bits are taken as they have the longest period.
+	mState = mState * 1664525u + 1013904223u;
+	return static_cast<qreal>(mState >> 8) / (1u << 24);
+}
+
 qreal GaussNoise::genBody(unsigned int const approximationLevel, qreal const variance) const
 {
 	qreal x = 0.0;
 
 	for (unsigned int i = 0; i < approximationLevel; ++i) {
-		x += static_cast<qreal>(qrand()) / (static_cast<unsigned int>(RAND_MAX) + 1);
+		x += uniform();
 	}
 
 	x -= approximationLevel * mu;
@@ -9,7 +9,8 @@ namespace mathUtils {
 qreal const mu = 0.5;
 qreal const var = 0.083; // 1/12
 
-/// Provides Gauss Noise Generator
+/// Provides Gauss Noise Generator. Every generator has its own sequence of pseudorandom numbers, seeded by
+/// current time unless a seed is given, so a sequence can be repeated by seeding a generator with the same number.
 class QRUTILS_EXPORT GaussNoise
 {
 public:
@@ -27,6 +28,9 @@ public:
 	unsigned int approximationLevel() const;
 	qreal dispersion() const;
 
+	/// Restarts the sequence of generated numbers from given seed.
+	void setSeed(quint32 seed);
+
 	GaussNoise operator >> (qreal &left);
 
 private:
@@ -36,8 +40,14 @@ private:
 	/// Body of function 'generate'. Uses for various realizations of 'generate'
 	qreal genBody(unsigned int const approximationLevel, qreal const variance) const;
 
+	/// Returns next uniformly distributed number in [0, 1).
+	qreal uniform() const;
+
 	unsigned int mApproximationLevel;
 	qreal mDispersion;
+
+	/// State of linear congruential generator of uniformly distributed numbers.
+	mutable quint32 mState;
 };
 
 }